@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Minimum time between two writes to the same backlight while fading
+#define BSP_BACKLIGHT_UPDATE_INTERVAL_MS 20
+
+/// @brief Backlights that can be faded
+typedef enum {
+    BSP_BACKLIGHT_DISPLAY = 0,
+    BSP_BACKLIGHT_KEYBOARD,
+    BSP_BACKLIGHT_COUNT,
+} bsp_backlight_t;
+
+/// @brief Shape of a backlight fade
+typedef enum {
+    BSP_BACKLIGHT_CURVE_LINEAR = 0,   // Constant change in brightness
+    BSP_BACKLIGHT_CURVE_EASE_IN_OUT,  // Starts and ends slowly
+    BSP_BACKLIGHT_CURVE_PERCEPTUAL,   // Constant change in perceived brightness
+} bsp_backlight_curve_t;
+
+/// @brief Fade a backlight to a brightness level
+/// @details The fade runs on a task of its own which writes at most one update per backlight every
+///          BSP_BACKLIGHT_UPDATE_INTERVAL_MS and skips updates that would not change the level. Starting a new fade
+///          while one is running continues from the current level, so an animation may request a new target every
+///          frame without adding bus traffic, otherwise the fade starts from the level read back from the hardware.
+///          The backlights are driven through bsp_display_set_backlight_brightness and
+///          bsp_input_set_backlight_brightness of the target, setting a level through those while a fade runs is
+///          overwritten by the next update of the fade.
+/// @param percentage Target brightness (0-100%)
+/// @param duration_ms Duration of the fade, 0 sets the level at the next update
+/// @return ESP-IDF error code
+///          - ESP_OK if the fade has been started
+///          - ESP_ERR_NOT_SUPPORTED if the device has no controllable backlight of this kind
+esp_err_t bsp_backlight_fade(bsp_backlight_t backlight, uint8_t percentage, uint32_t duration_ms,
+                             bsp_backlight_curve_t curve);
+
+/// @brief Get the brightness a backlight is fading to, or its current brightness if no fade is running
+/// @return ESP-IDF error code
+esp_err_t bsp_backlight_get_target(bsp_backlight_t backlight, uint8_t* out_percentage);
+
+/// @brief Check whether a fade of a backlight is still running
+/// @return true while the backlight is fading
+bool bsp_backlight_is_fading(bsp_backlight_t backlight);
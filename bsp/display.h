@@ -55,8 +55,21 @@ typedef enum {
 typedef struct {
     bsp_display_color_format_t requested_color_format;  // Requested color format, applied if supported by the display
     size_t                     num_fbs;                 // Number of framebuffers to allocate
+    size_t                     max_blits_in_flight;     // Number of blits that may be queued at once (0 means 1)
+    size_t                     bounce_buffer_lines;     // RGB panels: lines per internal RAM bounce buffer (0 disables)
+    bool                       restart_on_vsync;        // RGB panels: resynchronize scan-out at every vsync
 } bsp_display_configuration_t;
 
+/// @brief Blit completion callback
+/// @details Called from interrupt context once the display driver no longer needs the pixel buffer
+/// @param user_ctx User context passed to bsp_display_blit_async
+/// @return Whether a high priority task has been woken up by this callback
+typedef bool (*bsp_display_blit_done_cb_t)(void* user_ctx);
+
+/// @brief Get the number of bits used to store a single pixel in a color format
+/// @return Bits per pixel, 0 for unknown formats
+size_t bsp_display_get_bits_per_pixel(bsp_display_color_format_t color_fmt);
+
 /// @brief Get display parameters
 /// @details Get display parameters
 /// @return ESP-IDF error code
@@ -65,6 +78,15 @@ typedef struct {
 esp_err_t bsp_display_get_parameters(size_t* h_res, size_t* v_res, bsp_display_color_format_t* color_fmt,
                                      bsp_display_endianness_t* data_endian);
 
+/// @brief Get the palette of a display with a palette color format
+/// @details Entries are red, green and blue bytes, the index of an entry is the value a pixel stores for that color
+/// @param out_palette Receives a pointer to the palette, owned by the display driver
+/// @param out_palette_size Receives the number of entries
+/// @return ESP-IDF error code
+///          - ESP_OK if succesful
+///          - ESP_ERR_NOT_SUPPORTED if the display does not use a palette
+esp_err_t bsp_display_get_palette(const uint8_t** out_palette, size_t* out_palette_size);
+
 /// @brief Get display panel
 /// @details Get display panel
 /// @return ESP-IDF error code
@@ -106,3 +128,262 @@ esp_err_t bsp_display_get_tearing_effect_semaphore(SemaphoreHandle_t* semaphore)
 /// @brief Send pixel data to the display
 /// @return ESP-IDF error code
 esp_err_t bsp_display_blit(size_t x, size_t y, size_t width, size_t height, const void* buffer);
+
+/// @brief Queue pixel data to be sent to the display
+/// @details Returns as soon as the transfer has been queued. The buffer must stay valid until the callback has been
+///          called. When the maximum number of blits are already in flight this function waits for the oldest one to
+///          complete first.
+/// @param callback Called when the transfer has completed, may be NULL
+/// @param user_ctx User context passed to the callback
+/// @return ESP-IDF error code
+///          - ESP_OK if the transfer has been queued
+///          - ESP_ERR_TIMEOUT if no previous transfer completed in time
+esp_err_t bsp_display_blit_async(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer,
+                                 bsp_display_blit_done_cb_t callback, void* user_ctx);
+
+/// @brief Wait for all queued blits to complete
+/// @return ESP-IDF error code
+///          - ESP_OK if no blits are in flight anymore
+///          - ESP_ERR_TIMEOUT if the queued blits did not complete in time
+esp_err_t bsp_display_blit_wait_idle(TickType_t timeout);
+
+// ============================================
+// Damage tracking
+// ============================================
+
+/// @brief Mark a region of the framebuffer as changed
+/// @details Regions are merged with previously marked regions when sending them as one costs less than sending them
+///          separately. Coordinates are clipped to the display resolution.
+/// @return ESP-IDF error code
+esp_err_t bsp_display_damage_add(size_t x_start, size_t y_start, size_t x_end, size_t y_end);
+
+/// @brief Forget all regions marked as changed
+void bsp_display_damage_clear(void);
+
+/// @brief Set the cost of starting a blit, expressed in pixels
+/// @details Used to decide whether two regions are merged, a higher cost results in fewer but larger blits
+void bsp_display_damage_set_blit_cost(size_t pixels);
+
+/// @brief Send the changed regions of a full screen framebuffer to the display
+/// @details Every region marked since the previous flush is blitted once, after which the damage is cleared. Regions
+///          spanning the full width are sent straight from the framebuffer, call bsp_display_blit_wait_idle before
+///          drawing into those rows again.
+/// @param framebuffer Full screen framebuffer in the color format of the display
+/// @param out_bytes Optional output for the number of pixel bytes sent
+/// @return ESP-IDF error code
+esp_err_t bsp_display_damage_flush(const void* framebuffer, size_t* out_bytes);
+
+// ============================================
+// Pixel format conversion
+// ============================================
+
+// Source pixels are read in the byte order of the CPU (little endian), destination pixels are written in the requested
+// byte order. RGB888 pixels hold the value 0xRRGGBB and ARGB8888 pixels the value 0xAARRGGBB. The kernels are portable
+// C working on whole 32-bit words where the pixel layout allows it. On the ESP32-P4 the RGB565 byte swap and the RGB565
+// to greyscale conversion use the PIE vector instructions for the 16 byte aligned part of the buffers, with the same
+// results as the C kernels, which remain the fallback on other targets.
+
+/// @brief Convert RGB888 pixels to RGB565
+void bsp_display_convert_rgb888_to_rgb565(void* dst, const void* src, size_t pixels,
+                                          bsp_display_endianness_t dst_endian);
+
+/// @brief Convert RGB565 pixels to RGB888
+void bsp_display_convert_rgb565_to_rgb888(void* dst, const void* src, size_t pixels,
+                                          bsp_display_endianness_t dst_endian);
+
+/// @brief Convert ARGB8888 pixels to RGB888, dropping the alpha channel
+void bsp_display_convert_argb8888_to_rgb888(void* dst, const void* src, size_t pixels,
+                                            bsp_display_endianness_t dst_endian);
+
+/// @brief Swap the bytes of RGB565 pixels, dst and src may point to the same buffer
+void bsp_display_convert_rgb565_swap(void* dst, const void* src, size_t pixels);
+
+/// @brief Convert RGB565 pixels to packed greyscale
+/// @details Pixels are packed starting at the most significant bit of each byte
+/// @param bits Bits per destination pixel: 1, 2, 4 or 8
+/// @return ESP-IDF error code
+esp_err_t bsp_display_convert_rgb565_to_grey(void* dst, const void* src, size_t pixels, size_t bits);
+
+/// @brief Convert RGB888 pixels to packed greyscale
+/// @details Pixels are packed starting at the most significant bit of each byte
+/// @param bits Bits per destination pixel: 1, 2, 4 or 8
+/// @return ESP-IDF error code
+esp_err_t bsp_display_convert_rgb888_to_grey(void* dst, const void* src, size_t pixels, size_t bits);
+
+/// @brief Convert pixels between two color formats
+/// @return ESP-IDF error code
+///          - ESP_OK if the pixels have been converted
+///          - ESP_ERR_NOT_SUPPORTED if there is no conversion between the formats
+esp_err_t bsp_display_convert(void* dst, bsp_display_color_format_t dst_fmt, bsp_display_endianness_t dst_endian,
+                              const void* src, bsp_display_color_format_t src_fmt, size_t pixels);
+
+/// @brief Send pixel data in another color format to the display
+/// @details Pixels are converted to the color format and byte order of the display in small DMA capable strips, each
+///          strip is queued while the next one is converted. The source buffer is free once this function returns.
+/// @param src_fmt Color format of the buffer, stored in CPU byte order
+/// @return ESP-IDF error code
+esp_err_t bsp_display_blit_convert(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer,
+                                   bsp_display_color_format_t src_fmt);
+
+// ============================================
+// Frame pacing
+// ============================================
+
+#define BSP_DISPLAY_FRAME_HISTOGRAM_BUCKETS   16
+#define BSP_DISPLAY_FRAME_HISTOGRAM_BUCKET_US 4000
+
+/// @brief Frame statistics
+/// @details Frame times are measured between the starts of two consecutive presents. Bucket n of the histogram counts
+///          frame times from n * 4 ms up to (n + 1) * 4 ms, the last bucket also counts everything longer.
+typedef struct {
+    uint32_t frames;                                                     // Number of frames presented
+    uint32_t missed_vsyncs;                                              // Vsyncs at which a frame was due but late
+    uint64_t wait_time_us;                                               // Total time spent waiting for a frame slot
+    uint32_t frame_time_histogram[BSP_DISPLAY_FRAME_HISTOGRAM_BUCKETS];  // Frame time distribution
+} bsp_display_frame_stats_t;
+
+/// @brief Set the target time between two presented frames
+/// @param interval_us Frame interval in microseconds, 0 presents every frame at the first vsync
+/// @return ESP-IDF error code
+esp_err_t bsp_display_set_frame_interval(uint32_t interval_us);
+
+/// @brief Send pixel data to the display at the start of the next frame slot
+/// @details Waits until the frame interval has passed since the previous present, then for the tearing effect (TE)
+///          signal of the panel so the transfer starts right after the display has scanned out the previous frame.
+///          Panels that do not report TE are paced by the frame interval alone, on a fixed schedule so the average frame
+///          time matches the interval even though sleeps are whole ticks. Enable TE output with
+///          bsp_display_set_tearing_effect_mode.
+/// @return ESP-IDF error code
+esp_err_t bsp_display_present(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer);
+
+/// @brief Get the frame statistics collected by bsp_display_present
+/// @return ESP-IDF error code
+esp_err_t bsp_display_get_frame_stats(bsp_display_frame_stats_t* out_stats);
+
+/// @brief Reset the frame statistics
+void bsp_display_reset_frame_stats(void);
+
+// ============================================
+// Direct framebuffer access
+// ============================================
+
+#define BSP_DISPLAY_MAX_FRAMEBUFFERS 3
+
+/// @brief Get the framebuffers the display driver scans out from
+/// @details Applications can render straight into these buffers instead of blitting a copy. Render into a buffer that
+///          is not being shown and make it visible with bsp_display_flip. The number of framebuffers is set through
+///          num_fbs in the display configuration.
+/// @param out_fbs Array that receives up to max_fbs framebuffer pointers
+/// @param out_num_fbs Number of framebuffers of the display
+/// @return ESP-IDF error code
+///          - ESP_OK if succesful
+///          - ESP_ERR_NOT_SUPPORTED if the display has no framebuffers that can be accessed directly
+esp_err_t bsp_display_get_framebuffers(void** out_fbs, size_t max_fbs, size_t* out_num_fbs);
+
+/// @brief Show a framebuffer obtained through bsp_display_get_framebuffers
+/// @details Waits for queued blits to complete, selects the framebuffer and waits for the next vblank. Once this
+///          function returns the previously shown framebuffer is no longer scanned out and can be rendered into.
+/// @return ESP-IDF error code
+///          - ESP_OK if the framebuffer is shown
+///          - ESP_ERR_INVALID_ARG if the buffer is not a framebuffer of the display
+///          - ESP_ERR_TIMEOUT if the display did not reach vblank in time
+esp_err_t bsp_display_flip(const void* framebuffer, TickType_t timeout);
+
+// ============================================
+// Rotation
+// ============================================
+
+/// @brief Rotate pixel data and send it to the display
+/// @details The region is given in the coordinate space of the rotated display: for 90 and 270 degrees its width is
+///          the vertical resolution of the panel. The buffer holds the region in that orientation and is rotated
+///          clockwise by the given rotation before it reaches the panel. On the ESP32-P4 the pixel-processing
+///          accelerator rotates and converts the pixels, other targets rotate in software in small strips. The source
+///          buffer is free once this function returns.
+/// @param src_fmt Color format of the buffer, stored in CPU byte order
+/// @return ESP-IDF error code
+///          - ESP_OK if the pixels have been queued
+///          - ESP_ERR_NOT_SUPPORTED if the color formats can not be rotated or converted
+esp_err_t bsp_display_blit_rotated(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer,
+                                   bsp_display_color_format_t src_fmt, bsp_display_rotation_t rotation);
+
+// ============================================
+// Statistics
+// ============================================
+
+/// @brief Timing breakdown, percentiles are calculated over the 64 most recent blits
+typedef struct {
+    uint32_t min_us;
+    uint32_t avg_us;
+    uint32_t max_us;
+    uint32_t p50_us;
+    uint32_t p90_us;
+    uint32_t p99_us;
+} bsp_display_timing_stats_t;
+
+/// @brief Display pipeline statistics
+typedef struct {
+    uint64_t                   blits;           // Number of blits handed to the display driver
+    uint64_t                   pixels;          // Number of pixels blitted
+    uint64_t                   bytes;           // Number of pixel bytes blitted
+    uint32_t                   flush_timeouts;  // Blits that failed because a previous transfer did not complete
+    uint64_t                   wait_time_us;    // Total time blocked waiting for previous transfers
+    bsp_display_timing_stats_t wait;            // Time blocked waiting for a previous transfer, per blit
+    bsp_display_timing_stats_t submit;          // Time spent handing a blit to the display driver
+} bsp_display_stats_t;
+
+/// @brief Get the display pipeline statistics
+/// @return ESP-IDF error code
+///          - ESP_OK if succesful
+///          - ESP_ERR_NOT_SUPPORTED if statistics are disabled through CONFIG_BSP_DISPLAY_STATS
+esp_err_t bsp_display_get_stats(bsp_display_stats_t* out_stats);
+
+/// @brief Reset the display pipeline statistics
+void bsp_display_reset_stats(void);
+
+// ============================================
+// Dithering
+// ============================================
+
+/// @brief Dithering method used when quantizing to a palette or greyscale format
+typedef enum {
+    BSP_DISPLAY_DITHER_NONE,             // Nearest color
+    BSP_DISPLAY_DITHER_ORDERED,          // 4x4 Bayer matrix, no state between pixels
+    BSP_DISPLAY_DITHER_FLOYD_STEINBERG,  // Error diffusion to the next pixel and row
+} bsp_display_dither_mode_t;
+
+typedef struct bsp_display_dither* bsp_display_dither_handle_t;
+
+/// @brief Create a quantizer that converts RGB rows to packed palette or greyscale rows
+/// @details Rows are converted one at a time, only the error of the previous row is kept for error diffusion. Each
+///          destination row starts at a byte boundary with pixels packed from the most significant bit.
+/// @param dst_fmt Destination format: 1, 2, 4 or 8 bit greyscale or palette
+/// @param src_fmt Source format: RGB565 or RGB888, stored in CPU byte order
+/// @param width Number of pixels per row
+/// @param palette Palette as red, green and blue bytes per entry, or NULL for evenly spaced grey levels
+/// @param palette_size Number of palette entries, at most 2 to the power of the destination bits per pixel
+/// @return ESP-IDF error code
+esp_err_t bsp_display_dither_create(bsp_display_color_format_t dst_fmt, bsp_display_color_format_t src_fmt,
+                                    size_t width, bsp_display_dither_mode_t mode, const uint8_t* palette,
+                                    size_t palette_size, bsp_display_dither_handle_t* out_handle);
+
+/// @brief Quantize the next row
+/// @return ESP-IDF error code
+esp_err_t bsp_display_dither_row(bsp_display_dither_handle_t handle, void* dst, const void* src);
+
+/// @brief Start a new frame, the next row is treated as the first row of the image
+void bsp_display_dither_reset(bsp_display_dither_handle_t handle);
+
+/// @brief Free a quantizer
+void bsp_display_dither_delete(bsp_display_dither_handle_t handle);
+
+/// @brief Quantize pixel data to the palette or greyscale format of the display and send it
+/// @details Greyscale displays use evenly spaced grey levels, palette displays the palette from
+///          bsp_display_get_palette. The region is sent as a single blit, so panels that refresh as a whole such as
+///          e-paper displays are refreshed once.
+/// @param src_fmt Color format of the buffer: RGB565 or RGB888, stored in CPU byte order
+/// @return ESP-IDF error code
+///          - ESP_OK if the pixels have been sent
+///          - ESP_ERR_NOT_SUPPORTED if the display does not use a palette or greyscale format, or does not report the
+///            palette it uses
+esp_err_t bsp_display_blit_dithered(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer,
+                                    bsp_display_color_format_t src_fmt, bsp_display_dither_mode_t mode);
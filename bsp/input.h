@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include "esp_err.h"
 #include "freertos/FreeRTOS.h"
@@ -251,6 +252,8 @@ typedef struct _bsp_input_event {
         bsp_input_event_args_action_t     args_action;
         bsp_input_event_args_scancode_t   args_scancode;
     };
+    int64_t timestamp;         // Time at which the event was generated in microseconds (esp_timer_get_time)
+    int64_t queued_timestamp;  // Time at which the event was queued in microseconds (esp_timer_get_time)
 } bsp_input_event_t;
 
 /// @brief Get the queue handle for the input event queue
@@ -286,6 +289,150 @@ esp_err_t bsp_input_read_action(bsp_input_action_type_t action, bool* out_state)
 esp_err_t bsp_input_get_touch_coordinates(uint16_t* out_x, uint16_t* out_y, uint16_t* out_strength, uint8_t* out_count,
                                           uint8_t max_count);
 
+// ============================================
+// Input event queue
+// ============================================
+
+/// @brief What happens to an event when the input event queue is full
+typedef enum {
+    BSP_INPUT_OVERFLOW_DROP_NEWEST = 0,  // Drop the new event
+    BSP_INPUT_OVERFLOW_DROP_OLDEST = 1,  // Drop the oldest pending event to make room for the new one
+    BSP_INPUT_OVERFLOW_BLOCK       = 2,  // Wait for room, events generated from an interrupt are dropped
+} bsp_input_overflow_policy_t;
+
+/// @brief Input event queue statistics
+typedef struct {
+    uint32_t depth;           // Number of events the queue holds
+    uint32_t pending;         // Number of events waiting to be received
+    uint32_t queued;          // Number of events queued
+    uint32_t dropped_newest;  // Events dropped because the queue was full
+    uint32_t dropped_oldest;  // Pending events dropped to make room for newer ones
+    uint32_t blocked;         // Events that had to wait for room
+    uint32_t high_water;      // Most events pending at once
+} bsp_input_queue_stats_t;
+
+/// @brief Set what happens to an event when the input event queue is full
+/// @details The default policy is selected with CONFIG_BSP_INPUT_QUEUE_OVERFLOW. Once bsp_input_get_queue has been
+///          called the policy applies to that queue, which then holds the pending events.
+/// @return ESP-IDF error code
+esp_err_t bsp_input_set_overflow_policy(bsp_input_overflow_policy_t policy);
+
+/// @brief Receive all pending input events in a single call
+/// @details Waits up to timeout for the first event, then returns it together with every other pending event. Once
+///          bsp_input_get_queue has been called the events are taken from that queue.
+/// @param out_events Array that receives up to max events
+/// @param timeout Longest time to wait for the first event
+/// @return Number of events received, 0 if no event arrived before the timeout
+size_t bsp_input_get_events(bsp_input_event_t* out_events, size_t max, TickType_t timeout);
+
+/// @brief Limit how often bsp_input_get_events returns events
+/// @details With an interval set, bsp_input_get_events waits until the interval has passed since it last returned
+///          events to the calling task, so the events of a burst are collected and returned together. An event after
+///          a quiet period is returned right away. Every task is paced on its own, a task is not held back by
+///          events another task received.
+/// @param interval_ms Shortest time between two calls that return events, 0 disables coalescing
+/// @return ESP-IDF error code
+esp_err_t bsp_input_set_event_coalescing(uint32_t interval_ms);
+
+/// @brief Get the input event queue statistics
+/// @return ESP-IDF error code
+esp_err_t bsp_input_get_queue_stats(bsp_input_queue_stats_t* out_stats);
+
+/// @brief Reset the input event queue statistics
+void bsp_input_reset_queue_stats(void);
+
+// ============================================
+// Input State Snapshot
+// ============================================
+
+/// @brief State of all inputs at one point in time
+typedef struct {
+    uint32_t scancodes[8];  ///< One bit per scancode, escaped (0xE0xx) scancodes use bits 128-255
+    uint64_t navigation;    ///< One bit per navigation key
+    uint32_t actions;       ///< One bit per action
+    uint32_t modifiers;     ///< BSP_INPUT_MODIFIER_* bits
+} bsp_input_state_t;
+
+/// @brief Get a consistent snapshot of all pressed scancodes, navigation keys, actions and the modifiers
+/// The snapshot is kept up to date from the input event path and read without locking, so polling any number of
+/// keys per frame costs a single call.
+/// @param out_state Snapshot output
+/// @return ESP-IDF error code
+esp_err_t bsp_input_get_state_snapshot(bsp_input_state_t* out_state);
+
+/// @brief Check whether a scancode is pressed in a snapshot
+/// @return true if the scancode is pressed
+bool bsp_input_state_get_scancode(bsp_input_state_t const* state, bsp_input_scancode_t scancode);
+
+/// @brief Check whether a navigation key is pressed in a snapshot
+/// @return true if the navigation key is pressed
+bool bsp_input_state_get_navigation_key(bsp_input_state_t const* state, bsp_input_navigation_key_t key);
+
+/// @brief Check whether an action is active in a snapshot
+/// @return true if the action is active
+bool bsp_input_state_get_action(bsp_input_state_t const* state, bsp_input_action_type_t action);
+
+// ============================================
+// Input latency
+// ============================================
+
+#define BSP_INPUT_LATENCY_HISTOGRAM_BUCKETS 16
+
+/// @brief Latency distribution of one stage of the input path
+/// @details Bucket 0 of the histogram counts latencies below 2 us, bucket n counts latencies from 2^n us up to
+///          2^(n + 1) us, the last bucket also counts everything longer.
+typedef struct {
+    uint32_t count;                                           // Number of events measured
+    uint32_t max_us;                                          // Longest latency
+    uint64_t total_us;                                        // Sum of all latencies
+    uint32_t histogram[BSP_INPUT_LATENCY_HISTOGRAM_BUCKETS];  // Latency distribution
+} bsp_input_latency_histogram_t;
+
+/// @brief Input latency statistics
+typedef struct {
+    bsp_input_latency_histogram_t source_to_enqueue;   // From generating an event to queueing it, includes the hooks
+    bsp_input_latency_histogram_t enqueue_to_dequeue;  // From queueing an event to the application receiving it
+} bsp_input_latency_stats_t;
+
+/// @brief Record that the application received an event from the input queue
+/// @details Call this right after receiving an event with xQueueReceive to measure the enqueue to dequeue latency.
+void bsp_input_record_dequeue(bsp_input_event_t const* event);
+
+/// @brief Get the input latency statistics
+/// @return ESP-IDF error code
+///          - ESP_OK if succesful
+///          - ESP_ERR_NOT_SUPPORTED if statistics are disabled through CONFIG_BSP_INPUT_LATENCY_STATS
+esp_err_t bsp_input_get_latency_stats(bsp_input_latency_stats_t* out_stats);
+
+/// @brief Reset the input latency statistics
+void bsp_input_reset_latency_stats(void);
+
+// ============================================
+// Key repeat
+// ============================================
+
+/// @brief Key repeat configuration
+typedef struct {
+    uint32_t delay_ms;         // Time a key is held before it starts repeating, 0 disables key repeat
+    uint32_t interval_ms;      // Time between the first repeats
+    uint32_t min_interval_ms;  // Shortest time between repeats reached through acceleration
+    uint32_t acceleration;     // Percentage by which every repeat shortens the interval, 0 for a constant rate
+    bool     keyboard;         // Repeat keyboard (text) events
+    bool     navigation;       // Repeat navigation key events
+} bsp_input_repeat_config_t;
+
+/// @brief Configure key repeat
+/// @details Applies to the keyboards of targets that repeat keys in the BSP. The defaults are set through
+///          CONFIG_BSP_INPUT_REPEAT_*, an application can replace them with its own settings at runtime.
+/// @param config Key repeat configuration
+/// @return ESP-IDF error code
+esp_err_t bsp_input_set_repeat_config(bsp_input_repeat_config_t const* config);
+
+/// @brief Get the key repeat configuration
+/// @param out_config Receives the key repeat configuration
+/// @return ESP-IDF error code
+esp_err_t bsp_input_get_repeat_config(bsp_input_repeat_config_t* out_config);
+
 // ============================================
 // Input Hook System
 // ============================================
@@ -296,6 +443,21 @@ esp_err_t bsp_input_get_touch_coordinates(uint16_t* out_x, uint16_t* out_y, uint
 /// @return true if the event was consumed (should not be queued), false to pass through
 typedef bool (*bsp_input_hook_cb_t)(bsp_input_event_t* event, void* user_data);
 
+/// @brief Mask bit selecting an event type in bsp_input_hook_config_t
+#define BSP_INPUT_HOOK_EVENT_TYPE(type) (1u << (type))
+
+/// @brief Mask bit selecting a navigation key in bsp_input_hook_config_t
+#define BSP_INPUT_HOOK_NAVIGATION_KEY(key) (1ull << (key))
+
+/// @brief Input hook registration
+typedef struct {
+    bsp_input_hook_cb_t callback;         // The callback function
+    void*               user_data;        // User data to pass to the callback
+    uint32_t            event_types;      // Event types the hook is called for, 0 for all event types
+    uint64_t            navigation_keys;  // Navigation keys the hook is called for, 0 for all navigation keys
+    int                 priority;         // Hooks with a higher priority are called first
+} bsp_input_hook_config_t;
+
 /// @brief Register an input hook callback
 /// Hooks are called for every input event before it is queued.
 /// If a hook returns true, the event is consumed and not queued.
@@ -304,7 +466,16 @@ typedef bool (*bsp_input_hook_cb_t)(bsp_input_event_t* event, void* user_data);
 /// @return hook ID (>= 0) on success, -1 on failure
 int bsp_input_hook_register(bsp_input_hook_cb_t callback, void* user_data);
 
+/// @brief Register an input hook callback for a selection of events
+/// @details Hooks are called in order of priority, hooks with the same priority in order of registration. Dispatching
+///          an event does not take a lock, registering or unregistering a hook never causes events to skip the hooks.
+/// @param config The hook callback, the events it is called for and its priority
+/// @return hook ID (>= 0) on success, -1 on failure
+int bsp_input_hook_register_with_config(bsp_input_hook_config_t const* config);
+
 /// @brief Unregister an input hook
+/// @details Waits for the events that are being dispatched to the hooks, once it returns the hook is not called again
+///          and its user data can be freed. A hook may unregister itself or another hook.
 /// @param hook_id The hook ID returned by bsp_input_hook_register
 void bsp_input_hook_unregister(int hook_id);
 
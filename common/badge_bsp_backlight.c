@@ -0,0 +1,242 @@
+// Board support package API: Backlight fade engine
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include "bsp/backlight.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "bsp/display.h"
+#include "bsp/input.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+static char const* TAG = "BSP backlight";
+
+// The writes run on a task of their own: on tanmatsu each write is an I2C transaction with the coprocessor, which
+// would hold up every other esp_timer callback if it ran on the esp_timer task
+#define BACKLIGHT_TASK_STACK_SIZE 3072
+#define BACKLIGHT_TASK_PRIORITY   2
+
+typedef struct {
+    bool                  active;
+    uint32_t              generation;  // Incremented by every fade, so a finished fade does not end a newer one
+    float                 from;
+    float                 to;
+    int64_t               start_time;
+    int64_t               duration_us;
+    bsp_backlight_curve_t curve;
+    int                   written;  // Level last written by the current fade, -1 if nothing has been written yet
+} bsp_backlight_channel_t;
+
+static SemaphoreHandle_t       backlight_mutex     = NULL;
+static TaskHandle_t            backlight_task      = NULL;
+static portMUX_TYPE            backlight_init_lock = portMUX_INITIALIZER_UNLOCKED;
+static bsp_backlight_channel_t backlight_channels[BSP_BACKLIGHT_COUNT];
+
+static esp_err_t bsp_backlight_read(bsp_backlight_t backlight, uint8_t* out_percentage) {
+    if (backlight == BSP_BACKLIGHT_DISPLAY) {
+        return bsp_display_get_backlight_brightness(out_percentage);
+    }
+    return bsp_input_get_backlight_brightness(out_percentage);
+}
+
+static esp_err_t bsp_backlight_write(bsp_backlight_t backlight, uint8_t percentage) {
+    if (backlight == BSP_BACKLIGHT_DISPLAY) {
+        return bsp_display_set_backlight_brightness(percentage);
+    }
+    return bsp_input_set_backlight_brightness(percentage);
+}
+
+static float bsp_backlight_interpolate(const bsp_backlight_channel_t* channel, float t) {
+    switch (channel->curve) {
+        case BSP_BACKLIGHT_CURVE_EASE_IN_OUT:
+            t = t * t * (3.0f - 2.0f * t);
+            break;
+        case BSP_BACKLIGHT_CURVE_PERCEPTUAL: {
+            // Perceived brightness roughly follows the square root of the light output
+            float from = sqrtf(channel->from);
+            float to   = sqrtf(channel->to);
+            float root = from + (to - from) * t;
+            return root * root;
+        }
+        default:
+            break;
+    }
+    return channel->from + (channel->to - channel->from) * t;
+}
+
+// Advance every running fade, returns true while a fade is still running
+static bool bsp_backlight_update(void) {
+    int64_t now = esp_timer_get_time();
+
+    for (size_t i = 0; i < BSP_BACKLIGHT_COUNT; i++) {
+        xSemaphoreTake(backlight_mutex, portMAX_DELAY);
+        bsp_backlight_channel_t channel = backlight_channels[i];
+        xSemaphoreGive(backlight_mutex);
+        if (!channel.active) {
+            continue;
+        }
+
+        float t = 1.0f;
+        if (channel.duration_us > 0 && now - channel.start_time < channel.duration_us) {
+            t = (float)(now - channel.start_time) / (float)channel.duration_us;
+        }
+        int level = (int)lroundf(bsp_backlight_interpolate(&channel, t));
+
+        // The bus write happens outside of the lock, fades started meanwhile are picked up at the next update
+        bool      failed = false;
+        esp_err_t res    = ESP_OK;
+        if (level != channel.written) {
+            res    = bsp_backlight_write(i, level);
+            failed = res != ESP_OK;
+        }
+
+        // A fade started during the write starts over with its own first write
+        xSemaphoreTake(backlight_mutex, portMAX_DELAY);
+        bsp_backlight_channel_t* current = &backlight_channels[i];
+        if (current->generation == channel.generation) {
+            current->written = failed ? -1 : level;
+            if (t >= 1.0f || failed) {
+                current->active = false;
+            }
+        }
+        xSemaphoreGive(backlight_mutex);
+
+        if (failed) {
+            ESP_LOGE(TAG, "Failed to set backlight %u: %s", (unsigned int)i, esp_err_to_name(res));
+        }
+    }
+
+    xSemaphoreTake(backlight_mutex, portMAX_DELAY);
+    bool active = false;
+    for (size_t i = 0; i < BSP_BACKLIGHT_COUNT; i++) {
+        active |= backlight_channels[i].active;
+    }
+    xSemaphoreGive(backlight_mutex);
+    return active;
+}
+
+static void bsp_backlight_task_main(void* arg) {
+    (void)arg;
+    TickType_t last_wake = xTaskGetTickCount();
+    while (true) {
+        if (bsp_backlight_update()) {
+            vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(BSP_BACKLIGHT_UPDATE_INTERVAL_MS));
+        } else {
+            // Sleep until the next fade starts, a fade started since the update left a notification behind
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            last_wake = xTaskGetTickCount();
+        }
+    }
+}
+
+static esp_err_t bsp_backlight_initialize(void) {
+    if (backlight_mutex != NULL) {
+        return ESP_OK;
+    }
+
+    SemaphoreHandle_t mutex = xSemaphoreCreateMutex();
+    ESP_RETURN_ON_FALSE(mutex, ESP_ERR_NO_MEM, TAG, "Failed to create backlight mutex");
+
+    // Two tasks may start their first fade at the same time
+    bool installed = false;
+    portENTER_CRITICAL(&backlight_init_lock);
+    if (backlight_mutex == NULL) {
+        for (size_t i = 0; i < BSP_BACKLIGHT_COUNT; i++) {
+            backlight_channels[i].written = -1;
+        }
+        backlight_mutex = mutex;
+        installed       = true;
+    }
+    portEXIT_CRITICAL(&backlight_init_lock);
+
+    if (!installed) {
+        vSemaphoreDelete(mutex);
+    }
+    return ESP_OK;
+}
+
+esp_err_t bsp_backlight_fade(bsp_backlight_t backlight, uint8_t percentage, uint32_t duration_ms,
+                             bsp_backlight_curve_t curve) {
+    ESP_RETURN_ON_FALSE(backlight < BSP_BACKLIGHT_COUNT, ESP_ERR_INVALID_ARG, TAG, "Invalid backlight");
+    ESP_RETURN_ON_FALSE(percentage <= 100, ESP_ERR_INVALID_ARG, TAG, "Percentage out of range");
+    ESP_RETURN_ON_ERROR(bsp_backlight_initialize(), TAG, "Failed to initialize backlight fading");
+
+    xSemaphoreTake(backlight_mutex, portMAX_DELAY);
+    bsp_backlight_channel_t* channel = &backlight_channels[backlight];
+    int64_t                  now     = esp_timer_get_time();
+
+    // Continue from wherever a running fade currently is, otherwise from the level of the hardware. The level may have
+    // been changed through bsp_display_set_backlight_brightness or bsp_input_set_backlight_brightness since the last
+    // fade, so it is read back instead of remembered.
+    float     from = 0;
+    esp_err_t res  = ESP_OK;
+    if (backlight_task == NULL &&
+        xTaskCreate(bsp_backlight_task_main, "BSP backlight", BACKLIGHT_TASK_STACK_SIZE, NULL, BACKLIGHT_TASK_PRIORITY,
+                    &backlight_task) != pdPASS) {
+        backlight_task = NULL;
+        res            = ESP_ERR_NO_MEM;
+    } else if (channel->active) {
+        float t = 1.0f;
+        if (channel->duration_us > 0 && now - channel->start_time < channel->duration_us) {
+            t = (float)(now - channel->start_time) / (float)channel->duration_us;
+        }
+        from = bsp_backlight_interpolate(channel, t);
+    } else {
+        uint8_t current = 0;
+        res             = bsp_backlight_read(backlight, &current);
+        from            = current;
+    }
+
+    if (res == ESP_OK) {
+        // The first update of the fade always writes, the setters may have changed the level behind its back
+        channel->from        = from;
+        channel->to          = percentage;
+        channel->start_time  = now;
+        channel->duration_us = (int64_t)duration_ms * 1000;
+        channel->curve       = curve;
+        channel->written     = -1;
+        channel->active      = true;
+        channel->generation++;
+        xTaskNotifyGive(backlight_task);
+    }
+    xSemaphoreGive(backlight_mutex);
+
+    if (res == ESP_ERR_NOT_SUPPORTED) {
+        return res;
+    }
+    ESP_RETURN_ON_ERROR(res, TAG, "Failed to start backlight fade");
+    return ESP_OK;
+}
+
+esp_err_t bsp_backlight_get_target(bsp_backlight_t backlight, uint8_t* out_percentage) {
+    ESP_RETURN_ON_FALSE(backlight < BSP_BACKLIGHT_COUNT, ESP_ERR_INVALID_ARG, TAG, "Invalid backlight");
+    ESP_RETURN_ON_FALSE(out_percentage, ESP_ERR_INVALID_ARG, TAG, "Percentage output argument is NULL");
+
+    if (backlight_mutex != NULL) {
+        xSemaphoreTake(backlight_mutex, portMAX_DELAY);
+        bsp_backlight_channel_t channel = backlight_channels[backlight];
+        xSemaphoreGive(backlight_mutex);
+        if (channel.active) {
+            *out_percentage = (uint8_t)channel.to;
+            return ESP_OK;
+        }
+    }
+    return bsp_backlight_read(backlight, out_percentage);
+}
+
+bool bsp_backlight_is_fading(bsp_backlight_t backlight) {
+    if (backlight >= BSP_BACKLIGHT_COUNT || backlight_mutex == NULL) {
+        return false;
+    }
+    xSemaphoreTake(backlight_mutex, portMAX_DELAY);
+    bool active = backlight_channels[backlight].active;
+    xSemaphoreGive(backlight_mutex);
+    return active;
+}
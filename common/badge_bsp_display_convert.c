@@ -0,0 +1,344 @@
+// Board support package API: Pixel format conversion implementation
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "badge_bsp_display_convert_pie.h"
+#include "badge_bsp_display_staging.h"
+#include "bsp/display.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+
+// The word based kernels below assume a little endian CPU, which all supported targets are
+_Static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "Pixel conversion assumes a little endian CPU");
+
+// Number of pixels converted to luma at once before packing them
+#define GREY_CHUNK_PIXELS 64
+
+static char const* TAG = "BSP display convert";
+
+static inline uint32_t load32(const uint8_t* src) {
+    uint32_t value;
+    memcpy(&value, src, sizeof(value));
+    return value;
+}
+
+static inline void store32(uint8_t* dst, uint32_t value) {
+    memcpy(dst, &value, sizeof(value));
+}
+
+static inline uint8_t luma(uint8_t r, uint8_t g, uint8_t b) {
+    return (uint8_t)((77 * r + 150 * g + 29 * b) >> 8);
+}
+
+static void rgb565_swap(uint8_t* d, const uint8_t* s, size_t pixels) {
+    // Two pixels per word
+    for (size_t i = 0; i < pixels / 2; i++) {
+        uint32_t value = load32(s);
+        store32(d, ((value & 0x00FF00FFu) << 8) | ((value >> 8) & 0x00FF00FFu));
+        s += 4;
+        d += 4;
+    }
+
+    if (pixels & 1) {
+        uint8_t low = s[0];
+        d[0]        = s[1];
+        d[1]        = low;
+    }
+}
+
+void bsp_display_convert_rgb565_swap(void* dst, const void* src, size_t pixels) {
+    uint8_t*       d = dst;
+    const uint8_t* s = src;
+
+#if CONFIG_IDF_TARGET_ESP32P4
+    // Buffers at the same offset from a 16 byte boundary are swapped in C up to the boundary and in vectors after it
+    uintptr_t offset = (uintptr_t)s & 15;
+    if (offset == ((uintptr_t)d & 15) && (offset & 1) == 0) {
+        size_t head = ((16 - offset) & 15) / 2;
+        head        = head < pixels ? head : pixels;
+        rgb565_swap(d, s, head);
+        size_t vectors = (pixels - head) / BSP_DISPLAY_CONVERT_PIE_PIXELS;
+        size_t done    = head + vectors * BSP_DISPLAY_CONVERT_PIE_PIXELS;
+        bsp_display_convert_pie_rgb565_swap(d + head * 2, s + head * 2, vectors);
+        d      += done * 2;
+        s      += done * 2;
+        pixels -= done;
+    }
+#endif
+
+    rgb565_swap(d, s, pixels);
+}
+
+void bsp_display_convert_rgb888_to_rgb565(void* dst, const void* src, size_t pixels,
+                                          bsp_display_endianness_t dst_endian) {
+    uint8_t*       d = dst;
+    const uint8_t* s = src;
+
+    if (dst_endian == BSP_DISPLAY_ENDIAN_BIG) {
+        for (size_t i = 0; i < pixels; i++, s += 3, d += 2) {
+            d[0] = (s[2] & 0xF8) | (s[1] >> 5);
+            d[1] = ((s[1] & 0x1C) << 3) | (s[0] >> 3);
+        }
+    } else {
+        for (size_t i = 0; i < pixels; i++, s += 3, d += 2) {
+            d[0] = ((s[1] & 0x1C) << 3) | (s[0] >> 3);
+            d[1] = (s[2] & 0xF8) | (s[1] >> 5);
+        }
+    }
+}
+
+void bsp_display_convert_rgb565_to_rgb888(void* dst, const void* src, size_t pixels,
+                                          bsp_display_endianness_t dst_endian) {
+    uint8_t*       d = dst;
+    const uint8_t* s = src;
+
+    // Indices of the red and blue bytes in the destination pixel
+    size_t r_index = dst_endian == BSP_DISPLAY_ENDIAN_BIG ? 0 : 2;
+    size_t b_index = 2 - r_index;
+
+    for (size_t i = 0; i < pixels; i++, s += 2, d += 3) {
+        uint16_t value = s[0] | (s[1] << 8);
+        uint8_t  r     = (value >> 11) & 0x1F;
+        uint8_t  g     = (value >> 5) & 0x3F;
+        uint8_t  b     = value & 0x1F;
+        d[r_index]     = (r << 3) | (r >> 2);
+        d[1]           = (g << 2) | (g >> 4);
+        d[b_index]     = (b << 3) | (b >> 2);
+    }
+}
+
+void bsp_display_convert_argb8888_to_rgb888(void* dst, const void* src, size_t pixels,
+                                            bsp_display_endianness_t dst_endian) {
+    uint8_t*       d = dst;
+    const uint8_t* s = src;
+    size_t         i = 0;
+
+    if (dst_endian == BSP_DISPLAY_ENDIAN_BIG) {
+        for (; i < pixels; i++, s += 4, d += 3) {
+            d[0] = s[2];
+            d[1] = s[1];
+            d[2] = s[0];
+        }
+        return;
+    }
+
+    // Four source words are packed into three destination words
+    for (; i + 4 <= pixels; i += 4, s += 16, d += 12) {
+        uint32_t w0 = load32(&s[0]);
+        uint32_t w1 = load32(&s[4]);
+        uint32_t w2 = load32(&s[8]);
+        uint32_t w3 = load32(&s[12]);
+        store32(&d[0], (w0 & 0x00FFFFFFu) | (w1 << 24));
+        store32(&d[4], ((w1 >> 8) & 0x0000FFFFu) | (w2 << 16));
+        store32(&d[8], ((w2 >> 16) & 0x000000FFu) | (w3 << 8));
+    }
+
+    for (; i < pixels; i++, s += 4, d += 3) {
+        d[0] = s[0];
+        d[1] = s[1];
+        d[2] = s[2];
+    }
+}
+
+static void rgb888_swap(uint8_t* d, const uint8_t* s, size_t pixels) {
+    for (size_t i = 0; i < pixels; i++, s += 3, d += 3) {
+        uint8_t b = s[0];
+        d[0]      = s[2];
+        d[1]      = s[1];
+        d[2]      = b;
+    }
+}
+
+typedef struct {
+    uint8_t* dst;
+    size_t   bits;
+    uint8_t  accumulator;
+    size_t   count;
+} grey_packer_t;
+
+static void grey_pack(grey_packer_t* packer, const uint8_t* values, size_t length) {
+    size_t per_byte = 8 / packer->bits;
+    for (size_t i = 0; i < length; i++) {
+        packer->accumulator = (packer->accumulator << packer->bits) | (values[i] >> (8 - packer->bits));
+        if (++packer->count == per_byte) {
+            *packer->dst++      = packer->accumulator;
+            packer->accumulator = 0;
+            packer->count       = 0;
+        }
+    }
+}
+
+static void grey_pack_finish(grey_packer_t* packer) {
+    if (packer->count == 0) {
+        return;
+    }
+    // Keep the pixels that follow the last one in a partially written byte
+    size_t  used = packer->bits * packer->count;
+    uint8_t keep = (uint8_t)((1 << (8 - used)) - 1);
+    *packer->dst = (*packer->dst & keep) | (uint8_t)(packer->accumulator << (8 - used));
+}
+
+static bool grey_bits_valid(size_t bits) {
+    return bits == 1 || bits == 2 || bits == 4 || bits == 8;
+}
+
+esp_err_t bsp_display_convert_rgb565_to_grey(void* dst, const void* src, size_t pixels, size_t bits) {
+    ESP_RETURN_ON_FALSE(grey_bits_valid(bits), ESP_ERR_INVALID_ARG, TAG, "Unsupported number of bits per pixel");
+
+    grey_packer_t  packer = {.dst = dst, .bits = bits};
+    const uint8_t* s      = src;
+    uint8_t        values[GREY_CHUNK_PIXELS];
+
+    while (pixels > 0) {
+        size_t length = pixels < GREY_CHUNK_PIXELS ? pixels : GREY_CHUNK_PIXELS;
+        size_t i      = 0;
+#if CONFIG_IDF_TARGET_ESP32P4
+        uintptr_t offset = (uintptr_t)s & 15;
+        if (offset != 0 && (offset & 1) == 0 && length > (16 - offset) / 2) {
+            length = (16 - offset) / 2;  // A short first chunk brings the source to a 16 byte boundary
+        } else if (offset == 0) {
+            // Whole vectors of a 16 byte aligned source, the rest of the chunk is converted in C
+            uint16_t wide[GREY_CHUNK_PIXELS] __attribute__((aligned(16)));
+            size_t   vectors = length / BSP_DISPLAY_CONVERT_PIE_PIXELS;
+            bsp_display_convert_pie_rgb565_luma(wide, s, vectors);
+            for (; i < vectors * BSP_DISPLAY_CONVERT_PIE_PIXELS; i++, s += 2) {
+                values[i] = (uint8_t)wide[i];
+            }
+        }
+#endif
+        for (; i < length; i++, s += 2) {
+            uint16_t value = s[0] | (s[1] << 8);
+            values[i]      = luma((value >> 8) & 0xF8, (value >> 3) & 0xFC, (value << 3) & 0xF8);
+        }
+        grey_pack(&packer, values, length);
+        pixels -= length;
+    }
+    grey_pack_finish(&packer);
+    return ESP_OK;
+}
+
+esp_err_t bsp_display_convert_rgb888_to_grey(void* dst, const void* src, size_t pixels, size_t bits) {
+    ESP_RETURN_ON_FALSE(grey_bits_valid(bits), ESP_ERR_INVALID_ARG, TAG, "Unsupported number of bits per pixel");
+
+    grey_packer_t  packer = {.dst = dst, .bits = bits};
+    const uint8_t* s      = src;
+    uint8_t        values[GREY_CHUNK_PIXELS];
+
+    while (pixels > 0) {
+        size_t length = pixels < GREY_CHUNK_PIXELS ? pixels : GREY_CHUNK_PIXELS;
+        for (size_t i = 0; i < length; i++, s += 3) {
+            values[i] = luma(s[2], s[1], s[0]);
+        }
+        grey_pack(&packer, values, length);
+        pixels -= length;
+    }
+    grey_pack_finish(&packer);
+    return ESP_OK;
+}
+
+static size_t grey_bits(bsp_display_color_format_t color_fmt) {
+    switch (color_fmt) {
+        case BSP_DISPLAY_COLOR_FORMAT_1_GREY:
+        case BSP_DISPLAY_COLOR_FORMAT_2_GREY:
+        case BSP_DISPLAY_COLOR_FORMAT_4_GREY:
+        case BSP_DISPLAY_COLOR_FORMAT_8_GREY:
+            return bsp_display_get_bits_per_pixel(color_fmt);
+        default:
+            return 0;
+    }
+}
+
+esp_err_t bsp_display_convert(void* dst, bsp_display_color_format_t dst_fmt, bsp_display_endianness_t dst_endian,
+                              const void* src, bsp_display_color_format_t src_fmt, size_t pixels) {
+    ESP_RETURN_ON_FALSE(dst && src, ESP_ERR_INVALID_ARG, TAG, "Buffer argument is NULL");
+    bool big_endian = dst_endian == BSP_DISPLAY_ENDIAN_BIG;
+
+    if (src_fmt == BSP_DISPLAY_COLOR_FORMAT_16_565RGB) {
+        if (dst_fmt == BSP_DISPLAY_COLOR_FORMAT_16_565RGB) {
+            if (big_endian) {
+                bsp_display_convert_rgb565_swap(dst, src, pixels);
+            } else if (dst != src) {
+                memcpy(dst, src, pixels * 2);
+            }
+            return ESP_OK;
+        }
+        if (dst_fmt == BSP_DISPLAY_COLOR_FORMAT_24_888RGB) {
+            bsp_display_convert_rgb565_to_rgb888(dst, src, pixels, dst_endian);
+            return ESP_OK;
+        }
+        if (grey_bits(dst_fmt) > 0) {
+            return bsp_display_convert_rgb565_to_grey(dst, src, pixels, grey_bits(dst_fmt));
+        }
+    } else if (src_fmt == BSP_DISPLAY_COLOR_FORMAT_24_888RGB) {
+        if (dst_fmt == BSP_DISPLAY_COLOR_FORMAT_24_888RGB) {
+            if (big_endian) {
+                rgb888_swap(dst, src, pixels);
+            } else if (dst != src) {
+                memcpy(dst, src, pixels * 3);
+            }
+            return ESP_OK;
+        }
+        if (dst_fmt == BSP_DISPLAY_COLOR_FORMAT_16_565RGB) {
+            bsp_display_convert_rgb888_to_rgb565(dst, src, pixels, dst_endian);
+            return ESP_OK;
+        }
+        if (grey_bits(dst_fmt) > 0) {
+            return bsp_display_convert_rgb888_to_grey(dst, src, pixels, grey_bits(dst_fmt));
+        }
+    } else if (src_fmt == BSP_DISPLAY_COLOR_FORMAT_32_8888ARGB) {
+        if (dst_fmt == BSP_DISPLAY_COLOR_FORMAT_24_888RGB) {
+            bsp_display_convert_argb8888_to_rgb888(dst, src, pixels, dst_endian);
+            return ESP_OK;
+        }
+    }
+
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t bsp_display_blit_convert(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer,
+                                   bsp_display_color_format_t src_fmt) {
+    ESP_RETURN_ON_FALSE(buffer, ESP_ERR_INVALID_ARG, TAG, "Buffer argument is NULL");
+    ESP_RETURN_ON_FALSE(x_start < x_end && y_start < y_end, ESP_ERR_INVALID_ARG, TAG, "Empty region");
+
+    size_t                     h_res = 0;
+    size_t                     v_res = 0;
+    bsp_display_color_format_t dst_fmt;
+    bsp_display_endianness_t   dst_endian;
+    ESP_RETURN_ON_ERROR(bsp_display_get_parameters(&h_res, &v_res, &dst_fmt, &dst_endian), TAG,
+                        "Failed to get display parameters");
+    ESP_RETURN_ON_FALSE(x_end <= h_res && y_end <= v_res, ESP_ERR_INVALID_ARG, TAG, "Region outside of display");
+
+    size_t src_bytes = bsp_display_get_bits_per_pixel(src_fmt) / 8;
+    size_t dst_bytes = bsp_display_get_bits_per_pixel(dst_fmt) / 8;
+    ESP_RETURN_ON_FALSE(src_bytes > 0 && dst_bytes > 0, ESP_ERR_NOT_SUPPORTED, TAG, "Unsupported color format");
+
+    size_t         width  = x_end - x_start;
+    const uint8_t* source = buffer;
+    for (size_t y = y_start; y < y_end;) {
+        uint8_t* staging      = NULL;
+        size_t   staging_size = 0;
+        ESP_RETURN_ON_ERROR(bsp_display_staging_get(&staging, &staging_size), TAG, "Failed to get staging buffer");
+
+        size_t rows_per_blit = staging_size / (width * dst_bytes);
+        size_t rows          = y_end - y < rows_per_blit ? y_end - y : rows_per_blit;
+        size_t pixels        = rows * width;
+
+        esp_err_t res = bsp_display_convert(staging, dst_fmt, dst_endian, source, src_fmt, pixels);
+        if (res != ESP_OK) {
+            bsp_display_staging_release(staging);
+            return res;
+        }
+        ESP_RETURN_ON_ERROR(bsp_display_staging_blit(staging, x_start, y, x_end, y + rows), TAG,
+                            "Failed to blit strip");
+
+        source += pixels * src_bytes;
+        y      += rows;
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,107 @@
+// Board support package API: Pixel format conversion kernels using the ESP32-P4 PIE vector instructions
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include "badge_bsp_display_convert_pie.h"
+#include <stddef.h>
+#include <stdint.h>
+#include "sdkconfig.h"
+
+#if CONFIG_IDF_TARGET_ESP32P4
+
+// The vector registers are not known to the compiler, every kernel keeps its loop in a single asm statement. Shifts
+// work on 32-bit lanes by the amount in SAR, the masks keep the bits that stay within each 16-bit pixel.
+
+static const uint32_t mask_low_bytes = 0x00FF00FFu;
+static const uint32_t mask_red_blue  = 0x00F800F8u;
+static const uint32_t mask_green     = 0x00FC00FCu;
+static const uint16_t weight_red     = 77;
+static const uint16_t weight_green   = 150;
+static const uint16_t weight_blue    = 29;
+
+void bsp_display_convert_pie_rgb565_swap(uint8_t* dst, const uint8_t* src, size_t vectors) {
+    if (vectors == 0) {
+        return;
+    }
+    const uint32_t* mask = &mask_low_bytes;
+    __asm__ volatile(
+        ".option push\n"
+        ".option arch, +xesppie\n"
+        "esp.vldbc.32.ip q7, %[mask], 0\n"
+        "li t0, 8\n"
+        "esp.movx.w.sar t0\n"
+        "1:\n"
+        "esp.vld.128.ip q0, %[src], 16\n"
+        // (value & 0x00FF00FF) << 8 | (value >> 8) & 0x00FF00FF
+        "esp.andq q1, q0, q7\n"
+        "esp.vsl.32 q1, q1\n"
+        "esp.vsr.u32 q0, q0\n"
+        "esp.andq q0, q0, q7\n"
+        "esp.orq q0, q0, q1\n"
+        "esp.vst.128.ip q0, %[dst], 16\n"
+        "addi %[vectors], %[vectors], -1\n"
+        "bnez %[vectors], 1b\n"
+        ".option pop\n"
+        : [dst] "+r"(dst), [src] "+r"(src), [vectors] "+r"(vectors), [mask] "+r"(mask)
+        :
+        : "t0", "memory");
+}
+
+void bsp_display_convert_pie_rgb565_luma(uint16_t* dst, const uint8_t* src, size_t vectors) {
+    if (vectors == 0) {
+        return;
+    }
+    const uint32_t* low      = &mask_low_bytes;
+    const uint32_t* red_blue = &mask_red_blue;
+    const uint32_t* green    = &mask_green;
+    const uint16_t* w_red    = &weight_red;
+    const uint16_t* w_green  = &weight_green;
+    const uint16_t* w_blue   = &weight_blue;
+    __asm__ volatile(
+        ".option push\n"
+        ".option arch, +xesppie\n"
+        "esp.vldbc.32.ip q7, %[red_blue], 0\n"
+        "esp.vldbc.32.ip q6, %[green], 0\n"
+        "esp.vldbc.16.ip q5, %[w_red], 0\n"
+        "esp.vldbc.16.ip q4, %[w_green], 0\n"
+        "esp.vldbc.16.ip q3, %[w_blue], 0\n"
+        "li t1, 8\n"
+        "li t2, 3\n"
+        "1:\n"
+        "esp.vld.128.ip q0, %[src], 16\n"
+        // Red: (value >> 8) & 0xF8
+        "esp.movx.w.sar t1\n"
+        "esp.vsr.u32 q1, q0\n"
+        "esp.andq q1, q1, q7\n"
+        "esp.movx.w.sar zero\n"
+        "esp.vmul.u16 q2, q1, q5\n"
+        // Green: (value >> 3) & 0xFC
+        "esp.movx.w.sar t2\n"
+        "esp.vsr.u32 q1, q0\n"
+        "esp.andq q1, q1, q6\n"
+        "esp.movx.w.sar zero\n"
+        "esp.vmul.u16 q1, q1, q4\n"
+        "esp.vadd.u16 q2, q2, q1\n"
+        // Blue: (value << 3) & 0xF8
+        "esp.movx.w.sar t2\n"
+        "esp.vsl.32 q1, q0\n"
+        "esp.andq q1, q1, q7\n"
+        "esp.movx.w.sar zero\n"
+        "esp.vmul.u16 q1, q1, q3\n"
+        "esp.vadd.u16 q2, q2, q1\n"
+        // The weighted sum stays below 65536, its high byte is the luma
+        "esp.movx.w.sar t1\n"
+        "esp.vsr.u32 q2, q2\n"
+        "esp.vldbc.32.ip q1, %[low], 0\n"
+        "esp.andq q2, q2, q1\n"
+        "esp.vst.128.ip q2, %[dst], 16\n"
+        "addi %[vectors], %[vectors], -1\n"
+        "bnez %[vectors], 1b\n"
+        ".option pop\n"
+        : [dst] "+r"(dst), [src] "+r"(src), [vectors] "+r"(vectors), [low] "+r"(low), [red_blue] "+r"(red_blue),
+          [green] "+r"(green), [w_red] "+r"(w_red), [w_green] "+r"(w_green), [w_blue] "+r"(w_blue)
+        :
+        : "t1", "t2", "memory");
+}
+
+#endif
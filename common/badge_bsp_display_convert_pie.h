@@ -0,0 +1,23 @@
+// Board support package API: Pixel format conversion kernels using the ESP32-P4 PIE vector instructions
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sdkconfig.h"
+
+#if CONFIG_IDF_TARGET_ESP32P4
+
+// Pixels of 16 bits in one 128-bit vector register
+#define BSP_DISPLAY_CONVERT_PIE_PIXELS 8
+
+// Swap the bytes of RGB565 pixels, a whole number of vectors, dst and src must be 16 byte aligned and may be the same
+void bsp_display_convert_pie_rgb565_swap(uint8_t* dst, const uint8_t* src, size_t vectors);
+
+// Convert RGB565 pixels to 8-bit luma held in 16-bit lanes, a whole number of vectors, dst and src must be 16 byte
+// aligned. Gives the same luma as the C kernel: (77 * r + 150 * g + 29 * b) >> 8 on the channels widened to 8 bits.
+void bsp_display_convert_pie_rgb565_luma(uint16_t* dst, const uint8_t* src, size_t vectors);
+
+#endif
@@ -0,0 +1,230 @@
+// Board support package API: Display damage tracking implementation
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "badge_bsp_display_staging.h"
+#include "bsp/display.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+
+// Maximum number of separate regions tracked between two flushes
+#define BSP_DISPLAY_DAMAGE_MAX_RECTS 16
+
+// Default cost of starting a blit (address window commands and transfer setup), expressed in pixels
+#define BSP_DISPLAY_DAMAGE_DEFAULT_BLIT_COST 256
+
+static char const* TAG = "BSP display damage";
+
+typedef struct {
+    size_t x_start;
+    size_t y_start;
+    size_t x_end;
+    size_t y_end;
+} bsp_display_damage_rect_t;
+
+static bsp_display_damage_rect_t damage_rects[BSP_DISPLAY_DAMAGE_MAX_RECTS] = {0};
+static size_t                    damage_count                               = 0;
+
+static size_t       damage_blit_cost = BSP_DISPLAY_DAMAGE_DEFAULT_BLIT_COST;
+static portMUX_TYPE damage_lock      = portMUX_INITIALIZER_UNLOCKED;
+
+static bool   damage_initialized = false;
+static size_t damage_h_res       = 0;
+static size_t damage_v_res       = 0;
+static size_t damage_bpp         = 0;
+
+static esp_err_t bsp_display_damage_initialize(void) {
+    if (damage_initialized) {
+        return ESP_OK;
+    }
+
+    bsp_display_color_format_t color_fmt;
+    ESP_RETURN_ON_ERROR(bsp_display_get_parameters(&damage_h_res, &damage_v_res, &color_fmt, NULL), TAG,
+                        "Failed to get display parameters");
+    damage_bpp = bsp_display_get_bits_per_pixel(color_fmt);
+    ESP_RETURN_ON_FALSE(damage_bpp > 0 && damage_h_res > 0 && damage_v_res > 0, ESP_ERR_NOT_SUPPORTED, TAG,
+                        "Unsupported display parameters");
+
+    damage_initialized = true;
+    return ESP_OK;
+}
+
+static size_t rect_area(const bsp_display_damage_rect_t* rect) {
+    return (rect->x_end - rect->x_start) * (rect->y_end - rect->y_start);
+}
+
+static bsp_display_damage_rect_t rect_union(const bsp_display_damage_rect_t* a, const bsp_display_damage_rect_t* b) {
+    bsp_display_damage_rect_t result = {
+        .x_start = a->x_start < b->x_start ? a->x_start : b->x_start,
+        .y_start = a->y_start < b->y_start ? a->y_start : b->y_start,
+        .x_end   = a->x_end > b->x_end ? a->x_end : b->x_end,
+        .y_end   = a->y_end > b->y_end ? a->y_end : b->y_end,
+    };
+    return result;
+}
+
+static size_t rect_overlap_area(const bsp_display_damage_rect_t* a, const bsp_display_damage_rect_t* b) {
+    size_t x_start = a->x_start > b->x_start ? a->x_start : b->x_start;
+    size_t y_start = a->y_start > b->y_start ? a->y_start : b->y_start;
+    size_t x_end   = a->x_end < b->x_end ? a->x_end : b->x_end;
+    size_t y_end   = a->y_end < b->y_end ? a->y_end : b->y_end;
+    if (x_start >= x_end || y_start >= y_end) {
+        return 0;
+    }
+    return (x_end - x_start) * (y_end - y_start);
+}
+
+// Number of pixels that sending the bounding box costs on top of sending both regions separately
+static size_t rect_merge_waste(const bsp_display_damage_rect_t* a, const bsp_display_damage_rect_t* b) {
+    bsp_display_damage_rect_t merged = rect_union(a, b);
+    size_t                    needed = rect_area(a) + rect_area(b) - rect_overlap_area(a, b);
+    return rect_area(&merged) - needed;
+}
+
+static void damage_remove(size_t index) {
+    damage_rects[index] = damage_rects[damage_count - 1];
+    damage_count--;
+}
+
+static void damage_insert(bsp_display_damage_rect_t rect) {
+    while (true) {
+        // Merge with any region for which a single blit is cheaper than two
+        bool merged = false;
+        for (size_t i = 0; i < damage_count; i++) {
+            if (rect_merge_waste(&damage_rects[i], &rect) <= damage_blit_cost) {
+                rect = rect_union(&damage_rects[i], &rect);
+                damage_remove(i);
+                merged = true;
+                break;
+            }
+        }
+        if (merged) {
+            continue;  // The grown region might now overlap others
+        }
+
+        if (damage_count < BSP_DISPLAY_DAMAGE_MAX_RECTS) {
+            damage_rects[damage_count++] = rect;
+            return;
+        }
+
+        // Out of slots, merge with the region that wastes the least
+        size_t best       = 0;
+        size_t best_waste = SIZE_MAX;
+        for (size_t i = 0; i < damage_count; i++) {
+            size_t waste = rect_merge_waste(&damage_rects[i], &rect);
+            if (waste < best_waste) {
+                best       = i;
+                best_waste = waste;
+            }
+        }
+        rect = rect_union(&damage_rects[best], &rect);
+        damage_remove(best);
+    }
+}
+
+static esp_err_t bsp_display_damage_blit_rect(const uint8_t* framebuffer, const bsp_display_damage_rect_t* rect,
+                                              size_t* bytes) {
+    size_t bytes_per_pixel = damage_bpp / 8;
+    size_t stride          = damage_h_res * bytes_per_pixel;
+    size_t row_bytes       = (rect->x_end - rect->x_start) * bytes_per_pixel;
+
+    // Full width regions are contiguous in the framebuffer and can be sent without copying
+    if (rect->x_start == 0 && rect->x_end == damage_h_res) {
+        ESP_RETURN_ON_ERROR(bsp_display_blit(0, rect->y_start, damage_h_res, rect->y_end,
+                                             &framebuffer[rect->y_start * stride]),
+                            TAG, "Failed to blit region");
+        *bytes += (rect->y_end - rect->y_start) * row_bytes;
+        return ESP_OK;
+    }
+
+    for (size_t y = rect->y_start; y < rect->y_end;) {
+        uint8_t* staging      = NULL;
+        size_t   staging_size = 0;
+        ESP_RETURN_ON_ERROR(bsp_display_staging_get(&staging, &staging_size), TAG, "Failed to get staging buffer");
+
+        size_t rows_per_blit = staging_size / row_bytes;
+        size_t rows          = rect->y_end - y < rows_per_blit ? rect->y_end - y : rows_per_blit;
+
+        const uint8_t* source = &framebuffer[y * stride + rect->x_start * bytes_per_pixel];
+        for (size_t row = 0; row < rows; row++) {
+            memcpy(&staging[row * row_bytes], &source[row * stride], row_bytes);
+        }
+
+        ESP_RETURN_ON_ERROR(bsp_display_staging_blit(staging, rect->x_start, y, rect->x_end, y + rows), TAG,
+                            "Failed to blit region");
+        *bytes += rows * row_bytes;
+        y      += rows;
+    }
+    return ESP_OK;
+}
+
+esp_err_t bsp_display_damage_add(size_t x_start, size_t y_start, size_t x_end, size_t y_end) {
+    ESP_RETURN_ON_ERROR(bsp_display_damage_initialize(), TAG, "Failed to initialize damage tracking");
+
+    if (x_end > damage_h_res) {
+        x_end = damage_h_res;
+    }
+    if (y_end > damage_v_res) {
+        y_end = damage_v_res;
+    }
+    if (x_start >= x_end || y_start >= y_end) {
+        return ESP_OK;  // Nothing left after clipping
+    }
+
+    bsp_display_damage_rect_t rect = {
+        .x_start = x_start,
+        .y_start = y_start,
+        .x_end   = x_end,
+        .y_end   = y_end,
+    };
+
+    portENTER_CRITICAL(&damage_lock);
+    damage_insert(rect);
+    portEXIT_CRITICAL(&damage_lock);
+    return ESP_OK;
+}
+
+void bsp_display_damage_clear(void) {
+    portENTER_CRITICAL(&damage_lock);
+    damage_count = 0;
+    portEXIT_CRITICAL(&damage_lock);
+}
+
+void bsp_display_damage_set_blit_cost(size_t pixels) {
+    damage_blit_cost = pixels;
+}
+
+esp_err_t bsp_display_damage_flush(const void* framebuffer, size_t* out_bytes) {
+    ESP_RETURN_ON_FALSE(framebuffer, ESP_ERR_INVALID_ARG, TAG, "Framebuffer argument is NULL");
+    ESP_RETURN_ON_ERROR(bsp_display_damage_initialize(), TAG, "Failed to initialize damage tracking");
+
+    bsp_display_damage_rect_t rects[BSP_DISPLAY_DAMAGE_MAX_RECTS];
+    portENTER_CRITICAL(&damage_lock);
+    size_t count = damage_count;
+    memcpy(rects, damage_rects, count * sizeof(bsp_display_damage_rect_t));
+    damage_count = 0;
+    portEXIT_CRITICAL(&damage_lock);
+
+    size_t    bytes = 0;
+    esp_err_t res   = ESP_OK;
+    if (count > 0 && damage_bpp % 8 != 0) {
+        // Packed formats do not allow addressing a region by byte offset, send the full screen instead
+        res   = bsp_display_blit(0, 0, damage_h_res, damage_v_res, framebuffer);
+        bytes = (damage_h_res * damage_v_res * damage_bpp + 7) / 8;
+    } else {
+        for (size_t i = 0; i < count && res == ESP_OK; i++) {
+            res = bsp_display_damage_blit_rect(framebuffer, &rects[i], &bytes);
+        }
+    }
+
+    if (out_bytes != NULL) {
+        *out_bytes = bytes;
+    }
+    return res;
+}
@@ -0,0 +1,364 @@
+// Board support package API: Palette quantization and dithering implementation
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "bsp/display.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+
+// Number of source pixels converted to grey or RGB888 at once before they are quantized
+#define DITHER_CHUNK_PIXELS 64
+
+// Colors are matched against the palette through a table indexed by the upper 4 bits of each channel
+#define COLOR_LUT_SIZE 4096
+
+static char const* TAG = "BSP display dither";
+
+static const uint8_t bayer_4x4[4][4] = {
+    {0, 8, 2, 10},
+    {12, 4, 14, 6},
+    {3, 11, 1, 9},
+    {15, 7, 13, 5},
+};
+
+struct bsp_display_dither {
+    bsp_display_color_format_t src_fmt;
+    bsp_display_dither_mode_t  mode;
+    size_t                     width;
+    size_t                     bits;
+    size_t                     row;
+    bool                       color;           // Match on RGB, the palette is not all grey
+    uint8_t                    grey_lut[256];   // Luma to nearest palette index
+    uint8_t                    palette[256][3];
+    int16_t                    ordered[4][4];   // Threshold offsets of the Bayer matrix
+    uint8_t*                   color_lut;       // RGB444 to nearest palette index
+    int16_t*                   errors;          // Diffused error of the current and next row, per channel
+};
+
+typedef struct {
+    uint8_t* dst;
+    size_t   bits;
+    uint8_t  accumulator;
+    size_t   count;
+} index_packer_t;
+
+static inline void pack_index(index_packer_t* packer, uint8_t index) {
+    packer->accumulator = (packer->accumulator << packer->bits) | index;
+    packer->count      += packer->bits;
+    if (packer->count == 8) {
+        *packer->dst++      = packer->accumulator;
+        packer->accumulator = 0;
+        packer->count       = 0;
+    }
+}
+
+static inline void pack_finish(index_packer_t* packer) {
+    if (packer->count > 0) {
+        *packer->dst = packer->accumulator << (8 - packer->count);
+    }
+}
+
+static inline int clamp_channel(int value) {
+    return value < 0 ? 0 : (value > 255 ? 255 : value);
+}
+
+static size_t palette_bits(bsp_display_color_format_t color_fmt) {
+    switch (color_fmt) {
+        case BSP_DISPLAY_COLOR_FORMAT_1_PAL:
+        case BSP_DISPLAY_COLOR_FORMAT_2_PAL:
+        case BSP_DISPLAY_COLOR_FORMAT_4_PAL:
+        case BSP_DISPLAY_COLOR_FORMAT_8_PAL:
+        case BSP_DISPLAY_COLOR_FORMAT_1_GREY:
+        case BSP_DISPLAY_COLOR_FORMAT_2_GREY:
+        case BSP_DISPLAY_COLOR_FORMAT_4_GREY:
+        case BSP_DISPLAY_COLOR_FORMAT_8_GREY:
+            return bsp_display_get_bits_per_pixel(color_fmt);
+        default:
+            return 0;
+    }
+}
+
+static bool palette_format(bsp_display_color_format_t color_fmt) {
+    return color_fmt == BSP_DISPLAY_COLOR_FORMAT_1_PAL || color_fmt == BSP_DISPLAY_COLOR_FORMAT_2_PAL ||
+           color_fmt == BSP_DISPLAY_COLOR_FORMAT_4_PAL || color_fmt == BSP_DISPLAY_COLOR_FORMAT_8_PAL;
+}
+
+static uint8_t nearest_color(const struct bsp_display_dither* handle, size_t palette_size, int r, int g, int b) {
+    uint8_t  best          = 0;
+    uint32_t best_distance = UINT32_MAX;
+    for (size_t i = 0; i < palette_size; i++) {
+        int      dr       = r - handle->palette[i][0];
+        int      dg       = g - handle->palette[i][1];
+        int      db       = b - handle->palette[i][2];
+        uint32_t distance = 2 * dr * dr + 4 * dg * dg + 3 * db * db;
+        if (distance < best_distance) {
+            best          = i;
+            best_distance = distance;
+        }
+    }
+    return best;
+}
+
+static esp_err_t build_tables(bsp_display_dither_handle_t handle, size_t palette_size) {
+    handle->color = false;
+    for (size_t i = 0; i < palette_size; i++) {
+        if (handle->palette[i][0] != handle->palette[i][1] || handle->palette[i][1] != handle->palette[i][2]) {
+            handle->color = true;
+        }
+    }
+
+    // Ordered dithering spreads values over the typical distance between two palette entries
+    int step = palette_size > 1 ? 255 / (int)(palette_size - 1) : 255;
+    for (size_t y = 0; y < 4; y++) {
+        for (size_t x = 0; x < 4; x++) {
+            handle->ordered[y][x] = (int16_t)(((2 * bayer_4x4[y][x] + 1) * step) / 32 - step / 2);
+        }
+    }
+
+    if (!handle->color) {
+        for (int value = 0; value < 256; value++) {
+            handle->grey_lut[value] = nearest_color(handle, palette_size, value, value, value);
+        }
+        return ESP_OK;
+    }
+
+    handle->color_lut = heap_caps_malloc(COLOR_LUT_SIZE, MALLOC_CAP_DEFAULT);
+    ESP_RETURN_ON_FALSE(handle->color_lut, ESP_ERR_NO_MEM, TAG, "Failed to allocate color table");
+    for (size_t i = 0; i < COLOR_LUT_SIZE; i++) {
+        int r                = ((i >> 8) & 0xF) * 17;
+        int g                = ((i >> 4) & 0xF) * 17;
+        int b                = (i & 0xF) * 17;
+        handle->color_lut[i] = nearest_color(handle, palette_size, r, g, b);
+    }
+    return ESP_OK;
+}
+
+esp_err_t bsp_display_dither_create(bsp_display_color_format_t dst_fmt, bsp_display_color_format_t src_fmt,
+                                    size_t width, bsp_display_dither_mode_t mode, const uint8_t* palette,
+                                    size_t palette_size, bsp_display_dither_handle_t* out_handle) {
+    ESP_RETURN_ON_FALSE(out_handle && width > 0, ESP_ERR_INVALID_ARG, TAG, "Invalid argument");
+    ESP_RETURN_ON_FALSE(src_fmt == BSP_DISPLAY_COLOR_FORMAT_16_565RGB || src_fmt == BSP_DISPLAY_COLOR_FORMAT_24_888RGB,
+                        ESP_ERR_NOT_SUPPORTED, TAG, "Unsupported source format");
+    size_t bits = palette_bits(dst_fmt);
+    ESP_RETURN_ON_FALSE(bits > 0, ESP_ERR_NOT_SUPPORTED, TAG, "Unsupported destination format");
+
+    size_t levels = (size_t)1 << bits;
+    if (palette == NULL) {
+        palette_size = levels;
+    }
+    ESP_RETURN_ON_FALSE(palette_size > 0 && palette_size <= levels, ESP_ERR_INVALID_ARG, TAG,
+                        "Palette does not fit the destination format");
+
+    bsp_display_dither_handle_t handle = heap_caps_calloc(1, sizeof(struct bsp_display_dither), MALLOC_CAP_DEFAULT);
+    ESP_RETURN_ON_FALSE(handle, ESP_ERR_NO_MEM, TAG, "Failed to allocate quantizer");
+    handle->src_fmt = src_fmt;
+    handle->mode    = mode;
+    handle->width   = width;
+    handle->bits    = bits;
+
+    for (size_t i = 0; i < palette_size; i++) {
+        if (palette != NULL) {
+            memcpy(handle->palette[i], &palette[i * 3], 3);
+        } else {
+            memset(handle->palette[i], (int)(i * 255 / (levels - 1)), 3);
+        }
+    }
+
+    esp_err_t res = build_tables(handle, palette_size);
+    if (res == ESP_OK && mode == BSP_DISPLAY_DITHER_FLOYD_STEINBERG) {
+        // Two rows with a pixel of margin on either side, one value per channel
+        size_t channels = handle->color ? 3 : 1;
+        handle->errors  = heap_caps_calloc(2 * (width + 2) * channels, sizeof(int16_t), MALLOC_CAP_DEFAULT);
+        if (handle->errors == NULL) {
+            res = ESP_ERR_NO_MEM;
+        }
+    }
+    if (res != ESP_OK) {
+        bsp_display_dither_delete(handle);
+        return res;
+    }
+
+    *out_handle = handle;
+    return ESP_OK;
+}
+
+static void dither_grey(bsp_display_dither_handle_t handle, index_packer_t* packer, const uint8_t* values,
+                        size_t x_start, size_t length, int16_t* current, int16_t* next) {
+    const int16_t* ordered = handle->ordered[handle->row & 3];
+
+    switch (handle->mode) {
+        case BSP_DISPLAY_DITHER_ORDERED:
+            for (size_t i = 0; i < length; i++) {
+                int value = clamp_channel(values[i] + ordered[(x_start + i) & 3]);
+                pack_index(packer, handle->grey_lut[value]);
+            }
+            break;
+        case BSP_DISPLAY_DITHER_FLOYD_STEINBERG:
+            for (size_t i = 0, x = x_start + 1; i < length; i++, x++) {
+                int     value = clamp_channel(values[i] + current[x] / 16);
+                uint8_t index = handle->grey_lut[value];
+                int     error = value - handle->palette[index][0];
+                current[x + 1] += error * 7;
+                next[x - 1]    += error * 3;
+                next[x]        += error * 5;
+                next[x + 1]    += error;
+                pack_index(packer, index);
+            }
+            break;
+        default:
+            for (size_t i = 0; i < length; i++) {
+                pack_index(packer, handle->grey_lut[values[i]]);
+            }
+            break;
+    }
+}
+
+// Pixels are in CPU byte order: blue, green and red
+static void dither_color(bsp_display_dither_handle_t handle, index_packer_t* packer, const uint8_t* pixels,
+                         size_t x_start, size_t length, int16_t* current, int16_t* next) {
+    const int16_t* ordered = handle->ordered[handle->row & 3];
+
+    for (size_t i = 0, x = x_start + 1; i < length; i++, x++, pixels += 3) {
+        int b = pixels[0];
+        int g = pixels[1];
+        int r = pixels[2];
+
+        if (handle->mode == BSP_DISPLAY_DITHER_ORDERED) {
+            int offset = ordered[(x_start + i) & 3];
+            r          = clamp_channel(r + offset);
+            g          = clamp_channel(g + offset);
+            b          = clamp_channel(b + offset);
+        } else if (handle->mode == BSP_DISPLAY_DITHER_FLOYD_STEINBERG) {
+            r = clamp_channel(r + current[x * 3] / 16);
+            g = clamp_channel(g + current[x * 3 + 1] / 16);
+            b = clamp_channel(b + current[x * 3 + 2] / 16);
+        }
+
+        uint8_t index = handle->color_lut[((r >> 4) << 8) | ((g >> 4) << 4) | (b >> 4)];
+
+        if (handle->mode == BSP_DISPLAY_DITHER_FLOYD_STEINBERG) {
+            int errors[3] = {r - handle->palette[index][0], g - handle->palette[index][1],
+                             b - handle->palette[index][2]};
+            for (size_t c = 0; c < 3; c++) {
+                current[(x + 1) * 3 + c] += errors[c] * 7;
+                next[(x - 1) * 3 + c]    += errors[c] * 3;
+                next[x * 3 + c]          += errors[c] * 5;
+                next[(x + 1) * 3 + c]    += errors[c];
+            }
+        }
+        pack_index(packer, index);
+    }
+}
+
+esp_err_t bsp_display_dither_row(bsp_display_dither_handle_t handle, void* dst, const void* src) {
+    ESP_RETURN_ON_FALSE(handle && dst && src, ESP_ERR_INVALID_ARG, TAG, "Invalid argument");
+
+    size_t   channels = handle->color ? 3 : 1;
+    size_t   stride   = (handle->width + 2) * channels;
+    int16_t* current  = NULL;
+    int16_t* next     = NULL;
+    if (handle->errors != NULL) {
+        current = &handle->errors[(handle->row & 1) * stride];
+        next    = &handle->errors[((handle->row + 1) & 1) * stride];
+        memset(next, 0, stride * sizeof(int16_t));
+    }
+
+    bsp_display_color_format_t chunk_fmt = handle->color ? BSP_DISPLAY_COLOR_FORMAT_24_888RGB
+                                                         : BSP_DISPLAY_COLOR_FORMAT_8_GREY;
+    size_t         src_bytes = bsp_display_get_bits_per_pixel(handle->src_fmt) / 8;
+    const uint8_t* source    = src;
+    index_packer_t packer    = {.dst = dst, .bits = handle->bits};
+    uint8_t        chunk[DITHER_CHUNK_PIXELS * 3];
+
+    for (size_t x = 0; x < handle->width; x += DITHER_CHUNK_PIXELS) {
+        size_t length = handle->width - x < DITHER_CHUNK_PIXELS ? handle->width - x : DITHER_CHUNK_PIXELS;
+        ESP_RETURN_ON_ERROR(bsp_display_convert(chunk, chunk_fmt, BSP_DISPLAY_ENDIAN_LITTLE, &source[x * src_bytes],
+                                                handle->src_fmt, length),
+                            TAG, "Failed to convert pixels");
+        if (handle->color) {
+            dither_color(handle, &packer, chunk, x, length, current, next);
+        } else {
+            dither_grey(handle, &packer, chunk, x, length, current, next);
+        }
+    }
+    pack_finish(&packer);
+
+    handle->row++;
+    return ESP_OK;
+}
+
+void bsp_display_dither_reset(bsp_display_dither_handle_t handle) {
+    if (handle == NULL) {
+        return;
+    }
+    handle->row = 0;
+    if (handle->errors != NULL) {
+        size_t channels = handle->color ? 3 : 1;
+        memset(handle->errors, 0, 2 * (handle->width + 2) * channels * sizeof(int16_t));
+    }
+}
+
+void bsp_display_dither_delete(bsp_display_dither_handle_t handle) {
+    if (handle == NULL) {
+        return;
+    }
+    heap_caps_free(handle->color_lut);
+    heap_caps_free(handle->errors);
+    heap_caps_free(handle);
+}
+
+esp_err_t bsp_display_blit_dithered(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer,
+                                    bsp_display_color_format_t src_fmt, bsp_display_dither_mode_t mode) {
+    ESP_RETURN_ON_FALSE(buffer, ESP_ERR_INVALID_ARG, TAG, "Buffer argument is NULL");
+    ESP_RETURN_ON_FALSE(x_start < x_end && y_start < y_end, ESP_ERR_INVALID_ARG, TAG, "Empty region");
+
+    bsp_display_color_format_t dst_fmt;
+    ESP_RETURN_ON_ERROR(bsp_display_get_parameters(NULL, NULL, &dst_fmt, NULL), TAG,
+                        "Failed to get display parameters");
+
+    // Palette formats are quantized to the colors of the panel, greyscale formats to evenly spaced grey levels
+    const uint8_t* palette      = NULL;
+    size_t         palette_size = 0;
+    if (palette_format(dst_fmt)) {
+        ESP_RETURN_ON_FALSE(bsp_display_get_palette(&palette, &palette_size) == ESP_OK, ESP_ERR_NOT_SUPPORTED, TAG,
+                            "Display does not report its palette");
+    }
+
+    size_t                      width = x_end - x_start;
+    bsp_display_dither_handle_t dither;
+    ESP_RETURN_ON_ERROR(bsp_display_dither_create(dst_fmt, src_fmt, width, mode, palette, palette_size, &dither), TAG,
+                        "Failed to create quantizer");
+
+    // Packed rows are small, the whole region is quantized first so the display is refreshed only once
+    size_t   src_stride = width * (bsp_display_get_bits_per_pixel(src_fmt) / 8);
+    size_t   dst_stride = (width * bsp_display_get_bits_per_pixel(dst_fmt) + 7) / 8;
+    uint8_t* packed     = heap_caps_malloc(dst_stride * (y_end - y_start), MALLOC_CAP_DEFAULT);
+    if (packed == NULL) {
+        bsp_display_dither_delete(dither);
+        ESP_LOGE(TAG, "Failed to allocate quantized region");
+        return ESP_ERR_NO_MEM;
+    }
+
+    const uint8_t* source = buffer;
+    esp_err_t      res    = ESP_OK;
+    for (size_t row = 0; row < y_end - y_start && res == ESP_OK; row++) {
+        res = bsp_display_dither_row(dither, &packed[row * dst_stride], &source[row * src_stride]);
+    }
+    if (res == ESP_OK) {
+        res = bsp_display_blit(x_start, y_start, x_end, y_end, packed);
+    }
+    if (res == ESP_OK) {
+        res = bsp_display_blit_wait_idle(portMAX_DELAY);
+    }
+
+    heap_caps_free(packed);
+    bsp_display_dither_delete(dither);
+    return res;
+}
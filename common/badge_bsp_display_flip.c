@@ -0,0 +1,67 @@
+// Board support package API: Display page flipping implementation
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include "badge_bsp_display_flip.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include "bsp/display.h"
+#include "esp_attr.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+static char const* TAG = "BSP display flip";
+
+static SemaphoreHandle_t flip_vblank = NULL;
+
+IRAM_ATTR bool bsp_display_flip_vblank_from_isr(void) {
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    if (flip_vblank != NULL) {
+        xSemaphoreGiveFromISR(flip_vblank, &higher_priority_task_woken);
+    }
+    return higher_priority_task_woken == pdTRUE;
+}
+
+esp_err_t bsp_display_flip(const void* framebuffer, TickType_t timeout) {
+    void*  framebuffers[BSP_DISPLAY_MAX_FRAMEBUFFERS] = {NULL};
+    size_t num_fbs                                    = 0;
+    ESP_RETURN_ON_ERROR(bsp_display_get_framebuffers(framebuffers, BSP_DISPLAY_MAX_FRAMEBUFFERS, &num_fbs), TAG,
+                        "Display does not provide framebuffers");
+
+    bool found = false;
+    for (size_t i = 0; i < num_fbs && i < BSP_DISPLAY_MAX_FRAMEBUFFERS; i++) {
+        if (framebuffers[i] == framebuffer) {
+            found = true;
+        }
+    }
+    ESP_RETURN_ON_FALSE(found, ESP_ERR_INVALID_ARG, TAG, "Buffer is not a framebuffer of the display");
+
+    if (flip_vblank == NULL) {
+        SemaphoreHandle_t semaphore = xSemaphoreCreateBinary();
+        ESP_RETURN_ON_FALSE(semaphore != NULL, ESP_ERR_NO_MEM, TAG, "Failed to create vblank semaphore");
+        flip_vblank = semaphore;
+    }
+
+    esp_lcd_panel_handle_t panel = NULL;
+    size_t                 h_res = 0;
+    size_t                 v_res = 0;
+    ESP_RETURN_ON_ERROR(bsp_display_get_panel(&panel), TAG, "Failed to get panel handle");
+    ESP_RETURN_ON_ERROR(bsp_display_get_parameters(&h_res, &v_res, NULL, NULL), TAG, "Failed to get parameters");
+
+    // Blits copy into the framebuffer currently shown, let them finish before switching to another one
+    ESP_RETURN_ON_ERROR(bsp_display_blit_wait_idle(timeout), TAG, "Timeout while waiting for blits to complete");
+
+    // Drawing a full framebuffer of the panel selects it for scan out without copying it
+    xSemaphoreTake(flip_vblank, 0);
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_draw_bitmap(panel, 0, 0, h_res, v_res, framebuffer), TAG,
+                        "Failed to select framebuffer");
+
+    // The previous framebuffer is free once the panel started scanning out a new frame
+    ESP_RETURN_ON_FALSE(xSemaphoreTake(flip_vblank, timeout) == pdTRUE, ESP_ERR_TIMEOUT, TAG,
+                        "Timeout while waiting for vblank");
+    return ESP_OK;
+}
@@ -0,0 +1,11 @@
+// Board support package API: Display page flipping
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdbool.h>
+
+// Record that the panel started scanning out a new frame, to be called from the refresh done or vsync interrupt
+// Returns true if a higher priority task has been woken up
+bool bsp_display_flip_vblank_from_isr(void);
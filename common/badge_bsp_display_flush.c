@@ -0,0 +1,174 @@
+// Board support package API: Display flush tracking implementation
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include "badge_bsp_display_flush.h"
+#include "badge_bsp_display_stats.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include "bsp/display.h"
+#include "esp_attr.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+static char const* TAG = "BSP display flush";
+
+typedef struct {
+    bsp_display_blit_done_cb_t callback;
+    void*                      user_ctx;
+} bsp_display_flush_entry_t;
+
+static SemaphoreHandle_t          flush_slots   = NULL;
+static SemaphoreHandle_t          flush_submit  = NULL;  // Held from bsp_display_flush_begin until the transfer started
+static bsp_display_flush_entry_t* flush_entries = NULL;
+static size_t                     flush_depth   = 0;
+static size_t                     flush_head    = 0;  // Slot for the next transfer to be started
+static size_t                     flush_tail    = 0;  // Slot of the oldest transfer in flight
+static size_t                     flush_count   = 0;
+static portMUX_TYPE               flush_lock    = portMUX_INITIALIZER_UNLOCKED;
+
+esp_err_t bsp_display_flush_initialize(size_t max_in_flight) {
+    if (flush_slots != NULL) {
+        return ESP_OK;
+    }
+
+    if (max_in_flight == 0) {
+        max_in_flight = 1;
+    }
+
+    // Entries are accessed from the transfer done interrupt, keep them in internal RAM
+    flush_entries = heap_caps_calloc(max_in_flight, sizeof(bsp_display_flush_entry_t), MALLOC_CAP_INTERNAL);
+    ESP_RETURN_ON_FALSE(flush_entries, ESP_ERR_NO_MEM, TAG, "Failed to allocate flush entries");
+
+    flush_submit = xSemaphoreCreateMutex();
+    flush_slots  = xSemaphoreCreateCounting(max_in_flight, max_in_flight);
+    if (flush_slots == NULL || flush_submit == NULL) {
+        if (flush_slots != NULL) {
+            vSemaphoreDelete(flush_slots);
+            flush_slots = NULL;
+        }
+        if (flush_submit != NULL) {
+            vSemaphoreDelete(flush_submit);
+            flush_submit = NULL;
+        }
+        heap_caps_free(flush_entries);
+        flush_entries = NULL;
+        ESP_LOGE(TAG, "Failed to create flush semaphore");
+        return ESP_ERR_NO_MEM;
+    }
+
+    flush_depth = max_in_flight;
+    return ESP_OK;
+}
+
+esp_err_t bsp_display_flush_begin(bsp_display_blit_done_cb_t callback, void* user_ctx, TickType_t timeout) {
+    ESP_RETURN_ON_FALSE(flush_slots, ESP_ERR_INVALID_STATE, TAG, "Flush tracking not initialized");
+
+    // The lock is taken first, a task waiting for a slot keeps its place ahead of tasks that call in later
+    int64_t start = bsp_display_stats_now();
+    if (xSemaphoreTake(flush_submit, timeout) != pdTRUE) {
+        bsp_display_stats_record_wait(start, true);
+        return ESP_ERR_TIMEOUT;
+    }
+    if (xSemaphoreTake(flush_slots, timeout) != pdTRUE) {
+        xSemaphoreGive(flush_submit);
+        bsp_display_stats_record_wait(start, true);
+        return ESP_ERR_TIMEOUT;
+    }
+    bsp_display_stats_record_wait(start, false);
+
+    // The entry is recorded before the transfer is started, the done callback can fire before the driver returns
+    portENTER_CRITICAL(&flush_lock);
+    flush_entries[flush_head].callback = callback;
+    flush_entries[flush_head].user_ctx = user_ctx;
+    flush_head                         = (flush_head + 1) % flush_depth;
+    flush_count++;
+    portEXIT_CRITICAL(&flush_lock);
+    return ESP_OK;
+}
+
+void bsp_display_flush_end(void) {
+    if (flush_submit != NULL) {
+        xSemaphoreGive(flush_submit);
+    }
+}
+
+void bsp_display_flush_cancel(void) {
+    if (flush_slots == NULL) {
+        return;
+    }
+
+    bool cancelled = false;
+    portENTER_CRITICAL(&flush_lock);
+    if (flush_count > 0) {
+        flush_head = (flush_head + flush_depth - 1) % flush_depth;
+        flush_count--;
+        cancelled = true;
+    }
+    portEXIT_CRITICAL(&flush_lock);
+
+    if (cancelled) {
+        xSemaphoreGive(flush_slots);
+    }
+    xSemaphoreGive(flush_submit);
+}
+
+IRAM_ATTR bool bsp_display_flush_done_from_isr(void) {
+    bsp_display_flush_entry_t entry = {0};
+    bool                      valid = false;
+
+    portENTER_CRITICAL_SAFE(&flush_lock);
+    if (flush_count > 0) {
+        entry      = flush_entries[flush_tail];
+        flush_tail = (flush_tail + 1) % flush_depth;
+        flush_count--;
+        valid = true;
+    }
+    portEXIT_CRITICAL_SAFE(&flush_lock);
+
+    // Transfers started by drawing on the panel handle directly are not tracked
+    if (!valid) {
+        return false;
+    }
+
+    bool need_yield = false;
+    if (entry.callback != NULL) {
+        need_yield = entry.callback(entry.user_ctx);
+    }
+
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(flush_slots, &woken);
+    return need_yield || woken == pdTRUE;
+}
+
+esp_err_t bsp_display_blit_wait_idle(TickType_t timeout) {
+    if (flush_slots == NULL) {
+        return ESP_OK;  // Target blits synchronously
+    }
+
+    // Claim every slot, which is only possible once no transfer is in flight anymore. Holding the submission lock keeps
+    // concurrent waiters from each claiming part of the slots and waiting for each other.
+    TickType_t start = xTaskGetTickCount();
+    if (xSemaphoreTake(flush_submit, timeout) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+    size_t taken = 0;
+    while (taken < flush_depth) {
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        if (elapsed > timeout || xSemaphoreTake(flush_slots, timeout - elapsed) != pdTRUE) {
+            break;
+        }
+        taken++;
+    }
+
+    for (size_t i = 0; i < taken; i++) {
+        xSemaphoreGive(flush_slots);
+    }
+    xSemaphoreGive(flush_submit);
+
+    return (taken == flush_depth) ? ESP_OK : ESP_ERR_TIMEOUT;
+}
@@ -0,0 +1,29 @@
+// Board support package API: Display flush tracking
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "bsp/display.h"
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+// Initialize flush tracking, allowing up to max_in_flight transfers to be queued at once (0 means 1)
+esp_err_t bsp_display_flush_initialize(size_t max_in_flight);
+
+// Claim an in-flight slot and record the completion callback for the transfer that is about to be started
+// Holds the submission lock until bsp_display_flush_end or bsp_display_flush_cancel is called, so transfers of
+// concurrent tasks reach the driver in the same order as their callbacks were recorded
+esp_err_t bsp_display_flush_begin(bsp_display_blit_done_cb_t callback, void* user_ctx, TickType_t timeout);
+
+// Release the submission lock once the transfer claimed by bsp_display_flush_begin has been handed to the driver
+void bsp_display_flush_end(void);
+
+// Release the slot claimed by bsp_display_flush_begin and the submission lock if the transfer could not be started
+void bsp_display_flush_cancel(void);
+
+// Complete the oldest transfer in flight, to be called from the color transfer done callback of the panel
+// Returns true if a higher priority task has been woken up
+bool bsp_display_flush_done_from_isr(void);
@@ -0,0 +1,37 @@
+// Board support package API: Display color format helpers
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stddef.h>
+#include "bsp/display.h"
+
+size_t bsp_display_get_bits_per_pixel(bsp_display_color_format_t color_fmt) {
+    switch (color_fmt) {
+        case BSP_DISPLAY_COLOR_FORMAT_1_PAL:
+        case BSP_DISPLAY_COLOR_FORMAT_1_GREY:
+            return 1;
+        case BSP_DISPLAY_COLOR_FORMAT_2_PAL:
+        case BSP_DISPLAY_COLOR_FORMAT_2_GREY:
+            return 2;
+        case BSP_DISPLAY_COLOR_FORMAT_4_PAL:
+        case BSP_DISPLAY_COLOR_FORMAT_4_GREY:
+        case BSP_DISPLAY_COLOR_FORMAT_4_1111ARGB:
+            return 4;
+        case BSP_DISPLAY_COLOR_FORMAT_8_PAL:
+        case BSP_DISPLAY_COLOR_FORMAT_8_GREY:
+        case BSP_DISPLAY_COLOR_FORMAT_8_332RGB:
+        case BSP_DISPLAY_COLOR_FORMAT_8_2222ARGB:
+            return 8;
+        case BSP_DISPLAY_COLOR_FORMAT_16_PAL:
+        case BSP_DISPLAY_COLOR_FORMAT_16_565RGB:
+        case BSP_DISPLAY_COLOR_FORMAT_16_4444ARGB:
+            return 16;
+        case BSP_DISPLAY_COLOR_FORMAT_18_666RGB:
+        case BSP_DISPLAY_COLOR_FORMAT_24_888RGB:
+            return 24;  // 18-bit color is sent as three bytes per pixel
+        case BSP_DISPLAY_COLOR_FORMAT_32_8888ARGB:
+            return 32;
+        default:
+            return 0;
+    }
+}
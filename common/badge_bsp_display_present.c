@@ -0,0 +1,182 @@
+// Board support package API: Display frame pacing implementation
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include "badge_bsp_display_present.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "bsp/display.h"
+#include "esp_attr.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+// A vsync this recent is used as is instead of waiting for the next one
+#define BSP_DISPLAY_PRESENT_VSYNC_WINDOW_US 1000
+
+// Vsyncs are considered to have stopped when none arrived for this long
+#define BSP_DISPLAY_PRESENT_VSYNC_TIMEOUT_US (100 * 1000)
+
+static char const* TAG = "BSP display present";
+
+static SemaphoreHandle_t vsync_semaphore  = NULL;
+static portMUX_TYPE      vsync_lock       = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t          vsync_count      = 0;
+static int64_t           vsync_time       = 0;
+static int64_t           vsync_period     = 0;  // Running average of the time between two vsyncs
+static uint32_t          present_interval = 0;
+
+static int64_t                   present_due        = 0;  // Time the next frame is due, 0 before the first present
+static int64_t                   last_present_time  = 0;
+static uint32_t                  last_present_vsync = 0;
+static bsp_display_frame_stats_t present_stats      = {0};
+static portMUX_TYPE              present_stats_lock = portMUX_INITIALIZER_UNLOCKED;
+
+IRAM_ATTR bool bsp_display_present_vsync_from_isr(void) {
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL_ISR(&vsync_lock);
+    if (vsync_time != 0 && now - vsync_time < BSP_DISPLAY_PRESENT_VSYNC_TIMEOUT_US) {
+        int64_t period = now - vsync_time;
+        vsync_period   = vsync_period == 0 ? period : vsync_period + (period - vsync_period) / 8;
+    }
+    vsync_time = now;
+    vsync_count++;
+    portEXIT_CRITICAL_ISR(&vsync_lock);
+
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    if (vsync_semaphore != NULL) {
+        xSemaphoreGiveFromISR(vsync_semaphore, &higher_priority_task_woken);
+    }
+    return higher_priority_task_woken == pdTRUE;
+}
+
+static esp_err_t bsp_display_present_initialize(void) {
+    if (vsync_semaphore != NULL) {
+        return ESP_OK;
+    }
+    SemaphoreHandle_t semaphore = xSemaphoreCreateBinary();
+    ESP_RETURN_ON_FALSE(semaphore != NULL, ESP_ERR_NO_MEM, TAG, "Failed to create vsync semaphore");
+    vsync_semaphore = semaphore;
+    return ESP_OK;
+}
+
+esp_err_t bsp_display_set_frame_interval(uint32_t interval_us) {
+    present_interval = interval_us;
+    return ESP_OK;
+}
+
+// Returns true if the panel reported a vsync recently enough to align frames to it
+static bool bsp_display_present_vsync_active(int64_t now) {
+    portENTER_CRITICAL(&vsync_lock);
+    int64_t last_vsync = vsync_time;
+    portEXIT_CRITICAL(&vsync_lock);
+    return last_vsync != 0 && now - last_vsync < BSP_DISPLAY_PRESENT_VSYNC_TIMEOUT_US;
+}
+
+static void bsp_display_present_wait_vsync(void) {
+    portENTER_CRITICAL(&vsync_lock);
+    int64_t last_vsync = vsync_time;
+    portEXIT_CRITICAL(&vsync_lock);
+
+    // Drop a vsync that was recorded before this frame was ready, unless it has only just happened
+    xSemaphoreTake(vsync_semaphore, 0);
+    if (esp_timer_get_time() - last_vsync < BSP_DISPLAY_PRESENT_VSYNC_WINDOW_US) {
+        return;
+    }
+    xSemaphoreTake(vsync_semaphore, pdMS_TO_TICKS(BSP_DISPLAY_PRESENT_VSYNC_TIMEOUT_US / 1000));
+}
+
+// Sleep until the given time, rounded down or up to a whole number of ticks
+static void bsp_display_present_sleep_until(int64_t time, bool round_up) {
+    int64_t remaining = time - esp_timer_get_time();
+    if (remaining <= 0) {
+        return;
+    }
+    TickType_t ticks = pdMS_TO_TICKS((remaining + (round_up ? 999 : 0)) / 1000);
+    if (round_up && ticks == 0) {
+        ticks = 1;
+    }
+    if (ticks > 0) {
+        vTaskDelay(ticks);
+    }
+}
+
+static void bsp_display_present_account(int64_t start, int64_t ready) {
+    portENTER_CRITICAL(&vsync_lock);
+    uint32_t count  = vsync_count;
+    int64_t  period = vsync_period;
+    portEXIT_CRITICAL(&vsync_lock);
+
+    portENTER_CRITICAL(&present_stats_lock);
+    present_stats.frames++;
+    present_stats.wait_time_us += ready - start;
+    if (last_present_time != 0) {
+        int64_t frame_time = ready - last_present_time;
+        size_t  bucket     = frame_time / BSP_DISPLAY_FRAME_HISTOGRAM_BUCKET_US;
+        if (bucket >= BSP_DISPLAY_FRAME_HISTOGRAM_BUCKETS) {
+            bucket = BSP_DISPLAY_FRAME_HISTOGRAM_BUCKETS - 1;
+        }
+        present_stats.frame_time_histogram[bucket]++;
+
+        if (period > 0) {
+            // Every vsync after the ones the frame interval asked for is one where a frame was due but not ready
+            uint32_t expected = present_interval > period ? (present_interval + period / 2) / period : 1;
+            uint32_t elapsed  = count - last_present_vsync;
+            if (elapsed > expected) {
+                present_stats.missed_vsyncs += elapsed - expected;
+            }
+        }
+    }
+    portEXIT_CRITICAL(&present_stats_lock);
+
+    last_present_time  = ready;
+    last_present_vsync = count;
+}
+
+esp_err_t bsp_display_present(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer) {
+    ESP_RETURN_ON_ERROR(bsp_display_present_initialize(), TAG, "Failed to initialize frame pacing");
+
+    int64_t start = esp_timer_get_time();
+    bool    vsync = bsp_display_present_vsync_active(start);
+    if (present_interval > 0 && present_due != 0) {
+        if (vsync) {
+            // Sleep until shortly before the frame is due, the final alignment is done on the vsync
+            bsp_display_present_sleep_until(present_due - BSP_DISPLAY_PRESENT_VSYNC_WINDOW_US, false);
+        } else {
+            bsp_display_present_sleep_until(present_due, true);
+        }
+    }
+    if (vsync) {
+        bsp_display_present_wait_vsync();
+    }
+
+    int64_t ready = esp_timer_get_time();
+    if (!vsync && present_due != 0 && ready - present_due < (int64_t)present_interval) {
+        // Without vsyncs the schedule advances from when the frame was due, so sleeping whole ticks does not add up
+        present_due += present_interval;
+    } else {
+        present_due = ready + present_interval;
+    }
+    bsp_display_present_account(start, ready);
+    return bsp_display_blit(x_start, y_start, x_end, y_end, buffer);
+}
+
+esp_err_t bsp_display_get_frame_stats(bsp_display_frame_stats_t* out_stats) {
+    ESP_RETURN_ON_FALSE(out_stats != NULL, ESP_ERR_INVALID_ARG, TAG, "Stats output argument is NULL");
+    portENTER_CRITICAL(&present_stats_lock);
+    memcpy(out_stats, &present_stats, sizeof(bsp_display_frame_stats_t));
+    portEXIT_CRITICAL(&present_stats_lock);
+    return ESP_OK;
+}
+
+void bsp_display_reset_frame_stats(void) {
+    portENTER_CRITICAL(&present_stats_lock);
+    memset(&present_stats, 0, sizeof(bsp_display_frame_stats_t));
+    portEXIT_CRITICAL(&present_stats_lock);
+}
@@ -0,0 +1,11 @@
+// Board support package API: Display frame pacing
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdbool.h>
+
+// Record a vsync, to be called from the tearing effect interrupt of the panel
+// Returns true if a higher priority task has been woken up
+bool bsp_display_present_vsync_from_isr(void);
@@ -0,0 +1,328 @@
+// Board support package API: Rotated display blit implementation
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "badge_bsp_display_staging.h"
+#include "bsp/display.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "soc/soc_caps.h"
+
+#if SOC_PPA_SUPPORTED
+#include "driver/ppa.h"
+#include "freertos/semphr.h"
+#endif
+
+// Source pixels are copied in tiles of this many destination pixels wide, keeping the source rows they touch cached
+#define BSP_DISPLAY_ROTATE_TILE 32
+
+#if SOC_PPA_SUPPORTED
+// Alignment and size granularity of the buffer the PPA writes to, covers the cache line size of external memory
+#define BSP_DISPLAY_ROTATE_PPA_ALIGNMENT 128
+#endif
+
+static char const* TAG = "BSP display rotate";
+
+// Region being rotated, with the mapping from destination (panel) pixels to source buffer pixels:
+// source index = base + u * du + v * dv, where u and v are relative to the top left corner of the destination region
+typedef struct {
+    size_t    dst_x_start;
+    size_t    dst_y_start;
+    size_t    dst_x_end;
+    size_t    dst_y_end;
+    ptrdiff_t base;
+    ptrdiff_t du;
+    ptrdiff_t dv;
+} bsp_display_rotate_region_t;
+
+static esp_err_t bsp_display_rotate_map(size_t x_start, size_t y_start, size_t x_end, size_t y_end, size_t h_res,
+                                        size_t v_res, bsp_display_rotation_t rotation,
+                                        bsp_display_rotate_region_t* out_region) {
+    ptrdiff_t width  = x_end - x_start;
+    ptrdiff_t height = y_end - y_start;
+
+    switch (rotation) {
+        case BSP_DISPLAY_ROTATION_0:
+            ESP_RETURN_ON_FALSE(x_end <= h_res && y_end <= v_res, ESP_ERR_INVALID_ARG, TAG, "Region outside display");
+            *out_region = (bsp_display_rotate_region_t){x_start, y_start, x_end, y_end, 0, 1, width};
+            break;
+        case BSP_DISPLAY_ROTATION_90:
+            ESP_RETURN_ON_FALSE(x_end <= v_res && y_end <= h_res, ESP_ERR_INVALID_ARG, TAG, "Region outside display");
+            *out_region = (bsp_display_rotate_region_t){h_res - y_end, x_start, h_res - y_start, x_end,
+                                                        (height - 1) * width, -width, 1};
+            break;
+        case BSP_DISPLAY_ROTATION_180:
+            ESP_RETURN_ON_FALSE(x_end <= h_res && y_end <= v_res, ESP_ERR_INVALID_ARG, TAG, "Region outside display");
+            *out_region = (bsp_display_rotate_region_t){h_res - x_end, v_res - y_end, h_res - x_start, v_res - y_start,
+                                                        width * height - 1, -1, -width};
+            break;
+        case BSP_DISPLAY_ROTATION_270:
+            ESP_RETURN_ON_FALSE(x_end <= v_res && y_end <= h_res, ESP_ERR_INVALID_ARG, TAG, "Region outside display");
+            *out_region = (bsp_display_rotate_region_t){y_start, v_res - x_end, y_end, v_res - x_start, width - 1,
+                                                        width, -1};
+            break;
+        default:
+            return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+// Copy count pixels that are step pixels apart in the source to consecutive destination pixels. The pixel size is a
+// constant in each case, so the copies compile to single loads and stores.
+static inline void bsp_display_rotate_run(uint8_t* dst, const uint8_t* src, ptrdiff_t step, size_t count,
+                                          size_t bytes) {
+    switch (bytes) {
+        case 1:
+            for (size_t i = 0; i < count; i++, src += step) {
+                dst[i] = *src;
+            }
+            break;
+        case 2:
+            step *= 2;
+            for (size_t i = 0; i < count; i++, src += step, dst += 2) {
+                memcpy(dst, src, 2);
+            }
+            break;
+        case 3:
+            step *= 3;
+            for (size_t i = 0; i < count; i++, src += step, dst += 3) {
+                memcpy(dst, src, 3);
+            }
+            break;
+        default:
+            step *= 4;
+            for (size_t i = 0; i < count; i++, src += step, dst += 4) {
+                memcpy(dst, src, 4);
+            }
+            break;
+    }
+}
+
+// Rotate the destination rows v_first up to v_first + rows into dst
+static void bsp_display_rotate_rows(uint8_t* dst, const bsp_display_rotate_region_t* region, size_t v_first,
+                                    size_t rows, const uint8_t* src, size_t bytes) {
+    size_t width = region->dst_x_end - region->dst_x_start;
+    if (region->du == 1) {
+        // Not rotated, the rows are contiguous in the source
+        for (size_t row = 0; row < rows; row++) {
+            ptrdiff_t index = region->base + (ptrdiff_t)(v_first + row) * region->dv;
+            memcpy(&dst[row * width * bytes], &src[index * (ptrdiff_t)bytes], width * bytes);
+        }
+        return;
+    }
+    for (size_t u_first = 0; u_first < width; u_first += BSP_DISPLAY_ROTATE_TILE) {
+        size_t count = width - u_first < BSP_DISPLAY_ROTATE_TILE ? width - u_first : BSP_DISPLAY_ROTATE_TILE;
+        for (size_t row = 0; row < rows; row++) {
+            ptrdiff_t index = region->base + (ptrdiff_t)u_first * region->du + (ptrdiff_t)(v_first + row) * region->dv;
+            bsp_display_rotate_run(&dst[(row * width + u_first) * bytes], &src[index * (ptrdiff_t)bytes], region->du,
+                                   count, bytes);
+        }
+    }
+}
+
+static esp_err_t bsp_display_rotate_software(const bsp_display_rotate_region_t* region, const uint8_t* src,
+                                             bsp_display_color_format_t src_fmt, bsp_display_color_format_t dst_fmt,
+                                             bsp_display_endianness_t dst_endian) {
+    size_t src_bytes = bsp_display_get_bits_per_pixel(src_fmt) / 8;
+    size_t dst_bytes = bsp_display_get_bits_per_pixel(dst_fmt) / 8;
+    size_t width     = region->dst_x_end - region->dst_x_start;
+    size_t height    = region->dst_y_end - region->dst_y_start;
+
+    // Pixels already in the format of the display are rotated straight into the staging buffer
+    bool direct = src_fmt == dst_fmt && dst_endian == BSP_DISPLAY_ENDIAN_LITTLE;
+
+    for (size_t v = 0; v < height;) {
+        uint8_t* staging      = NULL;
+        size_t   staging_size = 0;
+        ESP_RETURN_ON_ERROR(bsp_display_staging_get(&staging, &staging_size), TAG, "Failed to get staging buffer");
+
+        size_t rows_per_blit = staging_size / (width * dst_bytes);
+        size_t rows          = height - v < rows_per_blit ? height - v : rows_per_blit;
+        if (direct) {
+            bsp_display_rotate_rows(staging, region, v, rows, src, src_bytes);
+        } else {
+            // The scratch buffer belongs to the staging buffer, tasks rotating at the same time each have their own
+            uint8_t*  scratch      = NULL;
+            size_t    scratch_size = staging_size / dst_bytes * src_bytes;
+            esp_err_t res          = bsp_display_staging_get_scratch(staging, scratch_size, &scratch);
+            if (res == ESP_OK) {
+                bsp_display_rotate_rows(scratch, region, v, rows, src, src_bytes);
+                res = bsp_display_convert(staging, dst_fmt, dst_endian, scratch, src_fmt, rows * width);
+            }
+            if (res != ESP_OK) {
+                bsp_display_staging_release(staging);
+                return res;
+            }
+        }
+
+        ESP_RETURN_ON_ERROR(bsp_display_staging_blit(staging, region->dst_x_start, region->dst_y_start + v,
+                                                     region->dst_x_end, region->dst_y_start + v + rows),
+                            TAG, "Failed to blit strip");
+        v += rows;
+    }
+    return ESP_OK;
+}
+
+#if SOC_PPA_SUPPORTED
+
+static ppa_client_handle_t ppa_client      = NULL;
+static uint8_t*            ppa_buffer      = NULL;
+static size_t              ppa_buffer_size = 0;
+static SemaphoreHandle_t   ppa_buffer_free = NULL;
+
+static bool bsp_display_rotate_ppa_color_mode(bsp_display_color_format_t color_fmt, ppa_srm_color_mode_t* out_mode) {
+    switch (color_fmt) {
+        case BSP_DISPLAY_COLOR_FORMAT_16_565RGB:
+            *out_mode = PPA_SRM_COLOR_MODE_RGB565;
+            return true;
+        case BSP_DISPLAY_COLOR_FORMAT_24_888RGB:
+            *out_mode = PPA_SRM_COLOR_MODE_RGB888;
+            return true;
+        case BSP_DISPLAY_COLOR_FORMAT_32_8888ARGB:
+            *out_mode = PPA_SRM_COLOR_MODE_ARGB8888;
+            return true;
+        default:
+            return false;
+    }
+}
+
+static esp_err_t bsp_display_rotate_ppa_initialize(size_t h_res, size_t v_res, size_t dst_bytes) {
+    if (ppa_client != NULL) {
+        return ESP_OK;
+    }
+
+    size_t size = (h_res * v_res * dst_bytes + BSP_DISPLAY_ROTATE_PPA_ALIGNMENT - 1) &
+                  ~(size_t)(BSP_DISPLAY_ROTATE_PPA_ALIGNMENT - 1);
+    uint8_t*          buffer = heap_caps_aligned_alloc(BSP_DISPLAY_ROTATE_PPA_ALIGNMENT, size,
+                                                       MALLOC_CAP_SPIRAM | MALLOC_CAP_DMA);
+    SemaphoreHandle_t free   = xSemaphoreCreateBinary();
+    if (buffer == NULL || free == NULL) {
+        heap_caps_free(buffer);
+        if (free != NULL) {
+            vSemaphoreDelete(free);
+        }
+        return ESP_ERR_NO_MEM;
+    }
+
+    ppa_client_config_t client_config = {
+        .oper_type             = PPA_OPERATION_SRM,
+        .max_pending_trans_num = 1,
+    };
+    esp_err_t res = ppa_register_client(&client_config, &ppa_client);
+    if (res != ESP_OK) {
+        heap_caps_free(buffer);
+        vSemaphoreDelete(free);
+        return res;
+    }
+
+    xSemaphoreGive(free);
+    ppa_buffer      = buffer;
+    ppa_buffer_size = size;
+    ppa_buffer_free = free;
+    return ESP_OK;
+}
+
+static bool bsp_display_rotate_ppa_done(void* user_ctx) {
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(ppa_buffer_free, &woken);
+    return woken == pdTRUE;
+}
+
+static esp_err_t bsp_display_rotate_ppa(const bsp_display_rotate_region_t* region, const void* src, size_t src_width,
+                                        size_t src_height, ppa_srm_color_mode_t src_mode,
+                                        ppa_srm_color_mode_t dst_mode, bsp_display_rotation_t rotation) {
+    // The PPA rotates counter clockwise
+    static const ppa_srm_rotation_angle_t angles[] = {
+        [BSP_DISPLAY_ROTATION_0]   = PPA_SRM_ROTATION_ANGLE_0,
+        [BSP_DISPLAY_ROTATION_90]  = PPA_SRM_ROTATION_ANGLE_270,
+        [BSP_DISPLAY_ROTATION_180] = PPA_SRM_ROTATION_ANGLE_180,
+        [BSP_DISPLAY_ROTATION_270] = PPA_SRM_ROTATION_ANGLE_90,
+    };
+
+    size_t width  = region->dst_x_end - region->dst_x_start;
+    size_t height = region->dst_y_end - region->dst_y_start;
+
+    // Wait for the display driver to be done with the previous rotated region
+    ESP_RETURN_ON_FALSE(xSemaphoreTake(ppa_buffer_free, pdMS_TO_TICKS(1000)) == pdTRUE, ESP_ERR_TIMEOUT, TAG,
+                        "Timeout while waiting for rotation buffer");
+
+    ppa_srm_oper_config_t oper_config = {
+        .in =
+            {
+                .buffer         = src,
+                .pic_w          = src_width,
+                .pic_h          = src_height,
+                .block_w        = src_width,
+                .block_h        = src_height,
+                .block_offset_x = 0,
+                .block_offset_y = 0,
+                .srm_cm         = src_mode,
+            },
+        .out =
+            {
+                .buffer         = ppa_buffer,
+                .buffer_size    = ppa_buffer_size,
+                .pic_w          = width,
+                .pic_h          = height,
+                .block_offset_x = 0,
+                .block_offset_y = 0,
+                .srm_cm         = dst_mode,
+            },
+        .rotation_angle = angles[rotation],
+        .scale_x        = 1.0f,
+        .scale_y        = 1.0f,
+        .mode           = PPA_TRANS_MODE_BLOCKING,
+    };
+    esp_err_t res = ppa_do_scale_rotate_mirror(ppa_client, &oper_config);
+    if (res == ESP_OK) {
+        res = bsp_display_blit_async(region->dst_x_start, region->dst_y_start, region->dst_x_end, region->dst_y_end,
+                                     ppa_buffer, bsp_display_rotate_ppa_done, NULL);
+    }
+    if (res != ESP_OK) {
+        xSemaphoreGive(ppa_buffer_free);
+    }
+    return res;
+}
+
+#endif
+
+esp_err_t bsp_display_blit_rotated(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer,
+                                   bsp_display_color_format_t src_fmt, bsp_display_rotation_t rotation) {
+    ESP_RETURN_ON_FALSE(buffer, ESP_ERR_INVALID_ARG, TAG, "Buffer argument is NULL");
+    ESP_RETURN_ON_FALSE(x_start < x_end && y_start < y_end, ESP_ERR_INVALID_ARG, TAG, "Empty region");
+
+    size_t                     h_res = 0;
+    size_t                     v_res = 0;
+    bsp_display_color_format_t dst_fmt;
+    bsp_display_endianness_t   dst_endian;
+    ESP_RETURN_ON_ERROR(bsp_display_get_parameters(&h_res, &v_res, &dst_fmt, &dst_endian), TAG,
+                        "Failed to get display parameters");
+
+    size_t src_bits = bsp_display_get_bits_per_pixel(src_fmt);
+    size_t dst_bits = bsp_display_get_bits_per_pixel(dst_fmt);
+    ESP_RETURN_ON_FALSE(src_bits >= 8 && src_bits % 8 == 0 && dst_bits >= 8 && dst_bits % 8 == 0,
+                        ESP_ERR_NOT_SUPPORTED, TAG, "Unsupported color format");
+
+    bsp_display_rotate_region_t region;
+    ESP_RETURN_ON_ERROR(bsp_display_rotate_map(x_start, y_start, x_end, y_end, h_res, v_res, rotation, &region), TAG,
+                        "Invalid region");
+
+#if SOC_PPA_SUPPORTED
+    ppa_srm_color_mode_t src_mode;
+    ppa_srm_color_mode_t dst_mode;
+    if (dst_endian == BSP_DISPLAY_ENDIAN_LITTLE && bsp_display_rotate_ppa_color_mode(src_fmt, &src_mode) &&
+        bsp_display_rotate_ppa_color_mode(dst_fmt, &dst_mode) &&
+        bsp_display_rotate_ppa_initialize(h_res, v_res, dst_bits / 8) == ESP_OK) {
+        return bsp_display_rotate_ppa(&region, buffer, x_end - x_start, y_end - y_start, src_mode, dst_mode, rotation);
+    }
+#endif
+
+    return bsp_display_rotate_software(&region, buffer, src_fmt, dst_fmt, dst_endian);
+}
@@ -0,0 +1,206 @@
+// Board support package API: Display shadow framebuffer implementation
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include "badge_bsp_display_shadow.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+// A full refresh is done once fast refreshes changed this many full frames worth of pixels in total
+#define BSP_DISPLAY_SHADOW_GHOSTING_FRAMES 4
+
+// A full refresh is done after this many fast refreshes, however little they changed
+#define BSP_DISPLAY_SHADOW_GHOSTING_REFRESHES 32
+
+static char const* TAG = "BSP display shadow";
+
+static uint8_t* shadow_buffer    = NULL;
+static size_t   shadow_h_res     = 0;
+static size_t   shadow_v_res     = 0;
+static size_t   shadow_bpp       = 0;
+static size_t   shadow_stride    = 0;
+static bool     shadow_presented = false;
+static size_t   shadow_pending   = 0;  // Bytes changed since the panel was last written
+
+// Rows and byte columns of the changed bytes, empty when dirty_y_start >= dirty_y_end
+static size_t dirty_y_start = 0;
+static size_t dirty_y_end   = 0;
+static size_t dirty_x_start = 0;  // In bytes
+static size_t dirty_x_end   = 0;
+
+static size_t ghosting_bytes     = 0;
+static size_t ghosting_refreshes = 0;
+
+esp_err_t bsp_display_shadow_initialize(size_t h_res, size_t v_res, size_t bits_per_pixel) {
+    // Pixels either pack evenly into bytes or consist of whole bytes
+    bool packed = bits_per_pixel <= 8 ? 8 % bits_per_pixel == 0 : bits_per_pixel % 8 == 0;
+    ESP_RETURN_ON_FALSE(h_res > 0 && v_res > 0 && bits_per_pixel > 0 && packed, ESP_ERR_INVALID_ARG, TAG,
+                        "Unsupported shadow framebuffer format");
+    if (shadow_buffer != NULL) {
+        return ESP_OK;
+    }
+
+    shadow_stride = (h_res * bits_per_pixel + 7) / 8;
+    shadow_buffer = heap_caps_calloc(1, shadow_stride * v_res, MALLOC_CAP_DMA);
+    if (shadow_buffer == NULL) {
+        // Framebuffers of colour displays rarely fit in DMA capable memory, the panel driver copies from it anyway
+        shadow_buffer = heap_caps_calloc(1, shadow_stride * v_res, MALLOC_CAP_DEFAULT);
+    }
+    ESP_RETURN_ON_FALSE(shadow_buffer != NULL, ESP_ERR_NO_MEM, TAG, "Failed to allocate shadow framebuffer");
+    shadow_h_res = h_res;
+    shadow_v_res = v_res;
+    shadow_bpp   = bits_per_pixel;
+    return ESP_OK;
+}
+
+// Grow the dirty region by the bytes first up to last of a row
+static void bsp_display_shadow_mark_dirty(size_t y, size_t first, size_t last) {
+    if (dirty_y_start >= dirty_y_end) {
+        dirty_y_start = y;
+        dirty_x_start = first;
+        dirty_x_end   = last + 1;
+    } else {
+        dirty_x_start = first < dirty_x_start ? first : dirty_x_start;
+        dirty_x_end   = last + 1 > dirty_x_end ? last + 1 : dirty_x_end;
+    }
+    dirty_y_end = y + 1;
+}
+
+// Copy whole bytes into row y, starting at byte dst_offset
+static size_t bsp_display_shadow_copy_bytes(size_t y, size_t dst_offset, const uint8_t* src, size_t length) {
+    uint8_t* dst     = &shadow_buffer[y * shadow_stride + dst_offset];
+    size_t   changed = 0;
+    size_t   first   = 0;
+    size_t   last    = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (dst[i] != src[i]) {
+            dst[i] = src[i];
+            if (changed == 0) {
+                first = i;
+            }
+            last = i;
+            changed++;
+        }
+    }
+    if (changed > 0) {
+        bsp_display_shadow_mark_dirty(y, dst_offset + first, dst_offset + last);
+    }
+    return changed;
+}
+
+// Copy packed pixels into row y, starting at pixel dst_x, returns the number of bytes changed
+static size_t bsp_display_shadow_copy_pixels(size_t y, size_t dst_x, const uint8_t* src_row, size_t width) {
+    uint8_t* dst_row = &shadow_buffer[y * shadow_stride];
+    uint8_t  mask    = (1 << shadow_bpp) - 1;
+    size_t   changed = 0;
+    size_t   first   = 0;
+    size_t   last    = 0;
+    for (size_t x = 0; x < width; x++) {
+        size_t  src_bit = x * shadow_bpp;
+        size_t  dst_bit = (dst_x + x) * shadow_bpp;
+        uint8_t value   = (src_row[src_bit / 8] >> (8 - shadow_bpp - src_bit % 8)) & mask;
+        size_t  shift   = 8 - shadow_bpp - dst_bit % 8;
+        uint8_t old     = dst_row[dst_bit / 8];
+        uint8_t updated = (old & ~(mask << shift)) | (value << shift);
+        if (updated != old) {
+            dst_row[dst_bit / 8] = updated;
+            // Pixels are visited in order, a byte is counted by its first changed pixel
+            if (changed == 0 || dst_bit / 8 != last) {
+                if (changed == 0) {
+                    first = dst_bit / 8;
+                }
+                last = dst_bit / 8;
+                changed++;
+            }
+        }
+    }
+    if (changed > 0) {
+        bsp_display_shadow_mark_dirty(y, first, last);
+    }
+    return changed;
+}
+
+esp_err_t bsp_display_shadow_update(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer,
+                                    size_t* out_changed_bytes) {
+    ESP_RETURN_ON_FALSE(shadow_buffer != NULL, ESP_ERR_INVALID_STATE, TAG, "Shadow framebuffer not initialized");
+    ESP_RETURN_ON_FALSE(buffer != NULL && x_start < x_end && y_start < y_end && x_end <= shadow_h_res &&
+                            y_end <= shadow_v_res,
+                        ESP_ERR_INVALID_ARG, TAG, "Invalid region");
+
+    const uint8_t* src         = buffer;
+    size_t         width       = x_end - x_start;
+    size_t         src_stride  = (width * shadow_bpp + 7) / 8;
+    bool           byte_copies = (x_start * shadow_bpp) % 8 == 0 && (width * shadow_bpp) % 8 == 0;
+    size_t         changed     = 0;
+
+    for (size_t y = y_start; y < y_end; y++) {
+        if (byte_copies) {
+            changed += bsp_display_shadow_copy_bytes(y, x_start * shadow_bpp / 8, src, src_stride);
+        } else {
+            changed += bsp_display_shadow_copy_pixels(y, x_start, src, width);
+        }
+        src += src_stride;
+    }
+
+    // Changes stay pending until the panel has been written, a blit retried after a failed write still refreshes
+    shadow_pending += changed;
+    if (out_changed_bytes != NULL) {
+        *out_changed_bytes = shadow_presented ? shadow_pending : shadow_stride * shadow_v_res;
+    }
+    return ESP_OK;
+}
+
+const uint8_t* bsp_display_shadow_get_buffer(void) {
+    return shadow_buffer;
+}
+
+bool bsp_display_shadow_get_dirty(bsp_display_shadow_window_t* out_window) {
+    size_t y_start = dirty_y_start;
+    size_t y_end   = dirty_y_end;
+    size_t x_start = dirty_x_start;
+    size_t x_end   = dirty_x_end;
+    if (!shadow_presented) {
+        y_start = 0;
+        y_end   = shadow_v_res;
+        x_start = 0;
+        x_end   = shadow_stride;
+    } else if (y_start >= y_end) {
+        return false;
+    }
+    if (out_window != NULL) {
+        size_t x_end_pixels = (x_end * 8 + shadow_bpp - 1) / shadow_bpp;
+        out_window->x_start = x_start * 8 / shadow_bpp;
+        out_window->y_start = y_start;
+        out_window->x_end   = x_end_pixels < shadow_h_res ? x_end_pixels : shadow_h_res;
+        out_window->y_end   = y_end;
+    }
+    return true;
+}
+
+bool bsp_display_shadow_wants_full_refresh(size_t changed_bytes) {
+    if (!shadow_presented) {
+        return true;
+    }
+    return ghosting_bytes + changed_bytes >= BSP_DISPLAY_SHADOW_GHOSTING_FRAMES * shadow_stride * shadow_v_res ||
+           ghosting_refreshes + 1 >= BSP_DISPLAY_SHADOW_GHOSTING_REFRESHES;
+}
+
+void bsp_display_shadow_mark_presented(bool full_refresh, size_t changed_bytes) {
+    shadow_presented = true;
+    shadow_pending   = 0;
+    dirty_y_start    = 0;
+    dirty_y_end      = 0;
+    if (full_refresh) {
+        ghosting_bytes     = 0;
+        ghosting_refreshes = 0;
+    } else {
+        ghosting_bytes += changed_bytes;
+        ghosting_refreshes++;
+    }
+}
@@ -0,0 +1,49 @@
+// Board support package API: Display shadow framebuffer
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Shadow framebuffer for panels that can only be refreshed as a whole, such as e-paper displays
+// Pixels of less than 8 bits are stored in rows of packed pixels, starting at the most significant bit of each byte.
+// Each row of a blit buffer starts at a byte boundary. Pixels of 8 bits or more are stored as whole bytes.
+
+// Region of the shadow framebuffer in pixels, the end coordinates are exclusive
+typedef struct {
+    size_t x_start;
+    size_t y_start;
+    size_t x_end;
+    size_t y_end;
+} bsp_display_shadow_window_t;
+
+// Allocate the shadow framebuffer
+esp_err_t bsp_display_shadow_initialize(size_t h_res, size_t v_res, size_t bits_per_pixel);
+
+// Copy a region into the shadow framebuffer
+// out_changed_bytes receives the number of bytes of the shadow framebuffer changed since the panel was last written,
+// which is the full size of the framebuffer until bsp_display_shadow_mark_presented has been called once. Packed
+// pixels are counted by the bytes holding them, a byte with several changed pixels counts once. Changes accumulate
+// until bsp_display_shadow_mark_presented is called, so only call it once the panel write succeeded.
+esp_err_t bsp_display_shadow_update(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer,
+                                    size_t* out_changed_bytes);
+
+// Get the contents of the shadow framebuffer
+const uint8_t* bsp_display_shadow_get_buffer(void);
+
+// Get the smallest region holding every byte changed since the panel was last written, the whole framebuffer until
+// bsp_display_shadow_mark_presented has been called once. Packed pixels are widened to the whole bytes holding them.
+// Returns false when nothing changed.
+bool bsp_display_shadow_get_dirty(bsp_display_shadow_window_t* out_window);
+
+// Check whether the next refresh should be a full refresh of the panel
+// This is the case for the first frame and once the ghosting accumulated by fast refreshes, including the one about to
+// be done for changed_bytes, exceeds the limits
+bool bsp_display_shadow_wants_full_refresh(size_t changed_bytes);
+
+// Record that the shadow framebuffer has been written to the panel, a full refresh resets the ghosting counters
+void bsp_display_shadow_mark_presented(bool full_refresh, size_t changed_bytes);
@@ -0,0 +1,141 @@
+// Board support package API: Partial RAM writes to SSD1619 tri-color e-paper panels
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include "badge_bsp_display_ssd1619.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "badge_bsp_display_shadow.h"
+#include "driver/gpio.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "ssd1619.h"
+
+#define SSD1619_CMD_DATA_ENTRY_MODE   0x11
+#define SSD1619_CMD_MASTER_ACTIVATION 0x20
+#define SSD1619_CMD_UPDATE_CONTROL_2  0x22
+#define SSD1619_CMD_WRITE_RAM_BLACK   0x24
+#define SSD1619_CMD_WRITE_RAM_RED     0x26
+#define SSD1619_CMD_RAM_X_WINDOW      0x44
+#define SSD1619_CMD_RAM_Y_WINDOW      0x45
+#define SSD1619_CMD_RAM_X_COUNTER     0x4E
+#define SSD1619_CMD_RAM_Y_COUNTER     0x4F
+
+#define SSD1619_DATA_ENTRY_X_INC_Y_INC 0x03
+#define SSD1619_UPDATE_DISPLAY         0xC7  // Refresh with the LUT in the register, without loading one from OTP
+
+// RAM bytes sent per data transfer
+#define BSP_DISPLAY_SSD1619_CHUNK 128
+
+// Refreshing the panel takes a few seconds at low temperatures
+#define BSP_DISPLAY_SSD1619_BUSY_TIMEOUT_MS 10000
+#define BSP_DISPLAY_SSD1619_BUSY_POLL_MS    10
+
+static char const* TAG = "BSP display SSD1619";
+
+static esp_err_t bsp_display_ssd1619_command(ssd1619_t* epaper, uint8_t command, const uint8_t* data, size_t length) {
+    ESP_RETURN_ON_ERROR(ssd1619_send_command(epaper, command), TAG, "Failed to send command");
+    if (length > 0) {
+        ESP_RETURN_ON_ERROR(ssd1619_send_data(epaper, data, length), TAG, "Failed to send data");
+    }
+    return ESP_OK;
+}
+
+// Point the RAM window and the address counters at bytes x_start up to x_end of rows y_start up to y_end
+static esp_err_t bsp_display_ssd1619_set_window(ssd1619_t* epaper, size_t x_start, size_t y_start, size_t x_end,
+                                                size_t y_end) {
+    uint8_t x_window[]  = {x_start, x_end - 1};
+    uint8_t y_window[]  = {y_start & 0xFF, y_start >> 8, (y_end - 1) & 0xFF, (y_end - 1) >> 8};
+    uint8_t x_counter   = x_start;
+    uint8_t y_counter[] = {y_start & 0xFF, y_start >> 8};
+    ESP_RETURN_ON_ERROR(bsp_display_ssd1619_command(epaper, SSD1619_CMD_RAM_X_WINDOW, x_window, sizeof(x_window)),
+                        TAG, "Failed to set RAM X window");
+    ESP_RETURN_ON_ERROR(bsp_display_ssd1619_command(epaper, SSD1619_CMD_RAM_Y_WINDOW, y_window, sizeof(y_window)),
+                        TAG, "Failed to set RAM Y window");
+    ESP_RETURN_ON_ERROR(bsp_display_ssd1619_command(epaper, SSD1619_CMD_RAM_X_COUNTER, &x_counter, 1), TAG,
+                        "Failed to set RAM X counter");
+    ESP_RETURN_ON_ERROR(bsp_display_ssd1619_command(epaper, SSD1619_CMD_RAM_Y_COUNTER, y_counter, sizeof(y_counter)),
+                        TAG, "Failed to set RAM Y counter");
+    return ESP_OK;
+}
+
+// Send one RAM plane of the window, a set bit is a white pixel in the black RAM and a red pixel in the red RAM
+static esp_err_t bsp_display_ssd1619_write_plane(ssd1619_t* epaper, uint8_t command, const uint8_t* framebuffer,
+                                                 size_t stride, size_t x_start, size_t y_start, size_t x_end,
+                                                 size_t y_end) {
+    uint8_t chunk[BSP_DISPLAY_SSD1619_CHUNK];
+    size_t  length    = 0;
+    bool    red_plane = command == SSD1619_CMD_WRITE_RAM_RED;
+    ESP_RETURN_ON_ERROR(ssd1619_send_command(epaper, command), TAG, "Failed to send command");
+    for (size_t y = y_start; y < y_end; y++) {
+        const uint8_t* row = &framebuffer[y * stride];
+        for (size_t x = x_start; x < x_end; x++) {
+            // Eight pixels of 2 bits in two framebuffer bytes, the first pixel in the most significant bits
+            uint16_t pixels = (row[2 * x] << 8) | row[2 * x + 1];
+            uint8_t  bits   = 0;
+            for (int pixel = 0; pixel < 8; pixel++) {
+                uint8_t value = (pixels >> (14 - 2 * pixel)) & 0x3;
+                bool set = red_plane ? value == BSP_DISPLAY_SSD1619_RED : value != BSP_DISPLAY_SSD1619_BLACK;
+                bits     = (bits << 1) | set;
+            }
+            chunk[length++] = bits;
+            if (length == sizeof(chunk)) {
+                ESP_RETURN_ON_ERROR(ssd1619_send_data(epaper, chunk, length), TAG, "Failed to send RAM data");
+                length = 0;
+            }
+        }
+    }
+    if (length > 0) {
+        ESP_RETURN_ON_ERROR(ssd1619_send_data(epaper, chunk, length), TAG, "Failed to send RAM data");
+    }
+    return ESP_OK;
+}
+
+static esp_err_t bsp_display_ssd1619_wait_idle(ssd1619_t* epaper) {
+    for (int waited = 0; gpio_get_level(epaper->pin_busy); waited += BSP_DISPLAY_SSD1619_BUSY_POLL_MS) {
+        ESP_RETURN_ON_FALSE(waited < BSP_DISPLAY_SSD1619_BUSY_TIMEOUT_MS, ESP_ERR_TIMEOUT, TAG,
+                            "Timeout while waiting for the panel refresh");
+        vTaskDelay(pdMS_TO_TICKS(BSP_DISPLAY_SSD1619_BUSY_POLL_MS));
+    }
+    return ESP_OK;
+}
+
+esp_err_t bsp_display_ssd1619_write_window(ssd1619_t* epaper, const uint8_t* framebuffer, size_t h_res,
+                                           const bsp_display_shadow_window_t* window) {
+    ESP_RETURN_ON_FALSE(epaper != NULL && framebuffer != NULL && window != NULL, ESP_ERR_INVALID_ARG, TAG,
+                        "Argument is NULL");
+    ESP_RETURN_ON_FALSE(h_res % 8 == 0 && window->x_start < window->x_end && window->y_start < window->y_end &&
+                            window->x_end <= h_res,
+                        ESP_ERR_INVALID_ARG, TAG, "Invalid window");
+
+    // RAM bytes holding the window
+    size_t stride  = h_res / 4;
+    size_t x_start = window->x_start / 8;
+    size_t x_end   = (window->x_end + 7) / 8;
+
+    uint8_t data_entry = SSD1619_DATA_ENTRY_X_INC_Y_INC;
+    ESP_RETURN_ON_ERROR(bsp_display_ssd1619_command(epaper, SSD1619_CMD_DATA_ENTRY_MODE, &data_entry, 1), TAG,
+                        "Failed to set data entry mode");
+    ESP_RETURN_ON_ERROR(bsp_display_ssd1619_set_window(epaper, x_start, window->y_start, x_end, window->y_end), TAG,
+                        "Failed to set window");
+    ESP_RETURN_ON_ERROR(bsp_display_ssd1619_write_plane(epaper, SSD1619_CMD_WRITE_RAM_BLACK, framebuffer, stride,
+                                                        x_start, window->y_start, x_end, window->y_end),
+                        TAG, "Failed to write black RAM");
+
+    // The counters moved to the end of the window while writing the black RAM
+    ESP_RETURN_ON_ERROR(bsp_display_ssd1619_set_window(epaper, x_start, window->y_start, x_end, window->y_end), TAG,
+                        "Failed to set window");
+    ESP_RETURN_ON_ERROR(bsp_display_ssd1619_write_plane(epaper, SSD1619_CMD_WRITE_RAM_RED, framebuffer, stride,
+                                                        x_start, window->y_start, x_end, window->y_end),
+                        TAG, "Failed to write red RAM");
+
+    uint8_t sequence = SSD1619_UPDATE_DISPLAY;
+    ESP_RETURN_ON_ERROR(bsp_display_ssd1619_command(epaper, SSD1619_CMD_UPDATE_CONTROL_2, &sequence, 1), TAG,
+                        "Failed to set update sequence");
+    ESP_RETURN_ON_ERROR(bsp_display_ssd1619_command(epaper, SSD1619_CMD_MASTER_ACTIVATION, NULL, 0), TAG,
+                        "Failed to start refresh");
+    return bsp_display_ssd1619_wait_idle(epaper);
+}
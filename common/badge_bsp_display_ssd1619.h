@@ -0,0 +1,22 @@
+// Board support package API: Partial RAM writes to SSD1619 tri-color e-paper panels
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "badge_bsp_display_shadow.h"
+#include "esp_err.h"
+#include "ssd1619.h"
+
+// Pixel values of the 2-bit framebuffer, matching the palette of the targets
+#define BSP_DISPLAY_SSD1619_WHITE 0
+#define BSP_DISPLAY_SSD1619_BLACK 1
+#define BSP_DISPLAY_SSD1619_RED   2
+
+// Write a window of a 2-bit framebuffer of h_res pixels wide to the black and red RAM of the panel and refresh it
+// The RAM window and address counters are set to the window, widened to whole RAM bytes of 8 pixels, so only the rows
+// and byte columns of the window are sent. The RAM outside the window keeps what was written before.
+esp_err_t bsp_display_ssd1619_write_window(ssd1619_t* epaper, const uint8_t* framebuffer, size_t h_res,
+                                           const bsp_display_shadow_window_t* window);
@@ -0,0 +1,203 @@
+// Board support package API: Display staging buffers implementation
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include "badge_bsp_display_staging.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "bsp/display.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+// Number of full width rows that fit in each staging buffer unless the target asks for more
+#define BSP_DISPLAY_STAGING_ROWS    8
+#define BSP_DISPLAY_STAGING_BUFFERS 2
+
+static char const* TAG = "BSP display staging";
+
+// The buffers are owned by whoever took their semaphore, the lock only guards the allocation and the next buffer index
+static uint8_t*          staging_buffers[BSP_DISPLAY_STAGING_BUFFERS]    = {NULL};
+static SemaphoreHandle_t staging_semaphores[BSP_DISPLAY_STAGING_BUFFERS] = {NULL};
+static size_t            staging_size                                    = 0;
+static size_t            staging_rows                                    = BSP_DISPLAY_STAGING_ROWS;
+static size_t            staging_next                                    = 0;
+static portMUX_TYPE      staging_lock                                    = portMUX_INITIALIZER_UNLOCKED;
+
+// Completion callback of the blit of each buffer, set by the task holding the buffer
+typedef struct {
+    bsp_display_blit_done_cb_t callback;
+    void*                      user_ctx;
+} bsp_display_staging_callback_t;
+
+static bsp_display_staging_callback_t staging_callbacks[BSP_DISPLAY_STAGING_BUFFERS];
+
+// Scratch buffers, each only used by the task holding the staging buffer of the same index
+static uint8_t* staging_scratch[BSP_DISPLAY_STAGING_BUFFERS]      = {NULL};
+static size_t   staging_scratch_size[BSP_DISPLAY_STAGING_BUFFERS] = {0};
+
+static void bsp_display_staging_free(uint8_t** buffers, SemaphoreHandle_t* semaphores) {
+    for (size_t i = 0; i < BSP_DISPLAY_STAGING_BUFFERS; i++) {
+        if (buffers[i] != NULL) {
+            heap_caps_free(buffers[i]);
+        }
+        if (semaphores[i] != NULL) {
+            vSemaphoreDelete(semaphores[i]);
+        }
+    }
+}
+
+static esp_err_t bsp_display_staging_initialize(void) {
+    portENTER_CRITICAL(&staging_lock);
+    size_t size = staging_size;
+    size_t rows = staging_rows;
+    portEXIT_CRITICAL(&staging_lock);
+    if (size > 0) {
+        return ESP_OK;
+    }
+
+    size_t                     h_res = 0;
+    size_t                     v_res = 0;
+    bsp_display_color_format_t color_fmt;
+    ESP_RETURN_ON_ERROR(bsp_display_get_parameters(&h_res, &v_res, &color_fmt, NULL), TAG,
+                        "Failed to get display parameters");
+    size_t bpp = bsp_display_get_bits_per_pixel(color_fmt);
+    ESP_RETURN_ON_FALSE(bpp >= 8 && bpp % 8 == 0 && h_res > 0, ESP_ERR_NOT_SUPPORTED, TAG,
+                        "Display color format can not be staged");
+
+    uint8_t*          buffers[BSP_DISPLAY_STAGING_BUFFERS]    = {NULL};
+    SemaphoreHandle_t semaphores[BSP_DISPLAY_STAGING_BUFFERS] = {NULL};
+    size = h_res * rows * (bpp / 8);
+    for (size_t i = 0; i < BSP_DISPLAY_STAGING_BUFFERS; i++) {
+        buffers[i]    = heap_caps_malloc(size, MALLOC_CAP_DMA);
+        semaphores[i] = xSemaphoreCreateBinary();
+        if (buffers[i] == NULL || semaphores[i] == NULL) {
+            bsp_display_staging_free(buffers, semaphores);
+            ESP_LOGE(TAG, "Failed to allocate staging buffer");
+            return ESP_ERR_NO_MEM;
+        }
+        xSemaphoreGive(semaphores[i]);
+    }
+
+    // Two tasks may stage their first blit at the same time
+    bool installed = false;
+    portENTER_CRITICAL(&staging_lock);
+    if (staging_size == 0) {
+        for (size_t i = 0; i < BSP_DISPLAY_STAGING_BUFFERS; i++) {
+            staging_buffers[i]    = buffers[i];
+            staging_semaphores[i] = semaphores[i];
+        }
+        staging_size = size;
+        installed    = true;
+    }
+    portEXIT_CRITICAL(&staging_lock);
+
+    if (!installed) {
+        bsp_display_staging_free(buffers, semaphores);
+    }
+    return ESP_OK;
+}
+
+esp_err_t bsp_display_staging_set_rows(size_t rows) {
+    ESP_RETURN_ON_FALSE(rows > 0, ESP_ERR_INVALID_ARG, TAG, "Invalid number of rows");
+    esp_err_t res = ESP_OK;
+    portENTER_CRITICAL(&staging_lock);
+    if (staging_size > 0) {
+        res = ESP_ERR_INVALID_STATE;
+    } else if (rows > staging_rows) {
+        staging_rows = rows;
+    }
+    portEXIT_CRITICAL(&staging_lock);
+    ESP_RETURN_ON_ERROR(res, TAG, "Staging buffers already allocated");
+    return ESP_OK;
+}
+
+// Index of a buffer returned by bsp_display_staging_get, BSP_DISPLAY_STAGING_BUFFERS if it is not a staging buffer
+static size_t bsp_display_staging_index(const uint8_t* buffer) {
+    size_t i = 0;
+    while (i < BSP_DISPLAY_STAGING_BUFFERS && (buffer == NULL || staging_buffers[i] != buffer)) {
+        i++;
+    }
+    return i;
+}
+
+// Semaphore of a buffer returned by bsp_display_staging_get, NULL if the buffer is not a staging buffer
+static SemaphoreHandle_t bsp_display_staging_semaphore(const uint8_t* buffer) {
+    size_t index = bsp_display_staging_index(buffer);
+    return index < BSP_DISPLAY_STAGING_BUFFERS ? staging_semaphores[index] : NULL;
+}
+
+static bool bsp_display_staging_done(void* user_ctx) {
+    size_t index = (bsp_display_staging_callback_t*)user_ctx - staging_callbacks;
+
+    // The next holder of the buffer may set its own callback as soon as the buffer is released
+    bsp_display_staging_callback_t done  = staging_callbacks[index];
+    BaseType_t                     woken = pdFALSE;
+    xSemaphoreGiveFromISR(staging_semaphores[index], &woken);
+    bool need_yield = done.callback != NULL && done.callback(done.user_ctx);
+    return need_yield || woken == pdTRUE;
+}
+
+esp_err_t bsp_display_staging_get(uint8_t** out_buffer, size_t* out_size) {
+    ESP_RETURN_ON_FALSE(out_buffer && out_size, ESP_ERR_INVALID_ARG, TAG, "Output argument is NULL");
+    ESP_RETURN_ON_ERROR(bsp_display_staging_initialize(), TAG, "Failed to initialize staging buffers");
+
+    // Concurrent callers are handed different buffers, each waits until its own buffer has been sent
+    portENTER_CRITICAL(&staging_lock);
+    size_t index = staging_next;
+    staging_next = (staging_next + 1) % BSP_DISPLAY_STAGING_BUFFERS;
+    portEXIT_CRITICAL(&staging_lock);
+    if (xSemaphoreTake(staging_semaphores[index], pdMS_TO_TICKS(1000)) != pdTRUE) {
+        ESP_LOGE(TAG, "Timeout while waiting for staging buffer");
+        return ESP_ERR_TIMEOUT;
+    }
+
+    *out_buffer = staging_buffers[index];
+    *out_size   = staging_size;
+    return ESP_OK;
+}
+
+esp_err_t bsp_display_staging_get_scratch(const uint8_t* buffer, size_t size, uint8_t** out_scratch) {
+    ESP_RETURN_ON_FALSE(out_scratch, ESP_ERR_INVALID_ARG, TAG, "Output argument is NULL");
+    size_t index = bsp_display_staging_index(buffer);
+    ESP_RETURN_ON_FALSE(index < BSP_DISPLAY_STAGING_BUFFERS, ESP_ERR_INVALID_ARG, TAG, "Not a staging buffer");
+
+    if (staging_scratch_size[index] < size) {
+        heap_caps_free(staging_scratch[index]);
+        staging_scratch[index]      = heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        staging_scratch_size[index] = staging_scratch[index] != NULL ? size : 0;
+        ESP_RETURN_ON_FALSE(staging_scratch[index], ESP_ERR_NO_MEM, TAG, "Failed to allocate scratch buffer");
+    }
+    *out_scratch = staging_scratch[index];
+    return ESP_OK;
+}
+
+esp_err_t bsp_display_staging_blit(uint8_t* buffer, size_t x_start, size_t y_start, size_t x_end, size_t y_end) {
+    return bsp_display_staging_blit_with_callback(buffer, x_start, y_start, x_end, y_end, NULL, NULL);
+}
+
+esp_err_t bsp_display_staging_blit_with_callback(uint8_t* buffer, size_t x_start, size_t y_start, size_t x_end,
+                                                 size_t y_end, bsp_display_blit_done_cb_t callback, void* user_ctx) {
+    size_t index = bsp_display_staging_index(buffer);
+    ESP_RETURN_ON_FALSE(index < BSP_DISPLAY_STAGING_BUFFERS, ESP_ERR_INVALID_ARG, TAG, "Not a staging buffer");
+
+    staging_callbacks[index] = (bsp_display_staging_callback_t){callback, user_ctx};
+
+    esp_err_t res = bsp_display_blit_async(x_start, y_start, x_end, y_end, buffer, bsp_display_staging_done,
+                                           &staging_callbacks[index]);
+    if (res != ESP_OK) {
+        xSemaphoreGive(staging_semaphores[index]);  // The buffer was never handed to the driver
+    }
+    return res;
+}
+
+void bsp_display_staging_release(uint8_t* buffer) {
+    SemaphoreHandle_t semaphore = bsp_display_staging_semaphore(buffer);
+    if (semaphore != NULL) {
+        xSemaphoreGive(semaphore);
+    }
+}
@@ -0,0 +1,36 @@
+// Board support package API: Display staging buffers
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "bsp/display.h"
+#include "esp_err.h"
+
+// Make every staging buffer hold at least the given number of full width rows, 8 unless a target asks for more
+// Call before the first staging buffer is used, the buffers are allocated once
+esp_err_t bsp_display_staging_set_rows(size_t rows);
+
+// Wait for the next DMA capable staging buffer to be released by the display driver
+// The buffer holds a number of full width rows in the color format of the display and belongs to the caller until it
+// is passed to bsp_display_staging_blit or bsp_display_staging_release, so tasks may stage blits concurrently
+esp_err_t bsp_display_staging_get(uint8_t** out_buffer, size_t* out_size);
+
+// Get a scratch buffer of at least size bytes in internal memory that belongs to a buffer returned by
+// bsp_display_staging_get, for preparing its pixels. It is owned together with the staging buffer, so tasks staging
+// blits concurrently each have their own. It is kept for the next holder of the staging buffer and grows when needed.
+esp_err_t bsp_display_staging_get_scratch(const uint8_t* buffer, size_t size, uint8_t** out_scratch);
+
+// Queue a buffer returned by bsp_display_staging_get for the given region
+// The buffer is released again once the transfer has completed
+esp_err_t bsp_display_staging_blit(uint8_t* buffer, size_t x_start, size_t y_start, size_t x_end, size_t y_end);
+
+// Queue a buffer like bsp_display_staging_blit and call the callback from the transfer done interrupt once the buffer
+// has been released, to complete a blit that was sent in several strips with the last one
+esp_err_t bsp_display_staging_blit_with_callback(uint8_t* buffer, size_t x_start, size_t y_start, size_t x_end,
+                                                 size_t y_end, bsp_display_blit_done_cb_t callback, void* user_ctx);
+
+// Release a buffer returned by bsp_display_staging_get without sending it
+void bsp_display_staging_release(uint8_t* buffer);
@@ -0,0 +1,151 @@
+// Board support package API: Display pipeline statistics implementation
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include "badge_bsp_display_stats.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "bsp/display.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+
+static char const* TAG = "BSP display stats";
+
+#if CONFIG_BSP_DISPLAY_STATS
+
+// Number of most recent samples the percentiles are calculated over
+#define BSP_DISPLAY_STATS_SAMPLES 64
+
+typedef struct {
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t total_us;
+    uint64_t count;
+    uint32_t samples[BSP_DISPLAY_STATS_SAMPLES];
+    size_t   next_sample;
+} bsp_display_stats_timing_t;
+
+static portMUX_TYPE               stats_lock           = portMUX_INITIALIZER_UNLOCKED;
+static uint64_t                   stats_blits          = 0;
+static uint64_t                   stats_pixels         = 0;
+static uint64_t                   stats_bytes          = 0;
+static uint32_t                   stats_flush_timeouts = 0;
+static bsp_display_stats_timing_t stats_wait           = {0};
+static bsp_display_stats_timing_t stats_submit         = {0};
+static size_t                     stats_bpp            = 0;
+
+static void bsp_display_stats_add_sample(bsp_display_stats_timing_t* timing, int64_t duration) {
+    uint32_t value = duration < 0 ? 0 : (duration > UINT32_MAX ? UINT32_MAX : (uint32_t)duration);
+    if (timing->count == 0 || value < timing->min_us) {
+        timing->min_us = value;
+    }
+    if (value > timing->max_us) {
+        timing->max_us = value;
+    }
+    timing->total_us                      += value;
+    timing->count                         += 1;
+    timing->samples[timing->next_sample]   = value;
+    timing->next_sample                    = (timing->next_sample + 1) % BSP_DISPLAY_STATS_SAMPLES;
+}
+
+void bsp_display_stats_record_wait(int64_t start, bool timed_out) {
+    int64_t duration = esp_timer_get_time() - start;
+    portENTER_CRITICAL(&stats_lock);
+    bsp_display_stats_add_sample(&stats_wait, duration);
+    if (timed_out) {
+        stats_flush_timeouts++;
+    }
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+void bsp_display_stats_record_blit(size_t x_start, size_t y_start, size_t x_end, size_t y_end, int64_t start) {
+    int64_t duration = esp_timer_get_time() - start;
+
+    if (stats_bpp == 0) {
+        bsp_display_color_format_t color_fmt;
+        if (bsp_display_get_parameters(NULL, NULL, &color_fmt, NULL) == ESP_OK) {
+            stats_bpp = bsp_display_get_bits_per_pixel(color_fmt);
+        }
+    }
+
+    size_t pixels = x_end > x_start && y_end > y_start ? (x_end - x_start) * (y_end - y_start) : 0;
+    portENTER_CRITICAL(&stats_lock);
+    stats_blits++;
+    stats_pixels += pixels;
+    stats_bytes  += (pixels * stats_bpp + 7) / 8;
+    bsp_display_stats_add_sample(&stats_submit, duration);
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+static void bsp_display_stats_summarize(const bsp_display_stats_timing_t* timing, bsp_display_timing_stats_t* out) {
+    memset(out, 0, sizeof(bsp_display_timing_stats_t));
+    if (timing->count == 0) {
+        return;
+    }
+    out->min_us = timing->min_us;
+    out->max_us = timing->max_us;
+    out->avg_us = timing->total_us / timing->count;
+
+    size_t   count = timing->count < BSP_DISPLAY_STATS_SAMPLES ? timing->count : BSP_DISPLAY_STATS_SAMPLES;
+    uint32_t sorted[BSP_DISPLAY_STATS_SAMPLES];
+    memcpy(sorted, timing->samples, count * sizeof(uint32_t));
+    for (size_t i = 1; i < count; i++) {
+        uint32_t value = sorted[i];
+        size_t   j     = i;
+        while (j > 0 && sorted[j - 1] > value) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = value;
+    }
+    out->p50_us = sorted[(count - 1) * 50 / 100];
+    out->p90_us = sorted[(count - 1) * 90 / 100];
+    out->p99_us = sorted[(count - 1) * 99 / 100];
+}
+
+esp_err_t bsp_display_get_stats(bsp_display_stats_t* out_stats) {
+    ESP_RETURN_ON_FALSE(out_stats, ESP_ERR_INVALID_ARG, TAG, "Stats output argument is NULL");
+
+    bsp_display_stats_timing_t wait;
+    bsp_display_stats_timing_t submit;
+    portENTER_CRITICAL(&stats_lock);
+    out_stats->blits          = stats_blits;
+    out_stats->pixels         = stats_pixels;
+    out_stats->bytes          = stats_bytes;
+    out_stats->flush_timeouts = stats_flush_timeouts;
+    out_stats->wait_time_us   = stats_wait.total_us;
+    wait                      = stats_wait;
+    submit                    = stats_submit;
+    portEXIT_CRITICAL(&stats_lock);
+
+    bsp_display_stats_summarize(&wait, &out_stats->wait);
+    bsp_display_stats_summarize(&submit, &out_stats->submit);
+    return ESP_OK;
+}
+
+void bsp_display_reset_stats(void) {
+    portENTER_CRITICAL(&stats_lock);
+    stats_blits          = 0;
+    stats_pixels         = 0;
+    stats_bytes          = 0;
+    stats_flush_timeouts = 0;
+    memset(&stats_wait, 0, sizeof(stats_wait));
+    memset(&stats_submit, 0, sizeof(stats_submit));
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+#else
+
+esp_err_t bsp_display_get_stats(bsp_display_stats_t* out_stats) {
+    ESP_LOGD(TAG, "Display statistics are disabled, enable CONFIG_BSP_DISPLAY_STATS");
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void bsp_display_reset_stats(void) {
+}
+
+#endif
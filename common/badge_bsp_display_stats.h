@@ -0,0 +1,47 @@
+// Board support package API: Display pipeline statistics
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "sdkconfig.h"
+
+#if CONFIG_BSP_DISPLAY_STATS
+
+#include "esp_timer.h"
+
+// Timestamp to pass as start to the functions below
+static inline int64_t bsp_display_stats_now(void) {
+    return esp_timer_get_time();
+}
+
+// Record the time blocked waiting for a previous transfer to complete
+void bsp_display_stats_record_wait(int64_t start, bool timed_out);
+
+// Record a blit of the given region, start is the moment the transfer was handed to the driver
+void bsp_display_stats_record_blit(size_t x_start, size_t y_start, size_t x_end, size_t y_end, int64_t start);
+
+#else
+
+static inline int64_t bsp_display_stats_now(void) {
+    return 0;
+}
+
+static inline void bsp_display_stats_record_wait(int64_t start, bool timed_out) {
+    (void)start;
+    (void)timed_out;
+}
+
+static inline void bsp_display_stats_record_blit(size_t x_start, size_t y_start, size_t x_end, size_t y_end,
+                                                 int64_t start) {
+    (void)x_start;
+    (void)y_start;
+    (void)x_end;
+    (void)y_end;
+    (void)start;
+}
+
+#endif
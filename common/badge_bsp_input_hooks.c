@@ -3,19 +3,59 @@
 // SPDX-License-Identifier: MIT
 
 #include "badge_bsp_input_hooks.h"
+#include <stdatomic.h>
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "badge_bsp_input_state.h"
 #include "bsp/input.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
+#include "freertos/task.h"
 
 typedef struct {
     bsp_input_hook_cb_t callback;
     void*               user_data;
-    bool                in_use;
+    uint32_t            event_types;
+    uint64_t            navigation_keys;
 } bsp_input_hook_entry_t;
 
-static bsp_input_hook_entry_t input_hooks[BSP_INPUT_MAX_HOOKS] = {0};
-static SemaphoreHandle_t      input_hooks_mutex                = NULL;
+typedef struct {
+    bsp_input_hook_entry_t entry;
+    int                    priority;
+    bool                   in_use;
+} bsp_input_hook_registration_t;
+
+// Registrations by hook ID and the dispatch order, only accessed with the mutex held
+static bsp_input_hook_registration_t input_hooks[BSP_INPUT_MAX_HOOKS] = {0};
+static int                           input_hook_order[BSP_INPUT_MAX_HOOKS];
+static size_t                        input_hook_order_count = 0;
+static SemaphoreHandle_t             input_hooks_mutex      = NULL;
+
+// Dispatch table in priority order, published by writers under the sequence number, dispatch copies the table and
+// retries if the sequence number was odd (write in progress) or changed while copying
+static bsp_input_hook_entry_t input_hook_table[BSP_INPUT_MAX_HOOKS];
+static size_t                 input_hook_table_count = 0;
+static atomic_uint            input_hooks_sequence   = 0;
+static portMUX_TYPE           input_hooks_lock       = portMUX_INITIALIZER_UNLOCKED;
+
+// Dispatches in progress, counted by the parity of the epoch they started in. Unregistering a hook starts a new epoch
+// and waits for the dispatches counted under the previous one, after that no dispatch can still offer an event to it.
+static atomic_uint input_hooks_epoch     = 0;
+static atomic_uint input_hooks_active[2] = {0};
+
+// Dispatches of tasks in progress and the epoch parity they are counted under, so that a hook unregistering a hook does
+// not wait for the dispatch it was called from. The entries live on the stack of the dispatching task and are linked
+// under the lock, any number of tasks can dispatch at the same time. Dispatches from interrupts are only counted.
+typedef struct input_hooks_dispatch {
+    TaskHandle_t                 task;
+    unsigned int                 parity;
+    struct input_hooks_dispatch* next;
+} input_hooks_dispatch_t;
+
+static input_hooks_dispatch_t* input_hooks_dispatches    = NULL;
+static portMUX_TYPE            input_hooks_dispatch_lock = portMUX_INITIALIZER_UNLOCKED;
 
 void bsp_input_hooks_initialize(void) {
     if (input_hooks_mutex == NULL) {
@@ -23,30 +63,154 @@ void bsp_input_hooks_initialize(void) {
     }
 }
 
-bool bsp_input_hooks_process(bsp_input_event_t* event) {
-    if (input_hooks_mutex == NULL) {
+static inline bool hook_wants_event(bsp_input_hook_entry_t const* entry, bsp_input_event_t const* event) {
+    if (entry->event_types && (event->type >= 32 || !((entry->event_types >> event->type) & 1))) {
         return false;
     }
+    if (event->type == INPUT_EVENT_TYPE_NAVIGATION && entry->navigation_keys) {
+        uint32_t key = event->args_navigation.key;
+        return key < 64 && ((entry->navigation_keys >> key) & 1);
+    }
+    return true;
+}
 
-    bool consumed = false;
+// Copy the hooks that want the event, returns the number of hooks copied
+static size_t input_hooks_select(bsp_input_event_t const* event, bsp_input_hook_entry_t* out_hooks) {
+    unsigned int sequence;
+    size_t       count;
+    do {
+        sequence     = atomic_load_explicit(&input_hooks_sequence, memory_order_acquire);
+        count        = 0;
+        size_t total = input_hook_table_count;
+        for (size_t i = 0; i < total && i < BSP_INPUT_MAX_HOOKS; i++) {
+            if (hook_wants_event(&input_hook_table[i], event)) {
+                out_hooks[count++] = input_hook_table[i];
+            }
+        }
+        atomic_thread_fence(memory_order_acquire);
+    } while ((sequence & 1) || sequence != atomic_load_explicit(&input_hooks_sequence, memory_order_relaxed));
+    return count;
+}
 
-    if (xSemaphoreTake(input_hooks_mutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-        for (int i = 0; i < BSP_INPUT_MAX_HOOKS; i++) {
-            if (input_hooks[i].in_use && input_hooks[i].callback != NULL) {
-                if (input_hooks[i].callback(event, input_hooks[i].user_data)) {
-                    consumed = true;
-                    break;  // Event consumed, stop processing
-                }
+// Rebuild the dispatch table from the registrations and publish it, called with the mutex held
+static void input_hooks_publish(void) {
+    bsp_input_hook_entry_t table[BSP_INPUT_MAX_HOOKS];
+    for (size_t i = 0; i < input_hook_order_count; i++) {
+        table[i] = input_hooks[input_hook_order[i]].entry;
+    }
+
+    portENTER_CRITICAL(&input_hooks_lock);
+    atomic_fetch_add_explicit(&input_hooks_sequence, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(input_hook_table, table, sizeof(bsp_input_hook_entry_t) * input_hook_order_count);
+    input_hook_table_count = input_hook_order_count;
+    atomic_fetch_add_explicit(&input_hooks_sequence, 1, memory_order_release);
+    portEXIT_CRITICAL(&input_hooks_lock);
+}
+
+// Whether the hook is still in the dispatch table
+static bool input_hooks_contains(bsp_input_hook_entry_t const* entry) {
+    unsigned int sequence;
+    bool         found;
+    do {
+        sequence     = atomic_load_explicit(&input_hooks_sequence, memory_order_acquire);
+        found        = false;
+        size_t total = input_hook_table_count;
+        for (size_t i = 0; i < total && i < BSP_INPUT_MAX_HOOKS && !found; i++) {
+            bsp_input_hook_entry_t const* hook = &input_hook_table[i];
+            if (hook->callback == entry->callback && hook->user_data == entry->user_data) {
+                found = true;
             }
         }
-        xSemaphoreGive(input_hooks_mutex);
+        atomic_thread_fence(memory_order_acquire);
+    } while ((sequence & 1) || sequence != atomic_load_explicit(&input_hooks_sequence, memory_order_relaxed));
+    return found;
+}
+
+// Count a dispatch under the current epoch, the epoch is read again after counting so a dispatch is never counted under
+// an epoch that an unregister has already stopped waiting for
+static unsigned int input_hooks_enter(void) {
+    while (true) {
+        unsigned int epoch = atomic_load(&input_hooks_epoch);
+        atomic_fetch_add(&input_hooks_active[epoch & 1], 1);
+        if (atomic_load(&input_hooks_epoch) == epoch) {
+            return epoch;
+        }
+        atomic_fetch_sub(&input_hooks_active[epoch & 1], 1);
     }
+}
 
+static void input_hooks_track(input_hooks_dispatch_t* dispatch) {
+    portENTER_CRITICAL(&input_hooks_dispatch_lock);
+    dispatch->next         = input_hooks_dispatches;
+    input_hooks_dispatches = dispatch;
+    portEXIT_CRITICAL(&input_hooks_dispatch_lock);
+}
+
+static void input_hooks_untrack(input_hooks_dispatch_t* dispatch) {
+    portENTER_CRITICAL(&input_hooks_dispatch_lock);
+    input_hooks_dispatch_t** link = &input_hooks_dispatches;
+    while (*link != dispatch) {
+        link = &(*link)->next;
+    }
+    *link = dispatch->next;
+    portEXIT_CRITICAL(&input_hooks_dispatch_lock);
+}
+
+bool bsp_input_hooks_process(bsp_input_event_t* event) {
+    // Track the key state before offering the event, consumed events still change the state of the keyboard
+    bsp_input_state_update(event);
+
+    unsigned int           epoch    = input_hooks_enter();
+    unsigned int           parity   = epoch & 1;
+    bool                   tracked  = !xPortInIsrContext();
+    input_hooks_dispatch_t dispatch = {.parity = parity};
+    if (tracked) {
+        dispatch.task = xTaskGetCurrentTaskHandle();
+        input_hooks_track(&dispatch);
+    }
+
+    bsp_input_hook_entry_t hooks[BSP_INPUT_MAX_HOOKS];
+    size_t                 count    = input_hooks_select(event, hooks);
+    bool                   consumed = false;
+    for (size_t i = 0; i < count && !consumed; i++) {
+        // An unregister from a hook of this dispatch does not wait for it, skip the hooks it removed
+        if (atomic_load(&input_hooks_epoch) != epoch && !input_hooks_contains(&hooks[i])) {
+            continue;
+        }
+        consumed = hooks[i].callback(event, hooks[i].user_data);  // A consumed event is not offered to other hooks
+    }
+
+    if (tracked) {
+        input_hooks_untrack(&dispatch);
+    }
+    atomic_fetch_sub(&input_hooks_active[parity], 1);
     return consumed;
 }
 
-int bsp_input_hook_register(bsp_input_hook_cb_t callback, void* user_data) {
-    if (callback == NULL || input_hooks_mutex == NULL) {
+// Start a new epoch and wait until the dispatches of the previous one are done, called with the mutex held after the
+// table without the hook was published
+static void input_hooks_wait_for_dispatches(void) {
+    unsigned int parity = atomic_fetch_add(&input_hooks_epoch, 1) & 1;
+
+    // A dispatch of the calling task is waiting for this function to return
+    unsigned int own  = 0;
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    portENTER_CRITICAL(&input_hooks_dispatch_lock);
+    for (input_hooks_dispatch_t const* dispatch = input_hooks_dispatches; dispatch != NULL; dispatch = dispatch->next) {
+        if (dispatch->task == task && dispatch->parity == parity) {
+            own++;
+        }
+    }
+    portEXIT_CRITICAL(&input_hooks_dispatch_lock);
+
+    while (atomic_load(&input_hooks_active[parity]) > own) {
+        vTaskDelay(1);
+    }
+}
+
+int bsp_input_hook_register_with_config(bsp_input_hook_config_t const* config) {
+    if (config == NULL || config->callback == NULL || input_hooks_mutex == NULL) {
         return -1;
     }
 
@@ -55,28 +219,60 @@ int bsp_input_hook_register(bsp_input_hook_cb_t callback, void* user_data) {
     if (xSemaphoreTake(input_hooks_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
         for (int i = 0; i < BSP_INPUT_MAX_HOOKS; i++) {
             if (!input_hooks[i].in_use) {
-                input_hooks[i].callback  = callback;
-                input_hooks[i].user_data = user_data;
-                input_hooks[i].in_use    = true;
-                hook_id                  = i;
+                input_hooks[i].entry.callback        = config->callback;
+                input_hooks[i].entry.user_data       = config->user_data;
+                input_hooks[i].entry.event_types     = config->event_types;
+                input_hooks[i].entry.navigation_keys = config->navigation_keys;
+                input_hooks[i].priority              = config->priority;
+                input_hooks[i].in_use                = true;
+                hook_id                              = i;
                 break;
             }
         }
+        if (hook_id >= 0) {
+            // Insert after all hooks with the same or a higher priority, hooks with equal priority keep their
+            // registration order
+            size_t position = input_hook_order_count;
+            while (position > 0 && input_hooks[input_hook_order[position - 1]].priority < config->priority) {
+                input_hook_order[position] = input_hook_order[position - 1];
+                position--;
+            }
+            input_hook_order[position] = hook_id;
+            input_hook_order_count++;
+            input_hooks_publish();
+        }
         xSemaphoreGive(input_hooks_mutex);
     }
 
     return hook_id;
 }
 
+int bsp_input_hook_register(bsp_input_hook_cb_t callback, void* user_data) {
+    bsp_input_hook_config_t config = {
+        .callback  = callback,
+        .user_data = user_data,
+    };
+    return bsp_input_hook_register_with_config(&config);
+}
+
 void bsp_input_hook_unregister(int hook_id) {
     if (hook_id < 0 || hook_id >= BSP_INPUT_MAX_HOOKS || input_hooks_mutex == NULL) {
         return;
     }
 
     if (xSemaphoreTake(input_hooks_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        input_hooks[hook_id].callback  = NULL;
-        input_hooks[hook_id].user_data = NULL;
-        input_hooks[hook_id].in_use    = false;
+        if (input_hooks[hook_id].in_use) {
+            size_t position = 0;
+            for (size_t i = 0; i < input_hook_order_count; i++) {
+                if (input_hook_order[i] != hook_id) {
+                    input_hook_order[position++] = input_hook_order[i];
+                }
+            }
+            input_hook_order_count = position;
+            memset(&input_hooks[hook_id], 0, sizeof(bsp_input_hook_registration_t));
+            input_hooks_publish();
+            input_hooks_wait_for_dispatches();
+        }
         xSemaphoreGive(input_hooks_mutex);
     }
 }
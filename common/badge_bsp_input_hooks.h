@@ -11,6 +11,6 @@
 // Maximum number of input hooks
 #define BSP_INPUT_MAX_HOOKS 8
 
-// Process an event through all registered hooks
+// Process an event through all registered hooks, also updates the input state snapshot
 // Returns true if any hook consumed the event (should not be queued)
 bool bsp_input_hooks_process(bsp_input_event_t* event);
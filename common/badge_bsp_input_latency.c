@@ -0,0 +1,93 @@
+// Board support package API: Input latency tracing implementation
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include "badge_bsp_input_latency.h"
+#include <stdint.h>
+#include <string.h>
+#include "bsp/input.h"
+#include "esp_attr.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "sdkconfig.h"
+
+static char const* TAG = "BSP input latency";
+
+#if CONFIG_BSP_INPUT_LATENCY_STATS
+
+static portMUX_TYPE              latency_lock  = portMUX_INITIALIZER_UNLOCKED;
+static bsp_input_latency_stats_t latency_stats = {0};
+
+static IRAM_ATTR void bsp_input_latency_add_sample(bsp_input_latency_histogram_t* histogram, int64_t duration) {
+    uint32_t value  = duration < 0 ? 0 : (duration > UINT32_MAX ? UINT32_MAX : (uint32_t)duration);
+    size_t   bucket = value < 2 ? 0 : 31 - __builtin_clz(value);
+    if (bucket >= BSP_INPUT_LATENCY_HISTOGRAM_BUCKETS) {
+        bucket = BSP_INPUT_LATENCY_HISTOGRAM_BUCKETS - 1;
+    }
+    if (value > histogram->max_us) {
+        histogram->max_us = value;
+    }
+    histogram->total_us          += value;
+    histogram->count             += 1;
+    histogram->histogram[bucket] += 1;
+}
+
+#endif
+
+IRAM_ATTR void bsp_input_latency_record_enqueue(bsp_input_event_t* event) {
+    int64_t now = esp_timer_get_time();
+    if (event->timestamp == 0) {
+        event->timestamp = now;
+    }
+    event->queued_timestamp = now;
+#if CONFIG_BSP_INPUT_LATENCY_STATS
+    portENTER_CRITICAL_SAFE(&latency_lock);
+    bsp_input_latency_add_sample(&latency_stats.source_to_enqueue, now - event->timestamp);
+    portEXIT_CRITICAL_SAFE(&latency_lock);
+#endif
+}
+
+#if CONFIG_BSP_INPUT_LATENCY_STATS
+
+void bsp_input_record_dequeue(bsp_input_event_t const* event) {
+    if (event == NULL || event->queued_timestamp == 0) {
+        return;
+    }
+    int64_t duration = esp_timer_get_time() - event->queued_timestamp;
+    portENTER_CRITICAL(&latency_lock);
+    bsp_input_latency_add_sample(&latency_stats.enqueue_to_dequeue, duration);
+    portEXIT_CRITICAL(&latency_lock);
+}
+
+esp_err_t bsp_input_get_latency_stats(bsp_input_latency_stats_t* out_stats) {
+    ESP_RETURN_ON_FALSE(out_stats, ESP_ERR_INVALID_ARG, TAG, "Stats output argument is NULL");
+    portENTER_CRITICAL(&latency_lock);
+    *out_stats = latency_stats;
+    portEXIT_CRITICAL(&latency_lock);
+    return ESP_OK;
+}
+
+void bsp_input_reset_latency_stats(void) {
+    portENTER_CRITICAL(&latency_lock);
+    memset(&latency_stats, 0, sizeof(latency_stats));
+    portEXIT_CRITICAL(&latency_lock);
+}
+
+#else
+
+void bsp_input_record_dequeue(bsp_input_event_t const* event) {
+    (void)event;
+}
+
+esp_err_t bsp_input_get_latency_stats(bsp_input_latency_stats_t* out_stats) {
+    ESP_LOGD(TAG, "Input latency statistics are disabled, enable CONFIG_BSP_INPUT_LATENCY_STATS");
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void bsp_input_reset_latency_stats(void) {
+}
+
+#endif
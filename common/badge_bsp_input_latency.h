@@ -0,0 +1,11 @@
+// Board support package API: Input latency tracing
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "bsp/input.h"
+
+// Stamp an event right before it is queued and record the time since it was generated, safe to call from an ISR
+// Events without a generation timestamp are stamped as generated now
+void bsp_input_latency_record_enqueue(bsp_input_event_t* event);
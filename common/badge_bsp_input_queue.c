@@ -0,0 +1,490 @@
+// Board support package API: Input event queue implementation
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include "badge_bsp_input_queue.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "badge_bsp_input_latency.h"
+#include "bsp/input.h"
+#include "esp_attr.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+
+static char const* TAG = "BSP input queue";
+
+#define INPUT_QUEUE_DEPTH CONFIG_BSP_INPUT_QUEUE_DEPTH
+#define INPUT_QUEUE_MASK  (INPUT_QUEUE_DEPTH - 1)
+
+_Static_assert((INPUT_QUEUE_DEPTH & INPUT_QUEUE_MASK) == 0, "CONFIG_BSP_INPUT_QUEUE_DEPTH must be a power of two");
+
+#define INPUT_QUEUE_ADAPTER_STACK_SIZE 2048
+#define INPUT_QUEUE_ADAPTER_PRIORITY   (configMAX_PRIORITIES - 2)
+
+// Number of tasks bsp_input_get_events keeps coalescing apart
+#define INPUT_QUEUE_COALESCE_CALLERS 4
+
+#if defined(CONFIG_BSP_INPUT_QUEUE_OVERFLOW_DROP_OLDEST)
+#define INPUT_QUEUE_DEFAULT_POLICY BSP_INPUT_OVERFLOW_DROP_OLDEST
+#elif defined(CONFIG_BSP_INPUT_QUEUE_OVERFLOW_BLOCK)
+#define INPUT_QUEUE_DEFAULT_POLICY BSP_INPUT_OVERFLOW_BLOCK
+#else
+#define INPUT_QUEUE_DEFAULT_POLICY BSP_INPUT_OVERFLOW_DROP_NEWEST
+#endif
+
+// Bounded multi-producer queue (Vyukov): producers and consumers claim a position with a compare and swap on the tail
+// or head, the sequence number of a slot tells whether it is free to fill or ready to take at that position. Slot i
+// stores its sequence number minus i, so the zero initialized ring is valid before bsp_input_queue_initialize runs.
+typedef struct {
+    atomic_uint       sequence;
+    bsp_input_event_t event;
+} input_queue_slot_t;
+
+static input_queue_slot_t queue_slots[INPUT_QUEUE_DEPTH] = {0};
+static atomic_uint        queue_head                     = 0;
+static atomic_uint        queue_tail                     = 0;
+static atomic_int         queue_policy                   = INPUT_QUEUE_DEFAULT_POLICY;
+
+static atomic_uint stats_queued         = 0;
+static atomic_uint stats_dropped_newest = 0;
+static atomic_uint stats_dropped_oldest = 0;
+static atomic_uint stats_blocked        = 0;
+static atomic_uint stats_high_water     = 0;
+
+static SemaphoreHandle_t queue_mutex      = NULL;  // Serializes creating the adapter
+static SemaphoreHandle_t space_semaphore  = NULL;  // Given when an event is taken while producers wait for room
+static atomic_uint       space_waiters    = 0;
+static SemaphoreHandle_t events_semaphore = NULL;  // Given when an event is queued while a receiver waits
+static atomic_bool       receiver_waiting = false;
+
+// Event coalescing for bsp_input_get_events, every calling task is paced by the events it received itself. A task
+// pushed out of the table by other callers is treated like a task that has been quiet.
+typedef struct {
+    TaskHandle_t task;
+    TickType_t   last_delivery;
+} input_queue_caller_t;
+
+static atomic_uint          coalesce_interval_ms                           = 0;
+static input_queue_caller_t coalesce_callers[INPUT_QUEUE_COALESCE_CALLERS] = {0};
+static portMUX_TYPE         coalesce_lock                                  = portMUX_INITIALIZER_UNLOCKED;
+
+// FreeRTOS queue adapter, the adapter task moves events from the ring to the queue
+static QueueHandle_t adapter_queue = NULL;
+static TaskHandle_t  adapter_task  = NULL;
+
+static IRAM_ATTR bool input_queue_push(bsp_input_event_t const* event) {
+    uint32_t position = atomic_load_explicit(&queue_tail, memory_order_relaxed);
+    while (true) {
+        uint32_t            index    = position & INPUT_QUEUE_MASK;
+        input_queue_slot_t* slot     = &queue_slots[index];
+        uint32_t            sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire) + index;
+        int32_t             diff     = (int32_t)(sequence - position);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&queue_tail, &position, position + 1, memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                slot->event = *event;
+                atomic_store_explicit(&slot->sequence, position + 1 - index, memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;  // Full
+        } else {
+            position = atomic_load_explicit(&queue_tail, memory_order_relaxed);
+        }
+    }
+}
+
+static IRAM_ATTR bool input_queue_pop(bsp_input_event_t* out_event) {
+    uint32_t position = atomic_load_explicit(&queue_head, memory_order_relaxed);
+    while (true) {
+        uint32_t            index    = position & INPUT_QUEUE_MASK;
+        input_queue_slot_t* slot     = &queue_slots[index];
+        uint32_t            sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire) + index;
+        int32_t             diff     = (int32_t)(sequence - (position + 1));
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&queue_head, &position, position + 1, memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                *out_event = slot->event;
+                atomic_store_explicit(&slot->sequence, position + INPUT_QUEUE_DEPTH - index, memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;  // Empty, or the oldest event is still being written
+        } else {
+            position = atomic_load_explicit(&queue_head, memory_order_relaxed);
+        }
+    }
+}
+
+static IRAM_ATTR void input_queue_raise_high_water(uint32_t pending) {
+    uint32_t high_water = atomic_load_explicit(&stats_high_water, memory_order_relaxed);
+    while (pending > high_water && pending <= INPUT_QUEUE_DEPTH &&
+           !atomic_compare_exchange_weak_explicit(&stats_high_water, &high_water, pending, memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+    }
+}
+
+static IRAM_ATTR void input_queue_update_high_water(void) {
+    uint32_t head = atomic_load_explicit(&queue_head, memory_order_relaxed);
+    input_queue_raise_high_water(atomic_load_explicit(&queue_tail, memory_order_relaxed) - head);
+}
+
+// Called by consumers after taking events, wakes producers waiting for room
+static void input_queue_signal_space(void) {
+    if (atomic_load_explicit(&space_waiters, memory_order_acquire) > 0 && space_semaphore != NULL) {
+        xSemaphoreGive(space_semaphore);
+    }
+}
+
+static bool input_queue_wait_and_push(bsp_input_event_t const* event) {
+    TickType_t timeout = pdMS_TO_TICKS(CONFIG_BSP_INPUT_QUEUE_BLOCK_TIMEOUT_MS);
+    TickType_t start   = xTaskGetTickCount();
+    bool       queued  = false;
+
+    atomic_fetch_add_explicit(&stats_blocked, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&space_waiters, 1, memory_order_acq_rel);
+    // Retry before every wait, room may have been made before this producer was counted as waiting
+    while (!(queued = input_queue_push(event))) {
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        if (elapsed >= timeout || xSemaphoreTake(space_semaphore, timeout - elapsed) != pdTRUE) {
+            break;
+        }
+    }
+    // Pass the wakeup on to the next waiting producer
+    if (atomic_fetch_sub_explicit(&space_waiters, 1, memory_order_acq_rel) > 1 && queued) {
+        xSemaphoreGive(space_semaphore);
+    }
+    return queued;
+}
+
+// Wake the adapter task and a receiver blocked in bsp_input_get_events, the receiver is only woken when it waits so a
+// burst of events costs it a single wakeup
+static IRAM_ATTR void input_queue_notify(bool from_isr) {
+    TaskHandle_t task = adapter_task;
+    atomic_thread_fence(memory_order_seq_cst);
+    bool       wake_receiver         = atomic_load(&receiver_waiting) && events_semaphore != NULL;
+    BaseType_t higher_priority_woken = pdFALSE;
+    if (task != NULL) {
+        if (from_isr) {
+            vTaskNotifyGiveFromISR(task, &higher_priority_woken);
+        } else {
+            xTaskNotifyGive(task);
+        }
+    }
+    if (wake_receiver) {
+        if (from_isr) {
+            xSemaphoreGiveFromISR(events_semaphore, &higher_priority_woken);
+        } else {
+            xSemaphoreGive(events_semaphore);
+        }
+    }
+    if (from_isr) {
+        portYIELD_FROM_ISR(higher_priority_woken);
+    }
+}
+
+static IRAM_ATTR bool input_queue_send(bsp_input_event_t* event, bool may_block) {
+    bool from_isr = xPortInIsrContext();
+    bsp_input_latency_record_enqueue(event);
+
+    bool queued = input_queue_push(event);
+    if (!queued) {
+        switch (atomic_load_explicit(&queue_policy, memory_order_relaxed)) {
+            case BSP_INPUT_OVERFLOW_DROP_OLDEST: {
+                // Other producers can take the room made here, give up after a few attempts
+                bsp_input_event_t oldest;
+                for (int attempt = 0; attempt < 4 && !queued; attempt++) {
+                    if (input_queue_pop(&oldest)) {
+                        atomic_fetch_add_explicit(&stats_dropped_oldest, 1, memory_order_relaxed);
+                    }
+                    queued = input_queue_push(event);
+                }
+                break;
+            }
+            case BSP_INPUT_OVERFLOW_BLOCK:
+                // Interrupt handlers can not wait, their events are dropped like with the drop newest policy
+                if (may_block && !from_isr && space_semaphore != NULL) {
+                    queued = input_queue_wait_and_push(event);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (!queued) {
+        atomic_fetch_add_explicit(&stats_dropped_newest, 1, memory_order_relaxed);
+        return false;
+    }
+
+    atomic_fetch_add_explicit(&stats_queued, 1, memory_order_relaxed);
+    input_queue_update_high_water();
+    input_queue_notify(from_isr);
+    return true;
+}
+
+IRAM_ATTR bool bsp_input_queue_send(bsp_input_event_t* event) {
+    return input_queue_send(event, true);
+}
+
+bool bsp_input_queue_try_send(bsp_input_event_t* event) {
+    return input_queue_send(event, false);
+}
+
+size_t bsp_input_queue_receive(bsp_input_event_t* out_events, size_t max) {
+    size_t count = 0;
+    while (count < max && input_queue_pop(&out_events[count])) {
+        count++;
+    }
+    if (count > 0) {
+        input_queue_signal_space();
+    }
+    return count;
+}
+
+// Once the adapter exists its queue holds the oldest pending events, so the overflow policy is applied to that queue:
+// drop oldest drops the oldest of all pending events and the ring only passes events on
+static void input_queue_adapter_forward(bsp_input_event_t const* event) {
+    if (xQueueSend(adapter_queue, event, 0) != pdTRUE) {
+        bool queued = false;
+        switch (atomic_load_explicit(&queue_policy, memory_order_relaxed)) {
+            case BSP_INPUT_OVERFLOW_DROP_OLDEST: {
+                // The application can take events in between, give up after a few attempts
+                bsp_input_event_t oldest;
+                for (int attempt = 0; attempt < 4 && !queued; attempt++) {
+                    if (xQueueReceive(adapter_queue, &oldest, 0) == pdTRUE) {
+                        atomic_fetch_add_explicit(&stats_dropped_oldest, 1, memory_order_relaxed);
+                    }
+                    queued = xQueueSend(adapter_queue, event, 0) == pdTRUE;
+                }
+                break;
+            }
+            case BSP_INPUT_OVERFLOW_BLOCK:
+                // Producers wait for room in the ring while the adapter waits for room here
+                queued = xQueueSend(adapter_queue, event, portMAX_DELAY) == pdTRUE;
+                break;
+            default:
+                break;
+        }
+        if (!queued) {
+            // Counted like an event the ring had no room for
+            atomic_fetch_sub_explicit(&stats_queued, 1, memory_order_relaxed);
+            atomic_fetch_add_explicit(&stats_dropped_newest, 1, memory_order_relaxed);
+            return;
+        }
+    }
+    input_queue_raise_high_water(uxQueueMessagesWaiting(adapter_queue));
+}
+
+static void input_queue_adapter_task(void* arg) {
+    (void)arg;
+    bsp_input_event_t event;
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (input_queue_pop(&event)) {
+            input_queue_signal_space();
+            input_queue_adapter_forward(&event);
+        }
+    }
+}
+
+esp_err_t bsp_input_queue_initialize(void) {
+    if (queue_mutex == NULL) {
+        queue_mutex = xSemaphoreCreateMutex();
+        ESP_RETURN_ON_FALSE(queue_mutex, ESP_ERR_NO_MEM, TAG, "Failed to create input queue mutex");
+    }
+    if (space_semaphore == NULL) {
+        space_semaphore = xSemaphoreCreateBinary();
+        ESP_RETURN_ON_FALSE(space_semaphore, ESP_ERR_NO_MEM, TAG, "Failed to create input queue semaphore");
+    }
+    if (events_semaphore == NULL) {
+        events_semaphore = xSemaphoreCreateBinary();
+        ESP_RETURN_ON_FALSE(events_semaphore, ESP_ERR_NO_MEM, TAG, "Failed to create input event semaphore");
+    }
+    return ESP_OK;
+}
+
+esp_err_t bsp_input_queue_get_handle(QueueHandle_t* out_queue) {
+    ESP_RETURN_ON_FALSE(out_queue, ESP_ERR_INVALID_ARG, TAG, "Queue output argument is NULL");
+    ESP_RETURN_ON_FALSE(queue_mutex, ESP_FAIL, TAG, "Input queue is not initialized");
+
+    esp_err_t res = ESP_OK;
+    xSemaphoreTake(queue_mutex, portMAX_DELAY);
+    if (adapter_queue == NULL) {
+        adapter_queue = xQueueCreate(INPUT_QUEUE_DEPTH, sizeof(bsp_input_event_t));
+        if (adapter_queue == NULL) {
+            res = ESP_ERR_NO_MEM;
+        } else if (xTaskCreate(input_queue_adapter_task, "BSP input queue", INPUT_QUEUE_ADAPTER_STACK_SIZE, NULL,
+                               INPUT_QUEUE_ADAPTER_PRIORITY, &adapter_task) != pdPASS) {
+            vQueueDelete(adapter_queue);
+            adapter_queue = NULL;
+            res           = ESP_ERR_NO_MEM;
+        } else {
+            // Move the events queued before the adapter existed
+            xTaskNotifyGive(adapter_task);
+        }
+    }
+    xSemaphoreGive(queue_mutex);
+    ESP_RETURN_ON_ERROR(res, TAG, "Failed to create input queue adapter");
+
+    *out_queue = adapter_queue;
+    return ESP_OK;
+}
+
+// Take pending events without blocking, from the adapter queue once it exists as it then holds the oldest events
+static size_t input_queue_take(bsp_input_event_t* out_events, size_t max) {
+    QueueHandle_t queue = adapter_queue;
+    if (queue == NULL) {
+        return bsp_input_queue_receive(out_events, max);
+    }
+    size_t count = 0;
+    while (count < max && xQueueReceive(queue, &out_events[count], 0) == pdTRUE) {
+        count++;
+    }
+    return count;
+}
+
+// Block until at least one event is pending or the timeout expires
+static size_t input_queue_wait(bsp_input_event_t* out_events, size_t max, TickType_t start, TickType_t timeout) {
+    QueueHandle_t queue = adapter_queue;
+    size_t        count = 0;
+    while (count == 0) {
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        if (timeout != portMAX_DELAY && elapsed >= timeout) {
+            break;
+        }
+        TickType_t remaining = timeout == portMAX_DELAY ? portMAX_DELAY : timeout - elapsed;
+        if (queue != NULL) {
+            if (xQueueReceive(queue, &out_events[0], remaining) != pdTRUE) {
+                break;
+            }
+            count = 1 + input_queue_take(&out_events[1], max - 1);
+        } else {
+            // Announce the wait before checking the ring again, an event queued in between gives the semaphore
+            atomic_store(&receiver_waiting, true);
+            atomic_thread_fence(memory_order_seq_cst);
+            count = bsp_input_queue_receive(out_events, max);
+            if (count == 0 && xSemaphoreTake(events_semaphore, remaining) != pdTRUE) {
+                atomic_store(&receiver_waiting, false);
+                break;
+            }
+            atomic_store(&receiver_waiting, false);
+        }
+    }
+    return count;
+}
+
+// Ticks since events were last returned to the task, or the interval if the task is not in the table
+static TickType_t input_queue_since_delivery(TaskHandle_t task, TickType_t now, TickType_t interval) {
+    TickType_t since = interval;
+    portENTER_CRITICAL(&coalesce_lock);
+    for (size_t i = 0; i < INPUT_QUEUE_COALESCE_CALLERS; i++) {
+        if (coalesce_callers[i].task == task) {
+            since = now - coalesce_callers[i].last_delivery;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&coalesce_lock);
+    return since;
+}
+
+// Entries are filled in order and never emptied, a new task takes the first free entry or else the entry of the task
+// that received events longest ago
+static void input_queue_record_delivery(TaskHandle_t task, TickType_t now) {
+    portENTER_CRITICAL(&coalesce_lock);
+    size_t slot = 0;
+    for (size_t i = 0; i < INPUT_QUEUE_COALESCE_CALLERS; i++) {
+        input_queue_caller_t const* caller = &coalesce_callers[i];
+        input_queue_caller_t const* oldest = &coalesce_callers[slot];
+        if (caller->task == task) {
+            slot = i;
+            break;
+        }
+        if (oldest->task != NULL &&
+            (caller->task == NULL || now - caller->last_delivery > now - oldest->last_delivery)) {
+            slot = i;
+        }
+    }
+    coalesce_callers[slot].task          = task;
+    coalesce_callers[slot].last_delivery = now;
+    portEXIT_CRITICAL(&coalesce_lock);
+}
+
+size_t bsp_input_get_events(bsp_input_event_t* out_events, size_t max, TickType_t timeout) {
+    if (out_events == NULL || max == 0 || events_semaphore == NULL) {
+        return 0;
+    }
+
+    TaskHandle_t task     = NULL;
+    TickType_t   start    = xTaskGetTickCount();
+    TickType_t   interval = pdMS_TO_TICKS(atomic_load_explicit(&coalesce_interval_ms, memory_order_relaxed));
+    if (interval > 0) {
+        task             = xTaskGetCurrentTaskHandle();
+        TickType_t since = input_queue_since_delivery(task, start, interval);
+        if (since < interval) {
+            // Let the events of a burst collect until the coalescing interval has passed
+            TickType_t delay = interval - since;
+            vTaskDelay(delay < timeout ? delay : timeout);
+        }
+    }
+
+    size_t count = input_queue_take(out_events, max);
+    if (count == 0 && timeout > 0) {
+        count = input_queue_wait(out_events, max, start, timeout);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        bsp_input_record_dequeue(&out_events[i]);
+    }
+    if (count > 0 && task != NULL) {
+        input_queue_record_delivery(task, xTaskGetTickCount());
+    }
+    return count;
+}
+
+esp_err_t bsp_input_set_event_coalescing(uint32_t interval_ms) {
+    atomic_store_explicit(&coalesce_interval_ms, interval_ms, memory_order_relaxed);
+    return ESP_OK;
+}
+
+esp_err_t bsp_input_set_overflow_policy(bsp_input_overflow_policy_t policy) {
+    ESP_RETURN_ON_FALSE(policy <= BSP_INPUT_OVERFLOW_BLOCK, ESP_ERR_INVALID_ARG, TAG, "Invalid overflow policy");
+    atomic_store_explicit(&queue_policy, policy, memory_order_relaxed);
+    return ESP_OK;
+}
+
+esp_err_t bsp_input_get_queue_stats(bsp_input_queue_stats_t* out_stats) {
+    ESP_RETURN_ON_FALSE(out_stats, ESP_ERR_INVALID_ARG, TAG, "Stats output argument is NULL");
+    // The head is read first, it never passes the tail read after it
+    uint32_t head             = atomic_load_explicit(&queue_head, memory_order_relaxed);
+    out_stats->depth          = INPUT_QUEUE_DEPTH;
+    out_stats->pending        = atomic_load_explicit(&queue_tail, memory_order_relaxed) - head;
+    out_stats->queued         = atomic_load_explicit(&stats_queued, memory_order_relaxed);
+    out_stats->dropped_newest = atomic_load_explicit(&stats_dropped_newest, memory_order_relaxed);
+    out_stats->dropped_oldest = atomic_load_explicit(&stats_dropped_oldest, memory_order_relaxed);
+    out_stats->blocked        = atomic_load_explicit(&stats_blocked, memory_order_relaxed);
+    out_stats->high_water     = atomic_load_explicit(&stats_high_water, memory_order_relaxed);
+    if (out_stats->pending > INPUT_QUEUE_DEPTH) {
+        out_stats->pending = INPUT_QUEUE_DEPTH;  // Events were taken between reading the head and the tail
+    }
+    QueueHandle_t queue = adapter_queue;
+    if (queue != NULL) {
+        out_stats->pending += uxQueueMessagesWaiting(queue);
+    }
+    return ESP_OK;
+}
+
+void bsp_input_reset_queue_stats(void) {
+    atomic_store_explicit(&stats_queued, 0, memory_order_relaxed);
+    atomic_store_explicit(&stats_dropped_newest, 0, memory_order_relaxed);
+    atomic_store_explicit(&stats_dropped_oldest, 0, memory_order_relaxed);
+    atomic_store_explicit(&stats_blocked, 0, memory_order_relaxed);
+    atomic_store_explicit(&stats_high_water, 0, memory_order_relaxed);
+}
@@ -0,0 +1,29 @@
+// Board support package API: Input event queue
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "bsp/input.h"
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+// Prepare the input event queue, safe to call more than once
+esp_err_t bsp_input_queue_initialize(void);
+
+// Queue an event for the application, safe to call from an ISR
+// Stamps the event for latency tracing, returns false if the event was dropped by the overflow policy
+bool bsp_input_queue_send(bsp_input_event_t* event);
+
+// Queue an event without waiting for room, with the block overflow policy a full queue drops the event like the drop
+// newest policy does
+bool bsp_input_queue_try_send(bsp_input_event_t* event);
+
+// Take up to max pending events without blocking, returns the number of events taken
+size_t bsp_input_queue_receive(bsp_input_event_t* out_events, size_t max);
+
+// Get a FreeRTOS queue that receives all input events, created on first use
+esp_err_t bsp_input_queue_get_handle(QueueHandle_t* out_queue);
@@ -0,0 +1,223 @@
+// Board support package API: Key repeat engine implementation
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include "badge_bsp_input_repeat.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "badge_bsp_input_hooks.h"
+#include "badge_bsp_input_queue.h"
+#include "bsp/input.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+
+static char const* TAG = "BSP input repeat";
+
+// Events repeated for a single key: its navigation event and its text
+#define INPUT_REPEAT_MAX_EVENTS 2
+
+static bsp_input_repeat_config_t repeat_config = {
+    .delay_ms        = CONFIG_BSP_INPUT_REPEAT_DELAY_MS,
+    .interval_ms     = CONFIG_BSP_INPUT_REPEAT_INTERVAL_MS,
+    .min_interval_ms = CONFIG_BSP_INPUT_REPEAT_MIN_INTERVAL_MS,
+    .acceleration    = CONFIG_BSP_INPUT_REPEAT_ACCELERATION,
+    .keyboard        = true,
+    .navigation      = true,
+};
+static portMUX_TYPE repeat_config_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Repeat state, only accessed with the mutex held
+static esp_timer_handle_t repeat_timer     = NULL;
+static SemaphoreHandle_t  repeat_mutex     = NULL;
+static bool               repeat_active    = false;
+static uint32_t           repeat_key       = BSP_INPUT_REPEAT_KEY_NONE;
+static uint32_t           repeat_modifiers = 0;
+static uint32_t           repeat_interval  = 0;  // Time between the next two repeats in milliseconds
+static bsp_input_event_t  repeat_events[INPUT_REPEAT_MAX_EVENTS];
+static size_t             repeat_num_events = 0;
+
+// The timer callback sends a copy of the events without holding the mutex. Stopping a repeat starts a new generation,
+// the callback drops events of an older generation and stopping waits for a send in progress, so a key release never
+// overtakes a repeat of the same key.
+static atomic_uint           repeat_generation = 0;
+static _Atomic(TaskHandle_t) repeat_sender     = NULL;
+
+static void input_repeat_get_config(bsp_input_repeat_config_t* out_config) {
+    portENTER_CRITICAL(&repeat_config_lock);
+    *out_config = repeat_config;
+    portEXIT_CRITICAL(&repeat_config_lock);
+}
+
+// Called with the mutex held, returns whether a repeat was stopped
+static bool input_repeat_stop(void) {
+    if (!repeat_active) {
+        return false;
+    }
+    esp_timer_stop(repeat_timer);
+    repeat_active     = false;
+    repeat_key        = BSP_INPUT_REPEAT_KEY_NONE;
+    repeat_num_events = 0;
+    atomic_fetch_add(&repeat_generation, 1);
+    return true;
+}
+
+// Wait for the timer callback to finish sending repeats of an older generation, called after a stop without the mutex
+// held. A send on the calling task, from a hook offered a repeated event, is not waited for.
+static void input_repeat_wait_for_sender(void) {
+    TaskHandle_t sender;
+    while ((sender = atomic_load(&repeat_sender)) != NULL && sender != xTaskGetCurrentTaskHandle()) {
+        vTaskDelay(1);
+    }
+}
+
+static void input_repeat_send(bsp_input_event_t* event) {
+    if (event->type == INPUT_EVENT_TYPE_NAVIGATION) {
+        // Offer to hooks first; if consumed, don't queue
+        if (!bsp_input_hooks_process(event)) {
+            bsp_input_queue_try_send(event);
+        }
+    } else {
+        bsp_input_queue_try_send(event);
+    }
+}
+
+// Runs on the esp_timer task, safe to call hook callbacks. Repeats are dropped rather than wait for room in the queue,
+// waiting would delay every other esp_timer callback.
+static void input_repeat_timer_callback(void* arg) {
+    (void)arg;
+    bsp_input_event_t events[INPUT_REPEAT_MAX_EVENTS];
+    size_t            num_events = 0;
+    uint32_t          generation = 0;
+
+    xSemaphoreTake(repeat_mutex, portMAX_DELAY);
+    if (repeat_active) {
+        num_events = repeat_num_events;
+        for (size_t i = 0; i < num_events; i++) {
+            events[i] = repeat_events[i];
+        }
+        generation = atomic_load(&repeat_generation);
+
+        esp_timer_start_once(repeat_timer, (uint64_t)repeat_interval * 1000);
+
+        // Every repeat shortens the next interval by the acceleration percentage, down to the minimum interval
+        bsp_input_repeat_config_t config;
+        input_repeat_get_config(&config);
+        uint32_t next = repeat_interval - (repeat_interval * config.acceleration) / 100;
+        if (next < config.min_interval_ms) {
+            next = config.min_interval_ms;
+        }
+        repeat_interval = next > 0 ? next : 1;
+    }
+    xSemaphoreGive(repeat_mutex);
+
+    if (num_events == 0) {
+        return;
+    }
+    atomic_store(&repeat_sender, xTaskGetCurrentTaskHandle());
+    int64_t timestamp = esp_timer_get_time();
+    for (size_t i = 0; i < num_events && atomic_load(&repeat_generation) == generation; i++) {
+        events[i].timestamp        = timestamp;
+        events[i].queued_timestamp = 0;
+        input_repeat_send(&events[i]);
+    }
+    atomic_store(&repeat_sender, NULL);
+}
+
+esp_err_t bsp_input_repeat_initialize(void) {
+    if (repeat_mutex == NULL) {
+        repeat_mutex = xSemaphoreCreateMutex();
+        ESP_RETURN_ON_FALSE(repeat_mutex, ESP_ERR_NO_MEM, TAG, "Failed to create key repeat mutex");
+    }
+    if (repeat_timer == NULL) {
+        esp_timer_create_args_t timer_args = {
+            .callback        = input_repeat_timer_callback,
+            .dispatch_method = ESP_TIMER_TASK,
+            .name            = "key repeat",
+        };
+        ESP_RETURN_ON_ERROR(esp_timer_create(&timer_args, &repeat_timer), TAG, "Failed to create key repeat timer");
+    }
+    return ESP_OK;
+}
+
+void bsp_input_repeat_press(uint32_t key, bsp_input_event_t const* event) {
+    if (repeat_mutex == NULL || key == BSP_INPUT_REPEAT_KEY_NONE) {
+        return;
+    }
+
+    bsp_input_repeat_config_t config;
+    input_repeat_get_config(&config);
+    bool repeats = (event->type == INPUT_EVENT_TYPE_KEYBOARD && config.keyboard) ||
+                   (event->type == INPUT_EVENT_TYPE_NAVIGATION && config.navigation && event->args_navigation.state);
+
+    bool stopped = false;
+    xSemaphoreTake(repeat_mutex, portMAX_DELAY);
+    if (repeat_active && repeat_key != key) {
+        stopped = input_repeat_stop();
+    }
+    if (repeats && config.delay_ms > 0 && config.interval_ms > 0 && repeat_num_events < INPUT_REPEAT_MAX_EVENTS) {
+        repeat_events[repeat_num_events++] = *event;
+        if (!repeat_active) {
+            repeat_active   = true;
+            repeat_key      = key;
+            repeat_interval = config.interval_ms;
+            esp_timer_start_once(repeat_timer, (uint64_t)config.delay_ms * 1000);
+        }
+    }
+    xSemaphoreGive(repeat_mutex);
+    if (stopped) {
+        input_repeat_wait_for_sender();
+    }
+}
+
+void bsp_input_repeat_release(uint32_t key) {
+    if (repeat_mutex == NULL || key == BSP_INPUT_REPEAT_KEY_NONE) {
+        return;
+    }
+    bool stopped = false;
+    xSemaphoreTake(repeat_mutex, portMAX_DELAY);
+    if (repeat_key == key) {
+        stopped = input_repeat_stop();
+    }
+    xSemaphoreGive(repeat_mutex);
+    if (stopped) {
+        input_repeat_wait_for_sender();
+    }
+}
+
+void bsp_input_repeat_set_modifiers(uint32_t modifiers) {
+    if (repeat_mutex == NULL) {
+        return;
+    }
+    bool stopped = false;
+    xSemaphoreTake(repeat_mutex, portMAX_DELAY);
+    if (modifiers != repeat_modifiers) {
+        repeat_modifiers = modifiers;
+        stopped          = input_repeat_stop();
+    }
+    xSemaphoreGive(repeat_mutex);
+    if (stopped) {
+        input_repeat_wait_for_sender();
+    }
+}
+
+esp_err_t bsp_input_set_repeat_config(bsp_input_repeat_config_t const* config) {
+    ESP_RETURN_ON_FALSE(config, ESP_ERR_INVALID_ARG, TAG, "Configuration argument is NULL");
+    ESP_RETURN_ON_FALSE(config->acceleration <= 100, ESP_ERR_INVALID_ARG, TAG, "Acceleration above 100 percent");
+    portENTER_CRITICAL(&repeat_config_lock);
+    repeat_config = *config;
+    portEXIT_CRITICAL(&repeat_config_lock);
+    return ESP_OK;
+}
+
+esp_err_t bsp_input_get_repeat_config(bsp_input_repeat_config_t* out_config) {
+    ESP_RETURN_ON_FALSE(out_config, ESP_ERR_INVALID_ARG, TAG, "Configuration output argument is NULL");
+    input_repeat_get_config(out_config);
+    return ESP_OK;
+}
@@ -0,0 +1,25 @@
+// Board support package API: Key repeat engine
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdint.h>
+#include "bsp/input.h"
+#include "esp_err.h"
+
+// Key identifier that never repeats
+#define BSP_INPUT_REPEAT_KEY_NONE 0
+
+// Prepare the key repeat timer, safe to call more than once
+esp_err_t bsp_input_repeat_initialize(void);
+
+// Repeat an event of a key that was just pressed, keyboard and navigation events are repeated
+// Events of the same key repeat together, pressing another key makes that key the repeating key
+void bsp_input_repeat_press(uint32_t key, bsp_input_event_t const* event);
+
+// Stop repeating a key that was released, call before sending the release events
+void bsp_input_repeat_release(uint32_t key);
+
+// Track the held modifier keys, a change of modifiers stops the repeat
+void bsp_input_repeat_set_modifiers(uint32_t modifiers);
@@ -0,0 +1,127 @@
+// Board support package API: Input state tracking
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include "badge_bsp_input_state.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "bsp/input.h"
+#include "esp_attr.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+static char const* TAG = "BSP input state";
+
+// Writers serialize on the spinlock and bump the sequence number around every change, readers copy the state and
+// retry if the sequence number was odd (write in progress) or changed while copying
+static bsp_input_state_t input_state          = {0};
+static atomic_uint       input_state_sequence = 0;
+static portMUX_TYPE      input_state_lock     = portMUX_INITIALIZER_UNLOCKED;
+
+static inline void input_state_write_begin(void) {
+    portENTER_CRITICAL_SAFE(&input_state_lock);
+    atomic_fetch_add_explicit(&input_state_sequence, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+static inline void input_state_write_end(void) {
+    atomic_fetch_add_explicit(&input_state_sequence, 1, memory_order_release);
+    portEXIT_CRITICAL_SAFE(&input_state_lock);
+}
+
+static inline void set_bit(uint32_t* words, int index, bool state) {
+    uint32_t mask = 1u << (index % 32);
+    if (state) {
+        words[index / 32] |= mask;
+    } else {
+        words[index / 32] &= ~mask;
+    }
+}
+
+IRAM_ATTR int bsp_input_state_scancode_index(uint32_t scancode) {
+    if (scancode <= 0x7F) {
+        return scancode;
+    }
+    if ((scancode >> 8) == 0xE0 && (scancode & 0x80) == 0) {
+        return 0x80 | (scancode & 0x7F);
+    }
+    return -1;
+}
+
+IRAM_ATTR void bsp_input_state_update(bsp_input_event_t const* event) {
+    switch (event->type) {
+        case INPUT_EVENT_TYPE_NAVIGATION: {
+            uint32_t key = event->args_navigation.key;
+            if (key >= 64) {
+                return;
+            }
+            input_state_write_begin();
+            if (event->args_navigation.state) {
+                input_state.navigation |= 1ull << key;
+            } else {
+                input_state.navigation &= ~(1ull << key);
+            }
+            input_state_write_end();
+            break;
+        }
+        case INPUT_EVENT_TYPE_SCANCODE: {
+            uint32_t scancode = event->args_scancode.scancode;
+            int      index    = bsp_input_state_scancode_index(scancode & ~BSP_INPUT_SCANCODE_RELEASE_MODIFIER);
+            if (index < 0) {
+                return;
+            }
+            input_state_write_begin();
+            set_bit(input_state.scancodes, index, !(scancode & BSP_INPUT_SCANCODE_RELEASE_MODIFIER));
+            input_state_write_end();
+            break;
+        }
+        case INPUT_EVENT_TYPE_ACTION: {
+            uint32_t action = event->args_action.type;
+            if (action >= 32) {
+                return;
+            }
+            input_state_write_begin();
+            set_bit(&input_state.actions, action, event->args_action.state);
+            input_state_write_end();
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+IRAM_ATTR void bsp_input_state_set_modifiers(uint32_t modifiers) {
+    if (input_state.modifiers == modifiers) {
+        return;
+    }
+    input_state_write_begin();
+    input_state.modifiers = modifiers;
+    input_state_write_end();
+}
+
+esp_err_t bsp_input_get_state_snapshot(bsp_input_state_t* out_state) {
+    ESP_RETURN_ON_FALSE(out_state, ESP_ERR_INVALID_ARG, TAG, "State output argument is NULL");
+    unsigned int sequence;
+    do {
+        sequence = atomic_load_explicit(&input_state_sequence, memory_order_acquire);
+        memcpy(out_state, &input_state, sizeof(bsp_input_state_t));
+        atomic_thread_fence(memory_order_acquire);
+    } while ((sequence & 1) || sequence != atomic_load_explicit(&input_state_sequence, memory_order_relaxed));
+    return ESP_OK;
+}
+
+bool bsp_input_state_get_scancode(bsp_input_state_t const* state, bsp_input_scancode_t scancode) {
+    int index = bsp_input_state_scancode_index(scancode);
+    return index >= 0 && (state->scancodes[index / 32] >> (index % 32)) & 1;
+}
+
+bool bsp_input_state_get_navigation_key(bsp_input_state_t const* state, bsp_input_navigation_key_t key) {
+    return key < 64 && (state->navigation >> key) & 1;
+}
+
+bool bsp_input_state_get_action(bsp_input_state_t const* state, bsp_input_action_type_t action) {
+    return action < 32 && (state->actions >> action) & 1;
+}
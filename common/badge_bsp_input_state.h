@@ -0,0 +1,18 @@
+// Board support package API: Input state tracking
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdint.h>
+#include "bsp/input.h"
+
+// Bit index of a scancode in the state snapshot: plain scancodes map to 0-127, escaped (0xE0xx) scancodes to
+// 128-255, returns -1 for scancodes that can not be tracked
+int bsp_input_state_scancode_index(uint32_t scancode);
+
+// Apply a navigation, scancode or action event to the input state, safe to call from an ISR
+void bsp_input_state_update(bsp_input_event_t const* event);
+
+// Set the modifier word of the input state, safe to call from an ISR
+void bsp_input_state_set_modifiers(uint32_t modifiers);
@@ -0,0 +1,170 @@
+// Board support package API: Keymap engine for key matrix keyboards
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include "badge_bsp_keymap.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "badge_bsp_input_hooks.h"
+#include "badge_bsp_input_queue.h"
+#include "badge_bsp_input_repeat.h"
+#include "badge_bsp_input_state.h"
+#include "bsp/input.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+static char const* TAG = "BSP keymap";
+
+static inline bool key_is_mapped(bsp_keymap_key_t const* key) {
+    return key->scancode || key->navigation || key->modifier || key->utf8;
+}
+
+static void send_event(bsp_keymap_t* keymap, bsp_input_event_t* event) {
+    // Offer to hooks first; if consumed, don't queue
+    if (!bsp_input_hooks_process(event)) {
+        bsp_input_queue_send(event);
+    }
+}
+
+// Key code 0 is never a key, it is used as BSP_INPUT_REPEAT_KEY_NONE for events that do not repeat
+static void send_navigation_event(bsp_keymap_t* keymap, uint8_t code, bsp_input_navigation_key_t key, bool state) {
+    bsp_input_event_t event = {
+        .type                      = INPUT_EVENT_TYPE_NAVIGATION,
+        .args_navigation.key       = key,
+        .args_navigation.modifiers = keymap->modifiers,
+        .args_navigation.state     = state,
+        .timestamp                 = keymap->timestamp,
+    };
+    if (state) {
+        bsp_input_repeat_press(code, &event);
+    }
+    send_event(keymap, &event);
+}
+
+static void send_scancode_event(bsp_keymap_t* keymap, bsp_input_scancode_t scancode, bool state) {
+    bsp_input_event_t event = {
+        .type                   = INPUT_EVENT_TYPE_SCANCODE,
+        .args_scancode.scancode = scancode | (state ? 0 : BSP_INPUT_SCANCODE_RELEASE_MODIFIER),
+        .timestamp              = keymap->timestamp,
+    };
+    send_event(keymap, &event);
+}
+
+static void send_text_event(bsp_keymap_t* keymap, uint8_t code, bsp_keymap_key_t const* key) {
+    uint32_t          modifiers   = keymap->modifiers;
+    char              value_ascii = (modifiers & BSP_INPUT_MODIFIER_SHIFT) ? key->ascii_shift : key->ascii;
+    char const*       value_utf8  = (modifiers & BSP_INPUT_MODIFIER_ALT_R)
+                                        ? ((modifiers & BSP_INPUT_MODIFIER_SHIFT) ? key->utf8_shift_alt : key->utf8_alt)
+                                        : ((modifiers & BSP_INPUT_MODIFIER_SHIFT) ? key->utf8_shift : key->utf8);
+    bsp_input_event_t event       = {
+        .type                    = INPUT_EVENT_TYPE_KEYBOARD,
+        .args_keyboard.ascii     = value_ascii,
+        .args_keyboard.modifiers = modifiers,
+        .timestamp               = keymap->timestamp,
+    };
+    if (value_utf8) {
+        strlcpy(event.args_keyboard.utf8, value_utf8, sizeof(event.args_keyboard.utf8));
+    } else {
+        event.args_keyboard.utf8[0] = value_ascii;
+        event.args_keyboard.utf8[1] = 0;
+    }
+    bsp_input_repeat_press(code, &event);
+    bsp_input_queue_send(&event);
+}
+
+esp_err_t bsp_keymap_initialize(bsp_keymap_t* keymap, bsp_keymap_key_t const* keys, size_t num_keys) {
+    ESP_RETURN_ON_FALSE(keymap && keys, ESP_ERR_INVALID_ARG, TAG, "Keymap or key table is NULL");
+    ESP_RETURN_ON_FALSE(num_keys <= BSP_KEYMAP_MAX_KEYS, ESP_ERR_INVALID_ARG, TAG, "Key table too large");
+    ESP_RETURN_ON_ERROR(bsp_input_repeat_initialize(), TAG, "Failed to initialize key repeat");
+
+    memset(keymap, 0, sizeof(bsp_keymap_t));
+    keymap->keys     = keys;
+    keymap->num_keys = num_keys;
+
+    // Build the reverse lookup tables, the first key producing a scancode or navigation key wins
+    for (size_t code = 1; code < num_keys; code++) {
+        bsp_keymap_key_t const* key  = &keys[code];
+        int                     slot = bsp_input_state_scancode_index(key->scancode);
+        if (key->scancode != BSP_INPUT_SCANCODE_NONE && slot >= 0 && keymap->by_scancode[slot] == 0) {
+            keymap->by_scancode[slot] = code;
+        }
+        if (key->navigation != BSP_INPUT_NAVIGATION_KEY_NONE && key->navigation < BSP_KEYMAP_NAVIGATION_SLOTS &&
+            keymap->by_navigation[key->navigation] == 0) {
+            keymap->by_navigation[key->navigation] = code;
+        }
+        // The super navigation key is sent when the super modifier key is tapped
+        if (key->modifier == BSP_INPUT_MODIFIER_SUPER_L && keymap->by_navigation[BSP_INPUT_NAVIGATION_KEY_SUPER] == 0) {
+            keymap->by_navigation[BSP_INPUT_NAVIGATION_KEY_SUPER] = code;
+        }
+    }
+
+    return ESP_OK;
+}
+
+void bsp_keymap_handle_key(bsp_keymap_t* keymap, uint8_t code, bool pressed, int64_t timestamp) {
+    if (code >= keymap->num_keys || !key_is_mapped(&keymap->keys[code])) {
+        keymap->super_used = true;
+        ESP_LOGW(TAG, "Unmapped key pressed: %u", code);
+        return;
+    }
+
+    bsp_keymap_key_t const* key  = &keymap->keys[code];
+    uint32_t                bit  = 1u << (code % 32);
+    uint32_t*               word = &keymap->pressed[code / 32];
+    keymap->timestamp            = timestamp;
+    if (pressed) {
+        *word |= bit;
+    } else {
+        *word &= ~bit;
+    }
+
+    if (key->modifier) {
+        if (pressed) {
+            keymap->modifiers |= key->modifier;
+        } else {
+            keymap->modifiers &= ~key->modifier;
+        }
+        bsp_input_state_set_modifiers(keymap->modifiers);
+        bsp_input_repeat_set_modifiers(keymap->modifiers);
+    }
+    if (!pressed) {
+        bsp_input_repeat_release(code);
+    }
+
+    // A tap on the super key without any other key in between is sent as the super navigation key
+    if (key->modifier == BSP_INPUT_MODIFIER_SUPER_L) {
+        if (pressed) {
+            keymap->super_used = false;
+        } else if (!keymap->super_used) {
+            send_navigation_event(keymap, BSP_INPUT_REPEAT_KEY_NONE, BSP_INPUT_NAVIGATION_KEY_SUPER, true);
+            send_navigation_event(keymap, BSP_INPUT_REPEAT_KEY_NONE, BSP_INPUT_NAVIGATION_KEY_SUPER, false);
+        }
+    } else {
+        keymap->super_used = true;
+    }
+
+    if (key->navigation != BSP_INPUT_NAVIGATION_KEY_NONE) {
+        send_navigation_event(keymap, code, key->navigation, pressed);
+    }
+    if (key->scancode != BSP_INPUT_SCANCODE_NONE) {
+        send_scancode_event(keymap, key->scancode, pressed);
+    }
+    if (key->utf8 != NULL && pressed) {
+        send_text_event(keymap, code, key);
+    }
+}
+
+static inline bool key_is_pressed(bsp_keymap_t const* keymap, uint8_t code) {
+    return code != 0 && (keymap->pressed[code / 32] >> (code % 32)) & 1;
+}
+
+bool bsp_keymap_read_scancode(bsp_keymap_t const* keymap, bsp_input_scancode_t scancode) {
+    int slot = bsp_input_state_scancode_index(scancode);
+    return slot >= 0 && key_is_pressed(keymap, keymap->by_scancode[slot]);
+}
+
+bool bsp_keymap_read_navigation_key(bsp_keymap_t const* keymap, bsp_input_navigation_key_t key) {
+    return key < BSP_KEYMAP_NAVIGATION_SLOTS && key_is_pressed(keymap, keymap->by_navigation[key]);
+}
@@ -0,0 +1,67 @@
+// Board support package API: Keymap engine for key matrix keyboards
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "bsp/input.h"
+#include "esp_err.h"
+
+// Number of key codes a keymap can describe (the TCA8418 reports codes 1 to 127)
+#define BSP_KEYMAP_MAX_KEYS 128
+
+// Number of lookup slots for scancodes: plain scancodes map to 0x00-0x7F, escaped (0xE0xx) scancodes to 0x80-0xFF
+#define BSP_KEYMAP_SCANCODE_SLOTS 256
+
+// Number of lookup slots for navigation keys
+#define BSP_KEYMAP_NAVIGATION_SLOTS 64
+
+// Description of a single key, a key is unmapped if all fields are zero
+typedef struct {
+    uint16_t    scancode;        // Scancode sent on press and release, BSP_INPUT_SCANCODE_NONE if none
+    uint8_t     navigation;      // Navigation key sent on press and release, BSP_INPUT_NAVIGATION_KEY_NONE if none
+    uint16_t    modifier;        // Modifier bit held while the key is pressed, 0 if none
+    char        ascii;           // ASCII value sent on press
+    char        ascii_shift;     // ASCII value sent on press while shift is held
+    char const* utf8;            // UTF-8 value sent on press, NULL if the key does not produce text
+    char const* utf8_shift;      // UTF-8 value sent on press while shift is held
+    char const* utf8_alt;        // UTF-8 value sent on press while right alt is held
+    char const* utf8_shift_alt;  // UTF-8 value sent on press while shift and right alt are held
+} bsp_keymap_key_t;
+
+// Keymap table entries, indexed by key code
+#define BSP_KEYMAP_SCANCODE(code)        {.scancode = (code)}
+#define BSP_KEYMAP_NAVIGATION(code, nav) {.scancode = (code), .navigation = (nav)}
+#define BSP_KEYMAP_MODIFIER(code, mod)   {.scancode = (code), .modifier = (mod)}
+
+#define BSP_KEYMAP_TEXT(code, a, a_shift, u, u_shift, u_alt, u_shift_alt)                              \
+    {.scancode = (code), .ascii = (a), .ascii_shift = (a_shift), .utf8 = (u), .utf8_shift = (u_shift), \
+     .utf8_alt = (u_alt), .utf8_shift_alt = (u_shift_alt)}
+
+// Keymap engine state
+typedef struct {
+    bsp_keymap_key_t const* keys;
+    size_t                  num_keys;
+    uint32_t                pressed[BSP_KEYMAP_MAX_KEYS / 32];           // Packed key state, one bit per key code
+    uint8_t                 by_scancode[BSP_KEYMAP_SCANCODE_SLOTS];      // Key code per scancode, 0 if none
+    uint8_t                 by_navigation[BSP_KEYMAP_NAVIGATION_SLOTS];  // Key code per navigation key, 0 if none
+    uint32_t                modifiers;
+    bool                    super_used;
+    int64_t                 timestamp;  // Generation time of the key being handled
+} bsp_keymap_t;
+
+// Initialize the keymap engine with a table of keys indexed by key code
+esp_err_t bsp_keymap_initialize(bsp_keymap_t* keymap, bsp_keymap_key_t const* keys, size_t num_keys);
+
+// Handle a key press or release reported by the keyboard controller, timestamp is the time at which the keyboard
+// controller reported the key (esp_timer_get_time)
+void bsp_keymap_handle_key(bsp_keymap_t* keymap, uint8_t code, bool pressed, int64_t timestamp);
+
+// Read the state of a scancode, false if no key produces it
+bool bsp_keymap_read_scancode(bsp_keymap_t const* keymap, bsp_input_scancode_t scancode);
+
+// Read the state of a navigation key, false if no key produces it
+bool bsp_keymap_read_navigation_key(bsp_keymap_t const* keymap, bsp_input_navigation_key_t key);
@@ -0,0 +1,130 @@
+// Board support package API: Panel initialization tables implementation
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include "badge_bsp_lcd_init.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "driver/spi_master.h"
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+// Number of transactions queued at once, a command and its parameters use two
+#define BSP_LCD_INIT_QUEUE_DEPTH 8
+
+static bool bsp_lcd_init_is_marker(const uint8_t* cursor, uint8_t marker) {
+    return cursor[1] == marker;
+}
+
+bool bsp_lcd_init_next(const uint8_t** cursor, bsp_lcd_init_cmd_t* out_cmd) {
+    const uint8_t* position = *cursor;
+
+    // Delays without a preceding command are skipped
+    while (bsp_lcd_init_is_marker(position, BSP_LCD_INIT_DELAY_MARKER)) {
+        position += 4;
+    }
+    // Any other control record is treated as the end, rather than sending it to the panel as a command
+    if (position[1] & BSP_LCD_INIT_FLAG_CONTROL) {
+        *cursor = position;
+        return false;
+    }
+
+    out_cmd->command     = position[0];
+    out_cmd->num_params  = position[1];
+    out_cmd->params      = &position[2];
+    out_cmd->delay_ms    = 0;
+    position            += 2 + out_cmd->num_params;
+
+    while (bsp_lcd_init_is_marker(position, BSP_LCD_INIT_DELAY_MARKER)) {
+        out_cmd->delay_ms += position[2] | (position[3] << 8);
+        position          += 4;
+    }
+
+    *cursor = position;
+    return true;
+}
+
+size_t bsp_lcd_init_count(const uint8_t* table) {
+    bsp_lcd_init_cmd_t cmd;
+    size_t             count = 0;
+    while (bsp_lcd_init_next(&table, &cmd)) {
+        count++;
+    }
+    return count;
+}
+
+typedef struct {
+    spi_device_handle_t device;
+    spi_transaction_t   transactions[BSP_LCD_INIT_QUEUE_DEPTH];
+    size_t              queued;
+    size_t              next;
+} bsp_lcd_init_queue_t;
+
+static esp_err_t bsp_lcd_init_queue_drain(bsp_lcd_init_queue_t* queue, size_t keep) {
+    esp_err_t res = ESP_OK;
+    while (queue->queued > keep) {
+        spi_transaction_t* done   = NULL;
+        esp_err_t          result = spi_device_get_trans_result(queue->device, &done, portMAX_DELAY);
+        if (result != ESP_OK && res == ESP_OK) {
+            res = result;
+        }
+        queue->queued--;
+    }
+    return res;
+}
+
+static esp_err_t bsp_lcd_init_queue_write(bsp_lcd_init_queue_t* queue, int dc, const uint8_t* data, size_t length) {
+    // Reuse the oldest transaction once the queue is full
+    esp_err_t res = bsp_lcd_init_queue_drain(queue, BSP_LCD_INIT_QUEUE_DEPTH - 1);
+    if (res != ESP_OK) {
+        return res;
+    }
+
+    spi_transaction_t* transaction = &queue->transactions[queue->next];
+    memset(transaction, 0, sizeof(spi_transaction_t));
+    transaction->length = length * 8;
+    transaction->user   = (void*)(intptr_t)dc;
+    if (length <= sizeof(transaction->tx_data)) {
+        transaction->flags = SPI_TRANS_USE_TXDATA;
+        memcpy(transaction->tx_data, data, length);
+    } else {
+        transaction->tx_buffer = data;
+    }
+
+    res = spi_device_queue_trans(queue->device, transaction, portMAX_DELAY);
+    if (res != ESP_OK) {
+        return res;
+    }
+    queue->queued++;
+    queue->next = (queue->next + 1) % BSP_LCD_INIT_QUEUE_DEPTH;
+    return ESP_OK;
+}
+
+esp_err_t bsp_lcd_init_run_spi(spi_device_handle_t device, const uint8_t* table) {
+    // On the stack, the transactions are drained before returning and panels can be initialized from several tasks
+    bsp_lcd_init_queue_t queue = {.device = device};
+
+    esp_err_t res = spi_device_acquire_bus(device, portMAX_DELAY);
+    if (res != ESP_OK) {
+        return res;
+    }
+
+    bsp_lcd_init_cmd_t cmd;
+    while (res == ESP_OK && bsp_lcd_init_next(&table, &cmd)) {
+        res = bsp_lcd_init_queue_write(&queue, 0, &cmd.command, 1);
+        if (res == ESP_OK && cmd.num_params > 0) {
+            res = bsp_lcd_init_queue_write(&queue, 1, cmd.params, cmd.num_params);
+        }
+        if (res == ESP_OK && cmd.delay_ms > 0) {
+            // The delay starts once the command has actually been sent
+            res = bsp_lcd_init_queue_drain(&queue, 0);
+            vTaskDelay(pdMS_TO_TICKS(cmd.delay_ms));
+        }
+    }
+
+    esp_err_t drain_res = bsp_lcd_init_queue_drain(&queue, 0);
+    spi_device_release_bus(device);
+    return res != ESP_OK ? res : drain_res;
+}
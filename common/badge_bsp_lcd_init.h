@@ -0,0 +1,59 @@
+// Board support package API: Panel initialization tables
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "driver/spi_master.h"
+#include "esp_err.h"
+
+// Panel initialization sequences are stored as a compact byte table:
+//   command, number of parameters, parameters...   a command with at most 127 parameters
+//   0x00, 0x81, delay low byte, delay high byte    a delay in milliseconds after the previous command
+//   0x00, 0xFF                                     end of the table
+// Delay and end records are told apart from commands by the high bit of the second byte, so every command value,
+// including 0x00 (NOP), can be used.
+
+#define BSP_LCD_INIT_FLAG_CONTROL 0x80  // Set in the count byte of records that are not commands
+#define BSP_LCD_INIT_DELAY_MARKER (BSP_LCD_INIT_FLAG_CONTROL | 0x01)
+#define BSP_LCD_INIT_END_MARKER   (BSP_LCD_INIT_FLAG_CONTROL | 0x7F)
+
+// Number of parameters of a command, a table with more than 127 parameters for one command does not compile
+#define BSP_LCD_INIT_NUM_PARAMS(...)                                                                           \
+    (sizeof((uint8_t[]){__VA_ARGS__}) + 0 * sizeof(struct {                                                    \
+         _Static_assert(sizeof((uint8_t[]){__VA_ARGS__}) <= 127, "LCD init command with over 127 parameters"); \
+         char unused;                                                                                          \
+     }))
+
+// Command with parameters, for example BSP_LCD_INIT_CMD(0x3A, 0x05)
+#define BSP_LCD_INIT_CMD(command, ...) (command), BSP_LCD_INIT_NUM_PARAMS(__VA_ARGS__), __VA_ARGS__
+
+// Command without parameters
+#define BSP_LCD_INIT_CMD0(command) (command), 0
+
+// Delay after the previous command
+#define BSP_LCD_INIT_DELAY(ms) 0x00, BSP_LCD_INIT_DELAY_MARKER, ((ms) & 0xFF), (((ms) >> 8) & 0xFF)
+
+// End of the table
+#define BSP_LCD_INIT_END() 0x00, BSP_LCD_INIT_END_MARKER
+
+typedef struct {
+    uint8_t        command;
+    uint8_t        num_params;
+    const uint8_t* params;
+    uint32_t       delay_ms;  // Delay after the command, including all delay records that follow it
+} bsp_lcd_init_cmd_t;
+
+// Read the next command from a table, returns false at the end of the table
+bool bsp_lcd_init_next(const uint8_t** cursor, bsp_lcd_init_cmd_t* out_cmd);
+
+// Count the commands in a table
+size_t bsp_lcd_init_count(const uint8_t* table);
+
+// Send a table to a panel on an SPI device while holding the bus once
+// Commands are queued back to back and only drained for delays. The DC pin must be driven by the pre-transfer
+// callback of the device from the transaction user field: 0 for commands and 1 for parameters.
+esp_err_t bsp_lcd_init_run_spi(spi_device_handle_t device, const uint8_t* table);
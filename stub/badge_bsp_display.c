@@ -18,6 +18,10 @@ esp_err_t __attribute__((weak)) bsp_display_get_parameters(size_t* h_res, size_t
     return ESP_ERR_NOT_SUPPORTED;
 }
 
+esp_err_t __attribute__((weak)) bsp_display_get_palette(const uint8_t** out_palette, size_t* out_palette_size) {
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
 esp_err_t __attribute__((weak)) bsp_display_get_panel(esp_lcd_panel_handle_t* panel) {
     return ESP_ERR_NOT_SUPPORTED;
 }
@@ -54,3 +58,18 @@ esp_err_t __attribute__((weak)) bsp_display_blit(size_t x_start, size_t y_start,
                                                  const void* buffer) {
     return ESP_ERR_NOT_SUPPORTED;
 }
+
+esp_err_t __attribute__((weak)) bsp_display_blit_async(size_t x_start, size_t y_start, size_t x_end, size_t y_end,
+                                                       const void* buffer, bsp_display_blit_done_cb_t callback,
+                                                       void* user_ctx) {
+    // Targets without queued transfers blit synchronously, the buffer is free once the blit returns
+    esp_err_t res = bsp_display_blit(x_start, y_start, x_end, y_end, buffer);
+    if (res == ESP_OK && callback != NULL) {
+        callback(user_ctx);
+    }
+    return res;
+}
+
+esp_err_t __attribute__((weak)) bsp_display_get_framebuffers(void** out_fbs, size_t max_fbs, size_t* out_num_fbs) {
+    return ESP_ERR_NOT_SUPPORTED;
+}
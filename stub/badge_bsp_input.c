@@ -3,6 +3,8 @@
 // SPDX-License-Identifier: MIT
 
 #include <stdint.h>
+#include "badge_bsp_input_queue.h"
+#include "badge_bsp_input_state.h"
 #include "bsp/input.h"
 #include "esp_check.h"
 #include "esp_err.h"
@@ -11,25 +13,13 @@
 
 static char const* TAG = "BSP INPUT";
 
-static QueueHandle_t event_queue = NULL;
-
 esp_err_t __attribute__((weak)) bsp_input_initialize(void) {
-    if (event_queue == NULL) {
-        event_queue = xQueueCreate(32, sizeof(bsp_input_event_t));
-        ESP_RETURN_ON_FALSE(event_queue, ESP_ERR_NO_MEM, TAG, "Failed to create input event queue");
-    }
+    ESP_RETURN_ON_ERROR(bsp_input_queue_initialize(), TAG, "Failed to initialize input event queue");
     return ESP_OK;
 }
 
 esp_err_t __attribute__((weak)) bsp_input_get_queue(QueueHandle_t* out_queue) {
-    if (out_queue == NULL) {
-        return ESP_ERR_INVALID_ARG;
-    }
-    if (event_queue == NULL) {
-        return ESP_FAIL;
-    }
-    *out_queue = event_queue;
-    return ESP_OK;
+    return bsp_input_queue_get_handle(out_queue);
 }
 
 bool __attribute__((weak)) bsp_input_needs_on_screen_keyboard(void) {
@@ -63,11 +53,12 @@ esp_err_t __attribute__((weak)) bsp_input_get_touch_coordinates(uint16_t* out_x,
 }
 
 esp_err_t __attribute__((weak)) bsp_input_inject_event(bsp_input_event_t* event) {
-    if (event == NULL || event_queue == NULL) {
+    if (event == NULL) {
         return ESP_ERR_INVALID_ARG;
     }
+    bsp_input_state_update(event);
 
-    if (xQueueSend(event_queue, event, pdMS_TO_TICKS(10)) != pdTRUE) {
+    if (!bsp_input_queue_send(event)) {
         return ESP_ERR_TIMEOUT;
     }
 
@@ -2,6 +2,8 @@
 // SPDX-License-Identifier: MIT
 
 #include <stdint.h>
+#include "badge_bsp_input_queue.h"
+#include "badge_bsp_input_state.h"
 #include "bsp/input.h"
 #include "driver/gpio.h"
 #include "esp_attr.h"
@@ -16,7 +18,6 @@
 
 static char const TAG[] = "BSP: INPUT";
 
-static QueueHandle_t event_queue = NULL;
 
 static int const input_pins[] = {
     BSP_GPIO_BTN_UP,
@@ -40,16 +41,12 @@ static IRAM_ATTR void gpio_isr(void* arg) {
                 .state     = !gpio_get_level(input_pins[index]),
             },
     };
-    BaseType_t shouldYield = pdFALSE;
-    xQueueSendFromISR(event_queue, &event, &shouldYield);
-    if (shouldYield == pdTRUE) {
-        portYIELD_FROM_ISR();
-    }
+    bsp_input_state_update(&event);
+    bsp_input_queue_send(&event);
 }
 
 esp_err_t bsp_input_initialize(void) {
-    event_queue = xQueueCreate(32, sizeof(bsp_input_event_t));
-    ESP_RETURN_ON_FALSE(event_queue, ESP_ERR_NO_MEM, TAG, "Failed to create input event queue");
+    ESP_RETURN_ON_ERROR(bsp_input_queue_initialize(), TAG, "Failed to initialize input event queue");
 
     for (int i = 0; i < 3; i++) {
         ESP_ERROR_CHECK(gpio_set_direction(input_pins[i], GPIO_MODE_INPUT));
@@ -62,14 +59,7 @@ esp_err_t bsp_input_initialize(void) {
 }
 
 esp_err_t bsp_input_get_queue(QueueHandle_t* out_queue) {
-    if (out_queue == NULL) {
-        return ESP_ERR_INVALID_ARG;
-    }
-    if (event_queue == NULL) {
-        return ESP_FAIL;
-    }
-    *out_queue = event_queue;
-    return ESP_OK;
+    return bsp_input_queue_get_handle(out_queue);
 }
 
 bool bsp_input_needs_on_screen_keyboard(void) {
@@ -105,17 +95,17 @@ esp_err_t bsp_input_read_action(bsp_input_action_type_t action, bool* out_state)
     return ESP_ERR_NOT_SUPPORTED;
 }
 
-// NOTE: This target does not support input hooks because events are sent
-// directly from GPIO ISR using xQueueSendFromISR(). Hook processing requires
-// taking a mutex, which cannot be done from ISR context. The hook functions
-// will fall back to weak stubs (bsp_input_hook_register returns -1).
+// NOTE: Events on this target are not offered to input hooks because they are sent
+// directly from the GPIO ISR using bsp_input_queue_send(). Hook callbacks are
+// application code, which cannot run in ISR context.
 // Only bsp_input_inject_event() is implemented for this target.
 
 esp_err_t bsp_input_inject_event(bsp_input_event_t* event) {
-    if (event == NULL || event_queue == NULL) {
+    if (event == NULL) {
         return ESP_ERR_INVALID_ARG;
     }
-    if (xQueueSend(event_queue, event, pdMS_TO_TICKS(10)) != pdTRUE) {
+    bsp_input_state_update(event);
+    if (!bsp_input_queue_send(event)) {
         return ESP_ERR_TIMEOUT;
     }
     return ESP_OK;
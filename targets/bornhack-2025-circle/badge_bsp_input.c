@@ -4,6 +4,7 @@
 #include <inttypes.h>
 #include <stdint.h>
 #include <string.h>
+#include "badge_bsp_input_queue.h"
 #include "bsp/input.h"
 #include "driver/gpio.h"
 #include "esp_check.h"
@@ -16,25 +17,13 @@
 
 static char const* TAG = "BSP: INPUT";
 
-static QueueHandle_t event_queue = NULL;
-
 esp_err_t bsp_input_initialize(void) {
-    if (event_queue == NULL) {
-        event_queue = xQueueCreate(32, sizeof(bsp_input_event_t));
-        ESP_RETURN_ON_FALSE(event_queue, ESP_ERR_NO_MEM, TAG, "Failed to create input event queue");
-    }
+    ESP_RETURN_ON_ERROR(bsp_input_queue_initialize(), TAG, "Failed to initialize input event queue");
     return ESP_OK;
 }
 
 esp_err_t bsp_input_get_queue(QueueHandle_t* out_queue) {
-    if (out_queue == NULL) {
-        return ESP_ERR_INVALID_ARG;
-    }
-    if (event_queue == NULL) {
-        return ESP_FAIL;
-    }
-    *out_queue = event_queue;
-    return ESP_OK;
+    return bsp_input_queue_get_handle(out_queue);
 }
 
 bool bsp_input_needs_on_screen_keyboard(void) {
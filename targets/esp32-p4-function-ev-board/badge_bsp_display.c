@@ -5,9 +5,13 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
+#include "badge_bsp_display_flip.h"
+#include "badge_bsp_display_flush.h"
+#include "badge_bsp_display_stats.h"
 #include "bsp/device.h"
 #include "bsp/display.h"
 #include "driver/gpio.h"
+#include "driver/ledc.h"
 #include "dsi_panel_espressif_ek79007.h"
 #include "esp_check.h"
 #include "esp_err.h"
@@ -25,18 +29,29 @@ static char const* TAG = "BSP display";
 
 static esp_ldo_channel_handle_t ldo_mipi_phy            = NULL;
 static bool                     bsp_display_initialized = false;
-static SemaphoreHandle_t        flush_semaphore         = NULL;
+static size_t                   display_num_fbs         = 1;
+static uint8_t                  display_brightness      = 100;
 
 #define BSP_LCD_RESET_PIN 21
 #define BSP_LCD_PWM_PIN   23
 
+#define BSP_LCD_PWM_MODE       LEDC_LOW_SPEED_MODE
+#define BSP_LCD_PWM_TIMER      LEDC_TIMER_0
+#define BSP_LCD_PWM_CHANNEL    LEDC_CHANNEL_0
+#define BSP_LCD_PWM_RESOLUTION LEDC_TIMER_10_BIT
+#define BSP_LCD_PWM_FREQ_HZ    25000
+
 #define BSP_DSI_LDO_CHAN       3
 #define BSP_DSI_LDO_VOLTAGE_MV 2500
 
 IRAM_ATTR static bool bsp_display_flush_ready(esp_lcd_panel_handle_t panel, esp_lcd_dpi_panel_event_data_t* edata,
                                               void* user_ctx) {
-    xSemaphoreGiveFromISR(flush_semaphore, NULL);
-    return false;
+    return bsp_display_flush_done_from_isr();
+}
+
+IRAM_ATTR static bool bsp_display_refresh_done(esp_lcd_panel_handle_t panel, esp_lcd_dpi_panel_event_data_t* edata,
+                                               void* user_ctx) {
+    return bsp_display_flip_vblank_from_isr();
 }
 
 static esp_err_t bsp_display_enable_dsi_phy_power(void) {
@@ -50,19 +65,43 @@ static esp_err_t bsp_display_enable_dsi_phy_power(void) {
     return esp_ldo_acquire_channel(&ldo_mipi_phy_config, &ldo_mipi_phy);
 }
 
-static esp_err_t bsp_display_initialize_flush(void) {
-    flush_semaphore = xSemaphoreCreateBinary();
-    xSemaphoreGive(flush_semaphore);
+static esp_err_t bsp_display_initialize_backlight(void) {
+    ledc_timer_config_t timer_config = {
+        .speed_mode      = BSP_LCD_PWM_MODE,
+        .duty_resolution = BSP_LCD_PWM_RESOLUTION,
+        .timer_num       = BSP_LCD_PWM_TIMER,
+        .freq_hz         = BSP_LCD_PWM_FREQ_HZ,
+        .clk_cfg         = LEDC_AUTO_CLK,
+    };
+    ESP_RETURN_ON_ERROR(ledc_timer_config(&timer_config), TAG, "Failed to configure backlight PWM timer");
+
+    ledc_channel_config_t channel_config = {
+        .gpio_num   = BSP_LCD_PWM_PIN,
+        .speed_mode = BSP_LCD_PWM_MODE,
+        .channel    = BSP_LCD_PWM_CHANNEL,
+        .timer_sel  = BSP_LCD_PWM_TIMER,
+        .duty       = (1 << BSP_LCD_PWM_RESOLUTION) - 1,
+        .hpoint     = 0,
+    };
+    return ledc_channel_config(&channel_config);
+}
+
+static esp_err_t bsp_display_initialize_flush(const bsp_display_configuration_t* configuration) {
+    size_t max_in_flight = configuration != NULL ? configuration->max_blits_in_flight : 1;
+    ESP_RETURN_ON_ERROR(bsp_display_flush_initialize(max_in_flight), TAG, "Failed to initialize flush tracking");
     esp_lcd_dpi_panel_event_callbacks_t callbacks = {
         .on_color_trans_done = bsp_display_flush_ready,
+        .on_refresh_done     = bsp_display_refresh_done,
     };
     return esp_lcd_dpi_panel_register_event_callbacks(ek79007_get_panel(), &callbacks, NULL);
 }
 
 static esp_err_t bsp_display_initialize_panel(const bsp_display_configuration_t* configuration) {
+    display_num_fbs = configuration != NULL && configuration->num_fbs > 0 ? configuration->num_fbs : 1;
+
     ek79007_configuration_t ek79007_config = {
         .reset_pin = BSP_LCD_RESET_PIN,
-        .num_fbs   = configuration != NULL ? configuration->num_fbs : 1,
+        .num_fbs   = display_num_fbs,
     };
     ek79007_initialize(&ek79007_config);
     return ESP_OK;
@@ -76,7 +115,8 @@ esp_err_t bsp_display_initialize(const bsp_display_configuration_t* configuratio
     }
     ESP_RETURN_ON_ERROR(bsp_display_enable_dsi_phy_power(), TAG, "Failed to enable DSI PHY power");
     ESP_RETURN_ON_ERROR(bsp_display_initialize_panel(configuration), TAG, "Failed to initialize panel");
-    ESP_RETURN_ON_ERROR(bsp_display_initialize_flush(), TAG, "Failed to initialize flush callback");
+    ESP_RETURN_ON_ERROR(bsp_display_initialize_flush(configuration), TAG, "Failed to initialize flush callback");
+    ESP_RETURN_ON_ERROR(bsp_display_initialize_backlight(), TAG, "Failed to initialize backlight");
     bsp_display_initialized = true;
     return ESP_OK;
 }
@@ -132,7 +172,59 @@ bsp_display_rotation_t bsp_display_get_default_rotation() {
     return BSP_DISPLAY_ROTATION_0;
 }
 
+esp_err_t bsp_display_get_backlight_brightness(uint8_t* out_percentage) {
+    ESP_RETURN_ON_FALSE(out_percentage, ESP_ERR_INVALID_ARG, TAG, "Percentage output argument is NULL");
+    if (!bsp_display_initialized) {
+        return ESP_FAIL;
+    }
+    *out_percentage = display_brightness;
+    return ESP_OK;
+}
+
+esp_err_t bsp_display_set_backlight_brightness(uint8_t percentage) {
+    ESP_RETURN_ON_FALSE(percentage <= 100, ESP_ERR_INVALID_ARG, TAG, "Percentage out of range");
+    if (!bsp_display_initialized) {
+        return ESP_FAIL;
+    }
+    uint32_t duty = (percentage * ((1 << BSP_LCD_PWM_RESOLUTION) - 1)) / 100;
+    ESP_RETURN_ON_ERROR(ledc_set_duty(BSP_LCD_PWM_MODE, BSP_LCD_PWM_CHANNEL, duty), TAG, "Failed to set duty");
+    ESP_RETURN_ON_ERROR(ledc_update_duty(BSP_LCD_PWM_MODE, BSP_LCD_PWM_CHANNEL), TAG, "Failed to update duty");
+    display_brightness = percentage;
+    return ESP_OK;
+}
+
 esp_err_t bsp_display_blit(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer) {
-    xSemaphoreTake(flush_semaphore, pdMS_TO_TICKS(1000));
-    return esp_lcd_panel_draw_bitmap(ek79007_get_panel(), x_start, y_start, x_end, y_end, buffer);
+    return bsp_display_blit_async(x_start, y_start, x_end, y_end, buffer, NULL, NULL);
+}
+
+esp_err_t bsp_display_blit_async(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer,
+                                 bsp_display_blit_done_cb_t callback, void* user_ctx) {
+    ESP_RETURN_ON_ERROR(bsp_display_flush_begin(callback, user_ctx, pdMS_TO_TICKS(1000)), TAG,
+                        "Timeout while waiting for previous flush");
+    int64_t   start = bsp_display_stats_now();
+    esp_err_t res   = esp_lcd_panel_draw_bitmap(ek79007_get_panel(), x_start, y_start, x_end, y_end, buffer);
+    if (res != ESP_OK) {
+        bsp_display_flush_cancel();
+        return res;
+    }
+    bsp_display_flush_end();
+    bsp_display_stats_record_blit(x_start, y_start, x_end, y_end, start);
+    return ESP_OK;
+}
+
+esp_err_t bsp_display_get_framebuffers(void** out_fbs, size_t max_fbs, size_t* out_num_fbs) {
+    if (!bsp_display_initialized) {
+        return ESP_FAIL;
+    }
+    ESP_RETURN_ON_FALSE(out_fbs != NULL && out_num_fbs != NULL, ESP_ERR_INVALID_ARG, TAG, "Output argument is NULL");
+
+    void* fbs[BSP_DISPLAY_MAX_FRAMEBUFFERS] = {NULL};
+
+    esp_err_t res = esp_lcd_dpi_panel_get_frame_buffer(ek79007_get_panel(), display_num_fbs, &fbs[0], &fbs[1], &fbs[2]);
+    ESP_RETURN_ON_ERROR(res, TAG, "Failed to get framebuffers");
+    for (size_t i = 0; i < display_num_fbs && i < max_fbs; i++) {
+        out_fbs[i] = fbs[i];
+    }
+    *out_num_fbs = display_num_fbs;
+    return ESP_OK;
 }
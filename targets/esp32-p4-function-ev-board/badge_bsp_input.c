@@ -1,6 +1,7 @@
 #include <inttypes.h>
 #include <stdint.h>
 #include <string.h>
+#include "badge_bsp_input_queue.h"
 #include "bsp/display.h"
 #include "bsp/i2c.h"
 #include "bsp/input.h"
@@ -16,15 +17,11 @@
 
 static char const* TAG = "BSP: INPUT";
 
-static QueueHandle_t             event_queue  = NULL;
 static esp_lcd_panel_io_handle_t tp_io_handle = NULL;
 static esp_lcd_touch_handle_t    tp_handle    = NULL;
 
 esp_err_t bsp_input_initialize(void) {
-    if (event_queue == NULL) {
-        event_queue = xQueueCreate(32, sizeof(bsp_input_event_t));
-        ESP_RETURN_ON_FALSE(event_queue, ESP_ERR_NO_MEM, TAG, "Failed to create input event queue");
-    }
+    ESP_RETURN_ON_ERROR(bsp_input_queue_initialize(), TAG, "Failed to initialize input event queue");
 
     // GT911 touch screen
     i2c_master_bus_handle_t i2c_bus = NULL;
@@ -84,14 +81,7 @@ esp_err_t bsp_input_initialize(void) {
 }
 
 esp_err_t bsp_input_get_queue(QueueHandle_t* out_queue) {
-    if (out_queue == NULL) {
-        return ESP_ERR_INVALID_ARG;
-    }
-    if (event_queue == NULL) {
-        return ESP_FAIL;
-    }
-    *out_queue = event_queue;
-    return ESP_OK;
+    return bsp_input_queue_get_handle(out_queue);
 }
 
 bool bsp_input_needs_on_screen_keyboard(void) {
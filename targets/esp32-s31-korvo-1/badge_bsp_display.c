@@ -1,6 +1,9 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
+#include "badge_bsp_display_flip.h"
+#include "badge_bsp_display_flush.h"
+#include "badge_bsp_display_stats.h"
 #include "bsp/device.h"
 #include "bsp/display.h"
 #include "driver/gpio.h"
@@ -38,25 +41,50 @@
 #define LCD_DATA14_GPIO     GPIO_NUM_35   // R6
 #define LCD_DATA15_GPIO     GPIO_NUM_36   // R7
 
+#define LCD_H_RES 800
+#define LCD_V_RES 480
+
 static char const* TAG = "BSP display";
 
-static bool bsp_display_initialized = false;
-static esp_lcd_panel_handle_t lcd_panel = NULL;
-static SemaphoreHandle_t        flush_semaphore         = NULL;
+static bool                   bsp_display_initialized = false;
+static esp_lcd_panel_handle_t lcd_panel               = NULL;
+static size_t                 display_num_fbs         = 1;
+static bool                   display_restart_vsync   = false;
 
 IRAM_ATTR static bool bsp_display_flush_ready(esp_lcd_panel_handle_t panel, const esp_lcd_rgb_panel_event_data_t* edata,
                                               void* user_ctx) {
-    xSemaphoreGiveFromISR(flush_semaphore, NULL);
-    return false;
+    return bsp_display_flush_done_from_isr();
+}
+
+IRAM_ATTR static bool bsp_display_vsync(esp_lcd_panel_handle_t panel, const esp_lcd_rgb_panel_event_data_t* edata,
+                                        void* user_ctx) {
+    if (display_restart_vsync) {
+        // Only flags the bounce buffer interrupt to restart the DMA from the first line of the framebuffer, which
+        // recovers a picture that drifted because a bounce buffer could not be refilled from PSRAM in time
+        esp_lcd_rgb_panel_restart(panel);
+    }
+    return bsp_display_flip_vblank_from_isr();
 }
 
 static esp_err_t bsp_display_initialize_panel(const bsp_display_configuration_t* configuration) {
+    display_num_fbs = configuration != NULL && configuration->num_fbs > 0 ? configuration->num_fbs : 1;
+
+    // Bounce buffers are refilled from the PSRAM framebuffer by the CPU, so scan-out keeps reading internal RAM when
+    // other bus masters load the PSRAM. The driver alternates between two of them, so they have to split the frame
+    // into an even number of parts.
+    size_t bounce_lines = configuration != NULL ? configuration->bounce_buffer_lines : 0;
+    ESP_RETURN_ON_FALSE(bounce_lines == 0 || (LCD_V_RES % bounce_lines == 0 && (LCD_V_RES / bounce_lines) % 2 == 0),
+                        ESP_ERR_INVALID_ARG, TAG, "Bounce buffers must split the frame into an even number of parts");
+    display_restart_vsync = configuration != NULL && configuration->restart_on_vsync;
+    ESP_RETURN_ON_FALSE(!display_restart_vsync || bounce_lines > 0, ESP_ERR_INVALID_ARG, TAG,
+                        "Restarting on vsync requires bounce buffers");
+
     esp_lcd_rgb_panel_config_t rgb_cfg = {
         .clk_src = LCD_CLK_SRC_PLL160M,
         .timings = {
             .pclk_hz = 18 * 1000 * 1000,          // 18 MHz
-            .h_res = 800,
-            .v_res = 480,
+            .h_res = LCD_H_RES,
+            .v_res = LCD_V_RES,
             .hsync_pulse_width = 40,
             .hsync_back_porch = 40,
             .hsync_front_porch = 48,
@@ -70,8 +98,8 @@ static esp_err_t bsp_display_initialize_panel(const bsp_display_configuration_t*
         .data_width = 16,
         .in_color_format = LCD_COLOR_FMT_RGB565,
         .out_color_format = LCD_COLOR_FMT_RGB565,
-        .num_fbs = configuration->num_fbs,
-        .bounce_buffer_size_px = 0,
+        .num_fbs = display_num_fbs,
+        .bounce_buffer_size_px = bounce_lines * LCD_H_RES,
         .dma_burst_size = 64,
         .hsync_gpio_num = LCD_HSYNC_GPIO,
         .vsync_gpio_num = LCD_VSYNC_GPIO,
@@ -120,11 +148,12 @@ static esp_err_t bsp_display_initialize_panel(const bsp_display_configuration_t*
 }
 
 
-static esp_err_t bsp_display_initialize_flush(void) {
-    flush_semaphore = xSemaphoreCreateBinary();
-    xSemaphoreGive(flush_semaphore);
+static esp_err_t bsp_display_initialize_flush(const bsp_display_configuration_t* configuration) {
+    size_t max_in_flight = configuration != NULL ? configuration->max_blits_in_flight : 1;
+    ESP_RETURN_ON_ERROR(bsp_display_flush_initialize(max_in_flight), TAG, "Failed to initialize flush tracking");
     esp_lcd_rgb_panel_event_callbacks_t callbacks = {
         .on_color_trans_done = bsp_display_flush_ready,
+        .on_vsync            = bsp_display_vsync,
     };
     return esp_lcd_rgb_panel_register_event_callbacks(lcd_panel, &callbacks, NULL);
 }
@@ -136,7 +165,7 @@ esp_err_t bsp_display_initialize(const bsp_display_configuration_t* configuratio
         return ESP_OK;
     }
     ESP_RETURN_ON_ERROR(bsp_display_initialize_panel(configuration), TAG, "Failed to initialize panel");
-    ESP_RETURN_ON_ERROR(bsp_display_initialize_flush(), TAG, "Failed to initialize flush callback");
+    ESP_RETURN_ON_ERROR(bsp_display_initialize_flush(configuration), TAG, "Failed to initialize flush callback");
     bsp_display_initialized = true;
     return ESP_OK;
 }
@@ -148,11 +177,11 @@ esp_err_t bsp_display_get_parameters(size_t* h_res, size_t* v_res, bsp_display_c
     }
 
     if (h_res) {
-        *h_res = 800;
+        *h_res = LCD_H_RES;
     }
 
     if (v_res) {
-        *v_res = 480;
+        *v_res = LCD_V_RES;
     }
 
     if (color_fmt) {
@@ -187,6 +216,37 @@ bsp_display_rotation_t bsp_display_get_default_rotation() {
 }
 
 esp_err_t bsp_display_blit(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer) {
-    xSemaphoreTake(flush_semaphore, pdMS_TO_TICKS(1000));
-    return esp_lcd_panel_draw_bitmap(lcd_panel, x_start, y_start, x_end, y_end, buffer);
+    return bsp_display_blit_async(x_start, y_start, x_end, y_end, buffer, NULL, NULL);
+}
+
+esp_err_t bsp_display_blit_async(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer,
+                                 bsp_display_blit_done_cb_t callback, void* user_ctx) {
+    ESP_RETURN_ON_ERROR(bsp_display_flush_begin(callback, user_ctx, pdMS_TO_TICKS(1000)), TAG,
+                        "Timeout while waiting for previous flush");
+    int64_t   start = bsp_display_stats_now();
+    esp_err_t res   = esp_lcd_panel_draw_bitmap(lcd_panel, x_start, y_start, x_end, y_end, buffer);
+    if (res != ESP_OK) {
+        bsp_display_flush_cancel();
+        return res;
+    }
+    bsp_display_flush_end();
+    bsp_display_stats_record_blit(x_start, y_start, x_end, y_end, start);
+    return ESP_OK;
+}
+
+esp_err_t bsp_display_get_framebuffers(void** out_fbs, size_t max_fbs, size_t* out_num_fbs) {
+    if (!bsp_display_initialized) {
+        return ESP_FAIL;
+    }
+    ESP_RETURN_ON_FALSE(out_fbs != NULL && out_num_fbs != NULL, ESP_ERR_INVALID_ARG, TAG, "Output argument is NULL");
+
+    void* fbs[BSP_DISPLAY_MAX_FRAMEBUFFERS] = {NULL};
+
+    esp_err_t res = esp_lcd_rgb_panel_get_frame_buffer(lcd_panel, display_num_fbs, &fbs[0], &fbs[1], &fbs[2]);
+    ESP_RETURN_ON_ERROR(res, TAG, "Failed to get framebuffers");
+    for (size_t i = 0; i < display_num_fbs && i < max_fbs; i++) {
+        out_fbs[i] = fbs[i];
+    }
+    *out_num_fbs = display_num_fbs;
+    return ESP_OK;
 }
@@ -1,10 +1,15 @@
 // SPDX-FileCopyrightText: 2026 Nicolai Electronics
 // SPDX-License-Identifier: MIT
 
+#include <stdint.h>
+#include <string.h>
+#include "badge_bsp_display_stats.h"
+#include "badge_bsp_lcd_init.h"
 #include "bsp/display.h"
 #include "driver/gpio.h"
 #include "driver/spi_common.h"
 #include "driver/spi_master.h"
+#include "esp_attr.h"
 #include "esp_err.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
@@ -12,9 +17,17 @@
 
 #define MAX_TRANSFER_SIZE (4096 * 8)
 
+// Number of pixel data transactions queued at once, one is sent while the next one is being set up
+#define PIXEL_QUEUE_DEPTH 2
+
+// Level of the DC pin, passed to the pre-transfer callback through the user field of each transaction
+#define LCD_DC_COMMAND 0
+#define LCD_DC_DATA    1
+
 static const char* TAG = "BSP DISPLAY";
 
 static spi_device_handle_t device;
+static spi_transaction_t   pixel_transactions[PIXEL_QUEUE_DEPTH];
 
 static esp_err_t spi_initialize(void) {
     spi_bus_config_t buscfg = {
@@ -29,54 +42,212 @@ static esp_err_t spi_initialize(void) {
     return spi_bus_initialize(SPI2_HOST, &buscfg, SPI_DMA_CH_AUTO);
 }
 
-static esp_err_t send_command(uint8_t command, uint8_t num_params, uint8_t* params) {
-    esp_err_t res;
+IRAM_ATTR static void lcd_spi_pre_transfer_callback(spi_transaction_t* transaction) {
+    gpio_set_level(BSP_LCD_DC, (int)(intptr_t)transaction->user);
+}
 
-    res = spi_device_acquire_bus(device, portMAX_DELAY);
-    if (res != ESP_OK) {
-        return res;
+// Send a short command or parameter block, the bus must have been acquired by the caller
+static esp_err_t write_polling(int dc, size_t length, const uint8_t* data) {
+    spi_transaction_t transaction = {
+        .length = length * 8,
+        .user   = (void*)(intptr_t)dc,
+    };
+    if (length <= sizeof(transaction.tx_data)) {
+        transaction.flags = SPI_TRANS_USE_TXDATA;
+        memcpy(transaction.tx_data, data, length);
+    } else {
+        transaction.tx_buffer = data;
     }
+    return spi_device_polling_transmit(device, &transaction);
+}
 
-    gpio_set_level(BSP_LCD_DC, 0);
-    spi_transaction_t cmd_trans = {
-        .flags     = 0,
-        .length    = 8,
-        .tx_buffer = &command,
-    };
-    res = spi_device_transmit(device, &cmd_trans);
-    // printf("Command 0x%02x with %u parameters: 0x%02x\r\n", command, num_params, res);
+static esp_err_t send_command_locked(uint8_t command, uint8_t num_params, const uint8_t* params) {
+    esp_err_t res = write_polling(LCD_DC_COMMAND, 1, &command);
     if (res != ESP_OK || num_params == 0) {
-        spi_device_release_bus(device);
         return res;
     }
-
-    gpio_set_level(BSP_LCD_DC, 1);
-    spi_transaction_t data_trans = {
-        .flags     = 0,
-        .length    = num_params * 8,
-        .tx_buffer = params,
-    };
-    res = spi_device_transmit(device, &data_trans);
-    spi_device_release_bus(device);
-    return res;
+    return write_polling(LCD_DC_DATA, num_params, params);
 }
 
-static esp_err_t send_data(size_t length, const uint8_t* data) {
-    gpio_set_level(BSP_LCD_DC, 1);
-    esp_err_t res = ESP_OK;
-    while (length > 0 && res == ESP_OK) {
-        size_t            chunk       = length < MAX_TRANSFER_SIZE ? length : MAX_TRANSFER_SIZE;
-        spi_transaction_t transaction = {
-            .length    = chunk * 8,
-            .tx_buffer = data,
-        };
-        res     = spi_device_transmit(device, &transaction);
+// Stream pixel data through the DMA queue, the bus must have been acquired by the caller
+static esp_err_t send_data_locked(size_t length, const uint8_t* data) {
+    esp_err_t res    = ESP_OK;
+    size_t    queued = 0;
+    size_t    next   = 0;
+
+    while (length > 0) {
+        if (queued == PIXEL_QUEUE_DEPTH) {
+            spi_transaction_t* done = NULL;
+            res                     = spi_device_get_trans_result(device, &done, portMAX_DELAY);
+            if (res != ESP_OK) {
+                break;
+            }
+            queued--;
+        }
+
+        size_t             chunk       = length < MAX_TRANSFER_SIZE ? length : MAX_TRANSFER_SIZE;
+        spi_transaction_t* transaction = &pixel_transactions[next];
+        memset(transaction, 0, sizeof(spi_transaction_t));
+        transaction->length    = chunk * 8;
+        transaction->tx_buffer = data;
+        transaction->user      = (void*)LCD_DC_DATA;
+
+        res = spi_device_queue_trans(device, transaction, portMAX_DELAY);
+        if (res != ESP_OK) {
+            break;
+        }
+        queued++;
+        next    = (next + 1) % PIXEL_QUEUE_DEPTH;
         data   += chunk;
         length -= chunk;
     }
+
+    // Collect the remaining transactions before the bus is released or the buffer is reused
+    while (queued > 0) {
+        spi_transaction_t* done   = NULL;
+        esp_err_t          result = spi_device_get_trans_result(device, &done, portMAX_DELAY);
+        if (result != ESP_OK && res == ESP_OK) {
+            res = result;
+        }
+        queued--;
+    }
     return res;
 }
 
+// Panel initialization sequence
+static const uint8_t lcd_init_table[] = {
+    BSP_LCD_INIT_CMD(0xFF, 0xA5),
+
+    BSP_LCD_INIT_CMD(0x9a, 0x08),
+    BSP_LCD_INIT_CMD(0x9b, 0x08),
+    BSP_LCD_INIT_CMD(0x9c, 0xb0),
+    BSP_LCD_INIT_CMD(0x9d, 0x16),
+    BSP_LCD_INIT_CMD(0x9e, 0xc4),
+    BSP_LCD_INIT_CMD(0x8f, 0x55, 0x04),
+    BSP_LCD_INIT_CMD(0x84, 0x90),
+    BSP_LCD_INIT_CMD(0x83, 0x7b),
+    BSP_LCD_INIT_CMD(0x85, 0x33),
+    BSP_LCD_INIT_CMD(0x60, 0x00),
+    BSP_LCD_INIT_CMD(0x70, 0x00),
+    BSP_LCD_INIT_CMD(0x61, 0x02),
+    BSP_LCD_INIT_CMD(0x71, 0x02),
+    BSP_LCD_INIT_CMD(0x62, 0x04),
+    BSP_LCD_INIT_CMD(0x72, 0x04),
+    BSP_LCD_INIT_CMD(0x6c, 0x29),
+    BSP_LCD_INIT_CMD(0x7c, 0x29),
+    BSP_LCD_INIT_CMD(0x6d, 0x31),
+    BSP_LCD_INIT_CMD(0x7d, 0x31),
+    BSP_LCD_INIT_CMD(0x6e, 0x0f),
+    BSP_LCD_INIT_CMD(0x7e, 0x0f),
+    BSP_LCD_INIT_CMD(0x66, 0x21),
+    BSP_LCD_INIT_CMD(0x76, 0x21),
+    BSP_LCD_INIT_CMD(0x68, 0x3A),
+    BSP_LCD_INIT_CMD(0x78, 0x3A),
+    BSP_LCD_INIT_CMD(0x63, 0x07),
+    BSP_LCD_INIT_CMD(0x73, 0x07),
+    BSP_LCD_INIT_CMD(0x64, 0x05),
+    BSP_LCD_INIT_CMD(0x74, 0x05),
+    BSP_LCD_INIT_CMD(0x65, 0x02),
+    BSP_LCD_INIT_CMD(0x75, 0x02),
+    BSP_LCD_INIT_CMD(0x67, 0x23),
+    BSP_LCD_INIT_CMD(0x77, 0x23),
+    BSP_LCD_INIT_CMD(0x69, 0x08),
+    BSP_LCD_INIT_CMD(0x79, 0x08),
+    BSP_LCD_INIT_CMD(0x6a, 0x13),
+    BSP_LCD_INIT_CMD(0x7a, 0x13),
+    BSP_LCD_INIT_CMD(0x6b, 0x13),
+    BSP_LCD_INIT_CMD(0x7b, 0x13),
+    BSP_LCD_INIT_CMD(0x6f, 0x00),
+    BSP_LCD_INIT_CMD(0x7f, 0x00),
+    BSP_LCD_INIT_CMD(0x50, 0x00),
+    BSP_LCD_INIT_CMD(0x52, 0xd6),
+    BSP_LCD_INIT_CMD(0x53, 0x08),
+    BSP_LCD_INIT_CMD(0x54, 0x08),
+    BSP_LCD_INIT_CMD(0x55, 0x1e),
+    BSP_LCD_INIT_CMD(0x56, 0x1c),
+
+    BSP_LCD_INIT_CMD(0xa0, 0x2b, 0x24, 0x00),
+
+    BSP_LCD_INIT_CMD(0xa1, 0x87),
+    BSP_LCD_INIT_CMD(0xa2, 0x86),
+    BSP_LCD_INIT_CMD(0xa5, 0x00),
+    BSP_LCD_INIT_CMD(0xa6, 0x00),
+    BSP_LCD_INIT_CMD(0xa7, 0x00),
+    BSP_LCD_INIT_CMD(0xa8, 0x36),
+    BSP_LCD_INIT_CMD(0xa9, 0x7e),
+    BSP_LCD_INIT_CMD(0xaa, 0x7e),
+    BSP_LCD_INIT_CMD(0xB9, 0x85),
+    BSP_LCD_INIT_CMD(0xBA, 0x84),
+    BSP_LCD_INIT_CMD(0xBB, 0x83),
+    BSP_LCD_INIT_CMD(0xBC, 0x82),
+    BSP_LCD_INIT_CMD(0xBD, 0x81),
+    BSP_LCD_INIT_CMD(0xBE, 0x80),
+    BSP_LCD_INIT_CMD(0xBF, 0x01),
+    BSP_LCD_INIT_CMD(0xC0, 0x02),
+    BSP_LCD_INIT_CMD(0xc1, 0x00),
+    BSP_LCD_INIT_CMD(0xc2, 0x00),
+    BSP_LCD_INIT_CMD(0xc3, 0x00),
+    BSP_LCD_INIT_CMD(0xc4, 0x33),
+    BSP_LCD_INIT_CMD(0xc5, 0x7e),
+    BSP_LCD_INIT_CMD(0xc6, 0x7e),
+    BSP_LCD_INIT_CMD(0xC8, 0x33, 0x33),
+    BSP_LCD_INIT_CMD(0xC9, 0x68),
+    BSP_LCD_INIT_CMD(0xCA, 0x69),
+    BSP_LCD_INIT_CMD(0xCB, 0x6a),
+    BSP_LCD_INIT_CMD(0xCC, 0x6b),
+    BSP_LCD_INIT_CMD(0xCD, 0x33, 0x33),
+    BSP_LCD_INIT_CMD(0xCE, 0x6c),
+    BSP_LCD_INIT_CMD(0xCF, 0x6d),
+    BSP_LCD_INIT_CMD(0xD0, 0x6e),
+    BSP_LCD_INIT_CMD(0xD1, 0x6f),
+    BSP_LCD_INIT_CMD(0xAB, 0x03, 0x67),
+    BSP_LCD_INIT_CMD(0xAC, 0x03, 0x6b),
+    BSP_LCD_INIT_CMD(0xAD, 0x03, 0x68),
+    BSP_LCD_INIT_CMD(0xAE, 0x03, 0x6c),
+    BSP_LCD_INIT_CMD(0xb3, 0x00),
+    BSP_LCD_INIT_CMD(0xb4, 0x00),
+    BSP_LCD_INIT_CMD(0xb5, 0x00),
+    BSP_LCD_INIT_CMD(0xB6, 0x32),
+    BSP_LCD_INIT_CMD(0xB7, 0x7e),
+    BSP_LCD_INIT_CMD(0xB8, 0x7e),
+    BSP_LCD_INIT_CMD(0xe0, 0x00),
+    BSP_LCD_INIT_CMD(0xe1, 0x03, 0x0f),
+    BSP_LCD_INIT_CMD(0xe2, 0x04),
+    BSP_LCD_INIT_CMD(0xe3, 0x01),
+    BSP_LCD_INIT_CMD(0xe4, 0x0e),
+    BSP_LCD_INIT_CMD(0xe5, 0x01),
+    BSP_LCD_INIT_CMD(0xe6, 0x19),
+    BSP_LCD_INIT_CMD(0xe7, 0x10),
+    BSP_LCD_INIT_CMD(0xe8, 0x10),
+    BSP_LCD_INIT_CMD(0xea, 0x12),
+    BSP_LCD_INIT_CMD(0xeb, 0xd0),
+    BSP_LCD_INIT_CMD(0xec, 0x04),
+    BSP_LCD_INIT_CMD(0xed, 0x07),
+    BSP_LCD_INIT_CMD(0xee, 0x07),
+    BSP_LCD_INIT_CMD(0xef, 0x09),
+    BSP_LCD_INIT_CMD(0xf0, 0xd0),
+    BSP_LCD_INIT_CMD(0xf1, 0x0e),
+    BSP_LCD_INIT_CMD(0xF9, 0x17),
+
+    BSP_LCD_INIT_CMD(0xf2, 0x2c, 0x1b, 0x0b, 0x20),
+
+    BSP_LCD_INIT_CMD(0xe9, 0x29),
+    BSP_LCD_INIT_CMD(0xec, 0x04),
+    BSP_LCD_INIT_CMD(0x35, 0x00),
+    BSP_LCD_INIT_CMD(0x44, 0x00, 0x10),
+    BSP_LCD_INIT_CMD(0x46, 0x10),
+
+    BSP_LCD_INIT_DELAY(10),
+
+    BSP_LCD_INIT_CMD(0xFF, 0x00),
+
+    BSP_LCD_INIT_CMD(0x3a, 0x05),
+    BSP_LCD_INIT_CMD0(0x11),
+    BSP_LCD_INIT_DELAY(30),
+    BSP_LCD_INIT_CMD0(0x29),
+    BSP_LCD_INIT_END(),
+};
+
 esp_err_t bsp_display_initialize(const bsp_display_configuration_t* configuration) {
     (void)configuration;
 
@@ -102,6 +273,7 @@ esp_err_t bsp_display_initialize(const bsp_display_configuration_t* configuratio
         .mode           = 0,
         .spics_io_num   = BSP_LCD_CS,
         .queue_size     = 8,
+        .pre_cb         = lcd_spi_pre_transfer_callback,
     };
     res = spi_bus_add_device(SPI2_HOST, &devcfg, &device);
     if (res != ESP_OK) {
@@ -116,135 +288,11 @@ esp_err_t bsp_display_initialize(const bsp_display_configuration_t* configuratio
     gpio_set_level(BSP_LCD_RESET, 1);
     vTaskDelay(pdMS_TO_TICKS(120));
 
-    send_command(0xFF, 1, (uint8_t[]){0xA5});
-
-    send_command(0x9a, 1, (uint8_t[]){0x08});
-    send_command(0x9b, 1, (uint8_t[]){0x08});
-    send_command(0x9c, 1, (uint8_t[]){0xb0});
-    send_command(0x9d, 1, (uint8_t[]){0x16});
-    send_command(0x9e, 1, (uint8_t[]){0xc4});
-    send_command(0x8f, 2, (uint8_t[]){0x55, 0x04});
-    send_command(0x84, 1, (uint8_t[]){0x90});
-    send_command(0x83, 1, (uint8_t[]){0x7b});
-    send_command(0x85, 1, (uint8_t[]){0x33});
-    send_command(0x60, 1, (uint8_t[]){0x00});
-    send_command(0x70, 1, (uint8_t[]){0x00});
-    send_command(0x61, 1, (uint8_t[]){0x02});
-    send_command(0x71, 1, (uint8_t[]){0x02});
-    send_command(0x62, 1, (uint8_t[]){0x04});
-    send_command(0x72, 1, (uint8_t[]){0x04});
-    send_command(0x6c, 1, (uint8_t[]){0x29});
-    send_command(0x7c, 1, (uint8_t[]){0x29});
-    send_command(0x6d, 1, (uint8_t[]){0x31});
-    send_command(0x7d, 1, (uint8_t[]){0x31});
-    send_command(0x6e, 1, (uint8_t[]){0x0f});
-    send_command(0x7e, 1, (uint8_t[]){0x0f});
-    send_command(0x66, 1, (uint8_t[]){0x21});
-    send_command(0x76, 1, (uint8_t[]){0x21});
-    send_command(0x68, 1, (uint8_t[]){0x3A});
-    send_command(0x78, 1, (uint8_t[]){0x3A});
-    send_command(0x63, 1, (uint8_t[]){0x07});
-    send_command(0x73, 1, (uint8_t[]){0x07});
-    send_command(0x64, 1, (uint8_t[]){0x05});
-    send_command(0x74, 1, (uint8_t[]){0x05});
-    send_command(0x65, 1, (uint8_t[]){0x02});
-    send_command(0x75, 1, (uint8_t[]){0x02});
-    send_command(0x67, 1, (uint8_t[]){0x23});
-    send_command(0x77, 1, (uint8_t[]){0x23});
-    send_command(0x69, 1, (uint8_t[]){0x08});
-    send_command(0x79, 1, (uint8_t[]){0x08});
-    send_command(0x6a, 1, (uint8_t[]){0x13});
-    send_command(0x7a, 1, (uint8_t[]){0x13});
-    send_command(0x6b, 1, (uint8_t[]){0x13});
-    send_command(0x7b, 1, (uint8_t[]){0x13});
-    send_command(0x6f, 1, (uint8_t[]){0x00});
-    send_command(0x7f, 1, (uint8_t[]){0x00});
-    send_command(0x50, 1, (uint8_t[]){0x00});
-    send_command(0x52, 1, (uint8_t[]){0xd6});
-    send_command(0x53, 1, (uint8_t[]){0x08});
-    send_command(0x54, 1, (uint8_t[]){0x08});
-    send_command(0x55, 1, (uint8_t[]){0x1e});
-    send_command(0x56, 1, (uint8_t[]){0x1c});
-
-    send_command(0xa0, 3, (uint8_t[]){0x2b, 0x24, 0x00});
-
-    send_command(0xa1, 1, (uint8_t[]){0x87});
-    send_command(0xa2, 1, (uint8_t[]){0x86});
-    send_command(0xa5, 1, (uint8_t[]){0x00});
-    send_command(0xa6, 1, (uint8_t[]){0x00});
-    send_command(0xa7, 1, (uint8_t[]){0x00});
-    send_command(0xa8, 1, (uint8_t[]){0x36});
-    send_command(0xa9, 1, (uint8_t[]){0x7e});
-    send_command(0xaa, 1, (uint8_t[]){0x7e});
-    send_command(0xB9, 1, (uint8_t[]){0x85});
-    send_command(0xBA, 1, (uint8_t[]){0x84});
-    send_command(0xBB, 1, (uint8_t[]){0x83});
-    send_command(0xBC, 1, (uint8_t[]){0x82});
-    send_command(0xBD, 1, (uint8_t[]){0x81});
-    send_command(0xBE, 1, (uint8_t[]){0x80});
-    send_command(0xBF, 1, (uint8_t[]){0x01});
-    send_command(0xC0, 1, (uint8_t[]){0x02});
-    send_command(0xc1, 1, (uint8_t[]){0x00});
-    send_command(0xc2, 1, (uint8_t[]){0x00});
-    send_command(0xc3, 1, (uint8_t[]){0x00});
-    send_command(0xc4, 1, (uint8_t[]){0x33});
-    send_command(0xc5, 1, (uint8_t[]){0x7e});
-    send_command(0xc6, 1, (uint8_t[]){0x7e});
-    send_command(0xC8, 2, (uint8_t[]){0x33, 0x33});
-    send_command(0xC9, 1, (uint8_t[]){0x68});
-    send_command(0xCA, 1, (uint8_t[]){0x69});
-    send_command(0xCB, 1, (uint8_t[]){0x6a});
-    send_command(0xCC, 1, (uint8_t[]){0x6b});
-    send_command(0xCD, 2, (uint8_t[]){0x33, 0x33});
-    send_command(0xCE, 1, (uint8_t[]){0x6c});
-    send_command(0xCF, 1, (uint8_t[]){0x6d});
-    send_command(0xD0, 1, (uint8_t[]){0x6e});
-    send_command(0xD1, 1, (uint8_t[]){0x6f});
-    send_command(0xAB, 2, (uint8_t[]){0x03, 0x67});
-    send_command(0xAC, 2, (uint8_t[]){0x03, 0x6b});
-    send_command(0xAD, 2, (uint8_t[]){0x03, 0x68});
-    send_command(0xAE, 2, (uint8_t[]){0x03, 0x6c});
-    send_command(0xb3, 1, (uint8_t[]){0x00});
-    send_command(0xb4, 1, (uint8_t[]){0x00});
-    send_command(0xb5, 1, (uint8_t[]){0x00});
-    send_command(0xB6, 1, (uint8_t[]){0x32});
-    send_command(0xB7, 1, (uint8_t[]){0x7e});
-    send_command(0xB8, 1, (uint8_t[]){0x7e});
-    send_command(0xe0, 1, (uint8_t[]){0x00});
-    send_command(0xe1, 2, (uint8_t[]){0x03, 0x0f});
-    send_command(0xe2, 1, (uint8_t[]){0x04});
-    send_command(0xe3, 1, (uint8_t[]){0x01});
-    send_command(0xe4, 1, (uint8_t[]){0x0e});
-    send_command(0xe5, 1, (uint8_t[]){0x01});
-    send_command(0xe6, 1, (uint8_t[]){0x19});
-    send_command(0xe7, 1, (uint8_t[]){0x10});
-    send_command(0xe8, 1, (uint8_t[]){0x10});
-    send_command(0xea, 1, (uint8_t[]){0x12});
-    send_command(0xeb, 1, (uint8_t[]){0xd0});
-    send_command(0xec, 1, (uint8_t[]){0x04});
-    send_command(0xed, 1, (uint8_t[]){0x07});
-    send_command(0xee, 1, (uint8_t[]){0x07});
-    send_command(0xef, 1, (uint8_t[]){0x09});
-    send_command(0xf0, 1, (uint8_t[]){0xd0});
-    send_command(0xf1, 1, (uint8_t[]){0x0e});
-    send_command(0xF9, 1, (uint8_t[]){0x17});
-
-    send_command(0xf2, 4, (uint8_t[]){0x2c, 0x1b, 0x0b, 0x20});
-
-    send_command(0xe9, 1, (uint8_t[]){0x29});
-    send_command(0xec, 1, (uint8_t[]){0x04});
-    send_command(0x35, 1, (uint8_t[]){0x00});
-    send_command(0x44, 2, (uint8_t[]){0x00, 0x10});
-    send_command(0x46, 1, (uint8_t[]){0x10});
-
-    vTaskDelay(pdMS_TO_TICKS(10));
-
-    send_command(0xFF, 1, (uint8_t[]){0x00});
-
-    send_command(0x3a, 1, (uint8_t[]){0x05});
-    send_command(0x11, 0, NULL);
-    vTaskDelay(pdMS_TO_TICKS(30));
-    send_command(0x29, 0, NULL);
+    res = bsp_lcd_init_run_spi(device, lcd_init_table);
+    if (res != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to send display init sequence");
+        return res;
+    }
 
     ESP_LOGI(TAG, "Display init done");
 
@@ -305,21 +353,43 @@ esp_err_t bsp_display_blit(size_t x_start, size_t y_start, size_t x_end, size_t
     x_start       += offset;
     x_end         += offset;
 
-    send_command(0x2A, 4,
-                 (uint8_t[]){
-                     (x_start >> 8) & 0xFF,
-                     x_start & 0xFF,
-                     ((x_end - 1) >> 8) & 0xFF,
-                     (x_end - 1) & 0xFF,
-                 });
-    send_command(0x2B, 4,
-                 (uint8_t[]){
-                     (y_start >> 8) & 0xFF,
-                     y_start & 0xFF,
-                     ((y_end - 1) >> 8) & 0xFF,
-                     (y_end - 1) & 0xFF,
-                 });
-    send_command(0x2C, 0, NULL);
-    size_t pixel_count = (x_end - x_start) * (y_end - y_start);
-    return send_data(pixel_count * 2, (const uint8_t*)buffer);
+    // Hold the bus for the whole frame so the address window and pixel data are sent back to back
+    int64_t   wait_start = bsp_display_stats_now();
+    esp_err_t res        = spi_device_acquire_bus(device, portMAX_DELAY);
+    if (res != ESP_OK) {
+        return res;
+    }
+    bsp_display_stats_record_wait(wait_start, false);
+
+    int64_t start = bsp_display_stats_now();
+
+    res = send_command_locked(0x2A, 4,
+                              (uint8_t[]){
+                                  (x_start >> 8) & 0xFF,
+                                  x_start & 0xFF,
+                                  ((x_end - 1) >> 8) & 0xFF,
+                                  (x_end - 1) & 0xFF,
+                              });
+    if (res == ESP_OK) {
+        res = send_command_locked(0x2B, 4,
+                                  (uint8_t[]){
+                                      (y_start >> 8) & 0xFF,
+                                      y_start & 0xFF,
+                                      ((y_end - 1) >> 8) & 0xFF,
+                                      (y_end - 1) & 0xFF,
+                                  });
+    }
+    if (res == ESP_OK) {
+        res = send_command_locked(0x2C, 0, NULL);
+    }
+    if (res == ESP_OK) {
+        size_t pixel_count = (x_end - x_start) * (y_end - y_start);
+        res                = send_data_locked(pixel_count * 2, (const uint8_t*)buffer);
+    }
+
+    spi_device_release_bus(device);
+    if (res == ESP_OK) {
+        bsp_display_stats_record_blit(x_start, y_start, x_end, y_end, start);
+    }
+    return res;
 }
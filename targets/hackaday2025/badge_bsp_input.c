@@ -3,12 +3,15 @@
 
 #include <stdint.h>
 #include <stdio.h>
-#include "badge_bsp_input_hooks.h"
+#include "badge_bsp_input_queue.h"
+#include "badge_bsp_input_state.h"
+#include "badge_bsp_keymap.h"
 #include "bsp/i2c.h"
 #include "bsp/input.h"
 #include "driver/gpio.h"
 #include "esp_check.h"
 #include "esp_err.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
 #include "hackaday2025_hardware.h"
@@ -16,12 +19,9 @@
 
 static char const* TAG = "BSP INPUT";
 
-static QueueHandle_t    event_queue       = NULL;
 static bool             prev_button_state = false;
 static tca8418_handle_t tca8418_handle    = {0};
-static uint32_t         active_modifiers  = 0;
-static bool             super_used        = false;
-static bool             key_state[128]    = {0};
+static bsp_keymap_t     keymap            = {0};
 
 typedef enum {
     HACKADAY2025_KEY_F1       = 2,
@@ -102,91 +102,107 @@ typedef enum {
     HACKADAY2025_KEY_BACKSPACE   = 79,
 } hackaday2025_keys_t;
 
-static void send_navigation_event(bsp_input_navigation_key_t key, bool state, uint32_t modifiers) {
-    bsp_input_event_t event = {
-        .type                      = INPUT_EVENT_TYPE_NAVIGATION,
-        .args_navigation.key       = key,
-        .args_navigation.modifiers = modifiers,
-        .args_navigation.state     = state,
-    };
-    // Offer to hooks first; if consumed, don't queue
-    if (!bsp_input_hooks_process(&event)) {
-        xQueueSend(event_queue, &event, 0);
-    }
-}
-
-static void send_keyboard_event(char ascii, char const* utf8, uint32_t modifiers) {
-    bsp_input_event_t event = {
-        .type                    = INPUT_EVENT_TYPE_KEYBOARD,
-        .args_keyboard.ascii     = ascii,
-        .args_keyboard.modifiers = modifiers,
-    };
-    strlcpy(event.args_keyboard.utf8, utf8, sizeof(event.args_keyboard.utf8));
-    // Offer to hooks first; if consumed, don't queue
-    if (!bsp_input_hooks_process(&event)) {
-        xQueueSend(event_queue, &event, 0);
-    }
-}
-
-static void send_action_event(bsp_input_action_type_t action, bool state) {
-    bsp_input_event_t event = {
-        .type              = INPUT_EVENT_TYPE_ACTION,
-        .args_action.type  = action,
-        .args_action.state = state,
-    };
-    // Offer to hooks first; if consumed, don't queue
-    if (!bsp_input_hooks_process(&event)) {
-        xQueueSend(event_queue, &event, 0);
-    }
-}
-
-static void send_scancode_event(bsp_input_scancode_t scancode, bool state) {
-    bsp_input_event_t event = {
-        .type                   = INPUT_EVENT_TYPE_SCANCODE,
-        .args_scancode.scancode = scancode | (state ? 0 : BSP_INPUT_SCANCODE_RELEASE_MODIFIER),
-    };
-    // Offer to hooks first; if consumed, don't queue
-    if (!bsp_input_hooks_process(&event)) {
-        xQueueSend(event_queue, &event, 0);
-    }
-}
-
-static void handle_keyboard_text_entry(char ascii, char ascii_shift, char const* utf8, char const* utf8_shift,
-                                       char const* utf8_alt, char const* utf8_shift_alt, uint32_t modifiers) {
-    char              value_ascii = (modifiers & BSP_INPUT_MODIFIER_SHIFT) ? ascii_shift : ascii;
-    char const*       value_utf8  = (modifiers & BSP_INPUT_MODIFIER_ALT_R)
-                                        ? ((modifiers & BSP_INPUT_MODIFIER_SHIFT) ? utf8_shift_alt : utf8_alt)
-                                        : ((modifiers & BSP_INPUT_MODIFIER_SHIFT) ? utf8_shift : utf8);
-    bsp_input_event_t event       = {
-        .type                    = INPUT_EVENT_TYPE_KEYBOARD,
-        .args_keyboard.ascii     = value_ascii,
-        .args_keyboard.modifiers = modifiers,
-    };
-    if (value_utf8) {
-        strlcpy(event.args_keyboard.utf8, value_utf8, sizeof(event.args_keyboard.utf8));
-    } else {
-        event.args_keyboard.utf8[0] = value_ascii;
-        event.args_keyboard.utf8[1] = 0;
-    }
-    xQueueSend(event_queue, &event, 0);
-}
+static bsp_keymap_key_t const hackaday2025_keymap[] = {
+    [HACKADAY2025_KEY_F1]            = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_F1, BSP_INPUT_NAVIGATION_KEY_F1),
+    [HACKADAY2025_KEY_NUM_PLUS]      = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_KPPLUS, '+', '+', "+", "+", "+", "+"),
+    [HACKADAY2025_KEY_NUM_9]         = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_9, '9', '(', "9", "(", "‘", "̆"),
+    [HACKADAY2025_KEY_NUM_8]         = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_8, '8', '*', "8", "*", "¾", "̨"),
+    [HACKADAY2025_KEY_NUM_7]         = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_7, '7', '&', "7", "&", "½", "̛"),
+    [HACKADAY2025_KEY_F2]            = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_F2, BSP_INPUT_NAVIGATION_KEY_F2),
+    [HACKADAY2025_KEY_F3]            = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_F3, BSP_INPUT_NAVIGATION_KEY_F3),
+    [HACKADAY2025_KEY_F4]            = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_F4, BSP_INPUT_NAVIGATION_KEY_F4),
+    [HACKADAY2025_KEY_F5]            = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_F5, BSP_INPUT_NAVIGATION_KEY_F5),
+    [HACKADAY2025_KEY_ESC]           = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_ESC, BSP_INPUT_NAVIGATION_KEY_ESC),
+    [HACKADAY2025_KEY_Q]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_Q, 'q', 'Q', "q", "Q", "ä", "Ä"),
+    [HACKADAY2025_KEY_W]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_W, 'w', 'W', "w", "W", "å", "Å"),
+    [HACKADAY2025_KEY_E]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_E, 'e', 'E', "e", "E", "é", "É"),
+    [HACKADAY2025_KEY_R]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_R, 'r', 'R', "r", "R", "®", "™"),
+    [HACKADAY2025_KEY_T]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_T, 't', 'T', "t", "T", "þ", "Þ"),
+    [HACKADAY2025_KEY_Y]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_Y, 'y', 'Y', "y", "Y", "ü", "Ü"),
+    [HACKADAY2025_KEY_U]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_U, 'u', 'U', "u", "U", "ú", "Ú"),
+    [HACKADAY2025_KEY_I]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_I, 'i', 'I', "i", "I", "í", "Í"),
+    [HACKADAY2025_KEY_O]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_O, 'o', 'O', "o", "O", "ó", "Ó"),
+    [HACKADAY2025_KEY_TAB]           = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_TAB, BSP_INPUT_NAVIGATION_KEY_TAB),
+    [HACKADAY2025_KEY_A]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_A, 'a', 'A', "a", "A", "á", "Á"),
+    [HACKADAY2025_KEY_S]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_S, 's', 'S', "s", "S", "ß", "§"),
+    [HACKADAY2025_KEY_D]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_D, 'd', 'D', "d", "D", "ð", "Ð"),
+    [HACKADAY2025_KEY_F]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_F, 'f', 'F', "f", "F", "ë", "Ë"),
+    [HACKADAY2025_KEY_G]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_G, 'g', 'G', "g", "G", "g", "G"),
+    [HACKADAY2025_KEY_H]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_H, 'h', 'H', "h", "H", "h", "H"),
+    [HACKADAY2025_KEY_J]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_J, 'j', 'J', "j", "J", "ï", "Ï"),
+    [HACKADAY2025_KEY_K]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_K, 'k', 'K', "k", "K", "œ", "Œ"),
+    [HACKADAY2025_KEY_L]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_L, 'l', 'L', "l", "L", "ø", "L"),
+    [HACKADAY2025_KEY_LEFT_SHIFT]    = BSP_KEYMAP_MODIFIER(BSP_INPUT_SCANCODE_LEFTSHIFT, BSP_INPUT_MODIFIER_SHIFT_L),
+    [HACKADAY2025_KEY_Z]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_Z, 'z', 'Z', "z", "Z", "æ", "Æ"),
+    [HACKADAY2025_KEY_X]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_X, 'x', 'X', "x", "X", "·", " ̵"),
+    [HACKADAY2025_KEY_C]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_C, 'c', 'C', "c", "C", "©", "¢"),
+    [HACKADAY2025_KEY_V]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_V, 'v', 'V', "v", "V", "v", "V"),
+    [HACKADAY2025_KEY_B]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_B, 'b', 'B', "b", "B", "b", "B"),
+    [HACKADAY2025_KEY_N]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_N, 'n', 'N', "n", "N", "ñ", "Ñ"),
+    [HACKADAY2025_KEY_M]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_M, 'm', 'M', "m", "M", "µ", "±"),
+    [HACKADAY2025_KEY_COMMA]         = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_COMMA, ',', '<', ",", "<", "̧", "̌"),
+    [HACKADAY2025_KEY_DOT]           = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_DOT, '.', '>', ".", ">", "̇", "̌"),
+    [HACKADAY2025_KEY_CTRL]          = BSP_KEYMAP_MODIFIER(BSP_INPUT_SCANCODE_LEFTCTRL, BSP_INPUT_MODIFIER_CTRL_L),
+    [HACKADAY2025_KEY_SUPER]         = BSP_KEYMAP_MODIFIER(BSP_INPUT_SCANCODE_ESCAPED_LEFTMETA,
+                                                           BSP_INPUT_MODIFIER_SUPER_L),
+    [HACKADAY2025_KEY_LEFT_ALT]      = BSP_KEYMAP_MODIFIER(BSP_INPUT_SCANCODE_LEFTALT, BSP_INPUT_MODIFIER_ALT_L),
+    [HACKADAY2025_KEY_BACKSLASH]     = BSP_KEYMAP_SCANCODE(BSP_INPUT_SCANCODE_BACKSLASH),
+    [HACKADAY2025_KEY_SPACE]         = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_SPACE,
+                                                             BSP_INPUT_NAVIGATION_KEY_SPACE_M),
+    [HACKADAY2025_KEY_RIGHT]         = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_ESCAPED_GREY_RIGHT,
+                                                             BSP_INPUT_NAVIGATION_KEY_RIGHT),
+    [HACKADAY2025_KEY_DOWN]          = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_ESCAPED_GREY_DOWN,
+                                                             BSP_INPUT_NAVIGATION_KEY_DOWN),
+    [HACKADAY2025_KEY_LEFT]          = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_ESCAPED_GREY_LEFT,
+                                                             BSP_INPUT_NAVIGATION_KEY_LEFT),
+    [HACKADAY2025_KEY_RIGHT_ALT]     = BSP_KEYMAP_MODIFIER(BSP_INPUT_SCANCODE_ESCAPED_RALT, BSP_INPUT_MODIFIER_ALT_R),
+    [HACKADAY2025_KEY_NUM_MINUS]     = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_KPMINUS, '-', '-', "-", "-", "-", "-"),
+    [HACKADAY2025_KEY_NUM_6]         = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_6, '6', '^', "6", "^", "¼", "̂"),
+    [HACKADAY2025_KEY_NUM_5]         = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_5, '5', '%', "5", "%", "€", "¸"),
+    [HACKADAY2025_KEY_NUM_4]         = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_4, '4', '$', "4", "$", "¤", "£"),
+    [HACKADAY2025_KEY_RIGHT_BRACKET] = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_RIGHTBRACE, ']', '}', "]", "}", "»", "”"),
+    [HACKADAY2025_KEY_LEFT_BRACKET]  = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_LEFTBRACE, '[', '{', "[", "{", "«", "“"),
+    [HACKADAY2025_KEY_P]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_P, 'p', 'P', "p", "P", "ö", "Ö"),
+    [HACKADAY2025_KEY_NUM_ASTERISK]  = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_KPASTERISK, '*', '*', "*", "*", "*", "*"),
+    [HACKADAY2025_KEY_NUM_3]         = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_3, '3', '#', "3", "#", "³", "̄"),
+    [HACKADAY2025_KEY_NUM_2]         = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_2, '2', '@', "2", "@", "²", "̋"),
+    [HACKADAY2025_KEY_NUM_1]         = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_1, '1', '!', "1", "!", "¡", "¹"),
+    [HACKADAY2025_KEY_ENTER]         = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_ENTER, BSP_INPUT_NAVIGATION_KEY_RETURN),
+    [HACKADAY2025_KEY_APOSTROPHE]    = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_APOSTROPHE, '\'', '"', "'", "\"", "́", "̈"),
+    [HACKADAY2025_KEY_SEMICOLON]     = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_SEMICOLON, ';', ':', ";", ":", "̨", "̈"),
+    [HACKADAY2025_KEY_NUM_SLASH]     = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_ESCAPED_GREY_KPSLASH, '/', '/', "/", "/", "/",
+                                                       "/"),
+    [HACKADAY2025_KEY_NUM_EQUALS]    = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_EQUAL, '=', '+', "=", "+", "̋", "̛"),
+    [HACKADAY2025_KEY_NUM_DOT]       = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_KPDOT, '.', '.', ".", ".", ".", "."),
+    [HACKADAY2025_KEY_NUM_0]         = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_0, '0', ')', "0", ")", "’", "̊"),
+    [HACKADAY2025_KEY_RIGHT_SHIFT]   = BSP_KEYMAP_MODIFIER(BSP_INPUT_SCANCODE_RIGHTSHIFT, BSP_INPUT_MODIFIER_SHIFT_R),
+    [HACKADAY2025_KEY_UP]            = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_ESCAPED_GREY_UP,
+                                                             BSP_INPUT_NAVIGATION_KEY_UP),
+    [HACKADAY2025_KEY_BACKSPACE]     = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_BACKSPACE,
+                                                             BSP_INPUT_NAVIGATION_KEY_BACKSPACE),
+};
 
 IRAM_ATTR static void button_interrupt_handler(void* pvParameters) {
     bool state = !gpio_get_level(BSP_GPIO_BTN);  // GPIO is active low
     if (state != prev_button_state) {
         prev_button_state                = state;
+        int64_t           timestamp      = esp_timer_get_time();
         bsp_input_event_t scancode_event = {
             .type                   = INPUT_EVENT_TYPE_SCANCODE,
             .args_scancode.scancode = BSP_INPUT_SCANCODE_ENTER | (state ? 0 : BSP_INPUT_SCANCODE_RELEASE_MODIFIER),
+            .timestamp              = timestamp,
         };
-        xQueueSendFromISR(event_queue, &scancode_event, false);
+        bsp_input_state_update(&scancode_event);
+        bsp_input_queue_send(&scancode_event);
         bsp_input_event_t navigation_event = {
             .type                      = INPUT_EVENT_TYPE_NAVIGATION,
             .args_navigation.key       = BSP_INPUT_NAVIGATION_KEY_RETURN,
             .args_navigation.modifiers = 0,
             .args_navigation.state     = state,
+            .timestamp                 = timestamp,
         };
-        xQueueSendFromISR(event_queue, &navigation_event, false);
+        bsp_input_state_update(&navigation_event);
+        bsp_input_queue_send(&navigation_event);
     }
 }
 
@@ -207,6 +223,7 @@ static void tca8418_gpi_callback(tca8418_handle_t* handle) {
 }
 
 static void tca8418_key_callback(tca8418_handle_t* handle) {
+    int64_t timestamp = esp_timer_get_time();
     // Drain the key event FIFO (up to 10 entries deep)
     for (int i = 0; i < 10; i++) {
         bool    pressed = false;
@@ -215,332 +232,15 @@ static void tca8418_key_callback(tca8418_handle_t* handle) {
             break;
         }
 
-        hackaday2025_keys_t key = (hackaday2025_keys_t)code;
-
-        if (code < sizeof(key_state) / sizeof(key_state[0])) {
-            key_state[code] = pressed;
-        }
-
-        if (key != HACKADAY2025_KEY_SUPER) {
-            super_used = true;
-        }
-
-        switch (key) {
-            case HACKADAY2025_KEY_F1:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_F1, pressed, active_modifiers);
-                send_scancode_event(BSP_INPUT_SCANCODE_F1, pressed);
-                break;
-            case HACKADAY2025_KEY_NUM_PLUS:
-                send_scancode_event(BSP_INPUT_SCANCODE_KPPLUS, pressed);
-                if (pressed) handle_keyboard_text_entry('+', '+', "+", "+", "+", "+", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_NUM_9:
-                send_scancode_event(BSP_INPUT_SCANCODE_9, pressed);
-                if (pressed) handle_keyboard_text_entry('9', '(', "9", "(", "‘", "̆", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_NUM_8:
-                send_scancode_event(BSP_INPUT_SCANCODE_8, pressed);
-                if (pressed) handle_keyboard_text_entry('8', '*', "8", "*", "¾", "̨", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_NUM_7:
-                send_scancode_event(BSP_INPUT_SCANCODE_7, pressed);
-                if (pressed) handle_keyboard_text_entry('7', '&', "7", "&", "½", "̛", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_F2:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_F2, pressed, active_modifiers);
-                send_scancode_event(BSP_INPUT_SCANCODE_F2, pressed);
-                break;
-            case HACKADAY2025_KEY_F3:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_F3, pressed, active_modifiers);
-                send_scancode_event(BSP_INPUT_SCANCODE_F3, pressed);
-                break;
-            case HACKADAY2025_KEY_F4:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_F4, pressed, active_modifiers);
-                send_scancode_event(BSP_INPUT_SCANCODE_F4, pressed);
-                break;
-            case HACKADAY2025_KEY_F5:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_F5, pressed, active_modifiers);
-                send_scancode_event(BSP_INPUT_SCANCODE_F5, pressed);
-                break;
-            case HACKADAY2025_KEY_ESC:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_ESC, pressed, active_modifiers);
-                send_scancode_event(BSP_INPUT_SCANCODE_ESC, pressed);
-                break;
-            case HACKADAY2025_KEY_Q:
-                send_scancode_event(BSP_INPUT_SCANCODE_Q, pressed);
-                if (pressed) handle_keyboard_text_entry('q', 'Q', "q", "Q", "ä", "Ä", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_W:
-                send_scancode_event(BSP_INPUT_SCANCODE_W, pressed);
-                if (pressed) handle_keyboard_text_entry('w', 'W', "w", "W", "å", "Å", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_E:
-                send_scancode_event(BSP_INPUT_SCANCODE_E, pressed);
-                if (pressed) handle_keyboard_text_entry('e', 'E', "e", "E", "é", "É", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_R:
-                send_scancode_event(BSP_INPUT_SCANCODE_R, pressed);
-                if (pressed) handle_keyboard_text_entry('r', 'R', "r", "R", "®", "™", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_T:
-                send_scancode_event(BSP_INPUT_SCANCODE_T, pressed);
-                if (pressed) handle_keyboard_text_entry('t', 'T', "t", "T", "þ", "Þ", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_Y:
-                send_scancode_event(BSP_INPUT_SCANCODE_Y, pressed);
-                if (pressed) handle_keyboard_text_entry('y', 'Y', "y", "Y", "ü", "Ü", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_U:
-                send_scancode_event(BSP_INPUT_SCANCODE_U, pressed);
-                if (pressed) handle_keyboard_text_entry('u', 'U', "u", "U", "ú", "Ú", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_I:
-                send_scancode_event(BSP_INPUT_SCANCODE_I, pressed);
-                if (pressed) handle_keyboard_text_entry('i', 'I', "i", "I", "í", "Í", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_O:
-                send_scancode_event(BSP_INPUT_SCANCODE_O, pressed);
-                if (pressed) handle_keyboard_text_entry('o', 'O', "o", "O", "ó", "Ó", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_TAB:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_TAB, pressed, active_modifiers);
-                send_scancode_event(BSP_INPUT_SCANCODE_TAB, pressed);
-                break;
-            case HACKADAY2025_KEY_A:
-                send_scancode_event(BSP_INPUT_SCANCODE_A, pressed);
-                if (pressed) handle_keyboard_text_entry('a', 'A', "a", "A", "á", "Á", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_S:
-                send_scancode_event(BSP_INPUT_SCANCODE_S, pressed);
-                if (pressed) handle_keyboard_text_entry('s', 'S', "s", "S", "ß", "§", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_D:
-                send_scancode_event(BSP_INPUT_SCANCODE_D, pressed);
-                if (pressed) handle_keyboard_text_entry('d', 'D', "d", "D", "ð", "Ð", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_F:
-                send_scancode_event(BSP_INPUT_SCANCODE_F, pressed);
-                if (pressed) handle_keyboard_text_entry('f', 'F', "f", "F", "ë", "Ë", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_G:
-                send_scancode_event(BSP_INPUT_SCANCODE_G, pressed);
-                if (pressed) handle_keyboard_text_entry('g', 'G', "g", "G", "g", "G", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_H:
-                send_scancode_event(BSP_INPUT_SCANCODE_H, pressed);
-                if (pressed) handle_keyboard_text_entry('h', 'H', "h", "H", "h", "H", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_J:
-                send_scancode_event(BSP_INPUT_SCANCODE_J, pressed);
-                if (pressed) handle_keyboard_text_entry('j', 'J', "j", "J", "ï", "Ï", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_K:
-                send_scancode_event(BSP_INPUT_SCANCODE_K, pressed);
-                if (pressed) handle_keyboard_text_entry('k', 'K', "k", "K", "œ", "Œ", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_L:
-                send_scancode_event(BSP_INPUT_SCANCODE_L, pressed);
-                if (pressed) handle_keyboard_text_entry('l', 'L', "l", "L", "ø", "L", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_LEFT_SHIFT:
-                if (pressed) {
-                    active_modifiers |= BSP_INPUT_MODIFIER_SHIFT_L;
-                } else {
-                    active_modifiers &= ~(BSP_INPUT_MODIFIER_SHIFT_L);
-                }
-                send_scancode_event(BSP_INPUT_SCANCODE_LEFTSHIFT, pressed);
-                break;
-            case HACKADAY2025_KEY_Z:
-                send_scancode_event(BSP_INPUT_SCANCODE_Z, pressed);
-                if (pressed) handle_keyboard_text_entry('z', 'Z', "z", "Z", "æ", "Æ", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_X:
-                send_scancode_event(BSP_INPUT_SCANCODE_X, pressed);
-                if (pressed) handle_keyboard_text_entry('x', 'X', "x", "X", "·", " ̵", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_C:
-                send_scancode_event(BSP_INPUT_SCANCODE_C, pressed);
-                if (pressed) handle_keyboard_text_entry('c', 'C', "c", "C", "©", "¢", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_V:
-                send_scancode_event(BSP_INPUT_SCANCODE_V, pressed);
-                if (pressed) handle_keyboard_text_entry('v', 'V', "v", "V", "v", "V", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_B:
-                send_scancode_event(BSP_INPUT_SCANCODE_B, pressed);
-                if (pressed) handle_keyboard_text_entry('b', 'B', "b", "B", "b", "B", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_N:
-                send_scancode_event(BSP_INPUT_SCANCODE_N, pressed);
-                if (pressed) handle_keyboard_text_entry('n', 'N', "n", "N", "ñ", "Ñ", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_M:
-                send_scancode_event(BSP_INPUT_SCANCODE_M, pressed);
-                if (pressed) handle_keyboard_text_entry('m', 'M', "m", "M", "µ", "±", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_COMMA:
-                send_scancode_event(BSP_INPUT_SCANCODE_COMMA, pressed);
-                if (pressed) handle_keyboard_text_entry(',', '<', ",", "<", "̧", "̌", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_DOT:
-                send_scancode_event(BSP_INPUT_SCANCODE_DOT, pressed);
-                if (pressed) handle_keyboard_text_entry('.', '>', ".", ">", "̇", "̌", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_CTRL:
-                if (pressed) {
-                    active_modifiers |= BSP_INPUT_MODIFIER_CTRL_L;
-                } else {
-                    active_modifiers &= ~(BSP_INPUT_MODIFIER_CTRL_L);
-                }
-                send_scancode_event(BSP_INPUT_SCANCODE_LEFTCTRL, pressed);
-                break;
-            case HACKADAY2025_KEY_SUPER:
-                if (pressed) {
-                    active_modifiers |= BSP_INPUT_MODIFIER_SUPER_L;
-                    super_used        = false;
-                } else {
-                    active_modifiers &= ~(BSP_INPUT_MODIFIER_SUPER_L);
-                    if (!super_used) {
-                        send_navigation_event(BSP_INPUT_NAVIGATION_KEY_SUPER, true, active_modifiers);
-                        send_navigation_event(BSP_INPUT_NAVIGATION_KEY_SUPER, false, active_modifiers);
-                    }
-                }
-                send_scancode_event(BSP_INPUT_SCANCODE_ESCAPED_LEFTMETA, pressed);
-                break;
-            case HACKADAY2025_KEY_LEFT_ALT:
-                if (pressed) {
-                    active_modifiers |= BSP_INPUT_MODIFIER_ALT_L;
-                } else {
-                    active_modifiers &= ~(BSP_INPUT_MODIFIER_ALT_L);
-                }
-                send_scancode_event(BSP_INPUT_SCANCODE_LEFTALT, pressed);
-                break;
-            case HACKADAY2025_KEY_BACKSLASH:
-                send_scancode_event(BSP_INPUT_SCANCODE_BACKSLASH, pressed);
-                break;
-            case HACKADAY2025_KEY_SPACE:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_SPACE_M, pressed, active_modifiers);
-                send_scancode_event(BSP_INPUT_SCANCODE_SPACE, pressed);
-                break;
-            case HACKADAY2025_KEY_RIGHT:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_RIGHT, pressed, active_modifiers);
-                send_scancode_event(BSP_INPUT_SCANCODE_ESCAPED_GREY_RIGHT, pressed);
-                break;
-            case HACKADAY2025_KEY_DOWN:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_DOWN, pressed, active_modifiers);
-                send_scancode_event(BSP_INPUT_SCANCODE_ESCAPED_GREY_DOWN, pressed);
-                break;
-            case HACKADAY2025_KEY_LEFT:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_LEFT, pressed, active_modifiers);
-                send_scancode_event(BSP_INPUT_SCANCODE_ESCAPED_GREY_LEFT, pressed);
-                break;
-            case HACKADAY2025_KEY_RIGHT_ALT:
-                if (pressed) {
-                    active_modifiers |= BSP_INPUT_MODIFIER_ALT_R;
-                } else {
-                    active_modifiers &= ~(BSP_INPUT_MODIFIER_ALT_R);
-                }
-                send_scancode_event(BSP_INPUT_SCANCODE_ESCAPED_RALT, pressed);
-                break;
-            case HACKADAY2025_KEY_NUM_MINUS:
-                send_scancode_event(BSP_INPUT_SCANCODE_KPMINUS, pressed);
-                if (pressed) handle_keyboard_text_entry('-', '-', "-", "-", "-", "-", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_NUM_6:
-                send_scancode_event(BSP_INPUT_SCANCODE_6, pressed);
-                if (pressed) handle_keyboard_text_entry('6', '^', "6", "^", "¼", "̂", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_NUM_5:
-                send_scancode_event(BSP_INPUT_SCANCODE_5, pressed);
-                if (pressed) handle_keyboard_text_entry('5', '%', "5", "%", "€", "¸", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_NUM_4:
-                send_scancode_event(BSP_INPUT_SCANCODE_4, pressed);
-                if (pressed) handle_keyboard_text_entry('4', '$', "4", "$", "¤", "£", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_RIGHT_BRACKET:
-                send_scancode_event(BSP_INPUT_SCANCODE_RIGHTBRACE, pressed);
-                if (pressed) handle_keyboard_text_entry(']', '}', "]", "}", "»", "”", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_LEFT_BRACKET:
-                send_scancode_event(BSP_INPUT_SCANCODE_LEFTBRACE, pressed);
-                if (pressed) handle_keyboard_text_entry('[', '{', "[", "{", "«", "“", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_P:
-                send_scancode_event(BSP_INPUT_SCANCODE_P, pressed);
-                if (pressed) handle_keyboard_text_entry('p', 'P', "p", "P", "ö", "Ö", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_NUM_ASTERISK:
-                send_scancode_event(BSP_INPUT_SCANCODE_KPASTERISK, pressed);
-                if (pressed) handle_keyboard_text_entry('*', '*', "*", "*", "*", "*", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_NUM_3:
-                send_scancode_event(BSP_INPUT_SCANCODE_3, pressed);
-                if (pressed) handle_keyboard_text_entry('3', '#', "3", "#", "³", "̄", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_NUM_2:
-                send_scancode_event(BSP_INPUT_SCANCODE_2, pressed);
-                if (pressed) handle_keyboard_text_entry('2', '@', "2", "@", "²", "̋", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_NUM_1:
-                send_scancode_event(BSP_INPUT_SCANCODE_1, pressed);
-                if (pressed) handle_keyboard_text_entry('1', '!', "1", "!", "¡", "¹", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_ENTER:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_RETURN, pressed, active_modifiers);
-                send_scancode_event(BSP_INPUT_SCANCODE_ENTER, pressed);
-                break;
-            case HACKADAY2025_KEY_APOSTROPHE:
-                send_scancode_event(BSP_INPUT_SCANCODE_APOSTROPHE, pressed);
-                if (pressed) handle_keyboard_text_entry('\'', '"', "'", "\"", "́", "̈", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_SEMICOLON:
-                send_scancode_event(BSP_INPUT_SCANCODE_SEMICOLON, pressed);
-                if (pressed) handle_keyboard_text_entry(';', ':', ";", ":", "̨", "̈", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_NUM_SLASH:
-                send_scancode_event(BSP_INPUT_SCANCODE_ESCAPED_GREY_KPSLASH, pressed);
-                if (pressed) handle_keyboard_text_entry('/', '/', "/", "/", "/", "/", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_NUM_EQUALS:
-                send_scancode_event(BSP_INPUT_SCANCODE_EQUAL, pressed);
-                if (pressed) handle_keyboard_text_entry('=', '+', "=", "+", "̋", "̛", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_NUM_DOT:
-                send_scancode_event(BSP_INPUT_SCANCODE_KPDOT, pressed);
-                if (pressed) handle_keyboard_text_entry('.', '.', ".", ".", ".", ".", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_NUM_0:
-                send_scancode_event(BSP_INPUT_SCANCODE_0, pressed);
-                if (pressed) handle_keyboard_text_entry('0', ')', "0", ")", "’", "̊", active_modifiers);
-                break;
-            case HACKADAY2025_KEY_RIGHT_SHIFT:
-                if (pressed) {
-                    active_modifiers |= BSP_INPUT_MODIFIER_SHIFT_R;
-                } else {
-                    active_modifiers &= ~(BSP_INPUT_MODIFIER_SHIFT_R);
-                }
-                send_scancode_event(BSP_INPUT_SCANCODE_RIGHTSHIFT, pressed);
-                break;
-            case HACKADAY2025_KEY_UP:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_UP, pressed, active_modifiers);
-                send_scancode_event(BSP_INPUT_SCANCODE_ESCAPED_GREY_UP, pressed);
-                break;
-            case HACKADAY2025_KEY_BACKSPACE:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_BACKSPACE, pressed, active_modifiers);
-                send_scancode_event(BSP_INPUT_SCANCODE_BACKSPACE, pressed);
-                break;
-            default:
-                ESP_LOGW(TAG, "Unmapped key pressed: %u", code);
-        }
+        bsp_keymap_handle_key(&keymap, code, pressed, timestamp);
     }
 }
 
 esp_err_t bsp_input_initialize(void) {
-    if (event_queue == NULL) {
-        event_queue = xQueueCreate(32, sizeof(bsp_input_event_t));
-        ESP_RETURN_ON_FALSE(event_queue, ESP_ERR_NO_MEM, TAG, "Failed to create input event queue");
-    }
+    ESP_RETURN_ON_ERROR(bsp_input_queue_initialize(), TAG, "Failed to initialize input event queue");
+
+    size_t num_keys = sizeof(hackaday2025_keymap) / sizeof(hackaday2025_keymap[0]);
+    ESP_RETURN_ON_ERROR(bsp_keymap_initialize(&keymap, hackaday2025_keymap, num_keys), TAG, "Failed to initialize keymap");
 
     gpio_config_t int_pin_cfg = {
         .pin_bit_mask = BIT64(BSP_GPIO_BTN),
@@ -588,14 +288,7 @@ esp_err_t bsp_input_initialize(void) {
 }
 
 esp_err_t bsp_input_get_queue(QueueHandle_t* out_queue) {
-    if (out_queue == NULL) {
-        return ESP_ERR_INVALID_ARG;
-    }
-    if (event_queue == NULL) {
-        return ESP_FAIL;
-    }
-    *out_queue = event_queue;
-    return ESP_OK;
+    return bsp_input_queue_get_handle(out_queue);
 }
 
 bool bsp_input_needs_on_screen_keyboard(void) {
@@ -614,60 +307,7 @@ esp_err_t bsp_input_read_navigation_key(bsp_input_navigation_key_t key, bool* ou
     if (out_state == NULL) {
         return ESP_ERR_INVALID_ARG;
     }
-
-    hackaday2025_keys_t code;
-    switch (key) {
-        case BSP_INPUT_NAVIGATION_KEY_ESC:
-            code = HACKADAY2025_KEY_ESC;
-            break;
-        case BSP_INPUT_NAVIGATION_KEY_LEFT:
-            code = HACKADAY2025_KEY_LEFT;
-            break;
-        case BSP_INPUT_NAVIGATION_KEY_RIGHT:
-            code = HACKADAY2025_KEY_RIGHT;
-            break;
-        case BSP_INPUT_NAVIGATION_KEY_UP:
-            code = HACKADAY2025_KEY_UP;
-            break;
-        case BSP_INPUT_NAVIGATION_KEY_DOWN:
-            code = HACKADAY2025_KEY_DOWN;
-            break;
-        case BSP_INPUT_NAVIGATION_KEY_RETURN:
-            code = HACKADAY2025_KEY_ENTER;
-            break;
-        case BSP_INPUT_NAVIGATION_KEY_SUPER:
-            code = HACKADAY2025_KEY_SUPER;
-            break;
-        case BSP_INPUT_NAVIGATION_KEY_TAB:
-            code = HACKADAY2025_KEY_TAB;
-            break;
-        case BSP_INPUT_NAVIGATION_KEY_BACKSPACE:
-            code = HACKADAY2025_KEY_BACKSPACE;
-            break;
-        case BSP_INPUT_NAVIGATION_KEY_SPACE_M:
-            code = HACKADAY2025_KEY_SPACE;
-            break;
-        case BSP_INPUT_NAVIGATION_KEY_F1:
-            code = HACKADAY2025_KEY_F1;
-            break;
-        case BSP_INPUT_NAVIGATION_KEY_F2:
-            code = HACKADAY2025_KEY_F2;
-            break;
-        case BSP_INPUT_NAVIGATION_KEY_F3:
-            code = HACKADAY2025_KEY_F3;
-            break;
-        case BSP_INPUT_NAVIGATION_KEY_F4:
-            code = HACKADAY2025_KEY_F4;
-            break;
-        case BSP_INPUT_NAVIGATION_KEY_F5:
-            code = HACKADAY2025_KEY_F5;
-            break;
-        default:
-            *out_state = false;
-            return ESP_OK;
-    }
-
-    *out_state = key_state[code];
+    *out_state = bsp_keymap_read_navigation_key(&keymap, key);
     return ESP_OK;
 }
 
@@ -676,224 +316,11 @@ esp_err_t bsp_input_read_scancode(bsp_input_scancode_t key, bool* out_state) {
         return ESP_ERR_INVALID_ARG;
     }
 
+    *out_state = bsp_keymap_read_scancode(&keymap, key);
     if (key == BSP_INPUT_SCANCODE_ENTER) {
         // The enter scancode is shared between the keypad and the dedicated hardware button
-        *out_state = key_state[HACKADAY2025_KEY_ENTER] || prev_button_state;
-        return ESP_OK;
-    }
-
-    hackaday2025_keys_t code;
-    switch (key) {
-        case BSP_INPUT_SCANCODE_ESC:
-            code = HACKADAY2025_KEY_ESC;
-            break;
-        case BSP_INPUT_SCANCODE_1:
-            code = HACKADAY2025_KEY_NUM_1;
-            break;
-        case BSP_INPUT_SCANCODE_2:
-            code = HACKADAY2025_KEY_NUM_2;
-            break;
-        case BSP_INPUT_SCANCODE_3:
-            code = HACKADAY2025_KEY_NUM_3;
-            break;
-        case BSP_INPUT_SCANCODE_4:
-            code = HACKADAY2025_KEY_NUM_4;
-            break;
-        case BSP_INPUT_SCANCODE_5:
-            code = HACKADAY2025_KEY_NUM_5;
-            break;
-        case BSP_INPUT_SCANCODE_6:
-            code = HACKADAY2025_KEY_NUM_6;
-            break;
-        case BSP_INPUT_SCANCODE_7:
-            code = HACKADAY2025_KEY_NUM_7;
-            break;
-        case BSP_INPUT_SCANCODE_8:
-            code = HACKADAY2025_KEY_NUM_8;
-            break;
-        case BSP_INPUT_SCANCODE_9:
-            code = HACKADAY2025_KEY_NUM_9;
-            break;
-        case BSP_INPUT_SCANCODE_EQUAL:
-            code = HACKADAY2025_KEY_NUM_EQUALS;
-            break;
-        case BSP_INPUT_SCANCODE_BACKSPACE:
-            code = HACKADAY2025_KEY_BACKSPACE;
-            break;
-        case BSP_INPUT_SCANCODE_TAB:
-            code = HACKADAY2025_KEY_TAB;
-            break;
-        case BSP_INPUT_SCANCODE_Q:
-            code = HACKADAY2025_KEY_Q;
-            break;
-        case BSP_INPUT_SCANCODE_W:
-            code = HACKADAY2025_KEY_W;
-            break;
-        case BSP_INPUT_SCANCODE_E:
-            code = HACKADAY2025_KEY_E;
-            break;
-        case BSP_INPUT_SCANCODE_R:
-            code = HACKADAY2025_KEY_R;
-            break;
-        case BSP_INPUT_SCANCODE_T:
-            code = HACKADAY2025_KEY_T;
-            break;
-        case BSP_INPUT_SCANCODE_Y:
-            code = HACKADAY2025_KEY_Y;
-            break;
-        case BSP_INPUT_SCANCODE_U:
-            code = HACKADAY2025_KEY_U;
-            break;
-        case BSP_INPUT_SCANCODE_I:
-            code = HACKADAY2025_KEY_I;
-            break;
-        case BSP_INPUT_SCANCODE_O:
-            code = HACKADAY2025_KEY_O;
-            break;
-        case BSP_INPUT_SCANCODE_P:
-            code = HACKADAY2025_KEY_P;
-            break;
-        case BSP_INPUT_SCANCODE_LEFTBRACE:
-            code = HACKADAY2025_KEY_LEFT_BRACKET;
-            break;
-        case BSP_INPUT_SCANCODE_RIGHTBRACE:
-            code = HACKADAY2025_KEY_RIGHT_BRACKET;
-            break;
-        case BSP_INPUT_SCANCODE_LEFTCTRL:
-            code = HACKADAY2025_KEY_CTRL;
-            break;
-        case BSP_INPUT_SCANCODE_A:
-            code = HACKADAY2025_KEY_A;
-            break;
-        case BSP_INPUT_SCANCODE_S:
-            code = HACKADAY2025_KEY_S;
-            break;
-        case BSP_INPUT_SCANCODE_D:
-            code = HACKADAY2025_KEY_D;
-            break;
-        case BSP_INPUT_SCANCODE_F:
-            code = HACKADAY2025_KEY_F;
-            break;
-        case BSP_INPUT_SCANCODE_G:
-            code = HACKADAY2025_KEY_G;
-            break;
-        case BSP_INPUT_SCANCODE_H:
-            code = HACKADAY2025_KEY_H;
-            break;
-        case BSP_INPUT_SCANCODE_J:
-            code = HACKADAY2025_KEY_J;
-            break;
-        case BSP_INPUT_SCANCODE_K:
-            code = HACKADAY2025_KEY_K;
-            break;
-        case BSP_INPUT_SCANCODE_L:
-            code = HACKADAY2025_KEY_L;
-            break;
-        case BSP_INPUT_SCANCODE_SEMICOLON:
-            code = HACKADAY2025_KEY_SEMICOLON;
-            break;
-        case BSP_INPUT_SCANCODE_APOSTROPHE:
-            code = HACKADAY2025_KEY_APOSTROPHE;
-            break;
-        case BSP_INPUT_SCANCODE_LEFTSHIFT:
-            code = HACKADAY2025_KEY_LEFT_SHIFT;
-            break;
-        case BSP_INPUT_SCANCODE_BACKSLASH:
-            code = HACKADAY2025_KEY_BACKSLASH;
-            break;
-        case BSP_INPUT_SCANCODE_Z:
-            code = HACKADAY2025_KEY_Z;
-            break;
-        case BSP_INPUT_SCANCODE_X:
-            code = HACKADAY2025_KEY_X;
-            break;
-        case BSP_INPUT_SCANCODE_C:
-            code = HACKADAY2025_KEY_C;
-            break;
-        case BSP_INPUT_SCANCODE_V:
-            code = HACKADAY2025_KEY_V;
-            break;
-        case BSP_INPUT_SCANCODE_B:
-            code = HACKADAY2025_KEY_B;
-            break;
-        case BSP_INPUT_SCANCODE_N:
-            code = HACKADAY2025_KEY_N;
-            break;
-        case BSP_INPUT_SCANCODE_M:
-            code = HACKADAY2025_KEY_M;
-            break;
-        case BSP_INPUT_SCANCODE_COMMA:
-            code = HACKADAY2025_KEY_COMMA;
-            break;
-        case BSP_INPUT_SCANCODE_DOT:
-            code = HACKADAY2025_KEY_DOT;
-            break;
-        case BSP_INPUT_SCANCODE_RIGHTSHIFT:
-            code = HACKADAY2025_KEY_RIGHT_SHIFT;
-            break;
-        case BSP_INPUT_SCANCODE_KPASTERISK:
-            code = HACKADAY2025_KEY_NUM_ASTERISK;
-            break;
-        case BSP_INPUT_SCANCODE_LEFTALT:
-            code = HACKADAY2025_KEY_LEFT_ALT;
-            break;
-        case BSP_INPUT_SCANCODE_SPACE:
-            code = HACKADAY2025_KEY_SPACE;
-            break;
-        case BSP_INPUT_SCANCODE_F1:
-            code = HACKADAY2025_KEY_F1;
-            break;
-        case BSP_INPUT_SCANCODE_F2:
-            code = HACKADAY2025_KEY_F2;
-            break;
-        case BSP_INPUT_SCANCODE_F3:
-            code = HACKADAY2025_KEY_F3;
-            break;
-        case BSP_INPUT_SCANCODE_F4:
-            code = HACKADAY2025_KEY_F4;
-            break;
-        case BSP_INPUT_SCANCODE_F5:
-            code = HACKADAY2025_KEY_F5;
-            break;
-        case BSP_INPUT_SCANCODE_KPMINUS:
-            code = HACKADAY2025_KEY_NUM_MINUS;
-            break;
-        case BSP_INPUT_SCANCODE_KPPLUS:
-            code = HACKADAY2025_KEY_NUM_PLUS;
-            break;
-        case BSP_INPUT_SCANCODE_KP0:
-            code = HACKADAY2025_KEY_NUM_0;
-            break;
-        case BSP_INPUT_SCANCODE_KPDOT:
-            code = HACKADAY2025_KEY_NUM_DOT;
-            break;
-        case BSP_INPUT_SCANCODE_ESCAPED_RALT:
-            code = HACKADAY2025_KEY_RIGHT_ALT;
-            break;
-        case BSP_INPUT_SCANCODE_ESCAPED_GREY_UP:
-            code = HACKADAY2025_KEY_UP;
-            break;
-        case BSP_INPUT_SCANCODE_ESCAPED_GREY_DOWN:
-            code = HACKADAY2025_KEY_DOWN;
-            break;
-        case BSP_INPUT_SCANCODE_ESCAPED_GREY_LEFT:
-            code = HACKADAY2025_KEY_LEFT;
-            break;
-        case BSP_INPUT_SCANCODE_ESCAPED_GREY_RIGHT:
-            code = HACKADAY2025_KEY_RIGHT;
-            break;
-        case BSP_INPUT_SCANCODE_ESCAPED_GREY_KPSLASH:
-            code = HACKADAY2025_KEY_NUM_SLASH;
-            break;
-        case BSP_INPUT_SCANCODE_ESCAPED_LEFTMETA:
-            code = HACKADAY2025_KEY_SUPER;
-            break;
-        default:
-            *out_state = false;
-            return ESP_OK;
+        *out_state = *out_state || prev_button_state;
     }
-
-    *out_state = key_state[code];
     return ESP_OK;
 }
 
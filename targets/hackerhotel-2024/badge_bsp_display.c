@@ -2,6 +2,9 @@
 // SPDX-License-Identifier: MIT
 
 #include <stdint.h>
+#include "badge_bsp_display_shadow.h"
+#include "badge_bsp_display_ssd1619.h"
+#include "badge_bsp_display_stats.h"
 #include "bsp/display.h"
 #include "driver/gpio.h"
 #include "driver/spi_common.h"
@@ -26,6 +29,19 @@ static char const* TAG = "BSP display";
 #define V_RES      BSP_EPAPER_HEIGHT
 #define COLOUR_FMT BSP_DISPLAY_COLOR_FORMAT_2_PAL
 
+// Colors of the tri-color panel by pixel value
+static const uint8_t palette[][3] = {
+    {0xFF, 0xFF, 0xFF},  // White
+    {0x00, 0x00, 0x00},  // Black
+    {0xFF, 0x00, 0x00},  // Red
+};
+
+// Waveforms used for partial updates and for the periodic full refresh that clears accumulated ghosting
+#define LUT_FAST lut_900ms
+#define LUT_FULL lut_1s
+
+#define LUT_TEMPERATURE 20
+
 static ssd1619_t epaper = {
     .spi_bus               = BSP_EPAPER_SPI_BUS,
     .pin_cs                = BSP_EPAPER_CS_PIN,
@@ -37,7 +53,7 @@ static ssd1619_t epaper = {
     .screen_width          = BSP_EPAPER_WIDTH,
     .screen_height         = BSP_EPAPER_HEIGHT,
 };
-static ssd1619_lut_t cur_lut = lut_1s;
+static ssd1619_lut_t cur_lut = LUT_FULL;
 
 static esp_err_t bsp_display_initialize_epaper_lut() {
     esp_err_t res = ESP_OK;
@@ -70,7 +86,9 @@ esp_err_t bsp_display_initialize(const bsp_display_configuration_t* configuratio
     ESP_RETURN_ON_ERROR(spi_bus_initialize(BSP_EPAPER_SPI_BUS, &spi_bus_config, SPI_DMA_CH_AUTO), TAG,
                         "Failed to initialise the SPI bus");
     ESP_RETURN_ON_ERROR(ssd1619_init(&epaper), TAG, "Failed to initialize e-paper display");
-    ESP_RETURN_ON_ERROR(ssd1619_apply_lut(&epaper, lut_1s, 20), TAG, "Failed to apply e-paper LUT");
+    ESP_RETURN_ON_ERROR(ssd1619_apply_lut(&epaper, cur_lut, LUT_TEMPERATURE), TAG, "Failed to apply e-paper LUT");
+    ESP_RETURN_ON_ERROR(bsp_display_shadow_initialize(H_RES, V_RES, bsp_display_get_bits_per_pixel(COLOUR_FMT)), TAG,
+                        "Failed to allocate shadow framebuffer");
     return ESP_OK;
 }
 
@@ -83,6 +101,13 @@ esp_err_t bsp_display_get_parameters(size_t* h_res, size_t* v_res, bsp_display_c
     return ESP_OK;
 }
 
+esp_err_t bsp_display_get_palette(const uint8_t** out_palette, size_t* out_palette_size) {
+    ESP_RETURN_ON_FALSE(out_palette && out_palette_size, ESP_ERR_INVALID_ARG, TAG, "Output argument is NULL");
+    *out_palette      = &palette[0][0];
+    *out_palette_size = sizeof(palette) / sizeof(palette[0]);
+    return ESP_OK;
+}
+
 esp_err_t bsp_display_get_panel(esp_lcd_panel_handle_t* panel) {
     *panel = NULL;
     return ESP_OK;
@@ -97,10 +122,34 @@ bsp_display_rotation_t bsp_display_get_default_rotation() {
     return BSP_DISPLAY_ROTATION_90;
 }
 
-esp_err_t bsp_display_blit(size_t x, size_t y, size_t width, size_t height, const void* buffer) {
-    if (x != 0 || y != 0 || width != H_RES || height != V_RES) {
-        ESP_LOGE(TAG, "Display does not support partial updates");
-        return ESP_FAIL;
+static esp_err_t bsp_display_select_lut(ssd1619_lut_t lut) {
+    if (lut == cur_lut) {
+        return ESP_OK;
     }
-    return ssd1619_write(&epaper, buffer);
+    ESP_RETURN_ON_ERROR(ssd1619_apply_lut(&epaper, lut, LUT_TEMPERATURE), TAG, "Failed to apply e-paper LUT");
+    cur_lut = lut;
+    return ESP_OK;
+}
+
+esp_err_t bsp_display_blit(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer) {
+    size_t changed_bytes = 0;
+    ESP_RETURN_ON_ERROR(bsp_display_shadow_update(x_start, y_start, x_end, y_end, buffer, &changed_bytes), TAG,
+                        "Failed to update shadow framebuffer");
+    if (changed_bytes == 0) {
+        // The panel already shows this content, skip the refresh
+        return ESP_OK;
+    }
+
+    bool full_refresh = bsp_display_shadow_wants_full_refresh(changed_bytes);
+    ESP_RETURN_ON_ERROR(bsp_display_select_lut(full_refresh ? LUT_FULL : LUT_FAST), TAG, "Failed to select LUT");
+
+    // Only the RAM bytes changed since the last write are sent, the first write sends the whole frame
+    bsp_display_shadow_window_t window;
+    bsp_display_shadow_get_dirty(&window);
+    int64_t start = bsp_display_stats_now();
+    ESP_RETURN_ON_ERROR(bsp_display_ssd1619_write_window(&epaper, bsp_display_shadow_get_buffer(), H_RES, &window), TAG,
+                        "Failed to write e-paper");
+    bsp_display_shadow_mark_presented(full_refresh, changed_bytes);
+    bsp_display_stats_record_blit(x_start, y_start, x_end, y_end, start);
+    return ESP_OK;
 }
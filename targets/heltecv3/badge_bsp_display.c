@@ -1,9 +1,14 @@
 // SPDX-FileCopyrightText: 2026 Nicolai Electronics
 // SPDX-License-Identifier: MIT
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "badge_bsp_display_stats.h"
 #include "bsp/display.h"
 #include "bsp/i2c.h"
 #include "driver/gpio.h"
+#include "esp_check.h"
 #include "esp_err.h"
 #include "esp_lcd_panel_dev.h"
 #include "esp_lcd_panel_io.h"
@@ -11,17 +16,53 @@
 #include "esp_lcd_panel_vendor.h"
 #include "esp_lcd_types.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
 #include "heltecv3_hardware.h"
 
 #define SSD1306_HEIGHT 64
 
+// Resolution of the display as seen by the graphics stack (portrait, see bsp_display_initialize)
+#define H_RES 64
+#define V_RES 128
+
+// Each row of the framebuffer holds one byte for each page of the SSD1306
+#define PAGES (H_RES / 8)
+
+// Cost of sending an extra page/column window (addressing commands and I2C transaction overhead), in bytes
+#define WINDOW_COST 8
+
+// Minimum time between two transfers, keeps the display from monopolising the shared I2C bus
+#define MIN_FRAME_INTERVAL_US (20 * 1000)
+
+#define FLUSH_TASK_STACK_SIZE 3072
+#define FLUSH_TASK_PRIORITY   5
+
 static const char* TAG = "BSP DISPLAY";
 
 static i2c_master_bus_handle_t   i2c_bus_handle = NULL;
 static esp_lcd_panel_io_handle_t io_handle      = NULL;
 static esp_lcd_panel_handle_t    panel_handle   = NULL;
 
+// Copy of the display RAM, with for each page the range of columns that differ from what the display shows. Blits
+// update it with the mutex held, the flush task sends the accumulated changes at most once per frame interval.
+static uint8_t           shadow[V_RES * PAGES] = {0};
+static size_t            dirty_start[PAGES]    = {0};
+static size_t            dirty_end[PAGES]      = {0};
+static SemaphoreHandle_t shadow_mutex          = NULL;
+static TaskHandle_t      flush_task            = NULL;
+
+// Only accessed by the flush task: the frame being sent and its dirty column ranges
+static uint8_t frame[V_RES * PAGES]   = {0};
+static uint8_t staging[V_RES * PAGES] = {0};
+static size_t  frame_start[PAGES]     = {0};
+static size_t  frame_end[PAGES]       = {0};
+static int64_t last_frame_time        = 0;
+
+static void bsp_display_flush_task(void* arg);
+
 esp_err_t bsp_display_initialize(const bsp_display_configuration_t* configuration) {
     (void)configuration;
     ESP_LOGI(TAG, "Get I2C handle");
@@ -117,6 +158,22 @@ esp_err_t bsp_display_initialize(const bsp_display_configuration_t* configuratio
         return res;
     }
 
+    // The contents of the display RAM are unknown until the first frame has been sent
+    for (size_t page = 0; page < PAGES; page++) {
+        dirty_start[page] = 0;
+        dirty_end[page]   = V_RES;
+    }
+    shadow_mutex = xSemaphoreCreateMutex();
+    if (shadow_mutex == NULL) {
+        ESP_LOGE(TAG, "Failed to create shadow framebuffer mutex");
+        return ESP_ERR_NO_MEM;
+    }
+    if (xTaskCreate(bsp_display_flush_task, "BSP display flush", FLUSH_TASK_STACK_SIZE, NULL, FLUSH_TASK_PRIORITY,
+                    &flush_task) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create display flush task");
+        return ESP_ERR_NO_MEM;
+    }
+
     ESP_LOGI(TAG, "Initialized the display");
 
     return ESP_OK;
@@ -125,10 +182,10 @@ esp_err_t bsp_display_initialize(const bsp_display_configuration_t* configuratio
 esp_err_t bsp_display_get_parameters(size_t* h_res, size_t* v_res, bsp_display_color_format_t* color_fmt,
                                      bsp_display_endianness_t* data_endian) {
     if (h_res != NULL) {
-        *h_res = 64;
+        *h_res = H_RES;
     }
     if (v_res != NULL) {
-        *v_res = 128;
+        *v_res = V_RES;
     }
     if (color_fmt != NULL) {
         *color_fmt = BSP_DISPLAY_COLOR_FORMAT_1_GREY;
@@ -185,6 +242,151 @@ esp_err_t bsp_display_get_tearing_effect_semaphore(SemaphoreHandle_t* semaphore)
     return ESP_ERR_NOT_SUPPORTED;
 }
 
+// Widen the dirty column range of a page, called with the mutex held
+static void bsp_display_mark_dirty(size_t page, size_t start, size_t end) {
+    if (dirty_start[page] >= dirty_end[page]) {
+        dirty_start[page] = start;
+        dirty_end[page]   = end;
+    } else {
+        dirty_start[page] = start < dirty_start[page] ? start : dirty_start[page];
+        dirty_end[page]   = end > dirty_end[page] ? end : dirty_end[page];
+    }
+}
+
+// Copy a region into the shadow framebuffer and widen the dirty column range of every page that changed, called with
+// the mutex held
+static void bsp_display_shadow_update(size_t x_start, size_t y_start, size_t x_end, size_t y_end,
+                                      const uint8_t* buffer) {
+    size_t first_page = x_start / 8;
+    size_t num_pages  = (x_end - x_start) / 8;
+    for (size_t y = y_start; y < y_end; y++) {
+        const uint8_t* src = &buffer[(y - y_start) * num_pages];
+        uint8_t*       dst = &shadow[y * PAGES + first_page];
+        for (size_t i = 0; i < num_pages; i++) {
+            if (dst[i] != src[i]) {
+                dst[i] = src[i];
+                bsp_display_mark_dirty(first_page + i, y, y + 1);
+            }
+        }
+    }
+}
+
+// Take the changes made since the last flush into the frame to send, returns false if nothing changed
+static bool bsp_display_take_frame(void) {
+    bool changed = false;
+    xSemaphoreTake(shadow_mutex, portMAX_DELAY);
+    memcpy(frame, shadow, sizeof(frame));
+    for (size_t page = 0; page < PAGES; page++) {
+        frame_start[page] = dirty_start[page];
+        frame_end[page]   = dirty_end[page];
+        changed          |= dirty_start[page] < dirty_end[page];
+        dirty_start[page] = 0;
+        dirty_end[page]   = 0;
+    }
+    xSemaphoreGive(shadow_mutex);
+    return changed;
+}
+
+// Send the pages first_page up to last_page for columns start up to end
+static esp_err_t bsp_display_send_window(size_t first_page, size_t last_page, size_t start, size_t end) {
+    size_t         num_pages = last_page - first_page + 1;
+    const uint8_t* data      = &frame[start * PAGES];
+    if (num_pages != PAGES) {
+        // In vertical addressing mode the display expects the pages of each column back to back
+        for (size_t column = start; column < end; column++) {
+            memcpy(&staging[(column - start) * num_pages], &frame[column * PAGES + first_page], num_pages);
+        }
+        data = staging;
+    }
+
+    int64_t   stats_start = bsp_display_stats_now();
+    esp_err_t res         = esp_lcd_panel_draw_bitmap(panel_handle, start, first_page * 8, end, (last_page + 1) * 8,
+                                                      data);
+    if (res == ESP_OK) {
+        bsp_display_stats_record_blit(first_page * 8, start, (last_page + 1) * 8, end, stats_start);
+    }
+    return res;
+}
+
+// Send the dirty pages of the frame, adjacent pages are sent as one window when that costs less than sending them
+// separately. Pages that could not be sent are marked dirty again.
+static esp_err_t bsp_display_send_frame(void) {
+    esp_err_t res  = ESP_OK;
+    size_t    page = 0;
+    while (page < PAGES) {
+        if (frame_start[page] >= frame_end[page]) {
+            page++;
+            continue;
+        }
+
+        size_t first_page = page;
+        size_t start      = frame_start[page];
+        size_t end        = frame_end[page];
+        size_t cost       = end - start;
+        while (page + 1 < PAGES && frame_start[page + 1] < frame_end[page + 1]) {
+            size_t next_start  = frame_start[page + 1] < start ? frame_start[page + 1] : start;
+            size_t next_end    = frame_end[page + 1] > end ? frame_end[page + 1] : end;
+            size_t merged_cost = (next_end - next_start) * (page + 2 - first_page);
+            if (merged_cost > cost + (frame_end[page + 1] - frame_start[page + 1]) + WINDOW_COST) {
+                break;
+            }
+            start = next_start;
+            end   = next_end;
+            cost  = merged_cost;
+            page++;
+        }
+
+        if (res == ESP_OK) {
+            res = bsp_display_send_window(first_page, page, start, end);
+        }
+        if (res != ESP_OK) {
+            xSemaphoreTake(shadow_mutex, portMAX_DELAY);
+            for (size_t unsent = first_page; unsent <= page; unsent++) {
+                bsp_display_mark_dirty(unsent, frame_start[unsent], frame_end[unsent]);
+            }
+            xSemaphoreGive(shadow_mutex);
+        }
+        page++;
+    }
+    return res;
+}
+
+static void bsp_display_flush_task(void* arg) {
+    (void)arg;
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        // Blits arriving before the next frame slot are collected into a single transfer
+        int64_t wait = last_frame_time + MIN_FRAME_INTERVAL_US - esp_timer_get_time();
+        if (wait > 0) {
+            TickType_t ticks = pdMS_TO_TICKS((wait + 999) / 1000);
+            vTaskDelay(ticks > 0 ? ticks : 1);
+        }
+
+        if (!bsp_display_take_frame()) {
+            continue;
+        }
+        esp_err_t res   = bsp_display_send_frame();
+        last_frame_time = esp_timer_get_time();
+        if (res != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to send frame: %s", esp_err_to_name(res));
+        }
+    }
+}
+
 esp_err_t bsp_display_blit(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer) {
-    return esp_lcd_panel_draw_bitmap(panel_handle, y_start, x_start, y_end, x_end, buffer);
+    ESP_RETURN_ON_FALSE(shadow_mutex != NULL, ESP_ERR_INVALID_STATE, TAG, "Display not initialized");
+    ESP_RETURN_ON_FALSE(buffer != NULL && x_start % 8 == 0 && x_end % 8 == 0 && x_start < x_end && y_start < y_end &&
+                            x_end <= H_RES && y_end <= V_RES,
+                        ESP_ERR_INVALID_ARG, TAG, "Invalid region");
+
+    // The pixels are copied right away, the flush task sends them once the frame interval allows
+    int64_t wait_start = bsp_display_stats_now();
+    xSemaphoreTake(shadow_mutex, portMAX_DELAY);
+    bsp_display_stats_record_wait(wait_start, false);
+    bsp_display_shadow_update(x_start, y_start, x_end, y_end, buffer);
+    xSemaphoreGive(shadow_mutex);
+
+    xTaskNotifyGive(flush_task);
+    return ESP_OK;
 }
@@ -2,43 +2,47 @@
 // SPDX-License-Identifier: MIT
 
 #include <stdint.h>
+#include "badge_bsp_input_queue.h"
+#include "badge_bsp_input_state.h"
 #include "bsp/input.h"
 #include "driver/gpio.h"
 #include "esp_check.h"
 #include "esp_err.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
 #include "heltecv3_hardware.h"
 
 static char const* TAG = "BSP INPUT";
 
-static QueueHandle_t event_queue       = NULL;
-static bool          prev_button_state = false;
+static bool prev_button_state = false;
 
 IRAM_ATTR static void button_interrupt_handler(void* pvParameters) {
     bool state = !gpio_get_level(BSP_GPIO_BTN);  // GPIO is active low
     if (state != prev_button_state) {
         prev_button_state                = state;
+        int64_t           timestamp      = esp_timer_get_time();
         bsp_input_event_t scancode_event = {
             .type                   = INPUT_EVENT_TYPE_SCANCODE,
             .args_scancode.scancode = BSP_INPUT_SCANCODE_ENTER | (state ? 0 : BSP_INPUT_SCANCODE_RELEASE_MODIFIER),
+            .timestamp              = timestamp,
         };
-        xQueueSendFromISR(event_queue, &scancode_event, false);
+        bsp_input_state_update(&scancode_event);
+        bsp_input_queue_send(&scancode_event);
         bsp_input_event_t navigation_event = {
             .type                      = INPUT_EVENT_TYPE_NAVIGATION,
             .args_navigation.key       = BSP_INPUT_NAVIGATION_KEY_RETURN,
             .args_navigation.modifiers = 0,
             .args_navigation.state     = state,
+            .timestamp                 = timestamp,
         };
-        xQueueSendFromISR(event_queue, &navigation_event, false);
+        bsp_input_state_update(&navigation_event);
+        bsp_input_queue_send(&navigation_event);
     }
 }
 
 esp_err_t bsp_input_initialize(void) {
-    if (event_queue == NULL) {
-        event_queue = xQueueCreate(32, sizeof(bsp_input_event_t));
-        ESP_RETURN_ON_FALSE(event_queue, ESP_ERR_NO_MEM, TAG, "Failed to create input event queue");
-    }
+    ESP_RETURN_ON_ERROR(bsp_input_queue_initialize(), TAG, "Failed to initialize input event queue");
 
     gpio_config_t int_pin_cfg = {
         .pin_bit_mask = BIT64(BSP_GPIO_BTN),
@@ -55,14 +59,7 @@ esp_err_t bsp_input_initialize(void) {
 }
 
 esp_err_t bsp_input_get_queue(QueueHandle_t* out_queue) {
-    if (out_queue == NULL) {
-        return ESP_ERR_INVALID_ARG;
-    }
-    if (event_queue == NULL) {
-        return ESP_FAIL;
-    }
-    *out_queue = event_queue;
-    return ESP_OK;
+    return bsp_input_queue_get_handle(out_queue);
 }
 
 bool bsp_input_needs_on_screen_keyboard(void) {
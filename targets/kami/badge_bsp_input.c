@@ -5,12 +5,14 @@
 #include <stdint.h>
 #include <string.h>
 #include "badge_bsp_input_hooks.h"
+#include "badge_bsp_input_queue.h"
 #include "bsp/i2c.h"
 #include "bsp/input.h"
 #include "driver/gpio.h"
 #include "esp_check.h"
 #include "esp_err.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/projdefs.h"
 #include "freertos/queue.h"
@@ -20,11 +22,10 @@
 
 static char const* TAG = "BSP: INPUT";
 
-static QueueHandle_t   event_queue = NULL;
-static mpr121_handle_t mpr121      = NULL;
+static mpr121_handle_t mpr121 = NULL;
 
 static void mpr121_touch_callback(mpr121_handle_t handle, uint32_t previous_touch_state, uint32_t touch_state) {
-    bsp_input_event_t event = {0};
+    bsp_input_event_t event = {.timestamp = esp_timer_get_time()};
 
     const bsp_input_navigation_key_t keys[] = {
         BSP_INPUT_NAVIGATION_KEY_GAMEPAD_A, BSP_INPUT_NAVIGATION_KEY_GAMEPAD_B, BSP_INPUT_NAVIGATION_KEY_START,
@@ -42,7 +43,7 @@ static void mpr121_touch_callback(mpr121_handle_t handle, uint32_t previous_touc
 
             // Process through hooks first; if consumed, don't queue
             if (!bsp_input_hooks_process(&event)) {
-                xQueueSend(event_queue, &event, portMAX_DELAY);
+                bsp_input_queue_send(&event);
             }
         }
     }
@@ -53,10 +54,7 @@ static void mpr121_input_callback(mpr121_handle_t handle, uint32_t previous_inpu
 }
 
 esp_err_t bsp_input_initialize(void) {
-    if (event_queue == NULL) {
-        event_queue = xQueueCreate(32, sizeof(bsp_input_event_t));
-        ESP_RETURN_ON_FALSE(event_queue, ESP_ERR_NO_MEM, TAG, "Failed to create input event queue");
-    }
+    ESP_RETURN_ON_ERROR(bsp_input_queue_initialize(), TAG, "Failed to initialize input event queue");
 
     static i2c_master_bus_handle_t i2c_bus_handle_internal   = NULL;
     static SemaphoreHandle_t       i2c_concurrency_semaphore = NULL;
@@ -89,14 +87,7 @@ esp_err_t bsp_input_initialize(void) {
 }
 
 esp_err_t bsp_input_get_queue(QueueHandle_t* out_queue) {
-    if (out_queue == NULL) {
-        return ESP_ERR_INVALID_ARG;
-    }
-    if (event_queue == NULL) {
-        return ESP_FAIL;
-    }
-    *out_queue = event_queue;
-    return ESP_OK;
+    return bsp_input_queue_get_handle(out_queue);
 }
 
 bool bsp_input_needs_on_screen_keyboard(void) {
@@ -4,6 +4,11 @@
 // SPDX-License-Identifier: MIT
 
 #include <stdint.h>
+#include <string.h>
+#include "badge_bsp_display_flush.h"
+#include "badge_bsp_display_staging.h"
+#include "badge_bsp_display_stats.h"
+#include "badge_bsp_lcd_init.h"
 #include "bsp/display.h"
 #include "driver/gpio.h"
 #include "driver/spi_common.h"
@@ -16,6 +21,7 @@
 #include "esp_lcd_panel_ops.h"
 #include "esp_lcd_types.h"
 #include "esp_log.h"
+#include "esp_memory_utils.h"
 #include "hal/gpio_types.h"
 #include "hal/lcd_types.h"
 #include "hal/spi_types.h"
@@ -27,57 +33,78 @@ static char const* TAG = "BSP display";
 #define V_RES      240
 #define COLOUR_FMT BSP_DISPLAY_COLOR_FORMAT_16_565RGB
 
+// Rows per SPI transaction, a full frame is queued as a series of strips without blocking the caller
+#define STRIP_ROWS 16
+
 static esp_lcd_panel_handle_t    panel_handle    = NULL;
 static esp_lcd_panel_io_handle_t panel_io_handle = NULL;
-static SemaphoreHandle_t         flush_semaphore = NULL;
 
-static ili9341_lcd_init_cmd_t const lcd_init_cmds[] = {
-    //  {cmd, { data }, data_size, delay_ms}
+static const uint8_t lcd_init_table[] = {
     /* Power contorl B */
-    {0xCF, (uint8_t[]){0x00, 0xC1, 0x30}, 3, 0},
+    BSP_LCD_INIT_CMD(0xCF, 0x00, 0xC1, 0x30),
     /* Power on sequence control */
-    {0xED, (uint8_t[]){0x64, 0x03, 0X12, 0X81}, 4, 0},
+    BSP_LCD_INIT_CMD(0xED, 0x64, 0x03, 0x12, 0x81),
     /* Driver timing control A */
-    {0xE8, (uint8_t[]){0x85, 0x00, 0x78}, 3, 0},
+    BSP_LCD_INIT_CMD(0xE8, 0x85, 0x00, 0x78),
     /* Power control A */
-    {0xCB, (uint8_t[]){0x39, 0x2C, 0x00, 0x34, 0x02}, 5, 0},
+    BSP_LCD_INIT_CMD(0xCB, 0x39, 0x2C, 0x00, 0x34, 0x02),
     /* Pump ratio control */
-    {0xF7, (uint8_t[]){0x20}, 1, 0},
+    BSP_LCD_INIT_CMD(0xF7, 0x20),
     /* Driver timing control B */
-    {0xEA, (uint8_t[]){0x00, 0x00}, 2, 0},
+    BSP_LCD_INIT_CMD(0xEA, 0x00, 0x00),
     /* Power control 1 */
-    {0xC0, (uint8_t[]){0x23}, 1, 0},
+    BSP_LCD_INIT_CMD(0xC0, 0x23),
     /* Power control 2 */
-    {0xC1, (uint8_t[]){0x10}, 1, 0},
+    BSP_LCD_INIT_CMD(0xC1, 0x10),
     /* VCOM control 1 */
-    {0xC5, (uint8_t[]){0x3E, 0x28}, 2, 0},
+    BSP_LCD_INIT_CMD(0xC5, 0x3E, 0x28),
     /* VCOM control 2 */
-    {0xC7, (uint8_t[]){0x86}, 1, 0},
+    BSP_LCD_INIT_CMD(0xC7, 0x86),
     /* Frame rate control */
-    {0xB1, (uint8_t[]){0x00, 0x18}, 2, 0},
+    BSP_LCD_INIT_CMD(0xB1, 0x00, 0x18),
     /* Display function control */
-    {0xB6, (uint8_t[]){0x08, 0x82, 0x27}, 3, 0},
+    BSP_LCD_INIT_CMD(0xB6, 0x08, 0x82, 0x27),
     /* Enable 3G, disabled */
-    {0xF2, (uint8_t[]){0x00}, 1, 0},
+    BSP_LCD_INIT_CMD(0xF2, 0x00),
     /* Gamma set */
-    {0x26, (uint8_t[]){0x01}, 1, 0},
+    BSP_LCD_INIT_CMD(0x26, 0x01),
     /* Positive gamma correction */
-    {0xE0, (uint8_t[]){0x0F, 0x31, 0x2B, 0x0C, 0x0E, 0x08, 0x4E, 0xF1, 0x37, 0x07, 0x10, 0x03, 0x0E, 0x09, 0x00}, 15,
-     0},
+    BSP_LCD_INIT_CMD(0xE0, 0x0F, 0x31, 0x2B, 0x0C, 0x0E, 0x08, 0x4E, 0xF1, 0x37, 0x07, 0x10, 0x03, 0x0E, 0x09, 0x00),
     /* Negative gamma correction */
-    {0xE1, (uint8_t[]){0x00, 0x0E, 0x14, 0x03, 0x11, 0x07, 0x31, 0xC1, 0x48, 0x08, 0x0F, 0x0C, 0x31, 0x36, 0x0F}, 15,
-     0},
+    BSP_LCD_INIT_CMD(0xE1, 0x00, 0x0E, 0x14, 0x03, 0x11, 0x07, 0x31, 0xC1, 0x48, 0x08, 0x0F, 0x0C, 0x31, 0x36, 0x0F),
+    BSP_LCD_INIT_END(),
 };
 
+#define LCD_INIT_CMDS_MAX 24
+static ili9341_lcd_init_cmd_t lcd_init_cmds[LCD_INIT_CMDS_MAX];
+
+// The panel driver consumes its own command array, expanded once from the shared init table
+static esp_err_t bsp_display_expand_init_table(size_t* out_count) {
+    const uint8_t*     cursor = lcd_init_table;
+    bsp_lcd_init_cmd_t cmd;
+    size_t             count = 0;
+    while (bsp_lcd_init_next(&cursor, &cmd)) {
+        if (count >= LCD_INIT_CMDS_MAX) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        lcd_init_cmds[count].cmd        = cmd.command;
+        lcd_init_cmds[count].data       = cmd.params;
+        lcd_init_cmds[count].data_bytes = cmd.num_params;
+        lcd_init_cmds[count].delay_ms   = cmd.delay_ms;
+        count++;
+    }
+    *out_count = count;
+    return ESP_OK;
+}
+
 IRAM_ATTR static bool bsp_display_flush_ready(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t* edata,
                                               void* user_ctx) {
-    xSemaphoreGiveFromISR(flush_semaphore, NULL);
-    return false;
+    return bsp_display_flush_done_from_isr();
 }
 
-static esp_err_t bsp_display_initialize_flush(void) {
-    flush_semaphore = xSemaphoreCreateBinary();
-    xSemaphoreGive(flush_semaphore);
+static esp_err_t bsp_display_initialize_flush(const bsp_display_configuration_t* configuration) {
+    size_t max_in_flight = configuration != NULL ? configuration->max_blits_in_flight : 1;
+    ESP_RETURN_ON_ERROR(bsp_display_flush_initialize(max_in_flight), TAG, "Failed to initialize flush tracking");
 
     esp_lcd_panel_io_handle_t display_lcd_panel_io = NULL;
     ESP_RETURN_ON_ERROR(bsp_display_get_panel_io(&display_lcd_panel_io), TAG, "Failed to get panel io handle");
@@ -100,7 +127,7 @@ esp_err_t bsp_display_initialize(const bsp_display_configuration_t* configuratio
         .sclk_io_num     = BSP_SPI_SCLK,
         .quadwp_io_num   = -1,
         .quadhd_io_num   = -1,
-        .max_transfer_sz = H_RES * 8 * sizeof(uint16_t),
+        .max_transfer_sz = H_RES * STRIP_ROWS * sizeof(uint16_t),
     };
 
     ESP_RETURN_ON_ERROR(spi_bus_initialize(SPI3_HOST, &spi_bus_config, SPI_DMA_CH_AUTO), TAG,
@@ -111,7 +138,7 @@ esp_err_t bsp_display_initialize(const bsp_display_configuration_t* configuratio
         .dc_gpio_num       = BSP_LCD_DC_PIN,
         .spi_mode          = 0,
         .pclk_hz           = 40 * 1000 * 1000,
-        .trans_queue_depth = 4,
+        .trans_queue_depth = V_RES / STRIP_ROWS,
         .lcd_cmd_bits      = 8,
         .lcd_param_bits    = 8,
     };
@@ -119,9 +146,12 @@ esp_err_t bsp_display_initialize(const bsp_display_configuration_t* configuratio
     ESP_RETURN_ON_ERROR(esp_lcd_new_panel_io_spi(SPI3_HOST, &lcd_spi_config, &panel_io_handle), TAG,
                         "Failed to create LCD panel io handle");
 
+    size_t init_cmds_size = 0;
+    ESP_RETURN_ON_ERROR(bsp_display_expand_init_table(&init_cmds_size), TAG, "Failed to expand the LCD init table");
+
     ili9341_vendor_config_t vendor_config = {
         .init_cmds      = lcd_init_cmds,
-        .init_cmds_size = sizeof(lcd_init_cmds) / sizeof(ili9341_lcd_init_cmd_t),
+        .init_cmds_size = init_cmds_size,
     };
 
     esp_lcd_panel_dev_config_t lcd_panel_dev_config = {
@@ -141,7 +171,10 @@ esp_err_t bsp_display_initialize(const bsp_display_configuration_t* configuratio
     ESP_RETURN_ON_ERROR(esp_lcd_panel_swap_xy(panel_handle, true), TAG, "Failed to swap x and y on the LCD");
     ESP_RETURN_ON_ERROR(esp_lcd_panel_disp_on_off(panel_handle, true), TAG, "Failed to turn on the LCD panel");
 
-    ESP_RETURN_ON_ERROR(bsp_display_initialize_flush(), TAG, "Failed to initialize flush callback");
+    ESP_RETURN_ON_ERROR(bsp_display_initialize_flush(configuration), TAG, "Failed to initialize flush callback");
+
+    // Buffers the DMA can not read are staged in strips of the same size as the SPI transactions
+    ESP_RETURN_ON_ERROR(bsp_display_staging_set_rows(STRIP_ROWS), TAG, "Failed to configure staging buffers");
     return ESP_OK;
 }
 
@@ -177,6 +210,56 @@ bsp_display_rotation_t bsp_display_get_default_rotation() {
 }
 
 esp_err_t bsp_display_blit(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer) {
-    xSemaphoreTake(flush_semaphore, pdMS_TO_TICKS(1000));
-    return esp_lcd_panel_draw_bitmap(panel_handle, x_start, y_start, x_end, y_end, buffer);
+    return bsp_display_blit_async(x_start, y_start, x_end, y_end, buffer, NULL, NULL);
+}
+
+// Copy a buffer the SPI DMA can not read, such as one in PSRAM or flash, through the DMA capable staging strips
+static esp_err_t bsp_display_blit_staged(size_t x_start, size_t y_start, size_t x_end, size_t y_end,
+                                         const void* buffer, bsp_display_blit_done_cb_t callback, void* user_ctx) {
+    size_t         stride = (x_end - x_start) * sizeof(uint16_t);
+    const uint8_t* source = buffer;
+    for (size_t y = y_start; y < y_end;) {
+        uint8_t* staging      = NULL;
+        size_t   staging_size = 0;
+        ESP_RETURN_ON_ERROR(bsp_display_staging_get(&staging, &staging_size), TAG, "Failed to get staging buffer");
+
+        size_t rows = staging_size / stride;
+        if (rows > y_end - y) {
+            rows = y_end - y;
+        }
+        memcpy(staging, source, rows * stride);
+
+        // Strips are sent in order, the transfer of the last one completes the blit like an unstaged transfer
+        bool last = y + rows == y_end;
+        ESP_RETURN_ON_ERROR(bsp_display_staging_blit_with_callback(staging, x_start, y, x_end, y + rows,
+                                                                   last ? callback : NULL, user_ctx),
+                            TAG, "Failed to blit strip");
+
+        source += rows * stride;
+        y      += rows;
+    }
+    return ESP_OK;
+}
+
+esp_err_t bsp_display_blit_async(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer,
+                                 bsp_display_blit_done_cb_t callback, void* user_ctx) {
+    ESP_RETURN_ON_FALSE(buffer, ESP_ERR_INVALID_ARG, TAG, "Buffer argument is NULL");
+    ESP_RETURN_ON_FALSE(x_start < x_end && y_start < y_end && x_end <= H_RES && y_end <= V_RES, ESP_ERR_INVALID_ARG,
+                        TAG, "Invalid region");
+    if (!esp_ptr_dma_capable(buffer)) {
+        // The SPI driver would otherwise allocate and fill a bounce buffer for every transaction
+        return bsp_display_blit_staged(x_start, y_start, x_end, y_end, buffer, callback, user_ctx);
+    }
+
+    ESP_RETURN_ON_ERROR(bsp_display_flush_begin(callback, user_ctx, pdMS_TO_TICKS(1000)), TAG,
+                        "Timeout while waiting for previous flush");
+    int64_t   start = bsp_display_stats_now();
+    esp_err_t res   = esp_lcd_panel_draw_bitmap(panel_handle, x_start, y_start, x_end, y_end, buffer);
+    if (res != ESP_OK) {
+        bsp_display_flush_cancel();
+        return res;
+    }
+    bsp_display_flush_end();
+    bsp_display_stats_record_blit(x_start, y_start, x_end, y_end, start);
+    return ESP_OK;
 }
@@ -5,11 +5,14 @@
 #include <inttypes.h>
 #include <stdint.h>
 #include "badge_bsp_input_hooks.h"
+#include "badge_bsp_input_queue.h"
+#include "badge_bsp_input_state.h"
 #include "bsp/input.h"
 #include "bsp/mch2022.h"
 #include "esp_check.h"
 #include "esp_err.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
 #include "portmacro.h"
@@ -19,10 +22,9 @@ static char const* TAG = "BSP INPUT";
 
 static RP2040 rp2040;
 
-static QueueHandle_t event_queue = NULL;
 
 void bsp_mch2022_coprocessor_input_callback(rp2040_input_t input, bool state) {
-    bsp_input_event_t event = {0};
+    bsp_input_event_t event = {.timestamp = esp_timer_get_time()};
     switch (input) {
         case RP2040_INPUT_BUTTON_HOME:
             event.type                  = INPUT_EVENT_TYPE_NAVIGATION;
@@ -87,34 +89,20 @@ void bsp_mch2022_coprocessor_input_callback(rp2040_input_t input, bool state) {
 
     // Process through hooks first; if consumed, don't queue
     if (!bsp_input_hooks_process(&event)) {
-        if (event_queue != NULL) {
-            xQueueSend(event_queue, &event, portMAX_DELAY);
-        }
+        bsp_input_queue_send(&event);
     }
 }
 
 esp_err_t bsp_input_initialize(void) {
     bsp_mch2022_coprocessor_get_handle(&rp2040);
 
-    if (event_queue == NULL) {
-        event_queue = xQueueCreate(32, sizeof(bsp_input_event_t));
-        ESP_RETURN_ON_FALSE(event_queue, ESP_ERR_NO_MEM, TAG, "Failed to create input event queue");
-    }
+    ESP_RETURN_ON_ERROR(bsp_input_queue_initialize(), TAG, "Failed to initialize input event queue");
 
     return ESP_OK;
 }
 
 esp_err_t bsp_input_get_queue(QueueHandle_t* out_queue) {
-    if (out_queue == NULL) {
-        return ESP_ERR_INVALID_ARG;
-    }
-    if (event_queue == NULL) {
-        return ESP_FAIL;
-    }
-
-    *out_queue = event_queue;
-
-    return ESP_OK;
+    return bsp_input_queue_get_handle(out_queue);
 }
 
 bool bsp_input_needs_on_screen_keyboard(void) {
@@ -183,10 +171,11 @@ esp_err_t bsp_input_read_action(bsp_input_action_type_t action, bool* out_state)
 
 // Inject an input event into the queue (bypasses hooks)
 esp_err_t bsp_input_inject_event(bsp_input_event_t* event) {
-    if (event == NULL || event_queue == NULL) {
+    if (event == NULL) {
         return ESP_ERR_INVALID_ARG;
     }
-    if (xQueueSend(event_queue, event, pdMS_TO_TICKS(10)) != pdTRUE) {
+    bsp_input_state_update(event);
+    if (!bsp_input_queue_send(event)) {
         return ESP_ERR_TIMEOUT;
     }
     return ESP_OK;
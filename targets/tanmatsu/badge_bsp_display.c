@@ -6,6 +6,10 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
+#include "badge_bsp_display_flip.h"
+#include "badge_bsp_display_flush.h"
+#include "badge_bsp_display_stats.h"
+#include "badge_bsp_display_present.h"
 #include "bsp/device.h"
 #include "bsp/display.h"
 #include "bsp/tanmatsu.h"
@@ -32,12 +36,16 @@ static esp_ldo_channel_handle_t ldo_mipi_phy            = NULL;
 static bool                     bsp_display_initialized = false;
 static bsp_display_te_mode_t    display_te_mode         = BSP_DISPLAY_TE_DISABLED;
 static SemaphoreHandle_t        te_semaphore            = NULL;
-static SemaphoreHandle_t        flush_semaphore         = NULL;
+static size_t                   display_num_fbs         = 1;
 
 IRAM_ATTR static bool bsp_display_flush_ready(esp_lcd_panel_handle_t panel, esp_lcd_dpi_panel_event_data_t* edata,
                                               void* user_ctx) {
-    xSemaphoreGiveFromISR(flush_semaphore, NULL);
-    return false;
+    return bsp_display_flush_done_from_isr();
+}
+
+IRAM_ATTR static bool bsp_display_refresh_done(esp_lcd_panel_handle_t panel, esp_lcd_dpi_panel_event_data_t* edata,
+                                               void* user_ctx) {
+    return bsp_display_flip_vblank_from_isr();
 }
 
 static esp_err_t bsp_display_enable_dsi_phy_power(void) {
@@ -52,11 +60,13 @@ static esp_err_t bsp_display_enable_dsi_phy_power(void) {
 }
 
 static esp_err_t bsp_display_initialize_panel(const bsp_display_configuration_t* configuration) {
+    display_num_fbs = configuration && configuration->num_fbs > 0 ? configuration->num_fbs : 1;
+
     st7701_configuration_t config = {
         .reset_pin = BSP_LCD_RESET_PIN,
         .use_24_bit_color =
             configuration ? (configuration->requested_color_format == BSP_DISPLAY_COLOR_FORMAT_24_888RGB) : false,
-        .num_fbs = configuration ? configuration->num_fbs : 1,
+        .num_fbs = display_num_fbs,
     };
 
     st7701_initialize(&config);
@@ -64,14 +74,20 @@ static esp_err_t bsp_display_initialize_panel(const bsp_display_configuration_t*
 }
 
 IRAM_ATTR static void te_gpio_interrupt_handler(void* pvParameters) {
-    xSemaphoreGiveFromISR(te_semaphore, NULL);
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    xSemaphoreGiveFromISR(te_semaphore, &higher_priority_task_woken);
+    if (bsp_display_present_vsync_from_isr()) {
+        higher_priority_task_woken = pdTRUE;
+    }
+    portYIELD_FROM_ISR(higher_priority_task_woken);
 }
 
-static esp_err_t bsp_display_initialize_flush(void) {
-    flush_semaphore = xSemaphoreCreateBinary();
-    xSemaphoreGive(flush_semaphore);
+static esp_err_t bsp_display_initialize_flush(const bsp_display_configuration_t* configuration) {
+    size_t max_in_flight = configuration != NULL ? configuration->max_blits_in_flight : 1;
+    ESP_RETURN_ON_ERROR(bsp_display_flush_initialize(max_in_flight), TAG, "Failed to initialize flush tracking");
     esp_lcd_dpi_panel_event_callbacks_t callbacks = {
         .on_color_trans_done = bsp_display_flush_ready,
+        .on_refresh_done     = bsp_display_refresh_done,
     };
     return esp_lcd_dpi_panel_register_event_callbacks(st7701_get_panel(), &callbacks, NULL);
 }
@@ -103,7 +119,7 @@ esp_err_t bsp_display_initialize(const bsp_display_configuration_t* configuratio
     }
     ESP_RETURN_ON_ERROR(bsp_display_enable_dsi_phy_power(), TAG, "Failed to enable DSI PHY power");
     ESP_RETURN_ON_ERROR(bsp_display_initialize_panel(configuration), TAG, "Failed to initialize panel");
-    ESP_RETURN_ON_ERROR(bsp_display_initialize_flush(), TAG, "Failed to initialize flush callback");
+    ESP_RETURN_ON_ERROR(bsp_display_initialize_flush(configuration), TAG, "Failed to initialize flush callback");
     ESP_RETURN_ON_ERROR(bsp_display_initialize_te(), TAG, "Failed to tearing effect callback");
     bsp_display_initialized = true;
     return ESP_OK;
@@ -220,6 +236,37 @@ esp_err_t bsp_display_get_tearing_effect_semaphore(SemaphoreHandle_t* semaphore)
 }
 
 esp_err_t bsp_display_blit(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer) {
-    xSemaphoreTake(flush_semaphore, pdMS_TO_TICKS(1000));
-    return esp_lcd_panel_draw_bitmap(st7701_get_panel(), x_start, y_start, x_end, y_end, buffer);
+    return bsp_display_blit_async(x_start, y_start, x_end, y_end, buffer, NULL, NULL);
+}
+
+esp_err_t bsp_display_blit_async(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer,
+                                 bsp_display_blit_done_cb_t callback, void* user_ctx) {
+    ESP_RETURN_ON_ERROR(bsp_display_flush_begin(callback, user_ctx, pdMS_TO_TICKS(1000)), TAG,
+                        "Timeout while waiting for previous flush");
+    int64_t   start = bsp_display_stats_now();
+    esp_err_t res   = esp_lcd_panel_draw_bitmap(st7701_get_panel(), x_start, y_start, x_end, y_end, buffer);
+    if (res != ESP_OK) {
+        bsp_display_flush_cancel();
+        return res;
+    }
+    bsp_display_flush_end();
+    bsp_display_stats_record_blit(x_start, y_start, x_end, y_end, start);
+    return ESP_OK;
+}
+
+esp_err_t bsp_display_get_framebuffers(void** out_fbs, size_t max_fbs, size_t* out_num_fbs) {
+    if (!bsp_display_initialized) {
+        return ESP_FAIL;
+    }
+    ESP_RETURN_ON_FALSE(out_fbs != NULL && out_num_fbs != NULL, ESP_ERR_INVALID_ARG, TAG, "Output argument is NULL");
+
+    void* fbs[BSP_DISPLAY_MAX_FRAMEBUFFERS] = {NULL};
+
+    esp_err_t res = esp_lcd_dpi_panel_get_frame_buffer(st7701_get_panel(), display_num_fbs, &fbs[0], &fbs[1], &fbs[2]);
+    ESP_RETURN_ON_ERROR(res, TAG, "Failed to get framebuffers");
+    for (size_t i = 0; i < display_num_fbs && i < max_fbs; i++) {
+        out_fbs[i] = fbs[i];
+    }
+    *out_num_fbs = display_num_fbs;
+    return ESP_OK;
 }
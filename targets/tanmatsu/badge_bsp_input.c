@@ -7,12 +7,16 @@
 #include <stdint.h>
 #include <string.h>
 #include "badge_bsp_input_hooks.h"
+#include "badge_bsp_input_queue.h"
+#include "badge_bsp_input_repeat.h"
+#include "badge_bsp_input_state.h"
 #include "bsp/input.h"
 #include "bsp/tanmatsu.h"
 #include "driver/gpio.h"
 #include "esp_check.h"
 #include "esp_err.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/projdefs.h"
 #include "freertos/queue.h"
@@ -23,26 +27,24 @@
 
 static char const* TAG = "BSP INPUT";
 
-static QueueHandle_t event_queue              = NULL;
-static TaskHandle_t  key_repeat_thread_handle = NULL;
+// Key repeat identifiers: the keyboard register bit plus one, followed by the space bar and the volume down button
+#define REPEAT_KEY(bit)        ((bit) + 1)
+#define REPEAT_KEY_SPACE       REPEAT_KEY(TANMATSU_COPROCESSOR_KEYBOARD_NUM_REGS * 8)
+#define REPEAT_KEY_VOLUME_DOWN (REPEAT_KEY_SPACE + 1)
 
-static bool     key_repeat_wait      = false;
-static bool     key_repeat_fast      = false;
-static char     key_repeat_ascii     = '\0';
-static char     key_repeat_utf8[5]   = {0};
-static uint32_t key_repeat_modifiers = 0;
-
-static bool prev_volume_down_state = false;
+static bool    prev_volume_down_state = false;
+static int64_t volume_down_timestamp  = 0;
 
 static tanmatsu_coprocessor_keys_t current_keys = {0};
 
 // Inject an input event into the queue (bypasses hooks)
 esp_err_t bsp_input_inject_event(bsp_input_event_t* event) {
-    if (event == NULL || event_queue == NULL) {
+    if (event == NULL) {
         return ESP_ERR_INVALID_ARG;
     }
+    bsp_input_state_update(event);
 
-    if (xQueueSend(event_queue, event, pdMS_TO_TICKS(10)) != pdTRUE) {
+    if (!bsp_input_queue_send(event)) {
         return ESP_ERR_TIMEOUT;
     }
 
@@ -50,21 +52,27 @@ esp_err_t bsp_input_inject_event(bsp_input_event_t* event) {
 }
 
 // Forward declarations - the deferred handler below uses these.
-static void send_navigation_event(bsp_input_navigation_key_t key, bool state, uint32_t modifiers);
-static void send_scancode_event(bsp_input_scancode_t scancode, bool state);
+static void send_navigation_event(bsp_input_navigation_key_t key, bool state, uint32_t modifiers, int64_t timestamp,
+                                  uint32_t repeat_key);
+static void send_scancode_event(bsp_input_scancode_t scancode, bool state, int64_t timestamp);
 
 // Runs on the FreeRTOS Timer Service task; safe to call hook callbacks.
 static void volume_down_deferred(void* pvParameter1, uint32_t ulParameter2) {
     (void)pvParameter1;
     bool state = (ulParameter2 != 0);
-    send_scancode_event(BSP_INPUT_SCANCODE_ESCAPED_VOLUME_DOWN, state);
-    send_navigation_event(BSP_INPUT_NAVIGATION_KEY_VOLUME_DOWN, state, 0);
+    if (!state) {
+        bsp_input_repeat_release(REPEAT_KEY_VOLUME_DOWN);
+    }
+    send_scancode_event(BSP_INPUT_SCANCODE_ESCAPED_VOLUME_DOWN, state, volume_down_timestamp);
+    send_navigation_event(BSP_INPUT_NAVIGATION_KEY_VOLUME_DOWN, state, 0, volume_down_timestamp,
+                          REPEAT_KEY_VOLUME_DOWN);
 }
 
 IRAM_ATTR static void volume_down_gpio_interrupt_handler(void* pvParameters) {
     bool state = !gpio_get_level(BSP_GPIO_BTN_VOLUME_DOWN);  // GPIO is active low
     if (state != prev_volume_down_state) {
         prev_volume_down_state           = state;
+        volume_down_timestamp            = esp_timer_get_time();
         // Defer event delivery so we can call the hook chain (which is not
         // ISR-safe) from the FreeRTOS Timer Service task.
         BaseType_t higher_priority_woken = pdFALSE;
@@ -73,58 +81,52 @@ IRAM_ATTR static void volume_down_gpio_interrupt_handler(void* pvParameters) {
     }
 }
 
-static void send_navigation_event(bsp_input_navigation_key_t key, bool state, uint32_t modifiers) {
+static void send_navigation_event(bsp_input_navigation_key_t key, bool state, uint32_t modifiers, int64_t timestamp,
+                                  uint32_t repeat_key) {
     bsp_input_event_t event = {
         .type                      = INPUT_EVENT_TYPE_NAVIGATION,
         .args_navigation.key       = key,
         .args_navigation.modifiers = modifiers,
         .args_navigation.state     = state,
+        .timestamp                 = timestamp,
     };
-    // Offer to hooks first; if consumed, don't queue
-    if (!bsp_input_hooks_process(&event)) {
-        xQueueSend(event_queue, &event, 0);
+    if (state) {
+        bsp_input_repeat_press(repeat_key, &event);
     }
-}
-
-static void send_keyboard_event(char ascii, char const* utf8, uint32_t modifiers) {
-    bsp_input_event_t event = {
-        .type                    = INPUT_EVENT_TYPE_KEYBOARD,
-        .args_keyboard.ascii     = ascii,
-        .args_keyboard.modifiers = modifiers,
-    };
-    strlcpy(event.args_keyboard.utf8, utf8, sizeof(event.args_keyboard.utf8));
     // Offer to hooks first; if consumed, don't queue
     if (!bsp_input_hooks_process(&event)) {
-        xQueueSend(event_queue, &event, 0);
+        bsp_input_queue_send(&event);
     }
 }
 
-static void send_action_event(bsp_input_action_type_t action, bool state) {
+static void send_action_event(bsp_input_action_type_t action, bool state, int64_t timestamp) {
     bsp_input_event_t event = {
         .type              = INPUT_EVENT_TYPE_ACTION,
         .args_action.type  = action,
         .args_action.state = state,
+        .timestamp         = timestamp,
     };
     // Offer to hooks first; if consumed, don't queue
     if (!bsp_input_hooks_process(&event)) {
-        xQueueSend(event_queue, &event, 0);
+        bsp_input_queue_send(&event);
     }
 }
 
-static void send_scancode_event(bsp_input_scancode_t scancode, bool state) {
+static void send_scancode_event(bsp_input_scancode_t scancode, bool state, int64_t timestamp) {
     bsp_input_event_t event = {
         .type                   = INPUT_EVENT_TYPE_SCANCODE,
         .args_scancode.scancode = scancode | (state ? 0 : BSP_INPUT_SCANCODE_RELEASE_MODIFIER),
+        .timestamp              = timestamp,
     };
     // Offer to hooks first; if consumed, don't queue
     if (!bsp_input_hooks_process(&event)) {
-        xQueueSend(event_queue, &event, 0);
+        bsp_input_queue_send(&event);
     }
 }
 
 static void handle_keyboard_text_entry(bool curr_state, bool prev_state, char ascii, char ascii_shift, char const* utf8,
                                        char const* utf8_shift, char const* utf8_alt, char const* utf8_shift_alt,
-                                       uint32_t modifiers) {
+                                       uint32_t modifiers, int64_t timestamp, uint32_t repeat_key) {
     if (curr_state && (!prev_state)) {
         // Key pressed
         char              value_ascii = (modifiers & BSP_INPUT_MODIFIER_SHIFT) ? ascii_shift : ascii;
@@ -135,6 +137,7 @@ static void handle_keyboard_text_entry(bool curr_state, bool prev_state, char as
             .type                    = INPUT_EVENT_TYPE_KEYBOARD,
             .args_keyboard.ascii     = value_ascii,
             .args_keyboard.modifiers = modifiers,
+            .timestamp               = timestamp,
         };
         if (value_utf8) {
             strlcpy(event.args_keyboard.utf8, value_utf8, sizeof(event.args_keyboard.utf8));
@@ -142,27 +145,184 @@ static void handle_keyboard_text_entry(bool curr_state, bool prev_state, char as
             event.args_keyboard.utf8[0] = value_ascii;
             event.args_keyboard.utf8[1] = 0;
         }
-        xQueueSend(event_queue, &event, 0);
-        key_repeat_ascii = value_ascii;
-        strlcpy(key_repeat_utf8, value_utf8, sizeof(key_repeat_utf8));
-        key_repeat_modifiers = modifiers;
-        key_repeat_wait      = true;
-        key_repeat_fast      = false;
-    } else if (((!curr_state) && (prev_state)) || ((key_repeat_ascii != '\0') && (key_repeat_modifiers |= modifiers))) {
-        key_repeat_ascii = '\0';
-        memset(key_repeat_utf8, '\0', sizeof(key_repeat_utf8));
-        key_repeat_modifiers = modifiers;
-        key_repeat_wait      = false;
-        key_repeat_fast      = false;
+        bsp_input_repeat_press(repeat_key, &event);
+        bsp_input_queue_send(&event);
+    }
+}
+
+// Key table: the register bit of every key is taken from the coprocessor's bitfield definitions, so this table does not
+// duplicate the register layout. The meta key is not listed, it is handled separately by the callback.
+//
+// Keys that change in the same report are sent in a fixed order: the scancode and navigation events of the navigation
+// keys, then the scancodes of the other keys, then the text of the text keys. Within each group the keys are sent by
+// their order and text order, which keep the order in which the keys were always sent.
+typedef struct {
+    tanmatsu_coprocessor_keys_t mask;        // Register image with only this key set
+    uint8_t                     order;       // Position of the scancode and navigation events
+    uint8_t                     text_order;  // Position of the text
+    uint16_t                    scancode;
+    uint8_t                     navigation;
+    char                        ascii;
+    char                        ascii_shift;
+    char const*                 utf8;  // NULL if the key does not produce text
+    char const*                 utf8_shift;
+    char const*                 utf8_alt;
+    char const*                 utf8_shift_alt;
+} tanmatsu_key_t;
+
+#define KEY(field, order, code, nav) {{.field = true}, order, 0, code, nav, '\0', '\0', NULL, NULL, NULL, NULL}
+#define TEXT_KEY(field, order, text_order, code, nav, ...) {{.field = true}, order, text_order, code, nav, __VA_ARGS__}
+
+// Keys list their order and text keys their text order, followed by their ASCII value (plain, shift) and UTF-8 value
+// (plain, shift, alt, shift + alt)
+static tanmatsu_key_t const keymap[] = {
+    KEY(key_esc, 0, BSP_INPUT_SCANCODE_ESC, BSP_INPUT_NAVIGATION_KEY_ESC),
+    KEY(key_f1, 1, BSP_INPUT_SCANCODE_F1, BSP_INPUT_NAVIGATION_KEY_F1),
+    KEY(key_f2, 2, BSP_INPUT_SCANCODE_F2, BSP_INPUT_NAVIGATION_KEY_F2),
+    KEY(key_f3, 3, BSP_INPUT_SCANCODE_F3, BSP_INPUT_NAVIGATION_KEY_F3),
+    KEY(key_f4, 4, BSP_INPUT_SCANCODE_F4, BSP_INPUT_NAVIGATION_KEY_F4),
+    KEY(key_f5, 5, BSP_INPUT_SCANCODE_F5, BSP_INPUT_NAVIGATION_KEY_F5),
+    KEY(key_f6, 6, BSP_INPUT_SCANCODE_F6, BSP_INPUT_NAVIGATION_KEY_F6),
+    KEY(key_return, 7, BSP_INPUT_SCANCODE_ENTER, BSP_INPUT_NAVIGATION_KEY_RETURN),
+    KEY(key_up, 8, BSP_INPUT_SCANCODE_ESCAPED_GREY_UP, BSP_INPUT_NAVIGATION_KEY_UP),
+    KEY(key_left, 9, BSP_INPUT_SCANCODE_ESCAPED_GREY_LEFT, BSP_INPUT_NAVIGATION_KEY_LEFT),
+    KEY(key_down, 10, BSP_INPUT_SCANCODE_ESCAPED_GREY_DOWN, BSP_INPUT_NAVIGATION_KEY_DOWN),
+    KEY(key_right, 11, BSP_INPUT_SCANCODE_ESCAPED_GREY_RIGHT, BSP_INPUT_NAVIGATION_KEY_RIGHT),
+    KEY(key_volume_up, 12, BSP_INPUT_SCANCODE_ESCAPED_VOLUME_UP, BSP_INPUT_NAVIGATION_KEY_VOLUME_UP),
+    TEXT_KEY(key_tab, 13, 14, BSP_INPUT_SCANCODE_TAB, BSP_INPUT_NAVIGATION_KEY_TAB, '\t', '\t', "\t", "\t", "\t", "\t"),
+    TEXT_KEY(key_backspace, 14, 0, BSP_INPUT_SCANCODE_BACKSPACE, BSP_INPUT_NAVIGATION_KEY_BACKSPACE, '\b', '\b', "\b",
+             "\b", "\b", "\b"),
+    KEY(key_space_l, 15, BSP_INPUT_SCANCODE_NONE, BSP_INPUT_NAVIGATION_KEY_SPACE_L),
+    KEY(key_space_m, 16, BSP_INPUT_SCANCODE_NONE, BSP_INPUT_NAVIGATION_KEY_SPACE_M),
+    KEY(key_space_r, 17, BSP_INPUT_SCANCODE_NONE, BSP_INPUT_NAVIGATION_KEY_SPACE_R),
+    TEXT_KEY(key_tilde, 18, 1, BSP_INPUT_SCANCODE_GRAVE, BSP_INPUT_NAVIGATION_KEY_NONE, '`', '~', "`", "~", "`", "~"),
+    KEY(key_shift_l, 19, BSP_INPUT_SCANCODE_LEFTSHIFT, BSP_INPUT_NAVIGATION_KEY_NONE),
+    TEXT_KEY(key_1, 20, 2, BSP_INPUT_SCANCODE_1, BSP_INPUT_NAVIGATION_KEY_NONE, '1', '!', "1", "!", "¡", "¹"),
+    TEXT_KEY(key_2, 21, 3, BSP_INPUT_SCANCODE_2, BSP_INPUT_NAVIGATION_KEY_NONE, '2', '@', "2", "@", "²", "̋"),
+    TEXT_KEY(key_3, 22, 4, BSP_INPUT_SCANCODE_3, BSP_INPUT_NAVIGATION_KEY_NONE, '3', '#', "3", "#", "³", "̄"),
+    TEXT_KEY(key_4, 23, 5, BSP_INPUT_SCANCODE_4, BSP_INPUT_NAVIGATION_KEY_NONE, '4', '$', "4", "$", "¤", "£"),
+    TEXT_KEY(key_5, 24, 6, BSP_INPUT_SCANCODE_5, BSP_INPUT_NAVIGATION_KEY_NONE, '5', '%', "5", "%", "€", "¸"),
+    TEXT_KEY(key_6, 25, 7, BSP_INPUT_SCANCODE_6, BSP_INPUT_NAVIGATION_KEY_NONE, '6', '^', "6", "^", "¼", "̂"),
+    TEXT_KEY(key_7, 26, 8, BSP_INPUT_SCANCODE_7, BSP_INPUT_NAVIGATION_KEY_NONE, '7', '&', "7", "&", "½", "̛"),
+    TEXT_KEY(key_8, 27, 9, BSP_INPUT_SCANCODE_8, BSP_INPUT_NAVIGATION_KEY_NONE, '8', '*', "8", "*", "¾", "̨"),
+    TEXT_KEY(key_9, 28, 10, BSP_INPUT_SCANCODE_9, BSP_INPUT_NAVIGATION_KEY_NONE, '9', '(', "9", "(", "‘", "̆"),
+    TEXT_KEY(key_0, 29, 11, BSP_INPUT_SCANCODE_0, BSP_INPUT_NAVIGATION_KEY_NONE, '0', ')', "0", ")", "’", "̊"),
+    TEXT_KEY(key_minus, 30, 12, BSP_INPUT_SCANCODE_MINUS, BSP_INPUT_NAVIGATION_KEY_NONE, '-', '_', "-", "_", "¥", "̣"),
+    TEXT_KEY(key_equals, 31, 13, BSP_INPUT_SCANCODE_EQUAL, BSP_INPUT_NAVIGATION_KEY_NONE, '=', '+', "=", "+", "̋", "̛"),
+    TEXT_KEY(key_q, 32, 15, BSP_INPUT_SCANCODE_Q, BSP_INPUT_NAVIGATION_KEY_NONE, 'q', 'Q', "q", "Q", "ä", "Ä"),
+    TEXT_KEY(key_w, 33, 16, BSP_INPUT_SCANCODE_W, BSP_INPUT_NAVIGATION_KEY_NONE, 'w', 'W', "w", "W", "å", "Å"),
+    TEXT_KEY(key_e, 34, 17, BSP_INPUT_SCANCODE_E, BSP_INPUT_NAVIGATION_KEY_NONE, 'e', 'E', "e", "E", "é", "É"),
+    TEXT_KEY(key_r, 35, 18, BSP_INPUT_SCANCODE_R, BSP_INPUT_NAVIGATION_KEY_NONE, 'r', 'R', "r", "R", "®", "™"),
+    TEXT_KEY(key_t, 36, 19, BSP_INPUT_SCANCODE_T, BSP_INPUT_NAVIGATION_KEY_NONE, 't', 'T', "t", "T", "þ", "Þ"),
+    TEXT_KEY(key_y, 37, 20, BSP_INPUT_SCANCODE_Y, BSP_INPUT_NAVIGATION_KEY_NONE, 'y', 'Y', "y", "Y", "ü", "Ü"),
+    TEXT_KEY(key_u, 38, 21, BSP_INPUT_SCANCODE_U, BSP_INPUT_NAVIGATION_KEY_NONE, 'u', 'U', "u", "U", "ú", "Ú"),
+    TEXT_KEY(key_i, 39, 22, BSP_INPUT_SCANCODE_I, BSP_INPUT_NAVIGATION_KEY_NONE, 'i', 'I', "i", "I", "í", "Í"),
+    TEXT_KEY(key_o, 40, 23, BSP_INPUT_SCANCODE_O, BSP_INPUT_NAVIGATION_KEY_NONE, 'o', 'O', "o", "O", "ó", "Ó"),
+    TEXT_KEY(key_p, 41, 24, BSP_INPUT_SCANCODE_P, BSP_INPUT_NAVIGATION_KEY_NONE, 'p', 'P', "p", "P", "ö", "Ö"),
+    TEXT_KEY(key_sqbracket_open, 42, 25, BSP_INPUT_SCANCODE_LEFTBRACE, BSP_INPUT_NAVIGATION_KEY_NONE, '[', '{', "[",
+             "{", "«", "“"),
+    TEXT_KEY(key_sqbracket_close, 43, 26, BSP_INPUT_SCANCODE_RIGHTBRACE, BSP_INPUT_NAVIGATION_KEY_NONE, ']', '}', "]",
+             "}", "»", "”"),
+    TEXT_KEY(key_a, 44, 27, BSP_INPUT_SCANCODE_A, BSP_INPUT_NAVIGATION_KEY_NONE, 'a', 'A', "a", "A", "á", "Á"),
+    TEXT_KEY(key_s, 45, 28, BSP_INPUT_SCANCODE_S, BSP_INPUT_NAVIGATION_KEY_NONE, 's', 'S', "s", "S", "ß", "§"),
+    TEXT_KEY(key_d, 46, 29, BSP_INPUT_SCANCODE_D, BSP_INPUT_NAVIGATION_KEY_NONE, 'd', 'D', "d", "D", "ð", "Ð"),
+    TEXT_KEY(key_f, 47, 30, BSP_INPUT_SCANCODE_F, BSP_INPUT_NAVIGATION_KEY_NONE, 'f', 'F', "f", "F", "ë", "Ë"),
+    TEXT_KEY(key_g, 48, 31, BSP_INPUT_SCANCODE_G, BSP_INPUT_NAVIGATION_KEY_NONE, 'g', 'G', "g", "G", "g", "G"),
+    TEXT_KEY(key_h, 49, 32, BSP_INPUT_SCANCODE_H, BSP_INPUT_NAVIGATION_KEY_NONE, 'h', 'H', "h", "H", "h", "H"),
+    TEXT_KEY(key_j, 50, 33, BSP_INPUT_SCANCODE_J, BSP_INPUT_NAVIGATION_KEY_NONE, 'j', 'J', "j", "J", "ï", "Ï"),
+    TEXT_KEY(key_k, 51, 34, BSP_INPUT_SCANCODE_K, BSP_INPUT_NAVIGATION_KEY_NONE, 'k', 'K', "k", "K", "œ", "Œ"),
+    TEXT_KEY(key_l, 52, 35, BSP_INPUT_SCANCODE_L, BSP_INPUT_NAVIGATION_KEY_NONE, 'l', 'L', "l", "L", "ø", "L"),
+    TEXT_KEY(key_semicolon, 53, 36, BSP_INPUT_SCANCODE_SEMICOLON, BSP_INPUT_NAVIGATION_KEY_NONE, ';', ':', ";", ":",
+             "̨", "̈"),
+    TEXT_KEY(key_quote, 54, 37, BSP_INPUT_SCANCODE_APOSTROPHE, BSP_INPUT_NAVIGATION_KEY_NONE, '\'', '"', "'", "\"",
+             "́", "̈"),
+    TEXT_KEY(key_z, 55, 38, BSP_INPUT_SCANCODE_Z, BSP_INPUT_NAVIGATION_KEY_NONE, 'z', 'Z', "z", "Z", "æ", "Æ"),
+    TEXT_KEY(key_x, 56, 39, BSP_INPUT_SCANCODE_X, BSP_INPUT_NAVIGATION_KEY_NONE, 'x', 'X', "x", "X", "·", " ̵"),
+    TEXT_KEY(key_c, 57, 40, BSP_INPUT_SCANCODE_C, BSP_INPUT_NAVIGATION_KEY_NONE, 'c', 'C', "c", "C", "©", "¢"),
+    TEXT_KEY(key_v, 58, 41, BSP_INPUT_SCANCODE_V, BSP_INPUT_NAVIGATION_KEY_NONE, 'v', 'V', "v", "V", "v", "V"),
+    TEXT_KEY(key_b, 59, 42, BSP_INPUT_SCANCODE_B, BSP_INPUT_NAVIGATION_KEY_NONE, 'b', 'B', "b", "B", "b", "B"),
+    TEXT_KEY(key_n, 60, 43, BSP_INPUT_SCANCODE_N, BSP_INPUT_NAVIGATION_KEY_NONE, 'n', 'N', "n", "N", "ñ", "Ñ"),
+    TEXT_KEY(key_m, 61, 44, BSP_INPUT_SCANCODE_M, BSP_INPUT_NAVIGATION_KEY_NONE, 'm', 'M', "m", "M", "µ", "±"),
+    TEXT_KEY(key_comma, 62, 45, BSP_INPUT_SCANCODE_COMMA, BSP_INPUT_NAVIGATION_KEY_NONE, ',', '<', ",", "<", "̧", "̌"),
+    TEXT_KEY(key_dot, 63, 46, BSP_INPUT_SCANCODE_DOT, BSP_INPUT_NAVIGATION_KEY_NONE, '.', '>', ".", ">", "̇", "̌"),
+    TEXT_KEY(key_slash, 64, 47, BSP_INPUT_SCANCODE_SLASH, BSP_INPUT_NAVIGATION_KEY_NONE, '/', '?', "/", "?", "¿", "̉"),
+    KEY(key_shift_r, 65, BSP_INPUT_SCANCODE_RIGHTSHIFT, BSP_INPUT_NAVIGATION_KEY_NONE),
+    TEXT_KEY(key_backslash, 66, 48, BSP_INPUT_SCANCODE_BACKSLASH, BSP_INPUT_NAVIGATION_KEY_NONE, '\\', '|', "\\", "|",
+             "¬", "¦"),
+    KEY(key_fn, 68, BSP_INPUT_SCANCODE_FN, BSP_INPUT_NAVIGATION_KEY_NONE),
+    KEY(key_ctrl, 69, BSP_INPUT_SCANCODE_LEFTCTRL, BSP_INPUT_NAVIGATION_KEY_NONE),
+    KEY(key_alt_l, 70, BSP_INPUT_SCANCODE_LEFTALT, BSP_INPUT_NAVIGATION_KEY_NONE),
+    KEY(key_alt_r, 71, BSP_INPUT_SCANCODE_ESCAPED_RALT, BSP_INPUT_NAVIGATION_KEY_NONE),
+};
+
+#undef KEY
+#undef TEXT_KEY
+
+// The three space bar keys share a single scancode and text entry, sent after the backslash key and after all text
+static tanmatsu_key_t const keymap_space = {
+    .order          = 67,
+    .text_order     = 49,
+    .scancode       = BSP_INPUT_SCANCODE_SPACE,
+    .navigation     = BSP_INPUT_NAVIGATION_KEY_NONE,
+    .ascii          = ' ',
+    .ascii_shift    = ' ',
+    .utf8           = " ",
+    .utf8_shift     = " ",
+    .utf8_alt       = " ",
+    .utf8_shift_alt = " ",
+};
+
+#define KEYBOARD_NUM_BITS (TANMATSU_COPROCESSOR_KEYBOARD_NUM_REGS * 8)
+
+// Filled in by bsp_input_initialize, reports that arrive before that are ignored
+static tanmatsu_key_t const* keymap_by_bit[KEYBOARD_NUM_BITS] = {0};
+
+static void keymap_resolve_bits(void) {
+    for (size_t i = 0; i < sizeof(keymap) / sizeof(keymap[0]); i++) {
+        for (uint8_t reg = 0; reg < TANMATSU_COPROCESSOR_KEYBOARD_NUM_REGS; reg++) {
+            uint8_t value = keymap[i].mask.raw[reg];
+            if (value) {
+                keymap_by_bit[reg * 8 + __builtin_ctz(value)] = &keymap[i];
+                break;
+            }
+        }
     }
 }
 
+typedef struct {
+    tanmatsu_key_t const* key;
+    uint32_t              repeat_key;
+    bool                  state;
+} tanmatsu_key_change_t;
+
+// Insert a key change into the changes, which are kept sorted by the order of their keys
+static void insert_change(tanmatsu_key_change_t* changes, size_t* num_changes, tanmatsu_key_t const* key,
+                          uint32_t repeat_key, bool state) {
+    size_t position = (*num_changes)++;
+    while (position > 0 && changes[position - 1].key->order > key->order) {
+        changes[position] = changes[position - 1];
+        position--;
+    }
+    changes[position] = (tanmatsu_key_change_t){
+        .key        = key,
+        .repeat_key = repeat_key,
+        .state      = state,
+    };
+}
+
+static void send_key_text(tanmatsu_key_change_t const* change, uint32_t modifiers, int64_t timestamp) {
+    tanmatsu_key_t const* key = change->key;
+    handle_keyboard_text_entry(change->state, !change->state, key->ascii, key->ascii_shift, key->utf8, key->utf8_shift,
+                               key->utf8_alt, key->utf8_shift_alt, modifiers, timestamp, change->repeat_key);
+}
+
 void bsp_internal_coprocessor_keyboard_callback(tanmatsu_coprocessor_handle_t handle,
                                                 tanmatsu_coprocessor_keys_t*  prev_keys,
                                                 tanmatsu_coprocessor_keys_t*  keys) {
     static bool meta_key_modifier_used = false;
 
-    current_keys = *keys;
+    int64_t timestamp = esp_timer_get_time();
+    current_keys      = *keys;
 
     // Modifier keys
     uint32_t modifiers = 0;
@@ -170,7 +330,7 @@ void bsp_internal_coprocessor_keyboard_callback(tanmatsu_coprocessor_handle_t ha
         modifiers |= BSP_INPUT_MODIFIER_SHIFT_L;
     }
     if (keys->key_shift_r) {
-        modifiers |= BSP_INPUT_MODIFIER_SHIFT_L;
+        modifiers |= BSP_INPUT_MODIFIER_SHIFT_R;
     }
     if (keys->key_ctrl) {
         modifiers |= BSP_INPUT_MODIFIER_CTRL_L;
@@ -187,6 +347,8 @@ void bsp_internal_coprocessor_keyboard_callback(tanmatsu_coprocessor_handle_t ha
     if (keys->key_fn) {
         modifiers |= BSP_INPUT_MODIFIER_FUNCTION;
     }
+    bsp_input_state_set_modifiers(modifiers);
+    bsp_input_repeat_set_modifiers(modifiers);
 
     // Navigation keys
     for (uint8_t i = 0; i < TANMATSU_COPROCESSOR_KEYBOARD_NUM_REGS; i++) {
@@ -203,280 +365,121 @@ void bsp_internal_coprocessor_keyboard_callback(tanmatsu_coprocessor_handle_t ha
         meta_key_modifier_used = false;
     } else if ((!keys->key_meta) && prev_keys->key_meta) {
         if (!meta_key_modifier_used) {
-            send_navigation_event(BSP_INPUT_NAVIGATION_KEY_SUPER, true, modifiers);
-            send_navigation_event(BSP_INPUT_NAVIGATION_KEY_SUPER, false, modifiers);
+            send_navigation_event(BSP_INPUT_NAVIGATION_KEY_SUPER, true, modifiers, timestamp,
+                                  BSP_INPUT_REPEAT_KEY_NONE);
+            send_navigation_event(BSP_INPUT_NAVIGATION_KEY_SUPER, false, modifiers, timestamp,
+                                  BSP_INPUT_REPEAT_KEY_NONE);
         }
     }
 
     if (keys->key_meta != prev_keys->key_meta) {
-        send_scancode_event(BSP_INPUT_SCANCODE_ESCAPED_LEFTMETA, keys->key_meta);
-    }
-
-    if (keys->key_esc != prev_keys->key_esc) {
-        send_scancode_event(BSP_INPUT_SCANCODE_ESC, keys->key_esc);
-        send_navigation_event(BSP_INPUT_NAVIGATION_KEY_ESC, keys->key_esc, modifiers);
-    }
-    if (keys->key_f1 != prev_keys->key_f1) {
-        send_scancode_event(BSP_INPUT_SCANCODE_F1, keys->key_f1);
-        send_navigation_event(BSP_INPUT_NAVIGATION_KEY_F1, keys->key_f1, modifiers);
-    }
-    if (keys->key_f2 != prev_keys->key_f2) {
-        send_scancode_event(BSP_INPUT_SCANCODE_F2, keys->key_f2);
-        send_navigation_event(BSP_INPUT_NAVIGATION_KEY_F2, keys->key_f2, modifiers);
-    }
-    if (keys->key_f3 != prev_keys->key_f3) {
-        send_scancode_event(BSP_INPUT_SCANCODE_F3, keys->key_f3);
-        send_navigation_event(BSP_INPUT_NAVIGATION_KEY_F3, keys->key_f3, modifiers);
-    }
-    if (keys->key_f4 != prev_keys->key_f4) {
-        send_scancode_event(BSP_INPUT_SCANCODE_F4, keys->key_f4);
-        send_navigation_event(BSP_INPUT_NAVIGATION_KEY_F4, keys->key_f4, modifiers);
-    }
-    if (keys->key_f5 != prev_keys->key_f5) {
-        send_scancode_event(BSP_INPUT_SCANCODE_F5, keys->key_f5);
-        send_navigation_event(BSP_INPUT_NAVIGATION_KEY_F5, keys->key_f5, modifiers);
-    }
-    if (keys->key_f6 != prev_keys->key_f6) {
-        send_scancode_event(BSP_INPUT_SCANCODE_F6, keys->key_f6);
-        send_navigation_event(BSP_INPUT_NAVIGATION_KEY_F6, keys->key_f6, modifiers);
-    }
-    if (keys->key_return != prev_keys->key_return) {
-        send_scancode_event(BSP_INPUT_SCANCODE_ENTER, keys->key_return);
-        send_navigation_event(BSP_INPUT_NAVIGATION_KEY_RETURN, keys->key_return, modifiers);
-    }
-    if (keys->key_up != prev_keys->key_up) {
-        send_scancode_event(BSP_INPUT_SCANCODE_ESCAPED_GREY_UP, keys->key_up);
-        send_navigation_event(BSP_INPUT_NAVIGATION_KEY_UP, keys->key_up, modifiers);
-    }
-    if (keys->key_left != prev_keys->key_left) {
-        send_scancode_event(BSP_INPUT_SCANCODE_ESCAPED_GREY_LEFT, keys->key_left);
-        send_navigation_event(BSP_INPUT_NAVIGATION_KEY_LEFT, keys->key_left, modifiers);
-    }
-    if (keys->key_down != prev_keys->key_down) {
-        send_scancode_event(BSP_INPUT_SCANCODE_ESCAPED_GREY_DOWN, keys->key_down);
-        send_navigation_event(BSP_INPUT_NAVIGATION_KEY_DOWN, keys->key_down, modifiers);
-    }
-    if (keys->key_right != prev_keys->key_right) {
-        send_scancode_event(BSP_INPUT_SCANCODE_ESCAPED_GREY_RIGHT, keys->key_right);
-        send_navigation_event(BSP_INPUT_NAVIGATION_KEY_RIGHT, keys->key_right, modifiers);
-    }
-    if (keys->key_volume_up != prev_keys->key_volume_up) {
-        send_scancode_event(BSP_INPUT_SCANCODE_ESCAPED_VOLUME_UP, keys->key_volume_up);
-        send_navigation_event(BSP_INPUT_NAVIGATION_KEY_VOLUME_UP, keys->key_volume_up, modifiers);
-    }
-    if (keys->key_tab != prev_keys->key_tab) {
-        send_scancode_event(BSP_INPUT_SCANCODE_TAB, keys->key_tab);
-        send_navigation_event(BSP_INPUT_NAVIGATION_KEY_TAB, keys->key_tab, modifiers);
-    }
-    if (keys->key_backspace != prev_keys->key_backspace) {
-        send_scancode_event(BSP_INPUT_SCANCODE_BACKSPACE, keys->key_backspace);
-        send_navigation_event(BSP_INPUT_NAVIGATION_KEY_BACKSPACE, keys->key_backspace, modifiers);
-    }
-    if (keys->key_space_l != prev_keys->key_space_l) {
-        send_navigation_event(BSP_INPUT_NAVIGATION_KEY_SPACE_L, keys->key_space_l, modifiers);
-    }
-    if (keys->key_space_m != prev_keys->key_space_m) {
-        send_navigation_event(BSP_INPUT_NAVIGATION_KEY_SPACE_M, keys->key_space_m, modifiers);
-    }
-    if (keys->key_space_r != prev_keys->key_space_r) {
-        send_navigation_event(BSP_INPUT_NAVIGATION_KEY_SPACE_R, keys->key_space_r, modifiers);
-    }
-
-    // Text entry keys (scancode)
-    if (keys->key_tilde != prev_keys->key_tilde) send_scancode_event(BSP_INPUT_SCANCODE_GRAVE, keys->key_tilde);
-    if (keys->key_shift_l != prev_keys->key_shift_l)
-        send_scancode_event(BSP_INPUT_SCANCODE_LEFTSHIFT, keys->key_shift_l);
-    if (keys->key_1 != prev_keys->key_1) send_scancode_event(BSP_INPUT_SCANCODE_1, keys->key_1);
-    if (keys->key_2 != prev_keys->key_2) send_scancode_event(BSP_INPUT_SCANCODE_2, keys->key_2);
-    if (keys->key_3 != prev_keys->key_3) send_scancode_event(BSP_INPUT_SCANCODE_3, keys->key_3);
-    if (keys->key_4 != prev_keys->key_4) send_scancode_event(BSP_INPUT_SCANCODE_4, keys->key_4);
-    if (keys->key_5 != prev_keys->key_5) send_scancode_event(BSP_INPUT_SCANCODE_5, keys->key_5);
-    if (keys->key_6 != prev_keys->key_6) send_scancode_event(BSP_INPUT_SCANCODE_6, keys->key_6);
-    if (keys->key_7 != prev_keys->key_7) send_scancode_event(BSP_INPUT_SCANCODE_7, keys->key_7);
-    if (keys->key_8 != prev_keys->key_8) send_scancode_event(BSP_INPUT_SCANCODE_8, keys->key_8);
-    if (keys->key_9 != prev_keys->key_9) send_scancode_event(BSP_INPUT_SCANCODE_9, keys->key_9);
-    if (keys->key_0 != prev_keys->key_0) send_scancode_event(BSP_INPUT_SCANCODE_0, keys->key_0);
-    if (keys->key_minus != prev_keys->key_minus) send_scancode_event(BSP_INPUT_SCANCODE_MINUS, keys->key_minus);
-    if (keys->key_equals != prev_keys->key_equals) send_scancode_event(BSP_INPUT_SCANCODE_EQUAL, keys->key_equals);
-    if (keys->key_q != prev_keys->key_q) send_scancode_event(BSP_INPUT_SCANCODE_Q, keys->key_q);
-    if (keys->key_w != prev_keys->key_w) send_scancode_event(BSP_INPUT_SCANCODE_W, keys->key_w);
-    if (keys->key_e != prev_keys->key_e) send_scancode_event(BSP_INPUT_SCANCODE_E, keys->key_e);
-    if (keys->key_r != prev_keys->key_r) send_scancode_event(BSP_INPUT_SCANCODE_R, keys->key_r);
-    if (keys->key_t != prev_keys->key_t) send_scancode_event(BSP_INPUT_SCANCODE_T, keys->key_t);
-    if (keys->key_y != prev_keys->key_y) send_scancode_event(BSP_INPUT_SCANCODE_Y, keys->key_y);
-    if (keys->key_u != prev_keys->key_u) send_scancode_event(BSP_INPUT_SCANCODE_U, keys->key_u);
-    if (keys->key_i != prev_keys->key_i) send_scancode_event(BSP_INPUT_SCANCODE_I, keys->key_i);
-    if (keys->key_o != prev_keys->key_o) send_scancode_event(BSP_INPUT_SCANCODE_O, keys->key_o);
-    if (keys->key_p != prev_keys->key_p) send_scancode_event(BSP_INPUT_SCANCODE_P, keys->key_p);
-    if (keys->key_sqbracket_open != prev_keys->key_sqbracket_open)
-        send_scancode_event(BSP_INPUT_SCANCODE_LEFTBRACE, keys->key_sqbracket_open);
-    if (keys->key_sqbracket_close != prev_keys->key_sqbracket_close)
-        send_scancode_event(BSP_INPUT_SCANCODE_RIGHTBRACE, keys->key_sqbracket_close);
-    if (keys->key_a != prev_keys->key_a) send_scancode_event(BSP_INPUT_SCANCODE_A, keys->key_a);
-    if (keys->key_s != prev_keys->key_s) send_scancode_event(BSP_INPUT_SCANCODE_S, keys->key_s);
-    if (keys->key_d != prev_keys->key_d) send_scancode_event(BSP_INPUT_SCANCODE_D, keys->key_d);
-    if (keys->key_f != prev_keys->key_f) send_scancode_event(BSP_INPUT_SCANCODE_F, keys->key_f);
-    if (keys->key_g != prev_keys->key_g) send_scancode_event(BSP_INPUT_SCANCODE_G, keys->key_g);
-    if (keys->key_h != prev_keys->key_h) send_scancode_event(BSP_INPUT_SCANCODE_H, keys->key_h);
-    if (keys->key_j != prev_keys->key_j) send_scancode_event(BSP_INPUT_SCANCODE_J, keys->key_j);
-    if (keys->key_k != prev_keys->key_k) send_scancode_event(BSP_INPUT_SCANCODE_K, keys->key_k);
-    if (keys->key_l != prev_keys->key_l) send_scancode_event(BSP_INPUT_SCANCODE_L, keys->key_l);
-    if (keys->key_semicolon != prev_keys->key_semicolon)
-        send_scancode_event(BSP_INPUT_SCANCODE_SEMICOLON, keys->key_semicolon);
-    if (keys->key_quote != prev_keys->key_quote) send_scancode_event(BSP_INPUT_SCANCODE_APOSTROPHE, keys->key_quote);
-    if (keys->key_z != prev_keys->key_z) send_scancode_event(BSP_INPUT_SCANCODE_Z, keys->key_z);
-    if (keys->key_x != prev_keys->key_x) send_scancode_event(BSP_INPUT_SCANCODE_X, keys->key_x);
-    if (keys->key_c != prev_keys->key_c) send_scancode_event(BSP_INPUT_SCANCODE_C, keys->key_c);
-    if (keys->key_v != prev_keys->key_v) send_scancode_event(BSP_INPUT_SCANCODE_V, keys->key_v);
-    if (keys->key_b != prev_keys->key_b) send_scancode_event(BSP_INPUT_SCANCODE_B, keys->key_b);
-    if (keys->key_n != prev_keys->key_n) send_scancode_event(BSP_INPUT_SCANCODE_N, keys->key_n);
-    if (keys->key_m != prev_keys->key_m) send_scancode_event(BSP_INPUT_SCANCODE_M, keys->key_m);
-    if (keys->key_comma != prev_keys->key_comma) send_scancode_event(BSP_INPUT_SCANCODE_COMMA, keys->key_comma);
-    if (keys->key_dot != prev_keys->key_dot) send_scancode_event(BSP_INPUT_SCANCODE_DOT, keys->key_dot);
-    if (keys->key_slash != prev_keys->key_slash) send_scancode_event(BSP_INPUT_SCANCODE_SLASH, keys->key_slash);
-    if (keys->key_shift_r != prev_keys->key_shift_r)
-        send_scancode_event(BSP_INPUT_SCANCODE_RIGHTSHIFT, keys->key_shift_r);
-    if (keys->key_backslash != prev_keys->key_backslash)
-        send_scancode_event(BSP_INPUT_SCANCODE_BACKSLASH, keys->key_backslash);
-    if ((keys->key_space_l | keys->key_space_m | keys->key_space_r) !=
-        (prev_keys->key_space_l | prev_keys->key_space_m | prev_keys->key_space_r))
-        send_scancode_event(BSP_INPUT_SCANCODE_SPACE, keys->key_space_l | keys->key_space_m | keys->key_space_r);
-    if (keys->key_fn != prev_keys->key_fn) {
-        send_scancode_event(BSP_INPUT_SCANCODE_FN, keys->key_fn);
-    }
-    if (keys->key_ctrl != prev_keys->key_ctrl) {
-        send_scancode_event(BSP_INPUT_SCANCODE_LEFTCTRL, keys->key_ctrl);
-    }
-    if (keys->key_alt_l != prev_keys->key_alt_l) {
-        send_scancode_event(BSP_INPUT_SCANCODE_LEFTALT, keys->key_alt_l);
-    }
-    if (keys->key_alt_r != prev_keys->key_alt_r) {
-        send_scancode_event(BSP_INPUT_SCANCODE_ESCAPED_RALT, keys->key_alt_r);
-    }
-
-    // Text entry keys (ASCII / UTF8)
-    handle_keyboard_text_entry(keys->key_backspace, prev_keys->key_backspace, '\b', '\b', "\b", "\b", "\b", "\b",
-                               modifiers);
-    handle_keyboard_text_entry(keys->key_tilde, prev_keys->key_tilde, '`', '~', "`", "~", "`", "~", modifiers);
-    handle_keyboard_text_entry(keys->key_1, prev_keys->key_1, '1', '!', "1", "!", "¡", "¹", modifiers);
-    handle_keyboard_text_entry(keys->key_2, prev_keys->key_2, '2', '@', "2", "@", "²", "̋", modifiers);
-    handle_keyboard_text_entry(keys->key_3, prev_keys->key_3, '3', '#', "3", "#", "³", "̄", modifiers);
-    handle_keyboard_text_entry(keys->key_4, prev_keys->key_4, '4', '$', "4", "$", "¤", "£", modifiers);
-    handle_keyboard_text_entry(keys->key_5, prev_keys->key_5, '5', '%', "5", "%", "€", "¸", modifiers);
-    handle_keyboard_text_entry(keys->key_6, prev_keys->key_6, '6', '^', "6", "^", "¼", "̂", modifiers);
-    handle_keyboard_text_entry(keys->key_7, prev_keys->key_7, '7', '&', "7", "&", "½", "̛", modifiers);
-    handle_keyboard_text_entry(keys->key_8, prev_keys->key_8, '8', '*', "8", "*", "¾", "̨", modifiers);
-    handle_keyboard_text_entry(keys->key_9, prev_keys->key_9, '9', '(', "9", "(", "‘", "̆", modifiers);
-    handle_keyboard_text_entry(keys->key_0, prev_keys->key_0, '0', ')', "0", ")", "’", "̊", modifiers);
-    handle_keyboard_text_entry(keys->key_minus, prev_keys->key_minus, '-', '_', "-", "_", "¥", "̣", modifiers);
-    handle_keyboard_text_entry(keys->key_equals, prev_keys->key_equals, '=', '+', "=", "+", "̋", "̛", modifiers);
-    handle_keyboard_text_entry(keys->key_tab, prev_keys->key_tab, '\t', '\t', "\t", "\t", "\t", "\t", modifiers);
-    handle_keyboard_text_entry(keys->key_q, prev_keys->key_q, 'q', 'Q', "q", "Q", "ä", "Ä", modifiers);
-    handle_keyboard_text_entry(keys->key_w, prev_keys->key_w, 'w', 'W', "w", "W", "å", "Å", modifiers);
-    handle_keyboard_text_entry(keys->key_e, prev_keys->key_e, 'e', 'E', "e", "E", "é", "É", modifiers);
-    handle_keyboard_text_entry(keys->key_r, prev_keys->key_r, 'r', 'R', "r", "R", "®", "™", modifiers);
-    handle_keyboard_text_entry(keys->key_t, prev_keys->key_t, 't', 'T', "t", "T", "þ", "Þ", modifiers);
-    handle_keyboard_text_entry(keys->key_y, prev_keys->key_y, 'y', 'Y', "y", "Y", "ü", "Ü", modifiers);
-    handle_keyboard_text_entry(keys->key_u, prev_keys->key_u, 'u', 'U', "u", "U", "ú", "Ú", modifiers);
-    handle_keyboard_text_entry(keys->key_i, prev_keys->key_i, 'i', 'I', "i", "I", "í", "Í", modifiers);
-    handle_keyboard_text_entry(keys->key_o, prev_keys->key_o, 'o', 'O', "o", "O", "ó", "Ó", modifiers);
-    handle_keyboard_text_entry(keys->key_p, prev_keys->key_p, 'p', 'P', "p", "P", "ö", "Ö", modifiers);
-    handle_keyboard_text_entry(keys->key_sqbracket_open, prev_keys->key_sqbracket_open, '[', '{', "[", "{", "«", "“",
-                               modifiers);
-    handle_keyboard_text_entry(keys->key_sqbracket_close, prev_keys->key_sqbracket_close, ']', '}', "]", "}", "»", "”",
-                               modifiers);
-    handle_keyboard_text_entry(keys->key_a, prev_keys->key_a, 'a', 'A', "a", "A", "á", "Á", modifiers);
-    handle_keyboard_text_entry(keys->key_s, prev_keys->key_s, 's', 'S', "s", "S", "ß", "§", modifiers);
-    handle_keyboard_text_entry(keys->key_d, prev_keys->key_d, 'd', 'D', "d", "D", "ð", "Ð", modifiers);
-    handle_keyboard_text_entry(keys->key_f, prev_keys->key_f, 'f', 'F', "f", "F", "ë", "Ë", modifiers);
-    handle_keyboard_text_entry(keys->key_g, prev_keys->key_g, 'g', 'G', "g", "G", "g", "G", modifiers);
-    handle_keyboard_text_entry(keys->key_h, prev_keys->key_h, 'h', 'H', "h", "H", "h", "H", modifiers);
-    handle_keyboard_text_entry(keys->key_j, prev_keys->key_j, 'j', 'J', "j", "J", "ï", "Ï", modifiers);
-    handle_keyboard_text_entry(keys->key_k, prev_keys->key_k, 'k', 'K', "k", "K", "œ", "Œ", modifiers);
-    handle_keyboard_text_entry(keys->key_l, prev_keys->key_l, 'l', 'L', "l", "L", "ø", "L", modifiers);
-    handle_keyboard_text_entry(keys->key_semicolon, prev_keys->key_semicolon, ';', ':', ";", ":", "̨", "̈", modifiers);
-    handle_keyboard_text_entry(keys->key_quote, prev_keys->key_quote, '\'', '"', "'", "\"", "́", "̈", modifiers);
-    handle_keyboard_text_entry(keys->key_z, prev_keys->key_z, 'z', 'Z', "z", "Z", "æ", "Æ", modifiers);
-    handle_keyboard_text_entry(keys->key_x, prev_keys->key_x, 'x', 'X', "x", "X", "·", " ̵", modifiers);
-    handle_keyboard_text_entry(keys->key_c, prev_keys->key_c, 'c', 'C', "c", "C", "©", "¢", modifiers);
-    handle_keyboard_text_entry(keys->key_v, prev_keys->key_v, 'v', 'V', "v", "V", "v", "V", modifiers);
-    handle_keyboard_text_entry(keys->key_b, prev_keys->key_b, 'b', 'B', "b", "B", "b", "B", modifiers);
-    handle_keyboard_text_entry(keys->key_n, prev_keys->key_n, 'n', 'N', "n", "N", "ñ", "Ñ", modifiers);
-    handle_keyboard_text_entry(keys->key_m, prev_keys->key_m, 'm', 'M', "m", "M", "µ", "±", modifiers);
-    handle_keyboard_text_entry(keys->key_comma, prev_keys->key_comma, ',', '<', ",", "<", "̧", "̌", modifiers);
-    handle_keyboard_text_entry(keys->key_dot, prev_keys->key_dot, '.', '>', ".", ">", "̇", "̌", modifiers);
-    handle_keyboard_text_entry(keys->key_slash, prev_keys->key_slash, '/', '?', "/", "?", "¿", "̉", modifiers);
-    handle_keyboard_text_entry(keys->key_backslash, prev_keys->key_backslash, '\\', '|', "\\", "|", "¬", "¦",
-                               modifiers);
-    handle_keyboard_text_entry(keys->key_space_l | keys->key_space_m | keys->key_space_r,
-                               prev_keys->key_space_l | prev_keys->key_space_m | prev_keys->key_space_r, ' ', ' ', " ",
-                               " ", " ", " ", modifiers);
+        send_scancode_event(BSP_INPUT_SCANCODE_ESCAPED_LEFTMETA, keys->key_meta, timestamp);
+    }
+
+    // Only visit the keys that changed since the previous report, collected by their order
+    tanmatsu_key_change_t changes[KEYBOARD_NUM_BITS + 1];
+    size_t                num_changes = 0;
+    for (uint8_t reg = 0; reg < TANMATSU_COPROCESSOR_KEYBOARD_NUM_REGS; reg++) {
+        uint8_t changed = keys->raw[reg] ^ prev_keys->raw[reg];
+        while (changed) {
+            uint8_t bit  = __builtin_ctz(changed);
+            changed     &= changed - 1;
+
+            tanmatsu_key_t const* key = keymap_by_bit[reg * 8 + bit];
+            if (key == NULL) {
+                continue;  // Meta key or unused bit
+            }
+            insert_change(changes, &num_changes, key, REPEAT_KEY(reg * 8 + bit), (keys->raw[reg] >> bit) & 1);
+        }
+    }
+
+    bool space      = keys->key_space_l | keys->key_space_m | keys->key_space_r;
+    bool prev_space = prev_keys->key_space_l | prev_keys->key_space_m | prev_keys->key_space_r;
+    if (space != prev_space) {
+        insert_change(changes, &num_changes, &keymap_space, REPEAT_KEY_SPACE, space);
+    }
+
+    for (size_t i = 0; i < num_changes; i++) {
+        if (!changes[i].state) {
+            bsp_input_repeat_release(changes[i].repeat_key);
+        }
+    }
+
+    // The navigation keys first, then the scancodes of the other keys, then the text, see the key table
+    for (size_t i = 0; i < num_changes; i++) {
+        tanmatsu_key_t const* key = changes[i].key;
+        if (key->navigation != BSP_INPUT_NAVIGATION_KEY_NONE) {
+            if (key->scancode != BSP_INPUT_SCANCODE_NONE) {
+                send_scancode_event(key->scancode, changes[i].state, timestamp);
+            }
+            send_navigation_event(key->navigation, changes[i].state, modifiers, timestamp, changes[i].repeat_key);
+        }
+    }
+
+    for (size_t i = 0; i < num_changes; i++) {
+        tanmatsu_key_t const* key = changes[i].key;
+        if (key->navigation == BSP_INPUT_NAVIGATION_KEY_NONE && key->scancode != BSP_INPUT_SCANCODE_NONE) {
+            send_scancode_event(key->scancode, changes[i].state, timestamp);
+        }
+    }
+
+    // The text keys among the changes, by their text order
+    tanmatsu_key_change_t const* texts[KEYBOARD_NUM_BITS + 1];
+    size_t                       num_texts = 0;
+    for (size_t i = 0; i < num_changes; i++) {
+        if (changes[i].key->utf8 == NULL) {
+            continue;
+        }
+        size_t position = num_texts++;
+        while (position > 0 && texts[position - 1]->key->text_order > changes[i].key->text_order) {
+            texts[position] = texts[position - 1];
+            position--;
+        }
+        texts[position] = &changes[i];
+    }
+    for (size_t i = 0; i < num_texts; i++) {
+        send_key_text(texts[i], modifiers, timestamp);
+    }
 }
 
 void bsp_internal_coprocessor_input_callback(tanmatsu_coprocessor_handle_t  handle,
                                              tanmatsu_coprocessor_inputs_t* prev_inputs,
                                              tanmatsu_coprocessor_inputs_t* inputs) {
+    int64_t timestamp = esp_timer_get_time();
+
     if (inputs->sd_card_detect != prev_inputs->sd_card_detect) {
-        send_action_event(BSP_INPUT_ACTION_TYPE_SD_CARD, inputs->sd_card_detect);
+        send_action_event(BSP_INPUT_ACTION_TYPE_SD_CARD, inputs->sd_card_detect, timestamp);
     }
 
     if (inputs->headphone_detect != prev_inputs->headphone_detect) {
-        send_action_event(BSP_INPUT_ACTION_TYPE_AUDIO_JACK, inputs->headphone_detect);
+        send_action_event(BSP_INPUT_ACTION_TYPE_AUDIO_JACK, inputs->headphone_detect, timestamp);
     }
 
     if (inputs->power_button != prev_inputs->power_button) {
-        send_action_event(BSP_INPUT_ACTION_TYPE_POWER_BUTTON, inputs->power_button);
+        send_action_event(BSP_INPUT_ACTION_TYPE_POWER_BUTTON, inputs->power_button, timestamp);
     }
 }
 
 void bsp_internal_coprocessor_faults_callback(tanmatsu_coprocessor_handle_t       handle,
                                               tanmatsu_coprocessor_pmic_faults_t* prev_faults,
                                               tanmatsu_coprocessor_pmic_faults_t* faults) {
+    int64_t timestamp = esp_timer_get_time();
+
     if (prev_faults->watchdog != faults->watchdog || prev_faults->boost != faults->boost ||
         prev_faults->chrg_input != faults->chrg_input || prev_faults->chrg_thermal != faults->chrg_thermal ||
         prev_faults->chrg_safety != faults->chrg_safety || prev_faults->batt_ovp != faults->batt_ovp ||
         prev_faults->ntc_cold != faults->ntc_cold || prev_faults->ntc_hot != faults->ntc_hot ||
         prev_faults->ntc_boost != faults->ntc_boost) {
-        send_action_event(BSP_INPUT_ACTION_TYPE_PMIC_FAULT, faults->watchdog || faults->boost || faults->chrg_input ||
-                                                                faults->chrg_thermal || faults->chrg_safety ||
-                                                                faults->batt_ovp || faults->ntc_cold ||
-                                                                faults->ntc_hot || faults->ntc_boost);
+        bool fault = faults->watchdog || faults->boost || faults->chrg_input || faults->chrg_thermal ||
+                     faults->chrg_safety || faults->batt_ovp || faults->ntc_cold || faults->ntc_hot || faults->ntc_boost;
+        send_action_event(BSP_INPUT_ACTION_TYPE_PMIC_FAULT, fault, timestamp);
     }
 }
 
-/*static void key_repeat_thread(void* ignored) {
-    (void)ignored;
-    while (1) {
-        if (key_repeat_wait) {
-            key_repeat_fast = false;
-            key_repeat_wait = false;
-            vTaskDelay(pdMS_TO_TICKS(100));
-            continue;
-        }
-        if (key_repeat_ascii != '\0') {
-            bsp_input_event_t event = {
-                .type                    = INPUT_EVENT_TYPE_KEYBOARD,
-                .args_keyboard.ascii     = key_repeat_ascii,
-                .args_keyboard.utf8      = key_repeat_utf8,
-                .args_keyboard.modifiers = key_repeat_modifiers,
-            };
-            xQueueSend(event_queue, &event, 0);
-        }
-        vTaskDelay(pdMS_TO_TICKS(key_repeat_fast ? 100 : 200));
-        key_repeat_fast = true;
-    }
-}*/
-
 esp_err_t bsp_input_initialize(void) {
-    if (event_queue == NULL) {
-        event_queue = xQueueCreate(32, sizeof(bsp_input_event_t));
-        ESP_RETURN_ON_FALSE(event_queue, ESP_ERR_NO_MEM, TAG, "Failed to create input event queue");
-    }
-
-    /*if (key_repeat_thread_handle == NULL) {
-        xTaskCreate(key_repeat_thread, "Key repeat thread", 4096, NULL, tskIDLE_PRIORITY, &key_repeat_thread_handle);
-        ESP_RETURN_ON_FALSE(key_repeat_thread_handle, ESP_ERR_NO_MEM, TAG, "Failed to create key repeat task");
-    }*/
+    ESP_RETURN_ON_ERROR(bsp_input_queue_initialize(), TAG, "Failed to initialize input event queue");
+    ESP_RETURN_ON_ERROR(bsp_input_repeat_initialize(), TAG, "Failed to initialize key repeat");
+    keymap_resolve_bits();
 
     gpio_config_t int_pin_cfg = {
         .pin_bit_mask = BIT64(BSP_GPIO_BTN_VOLUME_DOWN),
@@ -498,14 +501,7 @@ esp_err_t bsp_input_initialize(void) {
 }
 
 esp_err_t bsp_input_get_queue(QueueHandle_t* out_queue) {
-    if (out_queue == NULL) {
-        return ESP_ERR_INVALID_ARG;
-    }
-    if (event_queue == NULL) {
-        return ESP_FAIL;
-    }
-    *out_queue = event_queue;
-    return ESP_OK;
+    return bsp_input_queue_get_handle(out_queue);
 }
 
 bool bsp_input_needs_on_screen_keyboard(void) {
@@ -0,0 +1,28 @@
+// Board support package API: Virtual device implementation
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "bsp/device.h"
+#include "esp_err.h"
+
+static char const device_name[]         = "Virtual display";
+static char const device_manufacturer[] = "Badge.Team";
+
+esp_err_t bsp_device_get_name(char* output, uint8_t buffer_length) {
+    if (output == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    strlcpy(output, device_name, buffer_length);
+    return ESP_OK;
+}
+
+esp_err_t bsp_device_get_manufacturer(char* output, uint8_t buffer_length) {
+    if (output == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    strlcpy(output, device_manufacturer, buffer_length);
+    return ESP_OK;
+}
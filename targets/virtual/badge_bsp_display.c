@@ -0,0 +1,314 @@
+// Board support package API: Virtual display implementation
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "badge_bsp_display_flush.h"
+#include "badge_bsp_display_shadow.h"
+#include "badge_bsp_display_stats.h"
+#include "bsp/display.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "sdkconfig.h"
+
+static char const* TAG = "BSP display";
+
+#define H_RES CONFIG_BSP_VIRTUAL_DISPLAY_H_RES
+#define V_RES CONFIG_BSP_VIRTUAL_DISPLAY_V_RES
+
+#if CONFIG_BSP_VIRTUAL_DISPLAY_COLOR_FORMAT_1_GREY
+#define COLOR_FORMAT BSP_DISPLAY_COLOR_FORMAT_1_GREY
+#elif CONFIG_BSP_VIRTUAL_DISPLAY_COLOR_FORMAT_2_GREY
+#define COLOR_FORMAT BSP_DISPLAY_COLOR_FORMAT_2_GREY
+#elif CONFIG_BSP_VIRTUAL_DISPLAY_COLOR_FORMAT_4_GREY
+#define COLOR_FORMAT BSP_DISPLAY_COLOR_FORMAT_4_GREY
+#elif CONFIG_BSP_VIRTUAL_DISPLAY_COLOR_FORMAT_8_GREY
+#define COLOR_FORMAT BSP_DISPLAY_COLOR_FORMAT_8_GREY
+#elif CONFIG_BSP_VIRTUAL_DISPLAY_COLOR_FORMAT_8_332RGB
+#define COLOR_FORMAT BSP_DISPLAY_COLOR_FORMAT_8_332RGB
+#elif CONFIG_BSP_VIRTUAL_DISPLAY_COLOR_FORMAT_24_888RGB
+#define COLOR_FORMAT BSP_DISPLAY_COLOR_FORMAT_24_888RGB
+#elif CONFIG_BSP_VIRTUAL_DISPLAY_COLOR_FORMAT_32_8888ARGB
+#define COLOR_FORMAT BSP_DISPLAY_COLOR_FORMAT_32_8888ARGB
+#else
+#define COLOR_FORMAT BSP_DISPLAY_COLOR_FORMAT_16_565RGB
+#endif
+
+#if CONFIG_BSP_VIRTUAL_DISPLAY_BIG_ENDIAN
+#define DATA_ENDIAN BSP_DISPLAY_ENDIAN_BIG
+#else
+#define DATA_ENDIAN BSP_DISPLAY_ENDIAN_LITTLE
+#endif
+
+// Number of simulated transfers that can be queued on the bus at once
+#define MAX_IN_FLIGHT 8
+
+static bool               bsp_display_initialized = false;
+static size_t             display_bpp             = 0;
+static uint8_t            display_brightness      = 100;
+static uint32_t           dump_frame_number       = 0;
+static esp_timer_handle_t transfer_timer          = NULL;
+
+// Completion times of the simulated transfers in flight, oldest first
+static int64_t      transfer_deadlines[MAX_IN_FLIGHT];
+static size_t       transfer_head  = 0;
+static size_t       transfer_tail  = 0;
+static size_t       transfer_count = 0;
+static int64_t      bus_free_at    = 0;
+static portMUX_TYPE transfer_lock  = portMUX_INITIALIZER_UNLOCKED;
+
+// Time the simulated bus needs to transfer the given number of bytes. At least a microsecond, so every completion is
+// reported by the transfer timer in the order the blits were queued, also without a simulated bus.
+static int64_t bsp_display_transfer_time_us(size_t bytes) {
+    int64_t duration = 0;
+#if CONFIG_BSP_VIRTUAL_DISPLAY_BUS_SPI
+    duration = (int64_t)bytes * 8 * 1000000 / CONFIG_BSP_VIRTUAL_DISPLAY_SPI_CLOCK_HZ;
+#elif CONFIG_BSP_VIRTUAL_DISPLAY_BUS_DSI
+    duration = (int64_t)bytes * 8 / (CONFIG_BSP_VIRTUAL_DISPLAY_DSI_LANES * CONFIG_BSP_VIRTUAL_DISPLAY_DSI_LANE_MBPS);
+#else
+    (void)bytes;
+#endif
+    return duration > 0 ? duration : 1;
+}
+
+static void bsp_display_transfer_done(void* arg) {
+    bsp_display_flush_done_from_isr();
+
+    int64_t next = 0;
+    portENTER_CRITICAL(&transfer_lock);
+    transfer_tail = (transfer_tail + 1) % MAX_IN_FLIGHT;
+    transfer_count--;
+    if (transfer_count > 0) {
+        next = transfer_deadlines[transfer_tail];
+    }
+    portEXIT_CRITICAL(&transfer_lock);
+
+    if (next > 0) {
+        int64_t delay = next - esp_timer_get_time();
+        esp_timer_start_once(transfer_timer, delay > 0 ? delay : 1);
+    }
+}
+
+// Queue a transfer behind the ones already in flight, the timer completes them one after another
+static esp_err_t bsp_display_schedule_transfer(int64_t duration) {
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&transfer_lock);
+    bus_free_at                       = (bus_free_at > now ? bus_free_at : now) + duration;
+    transfer_deadlines[transfer_head] = bus_free_at;
+    transfer_head                     = (transfer_head + 1) % MAX_IN_FLIGHT;
+    transfer_count++;
+    bool first = transfer_count == 1;
+    portEXIT_CRITICAL(&transfer_lock);
+
+    if (!first) {
+        return ESP_OK;
+    }
+
+    esp_err_t res = esp_timer_start_once(transfer_timer, duration);
+    if (res != ESP_OK) {
+        portENTER_CRITICAL(&transfer_lock);
+        transfer_head = (transfer_head + MAX_IN_FLIGHT - 1) % MAX_IN_FLIGHT;
+        transfer_count--;
+        portEXIT_CRITICAL(&transfer_lock);
+    }
+    return res;
+}
+
+// Decode a pixel of the framebuffer into 8-bit red, green and blue
+static void bsp_display_decode_pixel(const uint8_t* row, size_t x, uint8_t* rgb) {
+    bool big_endian = DATA_ENDIAN == BSP_DISPLAY_ENDIAN_BIG;
+
+    if (display_bpp < 8) {
+        size_t  bit   = x * display_bpp;
+        uint8_t mask  = (1 << display_bpp) - 1;
+        uint8_t value = (row[bit / 8] >> (8 - display_bpp - bit % 8)) & mask;
+        rgb[0] = rgb[1] = rgb[2] = value * 255 / mask;
+        return;
+    }
+
+    if (display_bpp == 8) {
+        uint8_t value = row[x];
+        if (COLOR_FORMAT == BSP_DISPLAY_COLOR_FORMAT_8_332RGB) {
+            rgb[0] = (value >> 5) * 255 / 7;
+            rgb[1] = ((value >> 2) & 0x07) * 255 / 7;
+            rgb[2] = (value & 0x03) * 85;
+        } else {
+            rgb[0] = rgb[1] = rgb[2] = value;
+        }
+        return;
+    }
+
+    if (display_bpp == 16) {
+        const uint8_t* p     = &row[x * 2];
+        uint16_t       value = big_endian ? (p[0] << 8) | p[1] : p[0] | (p[1] << 8);
+        uint8_t        r     = (value >> 11) & 0x1F;
+        uint8_t        g     = (value >> 5) & 0x3F;
+        uint8_t        b     = value & 0x1F;
+        rgb[0]               = (r << 3) | (r >> 2);
+        rgb[1]               = (g << 2) | (g >> 4);
+        rgb[2]               = (b << 3) | (b >> 2);
+        return;
+    }
+
+    // Three or four bytes per pixel, the alpha byte of ARGB8888 is ignored
+    size_t         bytes = display_bpp / 8;
+    const uint8_t* p     = &row[x * bytes];
+    if (big_endian) {
+        p += bytes - 3;
+        rgb[0] = p[0];
+        rgb[1] = p[1];
+        rgb[2] = p[2];
+    } else {
+        rgb[0] = p[2];
+        rgb[1] = p[1];
+        rgb[2] = p[0];
+    }
+}
+
+// Write the framebuffer as a binary PPM image
+static esp_err_t bsp_display_dump_frame(void) {
+    const char* pattern = CONFIG_BSP_VIRTUAL_DISPLAY_DUMP_PATH;
+    if (pattern[0] == '\0') {
+        return ESP_OK;
+    }
+
+    char path[128];
+    snprintf(path, sizeof(path), pattern, (unsigned int)dump_frame_number++);
+
+    uint8_t* line = malloc(H_RES * 3);
+    ESP_RETURN_ON_FALSE(line, ESP_ERR_NO_MEM, TAG, "Failed to allocate dump buffer");
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        free(line);
+        ESP_LOGE(TAG, "Failed to open %s", path);
+        return ESP_FAIL;
+    }
+
+    const uint8_t* framebuffer = bsp_display_shadow_get_buffer();
+    size_t         stride      = (H_RES * display_bpp + 7) / 8;
+    fprintf(file, "P6\n%u %u\n255\n", (unsigned int)H_RES, (unsigned int)V_RES);
+    for (size_t y = 0; y < V_RES; y++) {
+        for (size_t x = 0; x < H_RES; x++) {
+            bsp_display_decode_pixel(&framebuffer[y * stride], x, &line[x * 3]);
+        }
+        fwrite(line, 3, H_RES, file);
+    }
+
+    fclose(file);
+    free(line);
+    return ESP_OK;
+}
+
+// Public functions
+
+esp_err_t bsp_display_initialize(const bsp_display_configuration_t* configuration) {
+    if (bsp_display_initialized) {
+        return ESP_OK;
+    }
+
+    display_bpp = bsp_display_get_bits_per_pixel(COLOR_FORMAT);
+    ESP_RETURN_ON_ERROR(bsp_display_shadow_initialize(H_RES, V_RES, display_bpp), TAG,
+                        "Failed to allocate framebuffer");
+
+    size_t max_in_flight = configuration != NULL ? configuration->max_blits_in_flight : 1;
+    if (max_in_flight > MAX_IN_FLIGHT) {
+        max_in_flight = MAX_IN_FLIGHT;
+    }
+    ESP_RETURN_ON_ERROR(bsp_display_flush_initialize(max_in_flight), TAG, "Failed to initialize flush tracking");
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = bsp_display_transfer_done,
+        .name     = "virtual display",
+    };
+    ESP_RETURN_ON_ERROR(esp_timer_create(&timer_args, &transfer_timer), TAG, "Failed to create transfer timer");
+
+    bsp_display_initialized = true;
+    return ESP_OK;
+}
+
+esp_err_t bsp_display_get_parameters(size_t* h_res, size_t* v_res, bsp_display_color_format_t* color_fmt,
+                                     bsp_display_endianness_t* data_endian) {
+    if (!bsp_display_initialized) {
+        return ESP_FAIL;
+    }
+    if (h_res) {
+        *h_res = H_RES;
+    }
+    if (v_res) {
+        *v_res = V_RES;
+    }
+    if (color_fmt) {
+        *color_fmt = COLOR_FORMAT;
+    }
+    if (data_endian) {
+        *data_endian = DATA_ENDIAN;
+    }
+    return ESP_OK;
+}
+
+bsp_display_rotation_t bsp_display_get_default_rotation() {
+    return BSP_DISPLAY_ROTATION_0;
+}
+
+esp_err_t bsp_display_get_backlight_brightness(uint8_t* out_percentage) {
+    ESP_RETURN_ON_FALSE(out_percentage, ESP_ERR_INVALID_ARG, TAG, "Percentage output argument is NULL");
+    *out_percentage = display_brightness;
+    return ESP_OK;
+}
+
+esp_err_t bsp_display_set_backlight_brightness(uint8_t percentage) {
+    ESP_RETURN_ON_FALSE(percentage <= 100, ESP_ERR_INVALID_ARG, TAG, "Percentage out of range");
+    display_brightness = percentage;
+    return ESP_OK;
+}
+
+esp_err_t bsp_display_blit(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer) {
+    ESP_RETURN_ON_ERROR(bsp_display_blit_async(x_start, y_start, x_end, y_end, buffer, NULL, NULL), TAG,
+                        "Failed to blit");
+    return bsp_display_blit_wait_idle(portMAX_DELAY);
+}
+
+esp_err_t bsp_display_blit_async(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer,
+                                 bsp_display_blit_done_cb_t callback, void* user_ctx) {
+    if (!bsp_display_initialized) {
+        return ESP_FAIL;
+    }
+    ESP_RETURN_ON_FALSE(buffer != NULL && x_start < x_end && y_start < y_end && x_end <= H_RES && y_end <= V_RES,
+                        ESP_ERR_INVALID_ARG, TAG, "Invalid region");
+    ESP_RETURN_ON_ERROR(bsp_display_flush_begin(callback, user_ctx, pdMS_TO_TICKS(1000)), TAG,
+                        "Timeout while waiting for previous flush");
+
+    // The pixels are copied right away, completion is reported once the simulated bus would have sent them
+    int64_t   start   = bsp_display_stats_now();
+    size_t    changed = 0;
+    esp_err_t res     = bsp_display_shadow_update(x_start, y_start, x_end, y_end, buffer, &changed);
+    if (res != ESP_OK) {
+        bsp_display_flush_cancel();
+        return res;
+    }
+
+    size_t bytes = (y_end - y_start) * (((x_end - x_start) * display_bpp + 7) / 8);
+    res          = bsp_display_schedule_transfer(bsp_display_transfer_time_us(bytes));
+    if (res != ESP_OK) {
+        bsp_display_flush_cancel();
+        return res;
+    }
+    bsp_display_stats_record_blit(x_start, y_start, x_end, y_end, start);
+
+    // The shadow framebuffer is only used while holding the submission lock of the flush tracker
+    if (changed > 0) {
+        bsp_display_shadow_mark_presented(true, changed);
+        res = bsp_display_dump_frame();
+    }
+    bsp_display_flush_end();
+    ESP_RETURN_ON_ERROR(res, TAG, "Failed to dump frame");
+    return ESP_OK;
+}
@@ -4,6 +4,10 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
+#include "badge_bsp_display_flip.h"
+#include "badge_bsp_display_flush.h"
+#include "badge_bsp_display_stats.h"
+#include "badge_bsp_lcd_init.h"
 #include "bsp/display.h"
 #include "driver/gpio.h"
 #include "esp_check.h"
@@ -24,16 +28,26 @@
 
 static char const* TAG = "BSP display";
 
-static esp_ldo_channel_handle_t  ldo_mipi_phy    = NULL;
-static SemaphoreHandle_t         flush_semaphore = NULL;
-static esp_lcd_dsi_bus_handle_t  mipi_dsi_bus    = NULL;
-static esp_lcd_panel_io_handle_t mipi_dbi_io     = NULL;
-static esp_lcd_panel_handle_t    panel_handle    = NULL;
+static esp_ldo_channel_handle_t  ldo_mipi_phy = NULL;
+static esp_lcd_dsi_bus_handle_t  mipi_dsi_bus = NULL;
+static esp_lcd_panel_io_handle_t mipi_dbi_io  = NULL;
+static esp_lcd_panel_handle_t    panel_handle = NULL;
+
+static bool               bsp_display_initialized = false;
+static size_t             display_num_fbs         = 1;
+static lcd_color_format_t display_color_format    = LCD_COLOR_FMT_RGB888;
+
+#define LCD_INIT_CMDS_MAX 32
+static st7703_lcd_init_cmd_t lcd_init_cmds[LCD_INIT_CMDS_MAX];
 
 IRAM_ATTR static bool bsp_display_flush_ready(esp_lcd_panel_handle_t panel, esp_lcd_dpi_panel_event_data_t* edata,
                                               void* user_ctx) {
-    xSemaphoreGiveFromISR(flush_semaphore, NULL);
-    return true;
+    return bsp_display_flush_done_from_isr();
+}
+
+IRAM_ATTR static bool bsp_display_refresh_done(esp_lcd_panel_handle_t panel, esp_lcd_dpi_panel_event_data_t* edata,
+                                               void* user_ctx) {
+    return bsp_display_flip_vblank_from_isr();
 }
 
 static esp_err_t bsp_display_enable_dsi_phy_power(void) {
@@ -51,7 +65,32 @@ static esp_err_t bsp_display_reset(void) {
     return ESP_OK;
 }
 
-static esp_err_t bsp_display_initialize_panel(void) {
+// The panel driver consumes its own command array, expanded once from the shared init table
+static esp_err_t bsp_display_expand_init_table(size_t* out_count) {
+    const uint8_t*     cursor = why2025_lcd_init_table;
+    bsp_lcd_init_cmd_t cmd;
+    size_t             count = 0;
+    while (bsp_lcd_init_next(&cursor, &cmd)) {
+        if (count >= LCD_INIT_CMDS_MAX) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        lcd_init_cmds[count].cmd        = cmd.command;
+        lcd_init_cmds[count].data       = cmd.params;
+        lcd_init_cmds[count].data_bytes = cmd.num_params;
+        lcd_init_cmds[count].delay_ms   = cmd.delay_ms;
+        count++;
+    }
+    *out_count = count;
+    return ESP_OK;
+}
+
+static esp_err_t bsp_display_initialize_panel(const bsp_display_configuration_t* configuration) {
+    display_num_fbs = configuration != NULL && configuration->num_fbs > 0 ? configuration->num_fbs : 1;
+
+    // RGB565 halves the DSI link and PSRAM bandwidth needed to refresh the 720x720 panel
+    bool rgb565 = configuration != NULL && configuration->requested_color_format == BSP_DISPLAY_COLOR_FORMAT_16_565RGB;
+    display_color_format = rgb565 ? LCD_COLOR_FMT_RGB565 : LCD_COLOR_FMT_RGB888;
+
     ESP_LOGI(TAG, "Initialize MIPI DSI bus");
     esp_lcd_dsi_bus_config_t bus_config = {
         .bus_id             = 0,
@@ -71,40 +110,43 @@ static esp_err_t bsp_display_initialize_panel(void) {
 
     ESP_LOGI(TAG, "Install ST7703 panel driver");
     const esp_lcd_dpi_panel_config_t dpi_config = {
-    .dpi_clk_src        = MIPI_DSI_DPI_CLK_SRC_DEFAULT,
-     .dpi_clock_freq_mhz = 47,
-     .virtual_channel    = 0,
-     .in_color_format  = LCD_COLOR_FMT_RGB888,
-     .out_color_format = LCD_COLOR_FMT_RGB888,
-     .num_fbs = 1,
-     .video_timing =
-         {
-             .h_size            = 720,
-             .v_size            = 720,
-             .hsync_back_porch  = 120,
-             .hsync_pulse_width = 60,
-             .hsync_front_porch = 106,
-             .vsync_back_porch  = 20,
-             .vsync_pulse_width = 4,
-             .vsync_front_porch = 20,
-         },
-     .flags.disable_lp = false
+        .dpi_clk_src        = MIPI_DSI_DPI_CLK_SRC_DEFAULT,
+        .dpi_clock_freq_mhz = 47,
+        .virtual_channel    = 0,
+        .in_color_format    = display_color_format,
+        .out_color_format   = display_color_format,
+        .num_fbs            = display_num_fbs,
+        .video_timing =
+            {
+                .h_size            = 720,
+                .v_size            = 720,
+                .hsync_back_porch  = 120,
+                .hsync_pulse_width = 60,
+                .hsync_front_porch = 106,
+                .vsync_back_porch  = 20,
+                .vsync_pulse_width = 4,
+                .vsync_front_porch = 20,
+            },
+        .flags.disable_lp = false,
     };
 
+    size_t init_cmds_size = 0;
+    ESP_RETURN_ON_ERROR(bsp_display_expand_init_table(&init_cmds_size), TAG, "Failed to expand the LCD init table");
+
     st7703_vendor_config_t vendor_config = {
         .mipi_config =
             {
                 .dsi_bus    = mipi_dsi_bus,
                 .dpi_config = &dpi_config,
             },
-        .init_cmds      = custom_init,
-        .init_cmds_size = sizeof(custom_init) / sizeof(st7703_lcd_init_cmd_t),
+        .init_cmds      = lcd_init_cmds,
+        .init_cmds_size = init_cmds_size,
         .init_in_command_mode    = true
     };
     const esp_lcd_panel_dev_config_t panel_config = {
         .reset_gpio_num          = BSP_LCD_RESET_PIN,
         .rgb_ele_order           = LCD_RGB_ELEMENT_ORDER_RGB,
-        .bits_per_pixel          = 24,
+        .bits_per_pixel          = rgb565 ? 16 : 24,
         .vendor_config           = &vendor_config,
         .flags.reset_active_high = 1,
     };
@@ -116,27 +158,35 @@ static esp_err_t bsp_display_initialize_panel(void) {
     return ESP_OK;
 }
 
-static esp_err_t bsp_display_initialize_flush(void) {
-    flush_semaphore = xSemaphoreCreateBinary();
-    xSemaphoreGive(flush_semaphore);
+static esp_err_t bsp_display_initialize_flush(const bsp_display_configuration_t* configuration) {
+    size_t max_in_flight = configuration != NULL ? configuration->max_blits_in_flight : 1;
+    ESP_RETURN_ON_ERROR(bsp_display_flush_initialize(max_in_flight), TAG, "Failed to initialize flush tracking");
     esp_lcd_dpi_panel_event_callbacks_t callbacks = {
         .on_color_trans_done = bsp_display_flush_ready,
+        .on_refresh_done     = bsp_display_refresh_done,
     };
     return esp_lcd_dpi_panel_register_event_callbacks(panel_handle, &callbacks, NULL);
 }
 
 // Public functions
 
-esp_err_t bsp_display_initialize(void) {
+esp_err_t bsp_display_initialize(const bsp_display_configuration_t* configuration) {
+    if (bsp_display_initialized) {
+        return ESP_OK;
+    }
     ESP_RETURN_ON_ERROR(bsp_display_enable_dsi_phy_power(), TAG, "Failed to enable DSI PHY power");
     ESP_RETURN_ON_ERROR(bsp_display_reset(), TAG, "Failed to reset display");
-    ESP_RETURN_ON_ERROR(bsp_display_initialize_panel(), TAG, "Failed to initialize panel");
-    ESP_RETURN_ON_ERROR(bsp_display_initialize_flush(), TAG, "Failed to initialize flush callback");
+    ESP_RETURN_ON_ERROR(bsp_display_initialize_panel(configuration), TAG, "Failed to initialize panel");
+    ESP_RETURN_ON_ERROR(bsp_display_initialize_flush(configuration), TAG, "Failed to initialize flush callback");
+    bsp_display_initialized = true;
     return ESP_OK;
 }
 
 esp_err_t bsp_display_get_parameters(size_t* h_res, size_t* v_res, bsp_display_color_format_t* color_fmt,
                                      bsp_display_endianness_t* data_endian) {
+    if (!bsp_display_initialized) {
+        return ESP_FAIL;
+    }
     if (h_res) {
         *h_res = 720;
     }
@@ -144,7 +194,8 @@ esp_err_t bsp_display_get_parameters(size_t* h_res, size_t* v_res, bsp_display_c
         *v_res = 720;
     }
     if (color_fmt) {
-        *color_fmt = BSP_DISPLAY_COLOR_FORMAT_24_888RGB;
+        *color_fmt = display_color_format == LCD_COLOR_FMT_RGB565 ? BSP_DISPLAY_COLOR_FORMAT_16_565RGB
+                                                                  : BSP_DISPLAY_COLOR_FORMAT_24_888RGB;
     }
     if (data_endian) {
         *data_endian = BSP_DISPLAY_ENDIAN_LITTLE;
@@ -177,6 +228,37 @@ esp_err_t bsp_display_set_backlight_brightness(uint8_t percentage) {
 }
 
 esp_err_t bsp_display_blit(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer) {
-    xSemaphoreTake(flush_semaphore, pdMS_TO_TICKS(1000));
-    return esp_lcd_panel_draw_bitmap(panel_handle, x_start, y_start, x_end, y_end, buffer);
+    return bsp_display_blit_async(x_start, y_start, x_end, y_end, buffer, NULL, NULL);
+}
+
+esp_err_t bsp_display_blit_async(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer,
+                                 bsp_display_blit_done_cb_t callback, void* user_ctx) {
+    ESP_RETURN_ON_ERROR(bsp_display_flush_begin(callback, user_ctx, pdMS_TO_TICKS(1000)), TAG,
+                        "Timeout while waiting for previous flush");
+    int64_t   start = bsp_display_stats_now();
+    esp_err_t res   = esp_lcd_panel_draw_bitmap(panel_handle, x_start, y_start, x_end, y_end, buffer);
+    if (res != ESP_OK) {
+        bsp_display_flush_cancel();
+        return res;
+    }
+    bsp_display_flush_end();
+    bsp_display_stats_record_blit(x_start, y_start, x_end, y_end, start);
+    return ESP_OK;
+}
+
+esp_err_t bsp_display_get_framebuffers(void** out_fbs, size_t max_fbs, size_t* out_num_fbs) {
+    if (!bsp_display_initialized) {
+        return ESP_FAIL;
+    }
+    ESP_RETURN_ON_FALSE(out_fbs != NULL && out_num_fbs != NULL, ESP_ERR_INVALID_ARG, TAG, "Output argument is NULL");
+
+    void* fbs[BSP_DISPLAY_MAX_FRAMEBUFFERS] = {NULL};
+
+    esp_err_t res = esp_lcd_dpi_panel_get_frame_buffer(panel_handle, display_num_fbs, &fbs[0], &fbs[1], &fbs[2]);
+    ESP_RETURN_ON_ERROR(res, TAG, "Failed to get framebuffers");
+    for (size_t i = 0; i < display_num_fbs && i < max_fbs; i++) {
+        out_fbs[i] = fbs[i];
+    }
+    *out_num_fbs = display_num_fbs;
+    return ESP_OK;
 }
@@ -3,12 +3,14 @@
 
 #include <stdint.h>
 #include <stdio.h>
-#include "badge_bsp_input_hooks.h"
+#include "badge_bsp_input_queue.h"
+#include "badge_bsp_keymap.h"
 #include "bsp/i2c.h"
 #include "bsp/input.h"
 #include "driver/gpio.h"
 #include "esp_check.h"
 #include "esp_err.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
 #include "tca8418.h"
@@ -16,11 +18,8 @@
 
 static char const* TAG = "BSP INPUT";
 
-static QueueHandle_t    event_queue       = NULL;
-static bool             prev_button_state = false;
-static tca8418_handle_t tca8418_handle    = {0};
-static uint32_t         active_modifiers  = 0;
-static bool             super_used        = false;
+static tca8418_handle_t tca8418_handle = {0};
+static bsp_keymap_t     keymap         = {0};
 static i2c_master_bus_handle_t i2c_handle;
 
 typedef enum {
@@ -103,74 +102,77 @@ typedef enum {
 
 } WHY2025_keys_t;
 
-static void send_navigation_event(bsp_input_navigation_key_t key, bool state, uint32_t modifiers) {
-    bsp_input_event_t event = {
-        .type                      = INPUT_EVENT_TYPE_NAVIGATION,
-        .args_navigation.key       = key,
-        .args_navigation.modifiers = modifiers,
-        .args_navigation.state     = state,
-    };
-    // Offer to hooks first; if consumed, don't queue
-    if (!bsp_input_hooks_process(&event)) {
-        xQueueSend(event_queue, &event, 0);
-    }
-}
-
-static void send_keyboard_event(char ascii, char const* utf8, uint32_t modifiers) {
-    bsp_input_event_t event = {
-        .type                    = INPUT_EVENT_TYPE_KEYBOARD,
-        .args_keyboard.ascii     = ascii,
-        .args_keyboard.modifiers = modifiers,
-    };
-    strlcpy(event.args_keyboard.utf8, utf8, sizeof(event.args_keyboard.utf8));
-    // Offer to hooks first; if consumed, don't queue
-    if (!bsp_input_hooks_process(&event)) {
-        xQueueSend(event_queue, &event, 0);
-    }
-}
-
-static void send_action_event(bsp_input_action_type_t action, bool state) {
-    bsp_input_event_t event = {
-        .type              = INPUT_EVENT_TYPE_ACTION,
-        .args_action.type  = action,
-        .args_action.state = state,
-    };
-    // Offer to hooks first; if consumed, don't queue
-    if (!bsp_input_hooks_process(&event)) {
-        xQueueSend(event_queue, &event, 0);
-    }
-}
-
-static void send_scancode_event(bsp_input_scancode_t scancode, bool state) {
-    bsp_input_event_t event = {
-        .type                   = INPUT_EVENT_TYPE_SCANCODE,
-        .args_scancode.scancode = scancode | (state ? 0 : BSP_INPUT_SCANCODE_RELEASE_MODIFIER),
-    };
-    // Offer to hooks first; if consumed, don't queue
-    if (!bsp_input_hooks_process(&event)) {
-        xQueueSend(event_queue, &event, 0);
-    }
-}
-
-static void handle_keyboard_text_entry(char ascii, char ascii_shift, char const* utf8, char const* utf8_shift,
-                                       char const* utf8_alt, char const* utf8_shift_alt, uint32_t modifiers) {
-    char              value_ascii = (modifiers & BSP_INPUT_MODIFIER_SHIFT) ? ascii_shift : ascii;
-    char const*       value_utf8  = (modifiers & BSP_INPUT_MODIFIER_ALT_R)
-                                        ? ((modifiers & BSP_INPUT_MODIFIER_SHIFT) ? utf8_shift_alt : utf8_alt)
-                                        : ((modifiers & BSP_INPUT_MODIFIER_SHIFT) ? utf8_shift : utf8);
-    bsp_input_event_t event       = {
-              .type                    = INPUT_EVENT_TYPE_KEYBOARD,
-              .args_keyboard.ascii     = value_ascii,
-              .args_keyboard.modifiers = modifiers,
-    };
-    if (value_utf8) {
-        strlcpy(event.args_keyboard.utf8, value_utf8, sizeof(event.args_keyboard.utf8));
-    } else {
-        event.args_keyboard.utf8[0] = value_ascii;
-        event.args_keyboard.utf8[1] = 0;
-    }
-    xQueueSend(event_queue, &event, 0);
-}
+static bsp_keymap_key_t const why2025_keymap[] = {
+    [WHY2025_KEY_ESC]           = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_NONE, BSP_INPUT_NAVIGATION_KEY_ESC),
+    [WHY2025_KEY_F1]            = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_NONE, BSP_INPUT_NAVIGATION_KEY_F1),
+    [WHY2025_KEY_F2]            = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_NONE, BSP_INPUT_NAVIGATION_KEY_F2),
+    [WHY2025_KEY_F3]            = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_NONE, BSP_INPUT_NAVIGATION_KEY_F3),
+    [WHY2025_KEY_F4]            = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_NONE, BSP_INPUT_NAVIGATION_KEY_F4),
+    [WHY2025_KEY_F5]            = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_NONE, BSP_INPUT_NAVIGATION_KEY_F5),
+    [WHY2025_KEY_F6]            = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_NONE, BSP_INPUT_NAVIGATION_KEY_F6),
+    [WHY2025_KEY_BACKSPACE]     = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_NONE, BSP_INPUT_NAVIGATION_KEY_BACKSPACE),
+    [WHY2025_KEY_NUM_0]         = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_KP0, '0', ')', "0", ")", "’", "̊"),
+    [WHY2025_KEY_NUM_MINUS]     = BSP_KEYMAP_SCANCODE(BSP_INPUT_SCANCODE_KPMINUS),
+    [WHY2025_KEY_GRAVE]         = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_GRAVE, '`', '~', "`", "~", "", ""),
+    [WHY2025_KEY_NUM_1]         = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_1, '1', '!', "1", "!", "¡", "¹"),
+    [WHY2025_KEY_NUM_2]         = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_2, '2', '@', "2", "@", "²", "̋"),
+    [WHY2025_KEY_NUM_3]         = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_3, '3', '#', "3", "#", "³", "̄"),
+    [WHY2025_KEY_NUM_4]         = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_4, '4', '$', "4", "$", "¤", "£"),
+    [WHY2025_KEY_NUM_5]         = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_5, '5', '%', "5", "%", "€", "¸"),
+    [WHY2025_KEY_NUM_6]         = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_6, '6', '^', "6", "^", "¼", "̂"),
+    [WHY2025_KEY_NUM_7]         = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_7, '7', '&', "7", "&", "½", "̛"),
+    [WHY2025_KEY_NUM_8]         = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_8, '8', '*', "8", "*", "¾", "̨"),
+    [WHY2025_KEY_NUM_9]         = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_9, '9', '(', "9", "(", "‘", "̆"),
+    [WHY2025_KEY_TAB]           = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_NONE, BSP_INPUT_NAVIGATION_KEY_TAB),
+    [WHY2025_KEY_Q]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_Q, 'q', 'Q', "q", "Q", "ä", "Ä"),
+    [WHY2025_KEY_W]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_W, 'w', 'W', "w", "W", "å", "Å"),
+    [WHY2025_KEY_E]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_E, 'e', 'E', "e", "E", "é", "É"),
+    [WHY2025_KEY_R]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_R, 'r', 'R', "r", "R", "®", "™"),
+    [WHY2025_KEY_T]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_T, 't', 'T', "t", "T", "þ", "Þ"),
+    [WHY2025_KEY_Y]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_Y, 'y', 'Y', "y", "Y", "ü", "Ü"),
+    [WHY2025_KEY_U]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_U, 'u', 'U', "u", "U", "ú", "Ú"),
+    [WHY2025_KEY_I]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_I, 'i', 'I', "i", "I", "í", "Í"),
+    [WHY2025_KEY_O]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_O, 'o', 'O', "o", "O", "ó", "Ó"),
+    [WHY2025_KEY_FN]            = BSP_KEYMAP_SCANCODE(BSP_INPUT_SCANCODE_FN),
+    [WHY2025_KEY_A]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_A, 'a', 'A', "a", "A", "á", "Á"),
+    [WHY2025_KEY_S]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_S, 's', 'S', "s", "S", "ß", "§"),
+    [WHY2025_KEY_D]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_D, 'd', 'D', "d", "D", "ð", "Ð"),
+    [WHY2025_KEY_F]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_F, 'f', 'F', "f", "F", "ë", "Ë"),
+    [WHY2025_KEY_G]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_G, 'g', 'G', "g", "G", "g", "G"),
+    [WHY2025_KEY_H]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_H, 'h', 'H', "h", "H", "h", "H"),
+    [WHY2025_KEY_J]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_J, 'j', 'J', "j", "J", "ï", "Ï"),
+    [WHY2025_KEY_K]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_K, 'k', 'K', "k", "K", "œ", "Œ"),
+    [WHY2025_KEY_L]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_L, 'l', 'L', "l", "L", "ø", "L"),
+    [WHY2025_KEY_LEFT_SHIFT]    = BSP_KEYMAP_MODIFIER(BSP_INPUT_SCANCODE_NONE, BSP_INPUT_MODIFIER_SHIFT_L),
+    [WHY2025_KEY_Z]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_Z, 'z', 'Z', "z", "Z", "æ", "Æ"),
+    [WHY2025_KEY_X]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_X, 'x', 'X', "x", "X", "·", " ̵"),
+    [WHY2025_KEY_C]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_C, 'c', 'C', "c", "C", "©", "¢"),
+    [WHY2025_KEY_V]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_V, 'v', 'V', "v", "V", "v", "V"),
+    [WHY2025_KEY_B]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_B, 'b', 'B', "b", "B", "b", "B"),
+    [WHY2025_KEY_N]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_N, 'n', 'N', "n", "N", "ñ", "Ñ"),
+    [WHY2025_KEY_M]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_M, 'm', 'M', "m", "M", "µ", "±"),
+    [WHY2025_KEY_COMMA]         = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_COMMA, ',', '<', ",", "<", "̧", "̌"),
+    [WHY2025_KEY_DOT]           = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_DOT, '.', '>', ".", ">", "̇", "̌"),
+    [WHY2025_KEY_LEFT]          = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_NONE, BSP_INPUT_NAVIGATION_KEY_LEFT),
+    [WHY2025_KEY_DOWN]          = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_NONE, BSP_INPUT_NAVIGATION_KEY_DOWN),
+    [WHY2025_KEY_RIGHT]         = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_NONE, BSP_INPUT_NAVIGATION_KEY_RIGHT),
+    [WHY2025_KEY_SLASH]         = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_SLASH, '/', '?', "/", "?", "̨", "̈"),
+    [WHY2025_KEY_UP]            = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_NONE, BSP_INPUT_NAVIGATION_KEY_UP),
+    [WHY2025_KEY_RIGHT_SHIFT]   = BSP_KEYMAP_MODIFIER(BSP_INPUT_SCANCODE_NONE, BSP_INPUT_MODIFIER_SHIFT_R),
+    [WHY2025_KEY_SEMICOLON]     = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_SEMICOLON, ';', ':', ";", ":", "̨", "̈"),
+    [WHY2025_KEY_APOSTROPHE]    = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_APOSTROPHE, '\'', '"', "'", "\"", "́", "̈"),
+    [WHY2025_KEY_ENTER]         = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_NONE, BSP_INPUT_NAVIGATION_KEY_RETURN),
+    [WHY2025_KEY_EQUAL]         = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_EQUAL, '=', '+', "=", "+", "", ""),
+    [WHY2025_KEY_CTRL]          = BSP_KEYMAP_MODIFIER(BSP_INPUT_SCANCODE_NONE, BSP_INPUT_MODIFIER_CTRL_L),
+    [WHY2025_KEY_SUPER]         = BSP_KEYMAP_MODIFIER(BSP_INPUT_SCANCODE_NONE, BSP_INPUT_MODIFIER_SUPER_L),
+    [WHY2025_KEY_LEFT_ALT]      = BSP_KEYMAP_MODIFIER(BSP_INPUT_SCANCODE_NONE, BSP_INPUT_MODIFIER_ALT_L),
+    [WHY2025_KEY_BACKSLASH]     = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_BACKSLASH, '\\', '|', "\\", "|", "̇", "̌"),
+    [WHY2025_KEY_SPACE]         = BSP_KEYMAP_NAVIGATION(BSP_INPUT_SCANCODE_NONE, BSP_INPUT_NAVIGATION_KEY_SPACE_M),
+    [WHY2025_KEY_RIGHT_ALT]     = BSP_KEYMAP_MODIFIER(BSP_INPUT_SCANCODE_NONE, BSP_INPUT_MODIFIER_ALT_R),
+    [WHY2025_KEY_P]             = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_P, 'p', 'P', "p", "P", "ö", "Ö"),
+    [WHY2025_KEY_LEFT_BRACKET]  = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_LEFTBRACE, '[', '{', "[", "{", "«", "“"),
+    [WHY2025_KEY_RIGHT_BRACKET] = BSP_KEYMAP_TEXT(BSP_INPUT_SCANCODE_RIGHTBRACE, ']', '}', "]", "}", "»", "”"),
+};
 
 static void tca8418_cad_callback(tca8418_handle_t* handle) {
     ESP_LOGI(TAG, "Ctrl-Alt-Del key sequence detected\r\n");
@@ -189,6 +191,7 @@ static void tca8418_gpi_callback(tca8418_handle_t* handle) {
 }
 
 static void tca8418_key_callback(tca8418_handle_t* handle) {
+    int64_t timestamp = esp_timer_get_time();
     // Drain the key event FIFO (up to 10 entries deep)
     for (int i = 0; i < 10; i++) {
         bool    pressed = false;
@@ -197,298 +200,7 @@ static void tca8418_key_callback(tca8418_handle_t* handle) {
             break;
         }
         ESP_DRAM_LOGI(TAG, "key event %d\r\n", code);
-        WHY2025_keys_t key = (WHY2025_keys_t)code;
-
-        if (key != WHY2025_KEY_SUPER) {
-            super_used = true;
-        }
-
-        switch (key) {
-            case WHY2025_KEY_ESC:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_ESC, pressed, active_modifiers);
-                break;
-            case WHY2025_KEY_F1:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_F1, pressed, active_modifiers);
-                break;
-            case WHY2025_KEY_NUM_9:
-                send_scancode_event(BSP_INPUT_SCANCODE_9, pressed);
-                handle_keyboard_text_entry('9', '(', "9", "(", "‘", "̆", active_modifiers);
-                break;
-            case WHY2025_KEY_NUM_8:
-                send_scancode_event(BSP_INPUT_SCANCODE_8, pressed);
-                handle_keyboard_text_entry('8', '*', "8", "*", "¾", "̨", active_modifiers);
-                break;
-            case WHY2025_KEY_NUM_7:
-                send_scancode_event(BSP_INPUT_SCANCODE_7, pressed);
-                handle_keyboard_text_entry('7', '&', "7", "&", "½", "̛", active_modifiers);
-                break;
-            case WHY2025_KEY_F2:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_F2, pressed, active_modifiers);
-                break;
-            case WHY2025_KEY_F3:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_F3, pressed, active_modifiers);
-                break;
-            case WHY2025_KEY_F4:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_F4, pressed, active_modifiers);
-                break;
-            case WHY2025_KEY_F5:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_F5, pressed, active_modifiers);
-                break;
-            case WHY2025_KEY_F6:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_F6, pressed, active_modifiers);
-                break;
-            case WHY2025_KEY_Q:
-                send_scancode_event(BSP_INPUT_SCANCODE_Q, pressed);
-                handle_keyboard_text_entry('q', 'Q', "q", "Q", "ä", "Ä", active_modifiers);
-                break;
-            case WHY2025_KEY_W:
-                send_scancode_event(BSP_INPUT_SCANCODE_W, pressed);
-                handle_keyboard_text_entry('w', 'W', "w", "W", "å", "Å", active_modifiers);
-                break;
-            case WHY2025_KEY_E:
-                send_scancode_event(BSP_INPUT_SCANCODE_E, pressed);
-                handle_keyboard_text_entry('e', 'E', "e", "E", "é", "É", active_modifiers);
-                break;
-            case WHY2025_KEY_R:
-                send_scancode_event(BSP_INPUT_SCANCODE_R, pressed);
-                handle_keyboard_text_entry('r', 'R', "r", "R", "®", "™", active_modifiers);
-                break;
-            case WHY2025_KEY_T:
-                send_scancode_event(BSP_INPUT_SCANCODE_T, pressed);
-                handle_keyboard_text_entry('t', 'T', "t", "T", "þ", "Þ", active_modifiers);
-                break;
-            case WHY2025_KEY_Y:
-                send_scancode_event(BSP_INPUT_SCANCODE_Y, pressed);
-                handle_keyboard_text_entry('y', 'Y', "y", "Y", "ü", "Ü", active_modifiers);
-                break;
-            case WHY2025_KEY_U:
-                send_scancode_event(BSP_INPUT_SCANCODE_U, pressed);
-                handle_keyboard_text_entry('u', 'U', "u", "U", "ú", "Ú", active_modifiers);
-                break;
-            case WHY2025_KEY_I:
-                send_scancode_event(BSP_INPUT_SCANCODE_I, pressed);
-                handle_keyboard_text_entry('i', 'I', "i", "I", "í", "Í", active_modifiers);
-                break;
-            case WHY2025_KEY_O:
-                send_scancode_event(BSP_INPUT_SCANCODE_O, pressed);
-                handle_keyboard_text_entry('o', 'O', "o", "O", "ó", "Ó", active_modifiers);
-                break;
-            case WHY2025_KEY_TAB:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_TAB, pressed, active_modifiers);
-                break;
-            case WHY2025_KEY_A:
-                send_scancode_event(BSP_INPUT_SCANCODE_A, pressed);
-                handle_keyboard_text_entry('a', 'A', "a", "A", "á", "Á", active_modifiers);
-                break;
-            case WHY2025_KEY_S:
-                send_scancode_event(BSP_INPUT_SCANCODE_S, pressed);
-                handle_keyboard_text_entry('s', 'S', "s", "S", "ß", "§", active_modifiers);
-                break;
-            case WHY2025_KEY_D:
-                send_scancode_event(BSP_INPUT_SCANCODE_D, pressed);
-                handle_keyboard_text_entry('d', 'D', "d", "D", "ð", "Ð", active_modifiers);
-                break;
-            case WHY2025_KEY_F:
-                send_scancode_event(BSP_INPUT_SCANCODE_F, pressed);
-                handle_keyboard_text_entry('f', 'F', "f", "F", "ë", "Ë", active_modifiers);
-                break;
-            case WHY2025_KEY_G:
-                send_scancode_event(BSP_INPUT_SCANCODE_G, pressed);
-                handle_keyboard_text_entry('g', 'G', "g", "G", "g", "G", active_modifiers);
-                break;
-            case WHY2025_KEY_H:
-                send_scancode_event(BSP_INPUT_SCANCODE_H, pressed);
-                handle_keyboard_text_entry('h', 'H', "h", "H", "h", "H", active_modifiers);
-                break;
-            case WHY2025_KEY_J:
-                send_scancode_event(BSP_INPUT_SCANCODE_J, pressed);
-                handle_keyboard_text_entry('j', 'J', "j", "J", "ï", "Ï", active_modifiers);
-                break;
-            case WHY2025_KEY_K:
-                send_scancode_event(BSP_INPUT_SCANCODE_K, pressed);
-                handle_keyboard_text_entry('k', 'K', "k", "K", "œ", "Œ", active_modifiers);
-                break;
-            case WHY2025_KEY_L:
-                send_scancode_event(BSP_INPUT_SCANCODE_L, pressed);
-                handle_keyboard_text_entry('l', 'L', "l", "L", "ø", "L", active_modifiers);
-                break;
-            case WHY2025_KEY_LEFT_SHIFT:
-                if (pressed) {
-                    active_modifiers |= BSP_INPUT_MODIFIER_SHIFT_L;
-                } else {
-                    active_modifiers &= ~(BSP_INPUT_MODIFIER_SHIFT_L);
-                }
-                break;
-            case WHY2025_KEY_Z:
-                send_scancode_event(BSP_INPUT_SCANCODE_Z, pressed);
-                handle_keyboard_text_entry('z', 'Z', "z", "Z", "æ", "Æ", active_modifiers);
-                break;
-            case WHY2025_KEY_X:
-                send_scancode_event(BSP_INPUT_SCANCODE_X, pressed);
-                handle_keyboard_text_entry('x', 'X', "x", "X", "·", " ̵", active_modifiers);
-                break;
-            case WHY2025_KEY_C:
-                send_scancode_event(BSP_INPUT_SCANCODE_C, pressed);
-                handle_keyboard_text_entry('c', 'C', "c", "C", "©", "¢", active_modifiers);
-                break;
-            case WHY2025_KEY_V:
-                send_scancode_event(BSP_INPUT_SCANCODE_V, pressed);
-                handle_keyboard_text_entry('v', 'V', "v", "V", "v", "V", active_modifiers);
-                break;
-            case WHY2025_KEY_B:
-                send_scancode_event(BSP_INPUT_SCANCODE_B, pressed);
-                handle_keyboard_text_entry('b', 'B', "b", "B", "b", "B", active_modifiers);
-                break;
-            case WHY2025_KEY_N:
-                send_scancode_event(BSP_INPUT_SCANCODE_N, pressed);
-                handle_keyboard_text_entry('n', 'N', "n", "N", "ñ", "Ñ", active_modifiers);
-                break;
-            case WHY2025_KEY_M:
-                send_scancode_event(BSP_INPUT_SCANCODE_M, pressed);
-                handle_keyboard_text_entry('m', 'M', "m", "M", "µ", "±", active_modifiers);
-                break;
-            case WHY2025_KEY_COMMA:
-                send_scancode_event(BSP_INPUT_SCANCODE_COMMA, pressed);
-                handle_keyboard_text_entry(',', '<', ",", "<", "̧", "̌", active_modifiers);
-                break;
-            case WHY2025_KEY_DOT:
-                send_scancode_event(BSP_INPUT_SCANCODE_DOT, pressed);
-                handle_keyboard_text_entry('.', '>', ".", ">", "̇", "̌", active_modifiers);
-                break;
-            case WHY2025_KEY_CTRL:
-                if (pressed) {
-                    active_modifiers |= BSP_INPUT_MODIFIER_CTRL_L;
-                } else {
-                    active_modifiers &= ~(BSP_INPUT_MODIFIER_CTRL_L);
-                }
-                break;
-            case WHY2025_KEY_SUPER:
-                if (pressed) {
-                    active_modifiers |= BSP_INPUT_MODIFIER_SUPER_L;
-                    super_used        = false;
-                } else {
-                    active_modifiers &= ~(BSP_INPUT_MODIFIER_SUPER_L);
-                    if (!super_used) {
-                        send_navigation_event(BSP_INPUT_NAVIGATION_KEY_SUPER, true, active_modifiers);
-                        send_navigation_event(BSP_INPUT_NAVIGATION_KEY_SUPER, false, active_modifiers);
-                    }
-                }
-                break;
-            case WHY2025_KEY_LEFT_ALT:
-                if (pressed) {
-                    active_modifiers |= BSP_INPUT_MODIFIER_ALT_L;
-                } else {
-                    active_modifiers &= ~(BSP_INPUT_MODIFIER_ALT_L);
-                }
-                break;
-            case WHY2025_KEY_BACKSLASH:
-                send_scancode_event(BSP_INPUT_SCANCODE_BACKSLASH, pressed);
-                handle_keyboard_text_entry('\\', '|', "\\", "|", "̇", "̌", active_modifiers);
-                break;
-            case WHY2025_KEY_SPACE:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_SPACE_M, pressed, active_modifiers);
-                break;
-            case WHY2025_KEY_RIGHT:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_RIGHT, pressed, active_modifiers);
-                break;
-            case WHY2025_KEY_DOWN:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_DOWN, pressed, active_modifiers);
-                break;
-            case WHY2025_KEY_LEFT:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_LEFT, pressed, active_modifiers);
-                break;
-            case WHY2025_KEY_RIGHT_ALT:
-                if (pressed) {
-                    active_modifiers |= BSP_INPUT_MODIFIER_ALT_R;
-                } else {
-                    active_modifiers &= ~(BSP_INPUT_MODIFIER_ALT_R);
-                }
-                break;
-            case WHY2025_KEY_NUM_MINUS:
-                send_scancode_event(BSP_INPUT_SCANCODE_KPMINUS, pressed);
-                break;
-            case WHY2025_KEY_GRAVE:
-                send_scancode_event(BSP_INPUT_SCANCODE_GRAVE, pressed);
-                handle_keyboard_text_entry('`', '~', "`", "~", "", "", active_modifiers);
-                break;
-            case WHY2025_KEY_FN:
-                send_scancode_event(BSP_INPUT_SCANCODE_FN, pressed);
-                break;
-            case WHY2025_KEY_NUM_6:
-                send_scancode_event(BSP_INPUT_SCANCODE_6, pressed);
-                handle_keyboard_text_entry('6', '^', "6", "^", "¼", "̂", active_modifiers);
-                break;
-            case WHY2025_KEY_NUM_5:
-                send_scancode_event(BSP_INPUT_SCANCODE_5, pressed);
-                handle_keyboard_text_entry('5', '%', "5", "%", "€", "¸", active_modifiers);
-                break;
-            case WHY2025_KEY_NUM_4:
-                send_scancode_event(BSP_INPUT_SCANCODE_4, pressed);
-                handle_keyboard_text_entry('4', '$', "4", "$", "¤", "£", active_modifiers);
-                break;
-            case WHY2025_KEY_RIGHT_BRACKET:
-                send_scancode_event(BSP_INPUT_SCANCODE_RIGHTBRACE, pressed);
-                handle_keyboard_text_entry(']', '}', "]", "}", "»", "”", active_modifiers);
-                break;
-            case WHY2025_KEY_LEFT_BRACKET:
-                send_scancode_event(BSP_INPUT_SCANCODE_LEFTBRACE, pressed);
-                handle_keyboard_text_entry('[', '{', "[", "{", "«", "“", active_modifiers);
-                break;
-            case WHY2025_KEY_P:
-                send_scancode_event(BSP_INPUT_SCANCODE_P, pressed);
-                handle_keyboard_text_entry('p', 'P', "p", "P", "ö", "Ö", active_modifiers);
-                break;
-            case WHY2025_KEY_NUM_3:
-                send_scancode_event(BSP_INPUT_SCANCODE_3, pressed);
-                handle_keyboard_text_entry('3', '#', "3", "#", "³", "̄", active_modifiers);
-                break;
-            case WHY2025_KEY_NUM_2:
-                send_scancode_event(BSP_INPUT_SCANCODE_2, pressed);
-                handle_keyboard_text_entry('2', '@', "2", "@", "²", "̋", active_modifiers);
-                break;
-            case WHY2025_KEY_NUM_1:
-                send_scancode_event(BSP_INPUT_SCANCODE_1, pressed);
-                handle_keyboard_text_entry('1', '!', "1", "!", "¡", "¹", active_modifiers);
-                break;
-            case WHY2025_KEY_ENTER:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_RETURN, pressed, active_modifiers);
-                break;
-            case WHY2025_KEY_EQUAL:
-                send_scancode_event(BSP_INPUT_SCANCODE_EQUAL, pressed);
-                handle_keyboard_text_entry('=', '+', "=", "+", "", "", active_modifiers);
-                break;
-            case WHY2025_KEY_APOSTROPHE:
-                send_scancode_event(BSP_INPUT_SCANCODE_APOSTROPHE, pressed);
-                handle_keyboard_text_entry('\'', '"', "'", "\"", "́", "̈", active_modifiers);
-                break;
-            case WHY2025_KEY_SEMICOLON:
-                send_scancode_event(BSP_INPUT_SCANCODE_SEMICOLON, pressed);
-                handle_keyboard_text_entry(';', ':', ";", ":", "̨", "̈", active_modifiers);
-                break;
-            case WHY2025_KEY_SLASH:
-                send_scancode_event(BSP_INPUT_SCANCODE_SLASH, pressed);
-                handle_keyboard_text_entry('/', '?', ";", "?", "̨", "̈", active_modifiers);
-                break;
-            case WHY2025_KEY_NUM_0:
-                send_scancode_event(BSP_INPUT_SCANCODE_KP0, pressed);
-                handle_keyboard_text_entry('0', ')', "0", ")", "’", "̊", active_modifiers);
-                break;
-            case WHY2025_KEY_RIGHT_SHIFT:
-                if (pressed) {
-                    active_modifiers |= BSP_INPUT_MODIFIER_SHIFT_R;
-                } else {
-                    active_modifiers &= ~(BSP_INPUT_MODIFIER_SHIFT_R);
-                }
-                break;
-            case WHY2025_KEY_UP:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_UP, pressed, active_modifiers);
-                break;
-            case WHY2025_KEY_BACKSPACE:
-                send_navigation_event(BSP_INPUT_NAVIGATION_KEY_BACKSPACE, pressed, active_modifiers);
-                break;
-            default:
-                ESP_LOGW(TAG, "Unmapped key pressed: %u", code);
-        }
+        bsp_keymap_handle_key(&keymap, code, pressed, timestamp);
     }
 }
 
@@ -524,24 +236,17 @@ esp_err_t why_keyboard_reset_and_init() {
 }
 
 esp_err_t bsp_input_initialize(void) {
-    if (event_queue == NULL) {
-        event_queue = xQueueCreate(32, sizeof(bsp_input_event_t));
-        ESP_RETURN_ON_FALSE(event_queue, ESP_ERR_NO_MEM, TAG, "Failed to create input event queue");
-    }
+    ESP_RETURN_ON_ERROR(bsp_input_queue_initialize(), TAG, "Failed to initialize input event queue");
+
+    size_t num_keys = sizeof(why2025_keymap) / sizeof(why2025_keymap[0]);
+    ESP_RETURN_ON_ERROR(bsp_keymap_initialize(&keymap, why2025_keymap, num_keys), TAG, "Failed to initialize keymap");
 
     bsp_i2c_primary_bus_get_handle(&i2c_handle);
     return why_keyboard_reset_and_init();
 }
 
 esp_err_t bsp_input_get_queue(QueueHandle_t* out_queue) {
-    if (out_queue == NULL) {
-        return ESP_ERR_INVALID_ARG;
-    }
-    if (event_queue == NULL) {
-        return ESP_FAIL;
-    }
-    *out_queue = event_queue;
-    return ESP_OK;
+    return bsp_input_queue_get_handle(out_queue);
 }
 
 bool bsp_input_needs_on_screen_keyboard(void) {
@@ -557,11 +262,19 @@ esp_err_t bsp_input_set_backlight_brightness(uint8_t percentage) {
 }
 
 esp_err_t bsp_input_read_navigation_key(bsp_input_navigation_key_t key, bool* out_state) {
-    return ESP_ERR_NOT_SUPPORTED;
+    if (out_state == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *out_state = bsp_keymap_read_navigation_key(&keymap, key);
+    return ESP_OK;
 }
 
 esp_err_t bsp_input_read_scancode(bsp_input_scancode_t key, bool* out_state) {
-    return ESP_ERR_NOT_SUPPORTED;
+    if (out_state == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *out_state = bsp_keymap_read_scancode(&keymap, key);
+    return ESP_OK;
 }
 
 esp_err_t bsp_input_read_action(bsp_input_action_type_t action, bool* out_state) {
@@ -1,41 +1,46 @@
 #pragma once
 
-static const st7703_lcd_init_cmd_t custom_init[] = {
-    {0xB9, (uint8_t[]){0xF1, 0x12, 0x83}, 3, 0},
-    {0xB1, (uint8_t[]){0x00, 0x00, 0x00, 0xDA, 0x80}, 5, 0},
-    {0xB2, (uint8_t[]){0x3C, 0x02, 0x30}, 3, 0},
-    {0xB3, (uint8_t[]){0x13, 0x10, 0x28, 0x28, 0x03, 0xFF, 0x00, 0x00, 0x00, 0x00}, 10, 0},
-    {0xB4, (uint8_t[]){0x80}, 1, 0},
-    {0xB5, (uint8_t[]){0x0A, 0x0A}, 2, 0},
-    {0xB6, (uint8_t[]){0x97, 0x97}, 2, 0},
-    {0xB8, (uint8_t[]){0x26, 0x22, 0xF0, 0x63}, 4, 0},
-    {0xBA, (uint8_t[]){0x31, 0x81, 0x05, 0xF9, 0x0E, 0x0E, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                       0x44, 0x25, 0x00, 0x90, 0x0A, 0x00, 0x00, 0x01, 0x4F, 0x01, 0x00, 0x00, 0x37},
-     27, 0},
-    {0xBC, (uint8_t[]){0x47}, 1, 0},
-    {0xBF, (uint8_t[]){0x02, 0x11, 0x00}, 3, 0},
-    {0xC0, (uint8_t[]){0x73, 0x73, 0x50, 0x50, 0x00, 0x00, 0x12, 0x70, 0x00}, 9, 0},
-    {0xC1, (uint8_t[]){0x43, 0x00, 0x32, 0x32, 0x77, 0xC1, 0xFF, 0xFF, 0xCC, 0xCC, 0x77, 0x77}, 12, 0}, // 0x43 might need to be set to 53
-    {0xC6, (uint8_t[]){0x82, 0x00, 0xBF, 0xFF, 0x00, 0xFF}, 6, 0},
-    {0xC7, (uint8_t[]){0xB8, 0x00, 0x0A, 0x00, 0x00, 0x00}, 6, 0},
-    {0xC8, (uint8_t[]){0x10, 0x40, 0x1E, 0x02}, 4, 0},
-    {0xCC, (uint8_t[]){0x0B}, 1, 0},
-    {0xE0,
-     (uint8_t[]){0x00, 0x0B, 0x10, 0x2C, 0x3D, 0x3F, 0x42, 0x3A, 0x07, 0x0D, 0x0F, 0x13, 0x15, 0x13, 0x14, 0x0F, 0x16,
-                 0x00, 0x0B, 0x10, 0x2C, 0x3D, 0x3F, 0x42, 0x3A, 0x07, 0x0D, 0x0F, 0x13, 0x15, 0x13, 0x14, 0x0F, 0x16},
-     34, 0},
-    {0xE3, (uint8_t[]){0x07, 0x07, 0x0B, 0x0B, 0x0B, 0x0B, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00, 0xC0, 0x10}, 14, 0},
-    {0xE9, (uint8_t[]){0xC8, 0x10, 0x0A, 0x00, 0x00, 0x80, 0x81, 0x12, 0x31, 0x23, 0x4F, 0x86, 0xA0, 0x00, 0x47, 0x08,
-                       0x00, 0x00, 0x0C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x00, 0x00, 0x00, 0x98, 0x02, 0x8B, 0xAF,
-                       0x46, 0x02, 0x88, 0x88, 0x88, 0x88, 0x88, 0x98, 0x13, 0x8B, 0xAF, 0x57, 0x13, 0x88, 0x88, 0x88,
-                       0x88, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-     63, 0},
-    {0xEA, (uint8_t[]){0x97, 0x0C, 0x09, 0x09, 0x09, 0x78, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x9F, 0x31, 0x8B, 0xA8,
-                       0x31, 0x75, 0x88, 0x88, 0x88, 0x88, 0x88, 0x9F, 0x20, 0x8B, 0xA8, 0x20, 0x64, 0x88, 0x88, 0x88,
-                       0x88, 0x88, 0x23, 0x00, 0x00, 0x02, 0x62, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                       0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x80, 0x81, 0x00, 0x00, 0x00, 0x00},
-     61, 0},
-    {0xEF, (uint8_t[]){0xFF, 0xFF, 0x01}, 3, 0},
-    {0x11, (uint8_t[]){}, 0, 250},
-    {0x29, (uint8_t[]){}, 0, 50},
+#include <stdint.h>
+#include "badge_bsp_lcd_init.h"
+
+static const uint8_t why2025_lcd_init_table[] = {
+    BSP_LCD_INIT_CMD(0xB9, 0xF1, 0x12, 0x83),
+    BSP_LCD_INIT_CMD(0xB1, 0x00, 0x00, 0x00, 0xDA, 0x80),
+    BSP_LCD_INIT_CMD(0xB2, 0x3C, 0x02, 0x30),
+    BSP_LCD_INIT_CMD(0xB3, 0x13, 0x10, 0x28, 0x28, 0x03, 0xFF, 0x00, 0x00, 0x00, 0x00),
+    BSP_LCD_INIT_CMD(0xB4, 0x80),
+    BSP_LCD_INIT_CMD(0xB5, 0x0A, 0x0A),
+    BSP_LCD_INIT_CMD(0xB6, 0x97, 0x97),
+    BSP_LCD_INIT_CMD(0xB8, 0x26, 0x22, 0xF0, 0x63),
+    BSP_LCD_INIT_CMD(0xBA, 0x31, 0x81, 0x05, 0xF9, 0x0E, 0x0E, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x44,
+                           0x25, 0x00, 0x90, 0x0A, 0x00, 0x00, 0x01, 0x4F, 0x01, 0x00, 0x00, 0x37),
+    BSP_LCD_INIT_CMD(0xBC, 0x47),
+    BSP_LCD_INIT_CMD(0xBF, 0x02, 0x11, 0x00),
+    BSP_LCD_INIT_CMD(0xC0, 0x73, 0x73, 0x50, 0x50, 0x00, 0x00, 0x12, 0x70, 0x00),
+    // 0x43 might need to be set to 53
+    BSP_LCD_INIT_CMD(0xC1, 0x43, 0x00, 0x32, 0x32, 0x77, 0xC1, 0xFF, 0xFF, 0xCC, 0xCC, 0x77, 0x77),
+    BSP_LCD_INIT_CMD(0xC6, 0x82, 0x00, 0xBF, 0xFF, 0x00, 0xFF),
+    BSP_LCD_INIT_CMD(0xC7, 0xB8, 0x00, 0x0A, 0x00, 0x00, 0x00),
+    BSP_LCD_INIT_CMD(0xC8, 0x10, 0x40, 0x1E, 0x02),
+    BSP_LCD_INIT_CMD(0xCC, 0x0B),
+    BSP_LCD_INIT_CMD(0xE0, 0x00, 0x0B, 0x10, 0x2C, 0x3D, 0x3F, 0x42, 0x3A, 0x07, 0x0D, 0x0F, 0x13, 0x15, 0x13, 0x14,
+                           0x0F, 0x16, 0x00, 0x0B, 0x10, 0x2C, 0x3D, 0x3F, 0x42, 0x3A, 0x07, 0x0D, 0x0F, 0x13, 0x15,
+                           0x13, 0x14, 0x0F, 0x16),
+    BSP_LCD_INIT_CMD(0xE3, 0x07, 0x07, 0x0B, 0x0B, 0x0B, 0x0B, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00, 0xC0, 0x10),
+    BSP_LCD_INIT_CMD(0xE9, 0xC8, 0x10, 0x0A, 0x00, 0x00, 0x80, 0x81, 0x12, 0x31, 0x23, 0x4F, 0x86, 0xA0, 0x00, 0x47,
+                           0x08, 0x00, 0x00, 0x0C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x00, 0x00, 0x00, 0x98, 0x02,
+                           0x8B, 0xAF, 0x46, 0x02, 0x88, 0x88, 0x88, 0x88, 0x88, 0x98, 0x13, 0x8B, 0xAF, 0x57, 0x13,
+                           0x88, 0x88, 0x88, 0x88, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                           0x00, 0x00, 0x00),
+    BSP_LCD_INIT_CMD(0xEA, 0x97, 0x0C, 0x09, 0x09, 0x09, 0x78, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x9F, 0x31, 0x8B,
+                           0xA8, 0x31, 0x75, 0x88, 0x88, 0x88, 0x88, 0x88, 0x9F, 0x20, 0x8B, 0xA8, 0x20, 0x64, 0x88,
+                           0x88, 0x88, 0x88, 0x88, 0x23, 0x00, 0x00, 0x02, 0x62, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                           0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x80, 0x81, 0x00, 0x00, 0x00,
+                           0x00),
+    BSP_LCD_INIT_CMD(0xEF, 0xFF, 0xFF, 0x01),
+    BSP_LCD_INIT_CMD0(0x11),
+    BSP_LCD_INIT_DELAY(250),
+    BSP_LCD_INIT_CMD0(0x29),
+    BSP_LCD_INIT_DELAY(50),
+    BSP_LCD_INIT_END(),
 };
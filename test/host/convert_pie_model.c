@@ -0,0 +1,109 @@
+// Host tests: model of the ESP32-P4 PIE conversion kernels, following their vector instructions lane by lane so the
+// target specific dispatch in badge_bsp_display_convert.c can be tested against the reference loops
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "badge_bsp_display_convert_pie.h"
+#include "test_support.h"
+
+#define LANES 4
+
+typedef struct {
+    uint32_t lane[LANES];
+} vector_t;
+
+// esp.vld.128.ip and esp.vst.128.ip ignore the low four address bits, the kernels must only be given aligned buffers
+static vector_t vld(const void* src) {
+    CHECK(((uintptr_t)src & 15) == 0);
+    vector_t v;
+    memcpy(&v, src, sizeof(v));
+    return v;
+}
+
+static void vst(void* dst, vector_t v) {
+    CHECK(((uintptr_t)dst & 15) == 0);
+    memcpy(dst, &v, sizeof(v));
+}
+
+static vector_t vldbc32(uint32_t value) {
+    vector_t v;
+    for (size_t i = 0; i < LANES; i++) {
+        v.lane[i] = value;
+    }
+    return v;
+}
+
+static vector_t vldbc16(uint16_t value) {
+    return vldbc32(value | ((uint32_t)value << 16));
+}
+
+static vector_t andq(vector_t a, vector_t b) {
+    for (size_t i = 0; i < LANES; i++) {
+        a.lane[i] &= b.lane[i];
+    }
+    return a;
+}
+
+static vector_t orq(vector_t a, vector_t b) {
+    for (size_t i = 0; i < LANES; i++) {
+        a.lane[i] |= b.lane[i];
+    }
+    return a;
+}
+
+static vector_t vsl32(vector_t a, unsigned sar) {
+    for (size_t i = 0; i < LANES; i++) {
+        a.lane[i] <<= sar;
+    }
+    return a;
+}
+
+static vector_t vsr_u32(vector_t a, unsigned sar) {
+    for (size_t i = 0; i < LANES; i++) {
+        a.lane[i] >>= sar;
+    }
+    return a;
+}
+
+// esp.vmul.u16 with SAR 0 keeps the low 16 bits of every product, esp.vadd.u16 saturates every sum
+static vector_t vmul_u16(vector_t a, vector_t b) {
+    for (size_t i = 0; i < LANES; i++) {
+        uint32_t low  = ((a.lane[i] & 0xFFFF) * (b.lane[i] & 0xFFFF)) & 0xFFFF;
+        uint32_t high = ((a.lane[i] >> 16) * (b.lane[i] >> 16)) & 0xFFFF;
+        a.lane[i]     = low | (high << 16);
+    }
+    return a;
+}
+
+static vector_t vadd_u16(vector_t a, vector_t b) {
+    for (size_t i = 0; i < LANES; i++) {
+        uint32_t low  = (a.lane[i] & 0xFFFF) + (b.lane[i] & 0xFFFF);
+        uint32_t high = (a.lane[i] >> 16) + (b.lane[i] >> 16);
+        a.lane[i]     = (low > 0xFFFF ? 0xFFFF : low) | ((high > 0xFFFF ? 0xFFFF : high) << 16);
+    }
+    return a;
+}
+
+void bsp_display_convert_pie_rgb565_swap(uint8_t* dst, const uint8_t* src, size_t vectors) {
+    vector_t mask = vldbc32(0x00FF00FFu);
+    for (; vectors > 0; vectors--, src += 16, dst += 16) {
+        vector_t value = vld(src);
+        vector_t low   = vsl32(andq(value, mask), 8);
+        vst(dst, orq(andq(vsr_u32(value, 8), mask), low));
+    }
+}
+
+void bsp_display_convert_pie_rgb565_luma(uint16_t* dst, const uint8_t* src, size_t vectors) {
+    vector_t red_blue = vldbc32(0x00F800F8u);
+    vector_t green    = vldbc32(0x00FC00FCu);
+    for (; vectors > 0; vectors--, src += 16, dst += 8) {
+        vector_t value = vld(src);
+        vector_t sum   = vmul_u16(andq(vsr_u32(value, 8), red_blue), vldbc16(77));
+        sum            = vadd_u16(sum, vmul_u16(andq(vsr_u32(value, 3), green), vldbc16(150)));
+        sum            = vadd_u16(sum, vmul_u16(andq(vsl32(value, 3), red_blue), vldbc16(29)));
+        vst(dst, andq(vsr_u32(sum, 8), vldbc32(0x00FF00FFu)));
+    }
+}
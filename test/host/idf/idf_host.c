@@ -0,0 +1,672 @@
+// Host test stand-in: FreeRTOS, esp_timer and heap implementation on top of pthreads
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "host_idf.h"
+
+// ============================================
+// C library
+// ============================================
+
+#if defined(__GLIBC__) && !__GLIBC_PREREQ(2, 38)
+size_t strlcpy(char* dst, char const* src, size_t size) {
+    size_t length = strlen(src);
+    if (size > 0) {
+        size_t copy = length < size - 1 ? length : size - 1;
+        memcpy(dst, src, copy);
+        dst[copy] = '\0';
+    }
+    return length;
+}
+#endif
+
+// ============================================
+// Logging and errors
+// ============================================
+
+void host_log(char level, char const* tag, char const* format, ...) {
+    if (level != 'E' && level != 'W' && getenv("HOST_LOG_VERBOSE") == NULL) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    fprintf(stderr, "%c (%s) ", level, tag);
+    vfprintf(stderr, format, args);
+    fputc('\n', stderr);
+    va_end(args);
+}
+
+char const* esp_err_to_name(esp_err_t code) {
+    switch (code) {
+        case ESP_OK:
+            return "ESP_OK";
+        case ESP_FAIL:
+            return "ESP_FAIL";
+        case ESP_ERR_NO_MEM:
+            return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG:
+            return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE:
+            return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE:
+            return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND:
+            return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED:
+            return "ESP_ERR_NOT_SUPPORTED";
+        case ESP_ERR_TIMEOUT:
+            return "ESP_ERR_TIMEOUT";
+        default:
+            return "UNKNOWN ERROR";
+    }
+}
+
+// ============================================
+// Heap
+// ============================================
+
+void* heap_caps_malloc(size_t size, uint32_t caps) {
+    (void)caps;
+    return malloc(size);
+}
+
+void* heap_caps_calloc(size_t n, size_t size, uint32_t caps) {
+    (void)caps;
+    return calloc(n, size);
+}
+
+void* heap_caps_aligned_alloc(size_t alignment, size_t size, uint32_t caps) {
+    (void)caps;
+    void* ptr = NULL;
+    if (alignment < sizeof(void*)) {
+        alignment = sizeof(void*);
+    }
+    return posix_memalign(&ptr, alignment, size) == 0 ? ptr : NULL;
+}
+
+void heap_caps_free(void* ptr) {
+    free(ptr);
+}
+
+// ============================================
+// Critical sections and interrupt context
+// ============================================
+
+static pthread_mutex_t critical_lock = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+static _Thread_local bool in_isr     = false;
+
+void host_critical_enter(void) {
+    pthread_mutex_lock(&critical_lock);
+}
+
+void host_critical_exit(void) {
+    pthread_mutex_unlock(&critical_lock);
+}
+
+void host_isr_enter(void) {
+    in_isr = true;
+}
+
+void host_isr_exit(void) {
+    in_isr = false;
+}
+
+BaseType_t xPortInIsrContext(void) {
+    return in_isr ? pdTRUE : pdFALSE;
+}
+
+// ============================================
+// Clock
+// ============================================
+
+static bool    clock_simulated = false;
+static int64_t clock_now       = 0;  // Simulated time in microseconds
+static int64_t clock_origin    = 0;  // Monotonic time at the first reading of the real clock
+
+static int64_t monotonic_us(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+int64_t esp_timer_get_time(void) {
+    if (clock_simulated) {
+        return __atomic_load_n(&clock_now, __ATOMIC_SEQ_CST);
+    }
+    if (clock_origin == 0) {
+        clock_origin = monotonic_us();
+    }
+    // Like on the device the clock starts close to zero but never reads zero, zero means "no timestamp" in the BSP
+    return monotonic_us() - clock_origin + 1;
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return (TickType_t)(esp_timer_get_time() / 1000);
+}
+
+// Deadline for pthread_cond_timedwait, ticks are milliseconds of real time
+static struct timespec deadline_after(TickType_t ticks) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    int64_t nsec      = deadline.tv_nsec + (int64_t)ticks * 1000000;
+    deadline.tv_sec  += nsec / 1000000000;
+    deadline.tv_nsec  = nsec % 1000000000;
+    return deadline;
+}
+
+// Wait on a condition, returns false on timeout
+static bool cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex, TickType_t timeout,
+                      struct timespec const* deadline) {
+    if (timeout == portMAX_DELAY) {
+        pthread_cond_wait(cond, mutex);
+        return true;
+    }
+    return pthread_cond_timedwait(cond, mutex, deadline) != ETIMEDOUT;
+}
+
+// ============================================
+// esp_timer
+// ============================================
+
+struct esp_timer {
+    esp_timer_cb_t    callback;
+    void*             arg;
+    int64_t           deadline;
+    uint64_t          period;
+    bool              active;
+    struct esp_timer* next;
+};
+
+static pthread_mutex_t   timer_lock    = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t    timer_changed = PTHREAD_COND_INITIALIZER;
+static struct esp_timer* timer_list    = NULL;
+static pthread_t         timer_thread;
+static bool              timer_thread_started = false;
+
+// Earliest active timer due at or before limit, called with the timer lock held
+static struct esp_timer* timer_next_due(int64_t limit) {
+    struct esp_timer* due = NULL;
+    for (struct esp_timer* timer = timer_list; timer != NULL; timer = timer->next) {
+        if (timer->active && timer->deadline <= limit && (due == NULL || timer->deadline < due->deadline)) {
+            due = timer;
+        }
+    }
+    return due;
+}
+
+// Take a due timer off the active list or re-arm it when periodic, called with the timer lock held
+static void timer_expire(struct esp_timer* timer) {
+    if (timer->period > 0) {
+        timer->deadline += timer->period;
+    } else {
+        timer->active = false;
+    }
+}
+
+// The esp_timer task of the real clock
+static void* timer_task(void* arg) {
+    (void)arg;
+    pthread_mutex_lock(&timer_lock);
+    while (true) {
+        if (clock_simulated) {
+            pthread_cond_wait(&timer_changed, &timer_lock);
+            continue;
+        }
+        struct esp_timer* due = timer_next_due(INT64_MAX);
+        if (due == NULL) {
+            pthread_cond_wait(&timer_changed, &timer_lock);
+            continue;
+        }
+        int64_t wait = due->deadline - esp_timer_get_time();
+        if (wait > 0) {
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            int64_t nsec      = deadline.tv_nsec + wait * 1000;
+            deadline.tv_sec  += nsec / 1000000000;
+            deadline.tv_nsec  = nsec % 1000000000;
+            pthread_cond_timedwait(&timer_changed, &timer_lock, &deadline);
+            continue;
+        }
+        esp_timer_cb_t callback = due->callback;
+        void*          cb_arg   = due->arg;
+        timer_expire(due);
+        pthread_mutex_unlock(&timer_lock);
+        callback(cb_arg);
+        pthread_mutex_lock(&timer_lock);
+    }
+    return NULL;
+}
+
+void host_clock_set_simulated(int64_t start_us) {
+    pthread_mutex_lock(&timer_lock);
+    clock_simulated = true;
+    __atomic_store_n(&clock_now, start_us, __ATOMIC_SEQ_CST);
+    pthread_cond_broadcast(&timer_changed);
+    pthread_mutex_unlock(&timer_lock);
+}
+
+void host_clock_advance(int64_t us) {
+    int64_t end = esp_timer_get_time() + us;
+    pthread_mutex_lock(&timer_lock);
+    struct esp_timer* due;
+    while ((due = timer_next_due(end)) != NULL) {
+        __atomic_store_n(&clock_now, due->deadline, __ATOMIC_SEQ_CST);
+        esp_timer_cb_t callback = due->callback;
+        void*          cb_arg   = due->arg;
+        timer_expire(due);
+        pthread_mutex_unlock(&timer_lock);
+        callback(cb_arg);
+        pthread_mutex_lock(&timer_lock);
+    }
+    __atomic_store_n(&clock_now, end, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&timer_lock);
+}
+
+// Advance the simulated clock to the next timer due at or before limit and run it, or to limit if none is due
+static void clock_advance_step(int64_t limit) {
+    pthread_mutex_lock(&timer_lock);
+    struct esp_timer* due  = timer_next_due(limit);
+    int64_t           next = due != NULL ? due->deadline : limit;
+    pthread_mutex_unlock(&timer_lock);
+    int64_t now = esp_timer_get_time();
+    host_clock_advance(next > now ? next - now : 0);
+}
+
+esp_err_t esp_timer_create(esp_timer_create_args_t const* create_args, esp_timer_handle_t* out_handle) {
+    if (create_args == NULL || create_args->callback == NULL || out_handle == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct esp_timer* timer = calloc(1, sizeof(struct esp_timer));
+    if (timer == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    timer->callback = create_args->callback;
+    timer->arg      = create_args->arg;
+
+    pthread_mutex_lock(&timer_lock);
+    timer->next = timer_list;
+    timer_list  = timer;
+    if (!timer_thread_started) {
+        pthread_create(&timer_thread, NULL, timer_task, NULL);
+        pthread_detach(timer_thread);
+        timer_thread_started = true;
+    }
+    pthread_mutex_unlock(&timer_lock);
+    *out_handle = timer;
+    return ESP_OK;
+}
+
+static esp_err_t timer_start(esp_timer_handle_t timer, uint64_t timeout_us, uint64_t period) {
+    pthread_mutex_lock(&timer_lock);
+    if (timer->active) {
+        pthread_mutex_unlock(&timer_lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->deadline = esp_timer_get_time() + (int64_t)timeout_us;
+    timer->period   = period;
+    timer->active   = true;
+    pthread_cond_broadcast(&timer_changed);
+    pthread_mutex_unlock(&timer_lock);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us) {
+    return timer_start(timer, timeout_us, 0);
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period) {
+    return timer_start(timer, period, period);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    pthread_mutex_lock(&timer_lock);
+    esp_err_t res = timer->active ? ESP_OK : ESP_ERR_INVALID_STATE;
+    timer->active = false;
+    pthread_cond_broadcast(&timer_changed);
+    pthread_mutex_unlock(&timer_lock);
+    return res;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+    pthread_mutex_lock(&timer_lock);
+    for (struct esp_timer** link = &timer_list; *link != NULL; link = &(*link)->next) {
+        if (*link == timer) {
+            *link = timer->next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&timer_lock);
+    free(timer);
+    return ESP_OK;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer) {
+    pthread_mutex_lock(&timer_lock);
+    bool active = timer->active;
+    pthread_mutex_unlock(&timer_lock);
+    return active;
+}
+
+// ============================================
+// Tasks and task notifications
+// ============================================
+
+struct host_task {
+    pthread_t       thread;
+    TaskFunction_t  function;
+    void*           parameters;
+    pthread_mutex_t lock;
+    pthread_cond_t  notified;
+    uint32_t        notification;
+};
+
+static _Thread_local struct host_task* current_task = NULL;
+
+static struct host_task* task_new(void) {
+    struct host_task* task = calloc(1, sizeof(struct host_task));
+    pthread_mutex_init(&task->lock, NULL);
+    pthread_cond_init(&task->notified, NULL);
+    return task;
+}
+
+static void* task_entry(void* arg) {
+    current_task = arg;
+    current_task->function(current_task->parameters);
+    return NULL;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t function, char const* name, uint32_t stack_depth, void* parameters,
+                       UBaseType_t priority, TaskHandle_t* out_handle) {
+    (void)name;
+    (void)stack_depth;
+    (void)priority;
+    struct host_task* task = task_new();
+    task->function         = function;
+    task->parameters       = parameters;
+    if (out_handle != NULL) {
+        *out_handle = task;
+    }
+    if (pthread_create(&task->thread, NULL, task_entry, task) != 0) {
+        return pdFAIL;
+    }
+    pthread_detach(task->thread);
+    return pdPASS;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, char const* name, uint32_t stack_depth, void* parameters,
+                                   UBaseType_t priority, TaskHandle_t* out_handle, BaseType_t core) {
+    (void)core;
+    return xTaskCreate(function, name, stack_depth, parameters, priority, out_handle);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if (task == NULL || task == current_task) {
+        pthread_exit(NULL);
+    }
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    if (current_task == NULL) {
+        current_task = task_new();  // A thread not created through xTaskCreate, such as the test's main thread
+    }
+    return current_task;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    if (clock_simulated) {
+        host_clock_advance((int64_t)ticks * 1000);
+        return;
+    }
+    struct timespec delay = {.tv_sec = ticks / 1000, .tv_nsec = (long)(ticks % 1000) * 1000000};
+    nanosleep(&delay, NULL);
+}
+
+void vTaskDelayUntil(TickType_t* previous_wake_time, TickType_t increment) {
+    *previous_wake_time += increment;
+    TickType_t now       = xTaskGetTickCount();
+    if ((int32_t)(*previous_wake_time - now) > 0) {
+        vTaskDelay(*previous_wake_time - now);
+    }
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t timeout) {
+    struct host_task* task     = xTaskGetCurrentTaskHandle();
+    struct timespec   deadline = deadline_after(timeout);
+    pthread_mutex_lock(&task->lock);
+    while (task->notification == 0 && timeout != 0) {
+        if (!cond_wait(&task->notified, &task->lock, timeout, &deadline)) {
+            break;
+        }
+    }
+    uint32_t value = task->notification;
+    if (value > 0) {
+        task->notification = clear_on_exit ? 0 : value - 1;
+    }
+    pthread_mutex_unlock(&task->lock);
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    pthread_mutex_lock(&task->lock);
+    task->notification++;
+    pthread_cond_signal(&task->notified);
+    pthread_mutex_unlock(&task->lock);
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higher_priority_task_woken) {
+    xTaskNotifyGive(task);
+    if (higher_priority_task_woken != NULL) {
+        *higher_priority_task_woken = pdTRUE;
+    }
+}
+
+// ============================================
+// Semaphores
+// ============================================
+
+struct host_semaphore {
+    pthread_mutex_t lock;
+    pthread_cond_t  available;
+    UBaseType_t     count;
+    UBaseType_t     max_count;
+};
+
+static SemaphoreHandle_t semaphore_new(UBaseType_t max_count, UBaseType_t initial_count) {
+    struct host_semaphore* semaphore = calloc(1, sizeof(struct host_semaphore));
+    if (semaphore == NULL) {
+        return NULL;
+    }
+    pthread_mutex_init(&semaphore->lock, NULL);
+    pthread_cond_init(&semaphore->available, NULL);
+    semaphore->count     = initial_count;
+    semaphore->max_count = max_count;
+    return semaphore;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+    return semaphore_new(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+    return semaphore_new(1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count, UBaseType_t initial_count) {
+    return semaphore_new(max_count, initial_count);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) {
+    if (semaphore != NULL) {
+        pthread_cond_destroy(&semaphore->available);
+        pthread_mutex_destroy(&semaphore->lock);
+        free(semaphore);
+    }
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t timeout) {
+    if (clock_simulated && timeout != 0 && timeout != portMAX_DELAY) {
+        // Let the simulated time pass until a timer gives the semaphore or the timeout expires
+        int64_t end = esp_timer_get_time() + (int64_t)timeout * 1000;
+        while (uxSemaphoreGetCount(semaphore) == 0 && esp_timer_get_time() < end) {
+            clock_advance_step(end);
+        }
+        return xSemaphoreTake(semaphore, 0);
+    }
+
+    struct timespec deadline = deadline_after(timeout);
+    BaseType_t      taken    = pdFALSE;
+    pthread_mutex_lock(&semaphore->lock);
+    while (semaphore->count == 0 && timeout != 0) {
+        if (!cond_wait(&semaphore->available, &semaphore->lock, timeout, &deadline)) {
+            break;
+        }
+    }
+    if (semaphore->count > 0) {
+        semaphore->count--;
+        taken = pdTRUE;
+    }
+    pthread_mutex_unlock(&semaphore->lock);
+    return taken;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+    BaseType_t given = pdFALSE;
+    pthread_mutex_lock(&semaphore->lock);
+    if (semaphore->count < semaphore->max_count) {
+        semaphore->count++;
+        given = pdTRUE;
+        pthread_cond_signal(&semaphore->available);
+    }
+    pthread_mutex_unlock(&semaphore->lock);
+    return given;
+}
+
+BaseType_t xSemaphoreTakeFromISR(SemaphoreHandle_t semaphore, BaseType_t* higher_priority_task_woken) {
+    (void)higher_priority_task_woken;
+    return xSemaphoreTake(semaphore, 0);
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore, BaseType_t* higher_priority_task_woken) {
+    BaseType_t given = xSemaphoreGive(semaphore);
+    if (given && higher_priority_task_woken != NULL) {
+        *higher_priority_task_woken = pdTRUE;
+    }
+    return given;
+}
+
+UBaseType_t uxSemaphoreGetCount(SemaphoreHandle_t semaphore) {
+    pthread_mutex_lock(&semaphore->lock);
+    UBaseType_t count = semaphore->count;
+    pthread_mutex_unlock(&semaphore->lock);
+    return count;
+}
+
+// ============================================
+// Queues
+// ============================================
+
+struct host_queue {
+    pthread_mutex_t lock;
+    pthread_cond_t  changed;
+    size_t          item_size;
+    size_t          length;
+    size_t          head;
+    size_t          count;
+    uint8_t*        items;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+    struct host_queue* queue = calloc(1, sizeof(struct host_queue));
+    if (queue == NULL) {
+        return NULL;
+    }
+    queue->items = calloc(length, item_size);
+    if (queue->items == NULL) {
+        free(queue);
+        return NULL;
+    }
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->changed, NULL);
+    queue->item_size = item_size;
+    queue->length    = length;
+    return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+    if (queue != NULL) {
+        pthread_cond_destroy(&queue->changed);
+        pthread_mutex_destroy(&queue->lock);
+        free(queue->items);
+        free(queue);
+    }
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, void const* item, TickType_t timeout) {
+    struct timespec deadline = deadline_after(timeout);
+    BaseType_t      sent     = pdFALSE;
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == queue->length && timeout != 0) {
+        if (!cond_wait(&queue->changed, &queue->lock, timeout, &deadline)) {
+            break;
+        }
+    }
+    if (queue->count < queue->length) {
+        size_t slot = (queue->head + queue->count) % queue->length;
+        memcpy(queue->items + slot * queue->item_size, item, queue->item_size);
+        queue->count++;
+        sent = pdTRUE;
+        pthread_cond_broadcast(&queue->changed);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return sent;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, void const* item, BaseType_t* higher_priority_task_woken) {
+    (void)higher_priority_task_woken;
+    return xQueueSend(queue, item, 0);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t timeout) {
+    struct timespec deadline = deadline_after(timeout);
+    BaseType_t      received = pdFALSE;
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == 0 && timeout != 0) {
+        if (!cond_wait(&queue->changed, &queue->lock, timeout, &deadline)) {
+            break;
+        }
+    }
+    if (queue->count > 0) {
+        memcpy(item, queue->items + queue->head * queue->item_size, queue->item_size);
+        queue->head = (queue->head + 1) % queue->length;
+        queue->count--;
+        received = pdTRUE;
+        pthread_cond_broadcast(&queue->changed);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return received;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    pthread_mutex_lock(&queue->lock);
+    UBaseType_t count = queue->count;
+    pthread_mutex_unlock(&queue->lock);
+    return count;
+}
@@ -0,0 +1,39 @@
+// Host test stand-in: ESP-IDF SPI master driver, tests provide the implementation they need
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+#define SPI_TRANS_USE_RXDATA (1 << 2)
+#define SPI_TRANS_USE_TXDATA (1 << 3)
+
+typedef struct spi_device_t* spi_device_handle_t;
+
+typedef struct {
+    uint32_t flags;
+    uint16_t cmd;
+    uint64_t addr;
+    size_t   length;    // Total data length in bits
+    size_t   rxlength;  // Received data length in bits
+    void*    user;
+    union {
+        const void* tx_buffer;
+        uint8_t     tx_data[4];
+    };
+    union {
+        void*   rx_buffer;
+        uint8_t rx_data[4];
+    };
+} spi_transaction_t;
+
+esp_err_t spi_device_acquire_bus(spi_device_handle_t device, TickType_t wait);
+void      spi_device_release_bus(spi_device_handle_t device);
+esp_err_t spi_device_queue_trans(spi_device_handle_t device, spi_transaction_t* transaction, TickType_t timeout);
+esp_err_t spi_device_get_trans_result(spi_device_handle_t device, spi_transaction_t** out_transaction,
+                                      TickType_t timeout);
+esp_err_t spi_device_polling_transmit(spi_device_handle_t device, spi_transaction_t* transaction);
@@ -0,0 +1,56 @@
+// Host test stand-in: ESP-IDF error checking macros
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "esp_err.h"
+#include "esp_log.h"
+
+#define ESP_RETURN_ON_ERROR(x, log_tag, format, ...)      \
+    do {                                                  \
+        esp_err_t err_rc_ = (x);                          \
+        if (unlikely(err_rc_ != ESP_OK)) {                \
+            ESP_LOGE(log_tag, format, ##__VA_ARGS__);     \
+            return err_rc_;                               \
+        }                                                 \
+    } while (0)
+
+#define ESP_RETURN_ON_FALSE(a, err_code, log_tag, format, ...) \
+    do {                                                       \
+        if (unlikely(!(a))) {                                  \
+            ESP_LOGE(log_tag, format, ##__VA_ARGS__);          \
+            return err_code;                                   \
+        }                                                      \
+    } while (0)
+
+#define ESP_GOTO_ON_ERROR(x, goto_tag, log_tag, format, ...) \
+    do {                                                     \
+        esp_err_t err_rc_ = (x);                             \
+        if (unlikely(err_rc_ != ESP_OK)) {                   \
+            ESP_LOGE(log_tag, format, ##__VA_ARGS__);        \
+            ret = err_rc_;                                   \
+            goto goto_tag;                                   \
+        }                                                    \
+    } while (0)
+
+#define ESP_GOTO_ON_FALSE(a, err_code, goto_tag, log_tag, format, ...) \
+    do {                                                               \
+        if (unlikely(!(a))) {                                          \
+            ESP_LOGE(log_tag, format, ##__VA_ARGS__);                  \
+            ret = err_code;                                            \
+            goto goto_tag;                                             \
+        }                                                              \
+    } while (0)
+
+#define ESP_ERROR_CHECK(x)                                                            \
+    do {                                                                              \
+        esp_err_t err_rc_ = (x);                                                      \
+        if (err_rc_ != ESP_OK) {                                                      \
+            fprintf(stderr, "%s:%d: %s failed: %s\n", __FILE__, __LINE__, #x,         \
+                    esp_err_to_name(err_rc_));                                        \
+            abort();                                                                  \
+        }                                                                             \
+    } while (0)
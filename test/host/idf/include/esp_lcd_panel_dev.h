@@ -0,0 +1,15 @@
+// Host test stand-in: ESP-IDF LCD panel device configuration
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdint.h>
+
+typedef struct {
+    int      reset_gpio_num;
+    int      rgb_ele_order;
+    int      data_endian;
+    uint32_t bits_per_pixel;
+    void*    vendor_config;
+} esp_lcd_panel_dev_config_t;
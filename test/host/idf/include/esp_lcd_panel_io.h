@@ -0,0 +1,24 @@
+// Host test stand-in: ESP-IDF LCD panel IO, tests provide the implementation they need
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "driver/i2c_master.h"
+#include "esp_err.h"
+#include "esp_lcd_types.h"
+
+typedef struct {
+    uint32_t dev_addr;
+    uint32_t scl_speed_hz;
+    size_t   control_phase_bytes;
+    int      lcd_cmd_bits;
+    int      lcd_param_bits;
+    unsigned dc_bit_offset;
+} esp_lcd_panel_io_i2c_config_t;
+
+esp_err_t esp_lcd_new_panel_io_i2c(i2c_master_bus_handle_t bus, esp_lcd_panel_io_i2c_config_t const* io_config,
+                                   esp_lcd_panel_io_handle_t* ret_io);
+esp_err_t esp_lcd_panel_io_tx_param(esp_lcd_panel_io_handle_t io, int lcd_cmd, void const* param, size_t param_size);
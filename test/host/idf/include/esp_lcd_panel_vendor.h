@@ -0,0 +1,17 @@
+// Host test stand-in: ESP-IDF LCD panel drivers, tests provide the implementation they need
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_lcd_panel_dev.h"
+#include "esp_lcd_types.h"
+
+typedef struct {
+    uint8_t height;
+} esp_lcd_panel_ssd1306_config_t;
+
+esp_err_t esp_lcd_new_panel_ssd1306(esp_lcd_panel_io_handle_t io, esp_lcd_panel_dev_config_t const* panel_dev_config,
+                                    esp_lcd_panel_handle_t* ret_panel);
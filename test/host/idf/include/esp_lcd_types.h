@@ -0,0 +1,8 @@
+// Host test stand-in: ESP-IDF LCD handle types
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+typedef struct esp_lcd_panel_t*    esp_lcd_panel_handle_t;
+typedef struct esp_lcd_panel_io_t* esp_lcd_panel_io_handle_t;
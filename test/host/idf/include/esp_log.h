@@ -0,0 +1,15 @@
+// Host test stand-in: ESP-IDF logging, errors and warnings go to stderr
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+void host_log(char level, char const* tag, char const* format, ...) __attribute__((format(printf, 3, 4)));
+
+#define ESP_LOGE(tag, format, ...)      host_log('E', tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...)      host_log('W', tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...)      host_log('I', tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...)      host_log('D', tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...)      host_log('V', tag, format, ##__VA_ARGS__)
+#define ESP_DRAM_LOGI(tag, format, ...) host_log('I', tag, format, ##__VA_ARGS__)
+#define ESP_DRAM_LOGE(tag, format, ...) host_log('E', tag, format, ##__VA_ARGS__)
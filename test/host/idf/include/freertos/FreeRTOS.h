@@ -0,0 +1,55 @@
+// Host test stand-in: FreeRTOS kernel types, critical sections and ticks (1 tick is 1 ms)
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_attr.h"
+
+typedef uint32_t TickType_t;
+typedef int      BaseType_t;
+typedef unsigned UBaseType_t;
+
+typedef struct host_semaphore* SemaphoreHandle_t;
+typedef struct host_queue*     QueueHandle_t;
+typedef struct host_task*      TaskHandle_t;
+typedef void (*TaskFunction_t)(void* parameters);
+
+#define pdTRUE             1
+#define pdFALSE            0
+#define pdPASS             1
+#define pdFAIL             0
+#define portMAX_DELAY      ((TickType_t)0xFFFFFFFFUL)
+#define configTICK_RATE_HZ 1000
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms)  ((TickType_t)(ms))
+#define pdTICKS_TO_MS(t)   ((uint32_t)(t))
+
+#define configMAX_PRIORITIES 25
+#define tskIDLE_PRIORITY     0
+
+// All critical sections share one recursive lock
+typedef struct {
+    int unused;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {0}
+
+void host_critical_enter(void);
+void host_critical_exit(void);
+
+#define portENTER_CRITICAL(mux)      ((void)(mux), host_critical_enter())
+#define portEXIT_CRITICAL(mux)       ((void)(mux), host_critical_exit())
+#define portENTER_CRITICAL_ISR(mux)  ((void)(mux), host_critical_enter())
+#define portEXIT_CRITICAL_ISR(mux)   ((void)(mux), host_critical_exit())
+#define portENTER_CRITICAL_SAFE(mux) ((void)(mux), host_critical_enter())
+#define portEXIT_CRITICAL_SAFE(mux)  ((void)(mux), host_critical_exit())
+#define portYIELD_FROM_ISR(...)      ((void)0)
+#define configASSERT(x)              ((void)(x))
+
+BaseType_t xPortInIsrContext(void);
+TickType_t xTaskGetTickCount(void);
+void       vTaskDelay(TickType_t ticks);
@@ -0,0 +1,7 @@
+// Host test stand-in: FreeRTOS definitions, declared by freertos/FreeRTOS.h
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "freertos/FreeRTOS.h"
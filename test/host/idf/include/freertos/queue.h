@@ -0,0 +1,14 @@
+// Host test stand-in: FreeRTOS queues
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size);
+void          vQueueDelete(QueueHandle_t queue);
+BaseType_t    xQueueSend(QueueHandle_t queue, void const* item, TickType_t timeout);
+BaseType_t    xQueueSendFromISR(QueueHandle_t queue, void const* item, BaseType_t* higher_priority_task_woken);
+BaseType_t    xQueueReceive(QueueHandle_t queue, void* item, TickType_t timeout);
+UBaseType_t   uxQueueMessagesWaiting(QueueHandle_t queue);
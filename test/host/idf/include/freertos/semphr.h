@@ -0,0 +1,17 @@
+// Host test stand-in: FreeRTOS semaphores and mutexes
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count, UBaseType_t initial_count);
+void              vSemaphoreDelete(SemaphoreHandle_t semaphore);
+BaseType_t        xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t timeout);
+BaseType_t        xSemaphoreGive(SemaphoreHandle_t semaphore);
+BaseType_t        xSemaphoreTakeFromISR(SemaphoreHandle_t semaphore, BaseType_t* higher_priority_task_woken);
+BaseType_t        xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore, BaseType_t* higher_priority_task_woken);
+UBaseType_t       uxSemaphoreGetCount(SemaphoreHandle_t semaphore);
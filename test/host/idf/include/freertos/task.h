@@ -0,0 +1,18 @@
+// Host test stand-in: FreeRTOS tasks (pthreads) and task notifications
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+BaseType_t   xTaskCreate(TaskFunction_t function, char const* name, uint32_t stack_depth, void* parameters,
+                         UBaseType_t priority, TaskHandle_t* out_handle);
+BaseType_t   xTaskCreatePinnedToCore(TaskFunction_t function, char const* name, uint32_t stack_depth, void* parameters,
+                                     UBaseType_t priority, TaskHandle_t* out_handle, BaseType_t core);
+void         vTaskDelete(TaskHandle_t task);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+void         vTaskDelayUntil(TickType_t* previous_wake_time, TickType_t increment);
+uint32_t     ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t timeout);
+BaseType_t   xTaskNotifyGive(TaskHandle_t task);
+void         vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higher_priority_task_woken);
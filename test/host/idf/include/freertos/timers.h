@@ -0,0 +1,13 @@
+// Host test stand-in: FreeRTOS software timers, tests provide the implementation they need
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+
+typedef void (*PendedFunction_t)(void* parameter1, uint32_t parameter2);
+
+BaseType_t xTimerPendFunctionCallFromISR(PendedFunction_t function, void* parameter1, uint32_t parameter2,
+                                         BaseType_t* higher_priority_task_woken);
@@ -0,0 +1,7 @@
+// Host test stand-in: ESP-IDF GPIO types, declared by driver/gpio.h
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "driver/gpio.h"
@@ -0,0 +1,20 @@
+// Host test stand-in: controls for the simulated environment
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Switch esp_timer_get_time and the esp_timer callbacks to a simulated clock starting at start_us. With the simulated
+// clock, timers only fire from host_clock_advance. vTaskDelay and semaphore takes with a timeout advance the clock
+// instead of sleeping, running the timers that become due on the way.
+void host_clock_set_simulated(int64_t start_us);
+
+// Advance the simulated clock, running every esp_timer callback that becomes due on the calling thread in order
+void host_clock_advance(int64_t us);
+
+// Mark the calling thread as running an interrupt handler, xPortInIsrContext reports true in between
+void host_isr_enter(void);
+void host_isr_exit(void);
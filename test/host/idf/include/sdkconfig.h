@@ -0,0 +1,44 @@
+// Host test stand-in: BSP configuration used by the host tests, tests override single options with -D
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#define CONFIG_IDF_TARGET_LINUX 1
+
+#ifndef CONFIG_BSP_DISPLAY_STATS
+#define CONFIG_BSP_DISPLAY_STATS 1
+#endif
+
+#ifndef CONFIG_BSP_INPUT_LATENCY_STATS
+#define CONFIG_BSP_INPUT_LATENCY_STATS 1
+#endif
+
+#ifndef CONFIG_BSP_INPUT_QUEUE_DEPTH
+#define CONFIG_BSP_INPUT_QUEUE_DEPTH 32
+#endif
+
+#if !defined(CONFIG_BSP_INPUT_QUEUE_OVERFLOW_DROP_NEWEST) && !defined(CONFIG_BSP_INPUT_QUEUE_OVERFLOW_DROP_OLDEST) && \
+    !defined(CONFIG_BSP_INPUT_QUEUE_OVERFLOW_BLOCK)
+#define CONFIG_BSP_INPUT_QUEUE_OVERFLOW_DROP_NEWEST 1
+#endif
+
+#ifndef CONFIG_BSP_INPUT_QUEUE_BLOCK_TIMEOUT_MS
+#define CONFIG_BSP_INPUT_QUEUE_BLOCK_TIMEOUT_MS 100
+#endif
+
+#ifndef CONFIG_BSP_INPUT_REPEAT_DELAY_MS
+#define CONFIG_BSP_INPUT_REPEAT_DELAY_MS 400
+#endif
+
+#ifndef CONFIG_BSP_INPUT_REPEAT_INTERVAL_MS
+#define CONFIG_BSP_INPUT_REPEAT_INTERVAL_MS 100
+#endif
+
+#ifndef CONFIG_BSP_INPUT_REPEAT_MIN_INTERVAL_MS
+#define CONFIG_BSP_INPUT_REPEAT_MIN_INTERVAL_MS 30
+#endif
+
+#ifndef CONFIG_BSP_INPUT_REPEAT_ACCELERATION
+#define CONFIG_BSP_INPUT_REPEAT_ACCELERATION 10
+#endif
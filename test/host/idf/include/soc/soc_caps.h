@@ -0,0 +1,7 @@
+// Host test stand-in: SoC capabilities, the host has none of the accelerators
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#define SOC_PPA_SUPPORTED 0
@@ -0,0 +1,23 @@
+// Host test stand-in: SSD1619 e-paper controller driver, tests provide the implementation they need
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef struct {
+    int      spi_bus;
+    int      pin_cs;
+    int      pin_dcx;
+    int      pin_reset;
+    int      pin_busy;
+    uint32_t spi_speed;
+    uint32_t spi_max_transfer_size;
+    uint16_t screen_width;
+    uint16_t screen_height;
+} ssd1619_t;
+
+esp_err_t ssd1619_send_command(ssd1619_t* device, uint8_t command);
+esp_err_t ssd1619_send_data(ssd1619_t* device, const uint8_t* data, uint16_t length);
@@ -0,0 +1,11 @@
+// Host test stand-in: the C library string functions, with strlcpy for C libraries that predate it
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include_next <string.h>
+
+#if defined(__GLIBC__) && !__GLIBC_PREREQ(2, 38)
+size_t strlcpy(char* dst, char const* src, size_t size);
+#endif
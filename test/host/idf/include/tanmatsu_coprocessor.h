@@ -0,0 +1,118 @@
+// Host test stand-in: tanmatsu coprocessor component, tests provide the implementation they need
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#define TANMATSU_COPROCESSOR_KEYBOARD_NUM_REGS 9
+
+typedef struct tanmatsu_coprocessor* tanmatsu_coprocessor_handle_t;
+
+// Same keys as the keyboard registers of the coprocessor, the bit positions are not those of the real registers: the
+// BSP takes them from the bitfields and must not depend on them
+typedef union {
+    struct {
+        bool key_t : 1;
+        bool key_h : 1;
+        bool key_p : 1;
+        bool key_i : 1;
+        bool key_q : 1;
+        bool key_4 : 1;
+        bool key_return : 1;
+        bool key_x : 1;
+        bool key_a : 1;
+        bool key_f5 : 1;
+        bool key_7 : 1;
+        bool key_tilde : 1;
+        bool key_3 : 1;
+        bool key_u : 1;
+        bool key_2 : 1;
+        bool key_d : 1;
+        bool key_b : 1;
+        bool key_comma : 1;
+        bool key_1 : 1;
+        bool key_fn : 1;
+        bool key_tab : 1;
+        bool key_meta : 1;
+        bool key_shift_r : 1;
+        bool key_f6 : 1;
+        bool key_space_l : 1;
+        bool key_equals : 1;
+        bool key_g : 1;
+        bool key_f3 : 1;
+        bool key_right : 1;
+        bool key_sqbracket_close : 1;
+        bool key_0 : 1;
+        bool key_quote : 1;
+        bool key_9 : 1;
+        bool key_l : 1;
+        bool key_8 : 1;
+        bool key_v : 1;
+        bool key_z : 1;
+        bool key_space_r : 1;
+        bool key_slash : 1;
+        bool key_shift_l : 1;
+        bool key_f2 : 1;
+        bool key_y : 1;
+        bool key_down : 1;
+        bool key_f4 : 1;
+        bool key_sqbracket_open : 1;
+        bool key_esc : 1;
+        bool key_5 : 1;
+        bool key_w : 1;
+        bool key_j : 1;
+        bool key_k : 1;
+        bool key_dot : 1;
+        bool key_left : 1;
+        bool key_o : 1;
+        bool key_6 : 1;
+        bool key_c : 1;
+        bool key_m : 1;
+        bool key_semicolon : 1;
+        bool key_e : 1;
+        bool key_alt_r : 1;
+        bool key_s : 1;
+        bool key_volume_up : 1;
+        bool key_backspace : 1;
+        bool key_r : 1;
+        bool key_ctrl : 1;
+        bool key_backslash : 1;
+        bool key_f1 : 1;
+        bool key_up : 1;
+        bool key_n : 1;
+        bool key_f : 1;
+        bool key_space_m : 1;
+        bool key_alt_l : 1;
+        bool key_minus : 1;
+    };
+    uint8_t raw[TANMATSU_COPROCESSOR_KEYBOARD_NUM_REGS];
+} tanmatsu_coprocessor_keys_t;
+
+typedef struct {
+    bool sd_card_detect;
+    bool headphone_detect;
+    bool power_button;
+} tanmatsu_coprocessor_inputs_t;
+
+typedef struct {
+    bool watchdog;
+    bool boost;
+    bool chrg_input;
+    bool chrg_thermal;
+    bool chrg_safety;
+    bool batt_ovp;
+    bool ntc_cold;
+    bool ntc_hot;
+    bool ntc_boost;
+} tanmatsu_coprocessor_pmic_faults_t;
+
+esp_err_t tanmatsu_coprocessor_get_keyboard_keys(tanmatsu_coprocessor_handle_t handle,
+                                                 tanmatsu_coprocessor_keys_t*  out_keys);
+esp_err_t tanmatsu_coprocessor_get_keyboard_backlight(tanmatsu_coprocessor_handle_t handle, uint8_t* out_brightness);
+esp_err_t tanmatsu_coprocessor_set_keyboard_backlight(tanmatsu_coprocessor_handle_t handle, uint8_t brightness);
+esp_err_t tanmatsu_coprocessor_get_inputs(tanmatsu_coprocessor_handle_t  handle,
+                                          tanmatsu_coprocessor_inputs_t* out_inputs);
@@ -0,0 +1,35 @@
+// Host test stand-in: TCA8418 keypad scan controller driver, tests provide the implementation they need
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "driver/i2c_master.h"
+#include "esp_err.h"
+
+typedef struct tca8418_handle tca8418_handle_t;
+
+typedef void (*tca8418_callback_t)(tca8418_handle_t* handle);
+
+struct tca8418_handle {
+    i2c_master_bus_handle_t i2c_bus;
+    tca8418_callback_t      key_callback;
+};
+
+esp_err_t tca8418_initialize(tca8418_handle_t* handle, i2c_master_bus_handle_t i2c_bus, int reset_pin,
+                             int interrupt_pin);
+esp_err_t tca8418_set_kp_gpio1(tca8418_handle_t* handle, bool row0, bool row1, bool row2, bool row3, bool row4,
+                               bool row5, bool row6, bool row7);
+esp_err_t tca8418_set_kp_gpio2(tca8418_handle_t* handle, bool col0, bool col1, bool col2, bool col3, bool col4,
+                               bool col5, bool col6, bool col7);
+esp_err_t tca8418_set_kp_gpio3(tca8418_handle_t* handle, bool col8, bool col9);
+esp_err_t tca8418_set_cfg(tca8418_handle_t* handle, bool ai, bool gpi_e_cfg, bool overflow_mode, bool int_cfg,
+                          bool overflow_ien, bool k_lck_ien, bool gpi_ien, bool ke_ien);
+esp_err_t tca8418_set_cad_callback(tca8418_handle_t* handle, tca8418_callback_t callback);
+esp_err_t tca8418_set_lock_callback(tca8418_handle_t* handle, tca8418_callback_t callback);
+esp_err_t tca8418_set_gpi_callback(tca8418_handle_t* handle, tca8418_callback_t callback);
+esp_err_t tca8418_set_overflow_callback(tca8418_handle_t* handle, tca8418_callback_t callback);
+esp_err_t tca8418_set_key_callback(tca8418_handle_t* handle, tca8418_callback_t callback);
+esp_err_t tca8418_get_key_event_a(tca8418_handle_t* handle, bool* out_pressed, uint8_t* out_code);
@@ -0,0 +1,215 @@
+// Host tests: mock display panel for the stub target
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include "mock_panel.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "badge_bsp_display_flush.h"
+#include "badge_bsp_display_stats.h"
+#include "bsp/display.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "host_idf.h"
+#include "test_support.h"
+
+static char const* TAG = "mock panel";
+
+typedef struct {
+    mock_panel_transfer_t record;
+    void const*           buffer;
+} mock_panel_request_t;
+
+static mock_panel_config_t   panel_config;
+static uint8_t*              panel_memory = NULL;
+static size_t                panel_bpp    = 0;
+static QueueHandle_t         panel_queue  = NULL;
+static portMUX_TYPE          panel_lock   = portMUX_INITIALIZER_UNLOCKED;
+static mock_panel_transfer_t panel_records[MOCK_PANEL_MAX_RECORDS];
+static size_t                panel_num_records = 0;
+static size_t                panel_queued      = 0;
+static size_t                panel_max_queued  = 0;
+
+static size_t mock_panel_memory_size(void) {
+    return (panel_config.h_res * panel_config.v_res * panel_bpp + 7) / 8;
+}
+
+// Copy a region into the panel memory, pixels are packed most significant bits first like the panels in the tree
+static void mock_panel_write(mock_panel_transfer_t const* record, uint8_t const* buffer) {
+    size_t width = record->x_end - record->x_start;
+    if (panel_bpp % 8 == 0) {
+        size_t pixel_bytes = panel_bpp / 8;
+        for (size_t y = record->y_start; y < record->y_end; y++) {
+            memcpy(&panel_memory[(y * panel_config.h_res + record->x_start) * pixel_bytes],
+                   &buffer[(y - record->y_start) * width * pixel_bytes], width * pixel_bytes);
+        }
+        return;
+    }
+    size_t src_stride = (width * panel_bpp + 7) / 8 * 8;  // Source rows start at a byte boundary
+    for (size_t y = record->y_start; y < record->y_end; y++) {
+        for (size_t x = record->x_start; x < record->x_end; x++) {
+            size_t src_bit = (y - record->y_start) * src_stride + (x - record->x_start) * panel_bpp;
+            size_t dst_bit = (y * panel_config.h_res + x) * panel_bpp;
+            for (size_t bit = 0; bit < panel_bpp; bit++) {
+                size_t  s     = src_bit + bit;
+                size_t  d     = dst_bit + bit;
+                uint8_t value = (buffer[s / 8] >> (7 - s % 8)) & 1;
+                panel_memory[d / 8] =
+                    (uint8_t)((panel_memory[d / 8] & ~(1 << (7 - d % 8))) | (value << (7 - d % 8)));
+            }
+        }
+    }
+}
+
+static void mock_panel_task(void* arg) {
+    (void)arg;
+    mock_panel_request_t request;
+    while (xQueueReceive(panel_queue, &request, portMAX_DELAY) == pdTRUE) {
+        request.record.started = test_wall_time_us();
+        if (panel_config.bytes_per_ms > 0) {
+            int64_t duration = (int64_t)request.record.bytes * 1000 / panel_config.bytes_per_ms;
+            int64_t elapsed  = test_wall_time_us() - request.record.started;
+            if (duration > elapsed) {
+                struct timespec delay = {.tv_sec = 0, .tv_nsec = (long)(duration - elapsed) * 1000};
+                nanosleep(&delay, NULL);
+            }
+        }
+        mock_panel_write(&request.record, request.buffer);
+        request.record.finished = test_wall_time_us();
+
+        portENTER_CRITICAL(&panel_lock);
+        if (panel_num_records < MOCK_PANEL_MAX_RECORDS) {
+            panel_records[panel_num_records++] = request.record;
+        }
+        panel_queued--;
+        portEXIT_CRITICAL(&panel_lock);
+
+        host_isr_enter();
+        bsp_display_flush_done_from_isr();
+        host_isr_exit();
+    }
+}
+
+esp_err_t mock_panel_initialize(mock_panel_config_t const* config) {
+    ESP_RETURN_ON_FALSE(config, ESP_ERR_INVALID_ARG, TAG, "Configuration argument is NULL");
+    panel_config = *config;
+    panel_bpp    = bsp_display_get_bits_per_pixel(config->color_fmt);
+    ESP_RETURN_ON_FALSE(panel_bpp, ESP_ERR_INVALID_ARG, TAG, "Unknown color format");
+
+    panel_memory = calloc(1, mock_panel_memory_size());
+    ESP_RETURN_ON_FALSE(panel_memory, ESP_ERR_NO_MEM, TAG, "Failed to allocate panel memory");
+    ESP_RETURN_ON_ERROR(bsp_display_flush_initialize(config->max_blits_in_flight), TAG,
+                        "Failed to initialize flush tracking");
+
+    // The panel accepts more requests than the flush tracker lets through, blits never wait on the panel queue
+    panel_queue = xQueueCreate(64, sizeof(mock_panel_request_t));
+    ESP_RETURN_ON_FALSE(panel_queue, ESP_ERR_NO_MEM, TAG, "Failed to create panel queue");
+    ESP_RETURN_ON_FALSE(xTaskCreate(mock_panel_task, "mock panel", 4096, NULL, 10, NULL) == pdPASS, ESP_FAIL, TAG,
+                        "Failed to start panel task");
+    return ESP_OK;
+}
+
+uint8_t const* mock_panel_memory(void) {
+    return panel_memory;
+}
+
+size_t mock_panel_get_transfers(mock_panel_transfer_t const** out_transfers) {
+    portENTER_CRITICAL(&panel_lock);
+    size_t count = panel_num_records;
+    portEXIT_CRITICAL(&panel_lock);
+    *out_transfers = panel_records;
+    return count;
+}
+
+size_t mock_panel_get_max_queued(void) {
+    portENTER_CRITICAL(&panel_lock);
+    size_t max_queued = panel_max_queued;
+    portEXIT_CRITICAL(&panel_lock);
+    return max_queued;
+}
+
+void mock_panel_reset(void) {
+    bsp_display_blit_wait_idle(portMAX_DELAY);
+    portENTER_CRITICAL(&panel_lock);
+    panel_num_records = 0;
+    panel_max_queued  = 0;
+    memset(panel_memory, 0, mock_panel_memory_size());
+    portEXIT_CRITICAL(&panel_lock);
+}
+
+// ============================================
+// Display functions of the stub target
+// ============================================
+
+esp_err_t bsp_display_get_parameters(size_t* h_res, size_t* v_res, bsp_display_color_format_t* color_fmt,
+                                     bsp_display_endianness_t* data_endian) {
+    if (panel_memory == NULL) {
+        return ESP_FAIL;
+    }
+    if (h_res) {
+        *h_res = panel_config.h_res;
+    }
+    if (v_res) {
+        *v_res = panel_config.v_res;
+    }
+    if (color_fmt) {
+        *color_fmt = panel_config.color_fmt;
+    }
+    if (data_endian) {
+        *data_endian = panel_config.data_endian;
+    }
+    return ESP_OK;
+}
+
+esp_err_t bsp_display_blit_async(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer,
+                                 bsp_display_blit_done_cb_t callback, void* user_ctx) {
+    ESP_RETURN_ON_FALSE(panel_memory, ESP_FAIL, TAG, "Mock panel not initialized");
+    ESP_RETURN_ON_FALSE(x_start < x_end && y_start < y_end && x_end <= panel_config.h_res &&
+                            y_end <= panel_config.v_res,
+                        ESP_ERR_INVALID_ARG, TAG, "Region out of bounds");
+    ESP_RETURN_ON_ERROR(bsp_display_flush_begin(callback, user_ctx, pdMS_TO_TICKS(1000)), TAG,
+                        "Timeout while waiting for previous flush");
+
+    int64_t              start   = bsp_display_stats_now();
+    size_t               pixels  = (x_end - x_start) * (y_end - y_start);
+    mock_panel_request_t request = {
+        .record =
+            {
+                .x_start   = x_start,
+                .y_start   = y_start,
+                .x_end     = x_end,
+                .y_end     = y_end,
+                .bytes     = (pixels * panel_bpp + 7) / 8,
+                .submitted = test_wall_time_us(),
+            },
+        .buffer = buffer,
+    };
+
+    portENTER_CRITICAL(&panel_lock);
+    panel_queued++;
+    if (panel_queued > panel_max_queued) {
+        panel_max_queued = panel_queued;
+    }
+    portEXIT_CRITICAL(&panel_lock);
+
+    if (xQueueSend(panel_queue, &request, 0) != pdTRUE) {
+        portENTER_CRITICAL(&panel_lock);
+        panel_queued--;
+        portEXIT_CRITICAL(&panel_lock);
+        bsp_display_flush_cancel();
+        return ESP_FAIL;
+    }
+    bsp_display_flush_end();
+    bsp_display_stats_record_blit(x_start, y_start, x_end, y_end, start);
+    return ESP_OK;
+}
+
+esp_err_t bsp_display_blit(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer) {
+    return bsp_display_blit_async(x_start, y_start, x_end, y_end, buffer, NULL, NULL);
+}
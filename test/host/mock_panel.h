@@ -0,0 +1,51 @@
+// Host tests: mock display panel for the stub target
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "bsp/display.h"
+#include "esp_err.h"
+
+// Maximum number of transfers the mock panel keeps a record of
+#define MOCK_PANEL_MAX_RECORDS 4096
+
+typedef struct {
+    size_t  x_start;
+    size_t  y_start;
+    size_t  x_end;
+    size_t  y_end;
+    size_t  bytes;
+    int64_t submitted;  // Wall clock time the blit was handed to the panel in microseconds
+    int64_t started;    // Wall clock time the transfer started
+    int64_t finished;   // Wall clock time the transfer done interrupt fired
+} mock_panel_transfer_t;
+
+typedef struct {
+    size_t                     h_res;
+    size_t                     v_res;
+    bsp_display_color_format_t color_fmt;
+    bsp_display_endianness_t   data_endian;
+    size_t                     max_blits_in_flight;  // Passed to the flush tracker, 0 means 1
+    uint32_t                   bytes_per_ms;         // Simulated bus throughput, 0 transfers instantly
+} mock_panel_config_t;
+
+// Start the mock panel, it implements the display functions of the stub target: bsp_display_get_parameters,
+// bsp_display_blit and bsp_display_blit_async. Transfers run on a panel thread that copies the pixels into the panel
+// memory and then calls bsp_display_flush_done_from_isr like the color transfer done interrupt of a real panel.
+esp_err_t mock_panel_initialize(mock_panel_config_t const* config);
+
+// Pixel memory of the panel, in the color format of the panel
+uint8_t const* mock_panel_memory(void);
+
+// Transfers recorded since the last reset, only complete transfers are recorded
+size_t mock_panel_get_transfers(mock_panel_transfer_t const** out_transfers);
+
+// Highest number of transfers queued on the panel at once since the last reset
+size_t mock_panel_get_max_queued(void);
+
+// Forget the recorded transfers and clear the panel memory
+void mock_panel_reset(void);
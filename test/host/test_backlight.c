@@ -0,0 +1,118 @@
+// Host tests: backlight fade engine against a simulated backlight
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "bsp/backlight.h"
+#include "bsp/display.h"
+#include "bsp/input.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "test_support.h"
+
+// Simulated display backlight, written by the fade task and by the test through the direct setter
+static volatile uint8_t   display_level  = 0;
+static volatile size_t    display_writes = 0;
+static volatile pthread_t display_writer;
+
+esp_err_t bsp_display_get_backlight_brightness(uint8_t* out_percentage) {
+    *out_percentage = display_level;
+    return ESP_OK;
+}
+
+esp_err_t bsp_display_set_backlight_brightness(uint8_t percentage) {
+    display_level  = percentage;
+    display_writer = pthread_self();
+    display_writes++;
+    return ESP_OK;
+}
+
+esp_err_t bsp_input_get_backlight_brightness(uint8_t* out_percentage) {
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t bsp_input_set_backlight_brightness(uint8_t percentage) {
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+static void wait_for_fade(void) {
+    int64_t deadline = test_wall_time_us() + 2000000;
+    while (bsp_backlight_is_fading(BSP_BACKLIGHT_DISPLAY)) {
+        CHECK(test_wall_time_us() < deadline);
+        vTaskDelay(1);
+    }
+}
+
+// ============================================
+// Tests
+// ============================================
+
+// A level set through the direct setter after a fade is picked up by the next fade, even if the next fade has the
+// same target as the previous one
+static void test_direct_setter(void) {
+    CHECK_OK(bsp_backlight_fade(BSP_BACKLIGHT_DISPLAY, 50, 0, BSP_BACKLIGHT_CURVE_LINEAR));
+    wait_for_fade();
+    CHECK(display_level == 50);
+
+    CHECK_OK(bsp_display_set_backlight_brightness(10));
+    uint8_t target = 0;
+    CHECK_OK(bsp_backlight_get_target(BSP_BACKLIGHT_DISPLAY, &target));
+    CHECK(target == 10);
+
+    CHECK_OK(bsp_backlight_fade(BSP_BACKLIGHT_DISPLAY, 50, 0, BSP_BACKLIGHT_CURVE_LINEAR));
+    wait_for_fade();
+    CHECK(display_level == 50);
+}
+
+// A fade starts from the level the hardware is at, not from the level the previous fade ended at
+static void test_fade_starts_from_hardware(void) {
+    CHECK_OK(bsp_display_set_backlight_brightness(100));
+    size_t writes = display_writes;
+    CHECK_OK(bsp_backlight_fade(BSP_BACKLIGHT_DISPLAY, 0, 200, BSP_BACKLIGHT_CURVE_LINEAR));
+
+    // The first update lands well before the end of the fade, close to the level the fade started from
+    int64_t deadline = test_wall_time_us() + 1000000;
+    while (display_writes == writes) {
+        CHECK(test_wall_time_us() < deadline);
+        vTaskDelay(1);
+    }
+    CHECK(display_level > 50);
+    wait_for_fade();
+    CHECK(display_level == 0);
+}
+
+static void record_timer_thread(void* arg) {
+    *(pthread_t*)arg = pthread_self();
+}
+
+// The backlight is written by the fade task, the esp_timer task is never held up by a slow bus
+static void test_writes_off_timer_task(void) {
+    pthread_t                     timer_thread;
+    esp_timer_handle_t            timer = NULL;
+    const esp_timer_create_args_t args  = {
+        .callback = record_timer_thread,
+        .arg      = &timer_thread,
+        .name     = "test",
+    };
+    CHECK_OK(esp_timer_create(&args, &timer));
+    CHECK_OK(esp_timer_start_once(timer, 0));
+    vTaskDelay(pdMS_TO_TICKS(20));
+    esp_timer_delete(timer);
+
+    CHECK_OK(bsp_backlight_fade(BSP_BACKLIGHT_DISPLAY, 30, 0, BSP_BACKLIGHT_CURVE_LINEAR));
+    wait_for_fade();
+    CHECK(display_level == 30);
+    CHECK(!pthread_equal(display_writer, timer_thread));
+    CHECK(!pthread_equal(display_writer, pthread_self()));
+}
+
+int main(void) {
+    RUN_TEST(test_direct_setter);
+    RUN_TEST(test_fade_starts_from_hardware);
+    RUN_TEST(test_writes_off_timer_task);
+    return 0;
+}
@@ -0,0 +1,321 @@
+// Host tests: pixel format conversion kernels against per-pixel reference loops, with a throughput benchmark
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "bsp/display.h"
+#include "mock_panel.h"
+#include "test_support.h"
+
+#define MAX_PIXELS   (320 * 240)
+#define BENCH_ROUNDS 50
+
+// Aligned like framebuffers, so the offsets below include buffers that start on a 16 byte boundary
+static uint8_t source[MAX_PIXELS * 4 + 8] __attribute__((aligned(16)));
+static uint8_t expected[MAX_PIXELS * 4 + 8] __attribute__((aligned(16)));
+static uint8_t actual[MAX_PIXELS * 4 + 8] __attribute__((aligned(16)));
+
+static void fill_random(uint8_t* buffer, size_t length, uint32_t seed) {
+    for (size_t i = 0; i < length; i++) {
+        seed      = seed * 1664525 + 1013904223;
+        buffer[i] = (uint8_t)(seed >> 24);
+    }
+}
+
+// ============================================
+// Reference loops, one pixel at a time the way applications convert today
+// ============================================
+
+static void store16(uint8_t* dst, uint16_t value, bsp_display_endianness_t endian) {
+    dst[endian == BSP_DISPLAY_ENDIAN_BIG ? 0 : 1] = value >> 8;
+    dst[endian == BSP_DISPLAY_ENDIAN_BIG ? 1 : 0] = value & 0xFF;
+}
+
+static void store24(uint8_t* dst, uint32_t value, bsp_display_endianness_t endian) {
+    for (size_t i = 0; i < 3; i++) {
+        dst[endian == BSP_DISPLAY_ENDIAN_BIG ? i : 2 - i] = (value >> (16 - 8 * i)) & 0xFF;
+    }
+}
+
+static uint32_t load24(uint8_t const* src) {
+    return src[0] | (src[1] << 8) | (src[2] << 16);
+}
+
+static uint8_t reference_luma(uint32_t r, uint32_t g, uint32_t b) {
+    return (uint8_t)((77 * r + 150 * g + 29 * b) >> 8);
+}
+
+__attribute__((noinline)) static void reference_rgb888_to_rgb565(uint8_t* dst, uint8_t const* src, size_t pixels,
+                                                                 bsp_display_endianness_t endian) {
+    for (size_t i = 0; i < pixels; i++) {
+        uint32_t rgb = load24(&src[i * 3]);
+        uint16_t value =
+            (uint16_t)((((rgb >> 16) & 0xFF) >> 3) << 11 | (((rgb >> 8) & 0xFF) >> 2) << 5 | ((rgb & 0xFF) >> 3));
+        store16(&dst[i * 2], value, endian);
+    }
+}
+
+__attribute__((noinline)) static void reference_rgb565_to_rgb888(uint8_t* dst, uint8_t const* src, size_t pixels,
+                                                                 bsp_display_endianness_t endian) {
+    for (size_t i = 0; i < pixels; i++) {
+        uint16_t value = src[i * 2] | (src[i * 2 + 1] << 8);
+        uint32_t r     = (value >> 11) & 0x1F;
+        uint32_t g     = (value >> 5) & 0x3F;
+        uint32_t b     = value & 0x1F;
+        store24(&dst[i * 3], ((r << 3) | (r >> 2)) << 16 | ((g << 2) | (g >> 4)) << 8 | ((b << 3) | (b >> 2)), endian);
+    }
+}
+
+__attribute__((noinline)) static void reference_argb8888_to_rgb888(uint8_t* dst, uint8_t const* src, size_t pixels,
+                                                                   bsp_display_endianness_t endian) {
+    for (size_t i = 0; i < pixels; i++) {
+        store24(&dst[i * 3], load24(&src[i * 4]), endian);
+    }
+}
+
+__attribute__((noinline)) static void reference_rgb565_swap(uint8_t* dst, uint8_t const* src, size_t pixels) {
+    for (size_t i = 0; i < pixels; i++) {
+        uint16_t value = src[i * 2] | (src[i * 2 + 1] << 8);
+        store16(&dst[i * 2], value, BSP_DISPLAY_ENDIAN_BIG);
+    }
+}
+
+static void reference_grey_pack(uint8_t* dst, size_t index, uint8_t grey, size_t bits) {
+    size_t  bit   = index * bits;
+    uint8_t mask  = (uint8_t)(((1 << bits) - 1) << (8 - bits - bit % 8));
+    uint8_t value = (uint8_t)((grey >> (8 - bits)) << (8 - bits - bit % 8));
+    dst[bit / 8]  = (dst[bit / 8] & ~mask) | value;
+}
+
+__attribute__((noinline)) static void reference_rgb565_to_grey(uint8_t* dst, uint8_t const* src, size_t pixels,
+                                                               size_t bits) {
+    for (size_t i = 0; i < pixels; i++) {
+        uint16_t value = src[i * 2] | (src[i * 2 + 1] << 8);
+        uint8_t  grey  = reference_luma((value >> 8) & 0xF8, (value >> 3) & 0xFC, (value << 3) & 0xF8);
+        reference_grey_pack(dst, i, grey, bits);
+    }
+}
+
+__attribute__((noinline)) static void reference_rgb888_to_grey(uint8_t* dst, uint8_t const* src, size_t pixels,
+                                                               size_t bits) {
+    for (size_t i = 0; i < pixels; i++) {
+        uint32_t rgb = load24(&src[i * 3]);
+        reference_grey_pack(dst, i, reference_luma((rgb >> 16) & 0xFF, (rgb >> 8) & 0xFF, rgb & 0xFF), bits);
+    }
+}
+
+// ============================================
+// Correctness
+// ============================================
+
+// Every pixel count up to a few words, at every alignment of source and destination
+#define FOR_EACH_SHAPE(pixels, src_offset, dst_offset)            \
+    for (size_t pixels = 0; pixels < 70; pixels++)                \
+        for (size_t src_offset = 0; src_offset < 4; src_offset++) \
+            for (size_t dst_offset = 0; dst_offset < 4; dst_offset++)
+
+static void prepare(size_t src_bytes) {
+    fill_random(source, src_bytes + 8, (uint32_t)src_bytes);
+    // Bytes past the converted pixels must survive, start both outputs with the same pattern
+    size_t length = src_bytes * 2 + 16 < sizeof(expected) ? src_bytes * 2 + 16 : sizeof(expected);
+    fill_random(expected, length, 7);
+    memcpy(actual, expected, length);
+}
+
+static void test_rgb888_rgb565(void) {
+    for (int endian = 0; endian < 2; endian++) {
+        FOR_EACH_SHAPE(pixels, src_offset, dst_offset) {
+            prepare(pixels * 3);
+            reference_rgb888_to_rgb565(&expected[dst_offset], &source[src_offset], pixels, endian);
+            bsp_display_convert_rgb888_to_rgb565(&actual[dst_offset], &source[src_offset], pixels, endian);
+            CHECK(memcmp(expected, actual, pixels * 2 + 8) == 0);
+
+            prepare(pixels * 2);
+            reference_rgb565_to_rgb888(&expected[dst_offset], &source[src_offset], pixels, endian);
+            bsp_display_convert_rgb565_to_rgb888(&actual[dst_offset], &source[src_offset], pixels, endian);
+            CHECK(memcmp(expected, actual, pixels * 3 + 8) == 0);
+        }
+    }
+}
+
+static void test_argb8888_to_rgb888(void) {
+    for (int endian = 0; endian < 2; endian++) {
+        FOR_EACH_SHAPE(pixels, src_offset, dst_offset) {
+            prepare(pixels * 4);
+            reference_argb8888_to_rgb888(&expected[dst_offset], &source[src_offset], pixels, endian);
+            bsp_display_convert_argb8888_to_rgb888(&actual[dst_offset], &source[src_offset], pixels, endian);
+            CHECK(memcmp(expected, actual, pixels * 4 + 8) == 0);
+        }
+    }
+}
+
+static void test_rgb565_swap(void) {
+    FOR_EACH_SHAPE(pixels, src_offset, dst_offset) {
+        prepare(pixels * 2);
+        reference_rgb565_swap(&expected[dst_offset], &source[src_offset], pixels);
+        bsp_display_convert_rgb565_swap(&actual[dst_offset], &source[src_offset], pixels);
+        CHECK(memcmp(expected, actual, pixels * 2 + 8) == 0);
+    }
+
+    // In place
+    prepare(66);
+    reference_rgb565_swap(expected, source, 33);
+    memcpy(actual, source, 66);
+    bsp_display_convert_rgb565_swap(actual, actual, 33);
+    CHECK(memcmp(expected, actual, 66) == 0);
+}
+
+static void test_grey(void) {
+    static size_t const bits[] = {1, 2, 4, 8};
+    for (size_t b = 0; b < 4; b++) {
+        FOR_EACH_SHAPE(pixels, src_offset, dst_offset) {
+            prepare(pixels * 2);
+            reference_rgb565_to_grey(&expected[dst_offset], &source[src_offset], pixels, bits[b]);
+            CHECK_OK(bsp_display_convert_rgb565_to_grey(&actual[dst_offset], &source[src_offset], pixels, bits[b]));
+            CHECK(memcmp(expected, actual, pixels + 8) == 0);
+
+            prepare(pixels * 3);
+            reference_rgb888_to_grey(&expected[dst_offset], &source[src_offset], pixels, bits[b]);
+            CHECK_OK(bsp_display_convert_rgb888_to_grey(&actual[dst_offset], &source[src_offset], pixels, bits[b]));
+            CHECK(memcmp(expected, actual, pixels + 8) == 0);
+        }
+    }
+    CHECK_ESP(ESP_ERR_INVALID_ARG, bsp_display_convert_rgb565_to_grey(actual, source, 8, 3));
+}
+
+static void test_convert_dispatch(void) {
+    prepare(64 * 3);
+    reference_rgb888_to_rgb565(expected, source, 64, BSP_DISPLAY_ENDIAN_BIG);
+    CHECK_OK(bsp_display_convert(actual, BSP_DISPLAY_COLOR_FORMAT_16_565RGB, BSP_DISPLAY_ENDIAN_BIG, source,
+                                 BSP_DISPLAY_COLOR_FORMAT_24_888RGB, 64));
+    CHECK(memcmp(expected, actual, 128) == 0);
+
+    prepare(64 * 2);
+    reference_rgb565_to_grey(expected, source, 64, 4);
+    CHECK_OK(bsp_display_convert(actual, BSP_DISPLAY_COLOR_FORMAT_4_GREY, BSP_DISPLAY_ENDIAN_LITTLE, source,
+                                 BSP_DISPLAY_COLOR_FORMAT_16_565RGB, 64));
+    CHECK(memcmp(expected, actual, 32) == 0);
+
+    CHECK_ESP(ESP_ERR_NOT_SUPPORTED, bsp_display_convert(actual, BSP_DISPLAY_COLOR_FORMAT_32_8888ARGB,
+                                                         BSP_DISPLAY_ENDIAN_LITTLE, source,
+                                                         BSP_DISPLAY_COLOR_FORMAT_16_565RGB, 64));
+}
+
+// The mock panel is a 64x48 RGB565 panel that expects big endian pixels, like mch2022 and hackaday2025
+static void test_blit_convert(void) {
+    size_t const x_start = 8, y_start = 4, x_end = 56, y_end = 44;
+    size_t const width = x_end - x_start, height = y_end - y_start;
+
+    mock_panel_reset();
+    prepare(width * height * 3);
+    CHECK_OK(bsp_display_blit_convert(x_start, y_start, x_end, y_end, source, BSP_DISPLAY_COLOR_FORMAT_24_888RGB));
+    CHECK_OK(bsp_display_blit_wait_idle(pdMS_TO_TICKS(1000)));
+
+    mock_panel_transfer_t const* transfers;
+    CHECK(mock_panel_get_transfers(&transfers) > 1);  // Sent in strips
+
+    reference_rgb888_to_rgb565(expected, source, width * height, BSP_DISPLAY_ENDIAN_BIG);
+    uint8_t const* memory = mock_panel_memory();
+    for (size_t y = 0; y < height; y++) {
+        CHECK(memcmp(&memory[((y + y_start) * 64 + x_start) * 2], &expected[y * width * 2], width * 2) == 0);
+    }
+}
+
+// ============================================
+// Benchmark
+// ============================================
+
+// Built with the model of the PIE kernels the benchmark would only time the model
+#if !CONFIG_IDF_TARGET_ESP32P4
+
+typedef void (*kernel_t)(void);
+
+static double megapixels_per_second(kernel_t kernel) {
+    kernel();  // Warm up the caches
+    int64_t start = test_wall_time_us();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        kernel();
+    }
+    int64_t elapsed = test_wall_time_us() - start;
+    return (double)MAX_PIXELS * BENCH_ROUNDS / (elapsed > 0 ? elapsed : 1);
+}
+
+static void bench_swap(void) {
+    bsp_display_convert_rgb565_swap(actual, source, MAX_PIXELS);
+}
+static void bench_swap_reference(void) {
+    reference_rgb565_swap(actual, source, MAX_PIXELS);
+}
+static void bench_888_565(void) {
+    bsp_display_convert_rgb888_to_rgb565(actual, source, MAX_PIXELS, BSP_DISPLAY_ENDIAN_BIG);
+}
+static void bench_888_565_reference(void) {
+    reference_rgb888_to_rgb565(actual, source, MAX_PIXELS, BSP_DISPLAY_ENDIAN_BIG);
+}
+static void bench_565_888(void) {
+    bsp_display_convert_rgb565_to_rgb888(actual, source, MAX_PIXELS, BSP_DISPLAY_ENDIAN_LITTLE);
+}
+static void bench_565_888_reference(void) {
+    reference_rgb565_to_rgb888(actual, source, MAX_PIXELS, BSP_DISPLAY_ENDIAN_LITTLE);
+}
+static void bench_8888_888(void) {
+    bsp_display_convert_argb8888_to_rgb888(actual, source, MAX_PIXELS, BSP_DISPLAY_ENDIAN_LITTLE);
+}
+static void bench_8888_888_reference(void) {
+    reference_argb8888_to_rgb888(actual, source, MAX_PIXELS, BSP_DISPLAY_ENDIAN_LITTLE);
+}
+static void bench_grey(void) {
+    bsp_display_convert_rgb565_to_grey(actual, source, MAX_PIXELS, 2);
+}
+static void bench_grey_reference(void) {
+    reference_rgb565_to_grey(actual, source, MAX_PIXELS, 2);
+}
+
+static void test_benchmark(void) {
+    static struct {
+        char const* name;
+        kernel_t    kernel;
+        kernel_t    reference;
+    } const cases[] = {
+        {"RGB565 byte swap", bench_swap, bench_swap_reference},
+        {"RGB888 to RGB565 big endian", bench_888_565, bench_888_565_reference},
+        {"RGB565 to RGB888", bench_565_888, bench_565_888_reference},
+        {"ARGB8888 to RGB888", bench_8888_888, bench_8888_888_reference},
+        {"RGB565 to 2-bit grey", bench_grey, bench_grey_reference},
+    };
+
+    fill_random(source, sizeof(source), 1);
+    printf("  %-28s %12s %12s\n", "320x240 frames", "kernel", "per pixel");
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        double kernel    = megapixels_per_second(cases[i].kernel);
+        double reference = megapixels_per_second(cases[i].reference);
+        printf("  %-28s %7.0f MP/s %7.0f MP/s %5.2fx\n", cases[i].name, kernel, reference, kernel / reference);
+    }
+}
+
+#endif
+
+int main(void) {
+    mock_panel_config_t config = {
+        .h_res               = 64,
+        .v_res               = 48,
+        .color_fmt           = BSP_DISPLAY_COLOR_FORMAT_16_565RGB,
+        .data_endian         = BSP_DISPLAY_ENDIAN_BIG,
+        .max_blits_in_flight = 2,
+    };
+    CHECK_OK(mock_panel_initialize(&config));
+
+    RUN_TEST(test_rgb888_rgb565);
+    RUN_TEST(test_argb8888_to_rgb888);
+    RUN_TEST(test_rgb565_swap);
+    RUN_TEST(test_grey);
+    RUN_TEST(test_convert_dispatch);
+    RUN_TEST(test_blit_convert);
+#if !CONFIG_IDF_TARGET_ESP32P4
+    RUN_TEST(test_benchmark);
+#endif
+    return 0;
+}
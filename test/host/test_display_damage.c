@@ -0,0 +1,149 @@
+// Host tests: damage tracking, replaying damage traces of typical UI sessions on a mock SPI panel
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "bsp/display.h"
+#include "mock_panel.h"
+#include "test_support.h"
+
+#define H_RES        320
+#define V_RES        240
+#define FRAME_BYTES  (H_RES * V_RES * 2)
+#define BYTES_PER_MS 5000  // 40 MHz SPI
+#define MAX_RECTS    4096
+
+typedef struct {
+    uint32_t frame;
+    size_t   x_start;
+    size_t   y_start;
+    size_t   x_end;
+    size_t   y_end;
+} trace_rect_t;
+
+static uint16_t     framebuffer[H_RES * V_RES];
+static trace_rect_t trace[MAX_RECTS];
+
+static size_t load_trace(char const* name) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s.trace", TEST_DATA_DIR, name);
+    FILE* file = fopen(path, "r");
+    CHECK(file != NULL);
+    size_t count = 0;
+    char   line[256];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        trace_rect_t rect;
+        if (line[0] == '#') {
+            continue;
+        }
+        CHECK(sscanf(line, "%u %zu %zu %zu %zu", &rect.frame, &rect.x_start, &rect.y_start, &rect.x_end,
+                     &rect.y_end) == 5);
+        CHECK(count < MAX_RECTS);
+        trace[count++] = rect;
+    }
+    fclose(file);
+    return count;
+}
+
+// Draw a region the way an application would, every frame leaves a different value behind
+static void draw(trace_rect_t const* rect) {
+    for (size_t y = rect->y_start; y < rect->y_end; y++) {
+        for (size_t x = rect->x_start; x < rect->x_end; x++) {
+            framebuffer[y * H_RES + x] = (uint16_t)(rect->frame * 31 + x * 7 + y);
+        }
+    }
+}
+
+static void replay(char const* name, double min_reduction) {
+    size_t count = load_trace(name);
+    CHECK(count > 0);
+
+    mock_panel_reset();
+    memset(framebuffer, 0, sizeof(framebuffer));
+    bsp_display_damage_clear();
+
+    uint32_t frames = trace[count - 1].frame + 1;
+    size_t   bytes  = 0;
+    size_t   next   = 0;
+    int64_t  start  = test_wall_time_us();
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        for (; next < count && trace[next].frame == frame; next++) {
+            draw(&trace[next]);
+            CHECK_OK(bsp_display_damage_add(trace[next].x_start, trace[next].y_start, trace[next].x_end,
+                                            trace[next].y_end));
+        }
+        size_t frame_bytes = 0;
+        CHECK_OK(bsp_display_damage_flush(framebuffer, &frame_bytes));
+        // Full width regions are sent from the framebuffer, wait before drawing into it again
+        CHECK_OK(bsp_display_blit_wait_idle(pdMS_TO_TICKS(1000)));
+        bytes += frame_bytes;
+    }
+    int64_t elapsed = test_wall_time_us() - start;
+
+    // Everything drawn reached the panel
+    CHECK(memcmp(mock_panel_memory(), framebuffer, sizeof(framebuffer)) == 0);
+
+    mock_panel_transfer_t const* transfers;
+    size_t                       blits     = mock_panel_get_transfers(&transfers);
+    size_t                       full      = (size_t)frames * FRAME_BYTES;
+    double                       reduction = bytes > 0 ? (double)full / bytes : 0;
+    printf("  %-8s %4u frames %5zu regions %5zu blits %9zu bytes (%7.0f per frame) vs %9zu full screen: %6.1fx, "
+           "%lld ms on the bus vs %zu ms\n",
+           name, frames, count, blits, bytes, (double)bytes / frames, full, reduction, (long long)elapsed / 1000,
+           full / BYTES_PER_MS);
+    CHECK(reduction >= min_reduction);
+}
+
+static void test_overlapping_regions_merge(void) {
+    mock_panel_reset();
+    bsp_display_damage_clear();
+    CHECK_OK(bsp_display_damage_add(10, 10, 50, 50));
+    CHECK_OK(bsp_display_damage_add(20, 20, 60, 60));
+    CHECK_OK(bsp_display_damage_add(200, 200, 210, 210));
+    size_t bytes = 0;
+    CHECK_OK(bsp_display_damage_flush(framebuffer, &bytes));
+    CHECK_OK(bsp_display_blit_wait_idle(pdMS_TO_TICKS(1000)));
+
+    mock_panel_transfer_t const* transfers;
+    size_t                       blits = mock_panel_get_transfers(&transfers);
+    CHECK(bytes == (50 * 50 + 10 * 10) * 2);
+    CHECK(blits == 2);
+}
+
+static void test_regions_are_clipped(void) {
+    mock_panel_reset();
+    bsp_display_damage_clear();
+    CHECK_OK(bsp_display_damage_add(300, 230, 400, 300));
+    CHECK_OK(bsp_display_damage_add(H_RES, 0, H_RES + 10, 10));
+    size_t bytes = 0;
+    CHECK_OK(bsp_display_damage_flush(framebuffer, &bytes));
+    CHECK_OK(bsp_display_blit_wait_idle(pdMS_TO_TICKS(1000)));
+    CHECK(bytes == 20 * 10 * 2);
+}
+
+static void test_replay_traces(void) {
+    replay("launcher", 10.0);
+    replay("editor", 10.0);
+    replay("sprites", 10.0);
+    replay("scroll", 1.0);
+}
+
+int main(void) {
+    mock_panel_config_t config = {
+        .h_res               = H_RES,
+        .v_res               = V_RES,
+        .color_fmt           = BSP_DISPLAY_COLOR_FORMAT_16_565RGB,
+        .data_endian         = BSP_DISPLAY_ENDIAN_LITTLE,
+        .max_blits_in_flight = 2,
+        .bytes_per_ms        = BYTES_PER_MS,
+    };
+    CHECK_OK(mock_panel_initialize(&config));
+
+    RUN_TEST(test_overlapping_regions_merge);
+    RUN_TEST(test_regions_are_clipped);
+    RUN_TEST(test_replay_traces);
+    return 0;
+}
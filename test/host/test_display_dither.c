@@ -0,0 +1,196 @@
+// Host tests: quantization to the palette of the display with bsp_display_blit_dithered, with a benchmark of the
+// quantizer at the resolutions of the e-paper and OLED targets
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "bsp/display.h"
+#include "mock_panel.h"
+#include "test_support.h"
+
+// The mock panel is the 296x128 tri-color e-paper panel of kami and hackerhotel-2024
+#define H_RES        296
+#define V_RES        128
+#define PIXELS       (H_RES * V_RES)
+#define BENCH_ROUNDS 50
+
+// Pixel values of the colors of the panel
+#define INDEX_WHITE 0
+#define INDEX_BLACK 1
+#define INDEX_RED   2
+
+static const uint8_t panel_palette[][3] = {
+    {0xFF, 0xFF, 0xFF},
+    {0x00, 0x00, 0x00},
+    {0xFF, 0x00, 0x00},
+};
+
+static bool    palette_available = true;
+static uint8_t source[PIXELS * 3];
+static uint8_t packed[PIXELS];
+
+// Replaces the stub target, like the e-paper targets the panel reports its palette
+esp_err_t bsp_display_get_palette(const uint8_t** out_palette, size_t* out_palette_size) {
+    if (!palette_available) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    *out_palette      = &panel_palette[0][0];
+    *out_palette_size = sizeof(panel_palette) / sizeof(panel_palette[0]);
+    return ESP_OK;
+}
+
+// Fill a region of RGB888 pixels in CPU byte order: blue, green and red
+static void fill_rgb888(uint8_t* buffer, size_t pixels, uint8_t r, uint8_t g, uint8_t b) {
+    for (size_t i = 0; i < pixels; i++) {
+        buffer[i * 3]     = b;
+        buffer[i * 3 + 1] = g;
+        buffer[i * 3 + 2] = r;
+    }
+}
+
+// Value of a pixel of a buffer packed most significant bits first
+static uint8_t packed_pixel(uint8_t const* buffer, size_t stride, size_t bits, size_t x, size_t y) {
+    size_t bit = x * bits;
+    return (buffer[y * stride + bit / 8] >> (8 - bits - bit % 8)) & ((1 << bits) - 1);
+}
+
+// ============================================
+// Tests
+// ============================================
+
+// Colors of the panel end up as the pixel values of those colors, not as grey levels
+static void test_panel_colors(void) {
+    static const struct {
+        uint8_t r, g, b;
+        uint8_t index;
+    } colors[] = {
+        {0xFF, 0xFF, 0xFF, INDEX_WHITE},
+        {0x00, 0x00, 0x00, INDEX_BLACK},
+        {0xFF, 0x00, 0x00, INDEX_RED},
+    };
+    size_t stride = (H_RES * 2 + 7) / 8;
+    for (size_t i = 0; i < sizeof(colors) / sizeof(colors[0]); i++) {
+        for (bsp_display_dither_mode_t mode = BSP_DISPLAY_DITHER_NONE; mode <= BSP_DISPLAY_DITHER_FLOYD_STEINBERG;
+             mode++) {
+            mock_panel_reset();
+            fill_rgb888(source, PIXELS, colors[i].r, colors[i].g, colors[i].b);
+            CHECK_OK(bsp_display_blit_dithered(0, 0, H_RES, V_RES, source, BSP_DISPLAY_COLOR_FORMAT_24_888RGB, mode));
+            uint8_t const* memory = mock_panel_memory();
+            for (size_t y = 0; y < V_RES; y++) {
+                for (size_t x = 0; x < H_RES; x++) {
+                    CHECK(packed_pixel(memory, stride, 2, x, y) == colors[i].index);
+                }
+            }
+        }
+    }
+}
+
+// A palette display that does not report its palette is refused instead of receiving grey levels
+static void test_missing_palette(void) {
+    fill_rgb888(source, PIXELS, 0xFF, 0x00, 0x00);
+    palette_available = false;
+    CHECK_ESP(ESP_ERR_NOT_SUPPORTED, bsp_display_blit_dithered(0, 0, H_RES, V_RES, source,
+                                                               BSP_DISPLAY_COLOR_FORMAT_24_888RGB,
+                                                               BSP_DISPLAY_DITHER_NONE));
+    palette_available = true;
+}
+
+// Dithering a flat grey to one bit keeps the brightness of the image: the share of white pixels matches the grey level
+static void test_grey_mean(void) {
+    static const uint8_t levels[] = {0x20, 0x80, 0xC0};
+    size_t               stride   = (H_RES + 7) / 8;
+    for (size_t i = 0; i < sizeof(levels) / sizeof(levels[0]); i++) {
+        fill_rgb888(source, PIXELS, levels[i], levels[i], levels[i]);
+        for (bsp_display_dither_mode_t mode = BSP_DISPLAY_DITHER_ORDERED; mode <= BSP_DISPLAY_DITHER_FLOYD_STEINBERG;
+             mode++) {
+            bsp_display_dither_handle_t dither;
+            CHECK_OK(bsp_display_dither_create(BSP_DISPLAY_COLOR_FORMAT_1_GREY, BSP_DISPLAY_COLOR_FORMAT_24_888RGB,
+                                               H_RES, mode, NULL, 0, &dither));
+            size_t white = 0;
+            for (size_t y = 0; y < V_RES; y++) {
+                CHECK_OK(bsp_display_dither_row(dither, &packed[y * stride], &source[y * H_RES * 3]));
+                for (size_t x = 0; x < H_RES; x++) {
+                    white += packed_pixel(packed, stride, 1, x, y);
+                }
+            }
+            bsp_display_dither_delete(dither);
+            double mean = 255.0 * white / PIXELS;
+            CHECK(mean > levels[i] - 16 && mean < levels[i] + 16);
+        }
+    }
+}
+
+// ============================================
+// Benchmark
+// ============================================
+
+static char const* const mode_names[] = {"nearest", "ordered", "floyd-steinberg"};
+
+static double microseconds_per_frame(bsp_display_color_format_t dst_fmt, const uint8_t* palette, size_t palette_size,
+                                     size_t width, size_t height, bsp_display_dither_mode_t mode) {
+    bsp_display_dither_handle_t dither;
+    CHECK_OK(bsp_display_dither_create(dst_fmt, BSP_DISPLAY_COLOR_FORMAT_16_565RGB, width, mode, palette,
+                                       palette_size, &dither));
+    size_t  stride = (width * bsp_display_get_bits_per_pixel(dst_fmt) + 7) / 8;
+    int64_t start  = test_wall_time_us();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        bsp_display_dither_reset(dither);
+        for (size_t y = 0; y < height; y++) {
+            CHECK_OK(bsp_display_dither_row(dither, &packed[y * stride], &source[y * width * 2]));
+        }
+    }
+    int64_t elapsed = test_wall_time_us() - start;
+    bsp_display_dither_delete(dither);
+    return (double)elapsed / BENCH_ROUNDS;
+}
+
+static void test_benchmark(void) {
+    static const struct {
+        char const*                name;
+        bsp_display_color_format_t dst_fmt;
+        const uint8_t*             palette;
+        size_t                     palette_size;
+        size_t                     width;
+        size_t                     height;
+    } targets[] = {
+        {"kami 296x128 2 bit tri-color", BSP_DISPLAY_COLOR_FORMAT_2_PAL, &panel_palette[0][0], 3, 296, 128},
+        {"kami 296x128 2 bit grey", BSP_DISPLAY_COLOR_FORMAT_2_GREY, NULL, 0, 296, 128},
+        {"heltecv3 64x128 1 bit grey", BSP_DISPLAY_COLOR_FORMAT_1_GREY, NULL, 0, 64, 128},
+    };
+
+    uint32_t seed = 1;
+    for (size_t i = 0; i < PIXELS * 2; i++) {
+        seed      = seed * 1664525 + 1013904223;
+        source[i] = (uint8_t)(seed >> 24);
+    }
+
+    printf("  RGB565 source, us per frame\n");
+    for (size_t i = 0; i < sizeof(targets) / sizeof(targets[0]); i++) {
+        printf("    %-30s", targets[i].name);
+        for (bsp_display_dither_mode_t mode = BSP_DISPLAY_DITHER_NONE; mode <= BSP_DISPLAY_DITHER_FLOYD_STEINBERG;
+             mode++) {
+            double frame = microseconds_per_frame(targets[i].dst_fmt, targets[i].palette, targets[i].palette_size,
+                                                  targets[i].width, targets[i].height, mode);
+            printf(" %s %7.1f", mode_names[mode], frame);
+        }
+        printf("\n");
+    }
+}
+
+int main(void) {
+    mock_panel_config_t config = {
+        .h_res     = H_RES,
+        .v_res     = V_RES,
+        .color_fmt = BSP_DISPLAY_COLOR_FORMAT_2_PAL,
+    };
+    CHECK_OK(mock_panel_initialize(&config));
+
+    RUN_TEST(test_panel_colors);
+    RUN_TEST(test_missing_palette);
+    RUN_TEST(test_grey_mean);
+    RUN_TEST(test_benchmark);
+    return 0;
+}
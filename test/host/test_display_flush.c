@@ -0,0 +1,193 @@
+// Host tests: asynchronous blits and flush tracking on a mock panel
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "bsp/display.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "mock_panel.h"
+#include "test_support.h"
+
+#define H_RES        160
+#define V_RES        120
+#define FRAME_BYTES  (H_RES * V_RES * 2)
+#define BYTES_PER_MS (FRAME_BYTES / 4)  // A full frame takes 4 ms on the bus
+#define RENDER_US    4000               // Rendering a frame takes as long as sending it
+#define FRAMES       25
+#define WAIT_ROUNDS  20
+
+static uint16_t   frames[2][H_RES * V_RES];
+static atomic_int completed[2];
+static atomic_int completion_order[64];
+static atomic_int completion_count;
+static int64_t    render_started[FRAMES];
+
+static bool count_completion(void* user_ctx) {
+    int index                       = (int)(intptr_t)user_ctx;
+    int position                    = atomic_fetch_add(&completion_count, 1);
+    completion_order[position % 64] = index;
+    atomic_fetch_add(&completed[index % 2], 1);
+    return false;
+}
+
+// Stand-in for drawing a frame, the frame buffer must not be in flight
+static void render(uint16_t* frame, uint16_t value) {
+    test_busy_wait_us(RENDER_US);
+    for (size_t i = 0; i < H_RES * V_RES; i++) {
+        frame[i] = value;
+    }
+}
+
+static void test_callbacks_fire_in_submission_order(void) {
+    mock_panel_reset();
+    atomic_store(&completion_count, 0);
+    for (int i = 0; i < 8; i++) {
+        CHECK_OK(bsp_display_blit_async(0, i, H_RES, i + 1, frames[0], count_completion, (void*)(intptr_t)i));
+    }
+    CHECK_OK(bsp_display_blit_wait_idle(pdMS_TO_TICKS(1000)));
+    CHECK(atomic_load(&completion_count) == 8);
+    for (int i = 0; i < 8; i++) {
+        CHECK(completion_order[i] == i);
+    }
+}
+
+static void test_in_flight_depth_is_respected(void) {
+    mock_panel_reset();
+    for (int i = 0; i < 6; i++) {
+        CHECK_OK(bsp_display_blit_async(0, 0, H_RES, V_RES, frames[i % 2], NULL, NULL));
+    }
+    CHECK_OK(bsp_display_blit_wait_idle(pdMS_TO_TICKS(1000)));
+    CHECK(mock_panel_get_max_queued() == 2);
+}
+
+static void test_wait_idle_times_out(void) {
+    mock_panel_reset();
+    CHECK_OK(bsp_display_blit_async(0, 0, H_RES, V_RES, frames[0], NULL, NULL));
+    CHECK_ESP(ESP_ERR_TIMEOUT, bsp_display_blit_wait_idle(0));
+    CHECK_OK(bsp_display_blit_wait_idle(pdMS_TO_TICKS(1000)));
+}
+
+typedef struct {
+    SemaphoreHandle_t done;
+    esp_err_t         res;
+} wait_task_t;
+
+static void wait_task(void* arg) {
+    wait_task_t* task = arg;
+    task->res         = ESP_OK;
+    for (int i = 0; i < WAIT_ROUNDS && task->res == ESP_OK; i++) {
+        task->res = bsp_display_blit_async(0, 0, H_RES, V_RES / 2, frames[0], NULL, NULL);
+        if (task->res == ESP_OK) {
+            task->res = bsp_display_blit_wait_idle(pdMS_TO_TICKS(1000));
+        }
+    }
+    xSemaphoreGive(task->done);
+    vTaskDelete(NULL);
+}
+
+// Tasks waiting at the same time each see the display go idle instead of holding part of the slots each
+static void test_concurrent_wait_idle(void) {
+    mock_panel_reset();
+    wait_task_t tasks[2];
+    for (size_t i = 0; i < 2; i++) {
+        tasks[i].done = xSemaphoreCreateBinary();
+        CHECK(tasks[i].done != NULL);
+        CHECK(xTaskCreate(wait_task, "wait", 4096, &tasks[i], 5, NULL) == pdPASS);
+    }
+    for (size_t i = 0; i < 2; i++) {
+        CHECK(xSemaphoreTake(tasks[i].done, pdMS_TO_TICKS(10000)) == pdTRUE);
+        vSemaphoreDelete(tasks[i].done);
+        CHECK_OK(tasks[i].res);
+    }
+}
+
+// The old pipeline: every blit waits for the previous transfer before the next frame is rendered
+static int64_t run_synchronous(void) {
+    mock_panel_reset();
+    int64_t start = test_wall_time_us();
+    for (int i = 0; i < FRAMES; i++) {
+        render(frames[0], (uint16_t)i);
+        CHECK_OK(bsp_display_blit(0, 0, H_RES, V_RES, frames[0]));
+        CHECK_OK(bsp_display_blit_wait_idle(pdMS_TO_TICKS(1000)));
+    }
+    return test_wall_time_us() - start;
+}
+
+// Double buffered: frame N+1 is rendered into the other buffer while frame N is on the bus
+static int64_t run_asynchronous(void) {
+    mock_panel_reset();
+    atomic_store(&completed[0], 0);
+    atomic_store(&completed[1], 0);
+    int     submitted[2] = {0, 0};
+    int64_t start        = test_wall_time_us();
+    for (int i = 0; i < FRAMES; i++) {
+        int buffer = i % 2;
+        // Only render into a buffer after the panel is done with it
+        while (atomic_load(&completed[buffer]) < submitted[buffer]) {
+        }
+        render_started[i] = test_wall_time_us();
+        render(frames[buffer], (uint16_t)i);
+        CHECK_OK(bsp_display_blit_async(0, 0, H_RES, V_RES, frames[buffer], count_completion,
+                                        (void*)(intptr_t)buffer));
+        submitted[buffer]++;
+    }
+    CHECK_OK(bsp_display_blit_wait_idle(pdMS_TO_TICKS(1000)));
+    return test_wall_time_us() - start;
+}
+
+static void test_rendering_overlaps_transfers(void) {
+    int64_t synchronous  = run_synchronous();
+    int64_t asynchronous = run_asynchronous();
+
+    mock_panel_transfer_t const* transfers;
+    size_t                       count = mock_panel_get_transfers(&transfers);
+    CHECK(count == FRAMES);
+
+    // A frame is rendered while the previous frame is still on the bus
+    size_t overlapping = 0;
+    for (size_t i = 1; i < count; i++) {
+        if (render_started[i] < transfers[i - 1].finished) {
+            overlapping++;
+        }
+    }
+
+    // The panel shows the last frame, no buffer was overwritten while in flight
+    uint16_t const* memory = (uint16_t const*)mock_panel_memory();
+    CHECK(memory[0] == FRAMES - 1 && memory[H_RES * V_RES - 1] == FRAMES - 1);
+
+    double sync_fps  = FRAMES * 1e6 / synchronous;
+    double async_fps = FRAMES * 1e6 / asynchronous;
+    printf("  synchronous:  %6.1f fps (%lld us for %d frames)\n", sync_fps, (long long)synchronous, FRAMES);
+    printf("  asynchronous: %6.1f fps (%lld us for %d frames), %zu of %zu frames rendered during a transfer\n",
+           async_fps, (long long)asynchronous, FRAMES, overlapping, count - 1);
+    printf("  throughput gain: %.2fx\n", async_fps / sync_fps);
+
+    CHECK(overlapping >= (count - 1) / 2);
+    // Render and transfer take equally long, overlapping them should nearly double the frame rate
+    CHECK(async_fps > sync_fps * 1.3);
+}
+
+int main(void) {
+    mock_panel_config_t config = {
+        .h_res               = H_RES,
+        .v_res               = V_RES,
+        .color_fmt           = BSP_DISPLAY_COLOR_FORMAT_16_565RGB,
+        .data_endian         = BSP_DISPLAY_ENDIAN_LITTLE,
+        .max_blits_in_flight = 2,
+        .bytes_per_ms        = BYTES_PER_MS,
+    };
+    CHECK_OK(mock_panel_initialize(&config));
+
+    RUN_TEST(test_callbacks_fire_in_submission_order);
+    RUN_TEST(test_in_flight_depth_is_respected);
+    RUN_TEST(test_wait_idle_times_out);
+    RUN_TEST(test_concurrent_wait_idle);
+    RUN_TEST(test_rendering_overlaps_transfers);
+    return 0;
+}
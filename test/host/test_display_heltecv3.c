@@ -0,0 +1,256 @@
+// Host tests: heltecv3 SSD1306 page diffing and frame rate cap against a simulated panel on a 400 kHz I2C bus
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "bsp/display.h"
+#include "bsp/i2c.h"
+#include "driver/gpio.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_lcd_panel_vendor.h"
+#include "test_support.h"
+
+#define H_RES        64   // Portrait resolution as seen by the graphics stack
+#define V_RES        128  // One column of the SSD1306 per row
+#define PAGES        (H_RES / 8)
+#define FRAME_BYTES  (V_RES * PAGES)
+#define US_PER_BYTE  23  // 9 bits per byte at 400 kHz
+#define MAX_WINDOWS  4096
+#define MIN_INTERVAL 20000
+
+// Called by the device initialization, not part of the public API
+esp_err_t bsp_display_initialize(bsp_display_configuration_t const* configuration);
+
+// ============================================
+// Simulated SSD1306 in vertical addressing mode
+// ============================================
+
+typedef struct {
+    int64_t start;
+    int64_t end;
+    size_t  bytes;
+} window_t;
+
+static pthread_mutex_t panel_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint8_t         ram[PAGES][V_RES];
+static window_t        windows[MAX_WINDOWS];
+static size_t          num_windows;
+static size_t          bytes_sent;
+
+esp_err_t bsp_i2c_primary_bus_get_handle(i2c_master_bus_handle_t* handle) {
+    *handle = NULL;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_new_panel_io_i2c(i2c_master_bus_handle_t bus, esp_lcd_panel_io_i2c_config_t const* io_config,
+                                   esp_lcd_panel_io_handle_t* ret_io) {
+    (void)bus;
+    CHECK(io_config->scl_speed_hz == 400 * 1000);
+    *ret_io = (esp_lcd_panel_io_handle_t)1;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_io_tx_param(esp_lcd_panel_io_handle_t io, int lcd_cmd, void const* param, size_t param_size) {
+    (void)io;
+    if (lcd_cmd == 0x20) {
+        CHECK(param_size == 1 && ((uint8_t const*)param)[0] == 0x01);  // Vertical addressing mode
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_new_panel_ssd1306(esp_lcd_panel_io_handle_t io, esp_lcd_panel_dev_config_t const* panel_dev_config,
+                                    esp_lcd_panel_handle_t* ret_panel) {
+    (void)io;
+    CHECK(panel_dev_config->bits_per_pixel == 1);
+    *ret_panel = (esp_lcd_panel_handle_t)1;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_reset(esp_lcd_panel_handle_t panel) {
+    (void)panel;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_init(esp_lcd_panel_handle_t panel) {
+    (void)panel;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_disp_on_off(esp_lcd_panel_handle_t panel, bool on_off) {
+    (void)panel;
+    (void)on_off;
+    return ESP_OK;
+}
+
+esp_err_t gpio_config(gpio_config_t const* config) {
+    (void)config;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level) {
+    (void)gpio_num;
+    (void)level;
+    return ESP_OK;
+}
+
+// Columns x_start up to x_end of pages y_start / 8 up to y_end / 8, the pages of each column back to back
+esp_err_t esp_lcd_panel_draw_bitmap(esp_lcd_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end,
+                                    void const* color_data) {
+    (void)panel;
+    CHECK(y_start % 8 == 0 && y_end % 8 == 0 && x_start < x_end && x_end <= V_RES && y_end <= H_RES);
+    size_t         first_page = y_start / 8;
+    size_t         num_pages  = (y_end - y_start) / 8;
+    size_t         bytes      = (x_end - x_start) * num_pages;
+    uint8_t const* data       = color_data;
+
+    int64_t start = test_wall_time_us();
+    test_busy_wait_us(bytes * US_PER_BYTE + 100);  // Transaction overhead on top of the data
+    pthread_mutex_lock(&panel_lock);
+    for (int column = x_start; column < x_end; column++) {
+        for (size_t page = 0; page < num_pages; page++) {
+            ram[first_page + page][column] = *data++;
+        }
+    }
+    if (num_windows < MAX_WINDOWS) {
+        windows[num_windows++] = (window_t){.start = start, .end = test_wall_time_us(), .bytes = bytes};
+    }
+    bytes_sent += bytes;
+    pthread_mutex_unlock(&panel_lock);
+    return ESP_OK;
+}
+
+// Compare rows first_row up to last_row of a frame with the columns of the display RAM showing them
+static bool panel_shows(uint8_t const* frame, size_t first_row, size_t last_row) {
+    pthread_mutex_lock(&panel_lock);
+    bool equal = true;
+    for (size_t column = first_row; column < last_row && equal; column++) {
+        for (size_t page = 0; page < PAGES && equal; page++) {
+            equal = ram[page][column] == frame[column * PAGES + page];
+        }
+    }
+    pthread_mutex_unlock(&panel_lock);
+    return equal;
+}
+
+static void wait_for_panel(uint8_t const* frame, size_t first_row, size_t last_row) {
+    int64_t deadline = test_wall_time_us() + 500000;
+    while (!panel_shows(frame, first_row, last_row)) {
+        CHECK(test_wall_time_us() < deadline);
+        vTaskDelay(1);
+    }
+}
+
+static void panel_reset_records(void) {
+    pthread_mutex_lock(&panel_lock);
+    num_windows = 0;
+    bytes_sent  = 0;
+    pthread_mutex_unlock(&panel_lock);
+}
+
+// ============================================
+// Tests
+// ============================================
+
+static uint8_t frame[FRAME_BYTES];
+
+static void set_pixel(size_t x, size_t y, bool on) {
+    uint8_t mask = 0x80 >> (x % 8);
+    if (on) {
+        frame[y * PAGES + x / 8] |= mask;
+    } else {
+        frame[y * PAGES + x / 8] &= ~mask;
+    }
+}
+
+// A UI like frame: a static border, a moving 6x6 box and a changing counter bar
+static void draw_frame(int index) {
+    memset(frame, 0, sizeof(frame));
+    for (size_t y = 0; y < V_RES; y++) {
+        set_pixel(0, y, true);
+        set_pixel(H_RES - 1, y, true);
+    }
+    size_t box_x = 4 + (index * 3) % (H_RES - 14);
+    size_t box_y = 20 + (index * 2) % 40;
+    for (size_t y = box_y; y < box_y + 6; y++) {
+        for (size_t x = box_x; x < box_x + 6; x++) {
+            set_pixel(x, y, true);
+        }
+    }
+    for (size_t x = 8; x < 8 + (size_t)(index % 48); x++) {
+        set_pixel(x, 120, true);
+    }
+}
+
+static void test_frames_are_identical(void) {
+    // The first frame is sent in full, the display RAM is unknown until then
+    draw_frame(0);
+    CHECK_OK(bsp_display_blit(0, 0, H_RES, V_RES, frame));
+    wait_for_panel(frame, 0, V_RES);
+    panel_reset_records();
+
+    int const frames = 40;
+    for (int i = 1; i <= frames; i++) {
+        draw_frame(i);
+        CHECK_OK(bsp_display_blit(0, 0, H_RES, V_RES, frame));
+        wait_for_panel(frame, 0, V_RES);
+    }
+
+    pthread_mutex_lock(&panel_lock);
+    size_t sent = bytes_sent;
+    size_t sends = num_windows;
+    pthread_mutex_unlock(&panel_lock);
+    size_t full = (size_t)frames * FRAME_BYTES;
+    printf("  %d frames: %zu bytes in %zu windows instead of %zu bytes, %.1f%% saved, %.1f ms instead of %.1f ms of "
+           "bus time per frame\n",
+           frames, sent, sends, full, 100.0 * (full - sent) / full, sent * US_PER_BYTE / 1000.0 / frames,
+           FRAME_BYTES * US_PER_BYTE / 1000.0);
+    CHECK(sent * 4 < full);
+}
+
+static void test_blits_never_wait_for_the_bus(void) {
+    panel_reset_records();
+
+    // An application updating a small region far more often than the display can follow
+    int64_t start        = test_wall_time_us();
+    int64_t longest_blit = 0;
+    int     blits        = 0;
+    while (test_wall_time_us() - start < 300000) {
+        draw_frame(blits);
+        int64_t blit_start = test_wall_time_us();
+        CHECK_OK(bsp_display_blit(0, 112, H_RES, V_RES, &frame[112 * PAGES]));
+        int64_t duration = test_wall_time_us() - blit_start;
+        longest_blit     = duration > longest_blit ? duration : longest_blit;
+        blits++;
+        test_busy_wait_us(500);
+    }
+    int64_t elapsed = test_wall_time_us() - start;
+    wait_for_panel(frame, 112, V_RES);
+
+    pthread_mutex_lock(&panel_lock);
+    size_t  flushes      = num_windows;
+    int64_t min_interval = INT64_MAX;
+    for (size_t i = 1; i < num_windows; i++) {
+        int64_t interval = windows[i].start - windows[i - 1].start;
+        min_interval     = interval < min_interval ? interval : min_interval;
+    }
+    pthread_mutex_unlock(&panel_lock);
+
+    printf("  %d blits in %lld ms sent as %zu transfers, closest transfers %lld us apart, longest blit %lld us\n",
+           blits, (long long)elapsed / 1000, flushes, (long long)min_interval, (long long)longest_blit);
+    CHECK(flushes <= (size_t)(elapsed / MIN_INTERVAL) + 2);
+    CHECK(min_interval >= MIN_INTERVAL - 1000);  // Ticks are a millisecond
+    CHECK(longest_blit < 5000);                   // No blit waits for the frame interval or the bus
+}
+
+int main(void) {
+    CHECK_OK(bsp_display_initialize(NULL));
+
+    RUN_TEST(test_frames_are_identical);
+    RUN_TEST(test_blits_never_wait_for_the_bus);
+    return 0;
+}
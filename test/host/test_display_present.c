@@ -0,0 +1,221 @@
+// Host tests: frame pacing of bsp_display_present against a simulated tearing effect (TE) source
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "badge_bsp_display_present.h"
+#include "bsp/display.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "host_idf.h"
+#include "test_support.h"
+
+#define TE_PERIOD_US 16667  // 60 Hz panel refresh
+#define MAX_RECORDS  256
+#define FRAMES       60
+
+// ============================================
+// Simulated panel and TE source
+// ============================================
+
+// Everything runs on the simulated clock: rendering advances it, and waiting for a vsync lets it pass until the TE
+// timer fires, so the timings below are exact
+
+static esp_timer_handle_t te_timer;
+static bool               te_enabled;
+static int64_t            te_edges[MAX_RECORDS];
+static size_t             te_count;
+static int64_t            blits[MAX_RECORDS];  // Times the frames were handed to the panel
+static size_t             blit_count;
+
+static void te_callback(void* arg) {
+    (void)arg;
+    if (te_count < MAX_RECORDS) {
+        te_edges[te_count++] = esp_timer_get_time();
+    }
+    host_isr_enter();
+    bsp_display_present_vsync_from_isr();
+    host_isr_exit();
+}
+
+esp_err_t bsp_display_blit(size_t x_start, size_t y_start, size_t x_end, size_t y_end, const void* buffer) {
+    (void)x_start;
+    (void)y_start;
+    (void)x_end;
+    (void)y_end;
+    (void)buffer;
+    if (blit_count < MAX_RECORDS) {
+        blits[blit_count++] = esp_timer_get_time();
+    }
+    return ESP_OK;
+}
+
+static void te_set_enabled(bool enabled) {
+    if (enabled && !te_enabled) {
+        CHECK_OK(esp_timer_start_periodic(te_timer, TE_PERIOD_US));
+        host_clock_advance(3 * TE_PERIOD_US);  // Let the pacing see the TE source and measure its period
+    } else if (!enabled && te_enabled) {
+        CHECK_OK(esp_timer_stop(te_timer));
+        host_clock_advance(150000);  // A stopped TE source is noticed after 100 ms
+    }
+    te_enabled = enabled;
+    te_count   = 0;
+}
+
+// Time between a blit and the latest TE edge before it, -1 if there was none
+static int64_t since_te_edge(int64_t time) {
+    for (size_t i = te_count; i > 0; i--) {
+        if (te_edges[i - 1] <= time) {
+            return time - te_edges[i - 1];
+        }
+    }
+    return -1;
+}
+
+// ============================================
+// Frame loop
+// ============================================
+
+typedef struct {
+    int64_t min;
+    int64_t max;
+    int64_t mean;
+} intervals_t;
+
+// Present FRAMES frames, each taking render_us to draw, and measure the time between the blits
+static intervals_t present_frames(int64_t render_us) {
+    // One frame to start the schedule, the measurements cover the frames after it
+    CHECK_OK(bsp_display_present(0, 0, 1, 1, NULL));
+    bsp_display_reset_frame_stats();
+    blit_count = 0;
+
+    for (int i = 0; i < FRAMES; i++) {
+        host_clock_advance(render_us);
+        CHECK_OK(bsp_display_present(0, 0, 1, 1, NULL));
+    }
+
+    CHECK(blit_count == FRAMES);
+    intervals_t result = {.min = INT64_MAX, .max = 0};
+    for (size_t i = 1; i < blit_count; i++) {
+        int64_t interval = blits[i] - blits[i - 1];
+        result.min       = interval < result.min ? interval : result.min;
+        result.max       = interval > result.max ? interval : result.max;
+    }
+    result.mean = (blits[blit_count - 1] - blits[0]) / (int64_t)(blit_count - 1);
+    return result;
+}
+
+static bsp_display_frame_stats_t report(char const* name, intervals_t intervals) {
+    bsp_display_frame_stats_t stats;
+    CHECK_OK(bsp_display_get_frame_stats(&stats));
+    printf("  %s: frame time %lld us mean, %lld..%lld us, %lu frames, %lu missed vsyncs, %llu us waited\n", name,
+           (long long)intervals.mean, (long long)intervals.min, (long long)intervals.max, (unsigned long)stats.frames,
+           (unsigned long)stats.missed_vsyncs, (unsigned long long)stats.wait_time_us);
+    CHECK(stats.frames == FRAMES);
+    return stats;
+}
+
+// ============================================
+// Tests
+// ============================================
+
+static void test_paced_by_interval_without_te(void) {
+    te_set_enabled(false);
+    CHECK_OK(bsp_display_set_frame_interval(20000));
+    intervals_t               intervals = present_frames(3000);
+    bsp_display_frame_stats_t stats     = report("50 fps without TE", intervals);
+
+    // Sleeping whole ticks makes a frame late by less than a tick, the next one is due on the schedule again so the
+    // lateness does not add up
+    CHECK(intervals.min >= 20000 - 1000 && intervals.max <= 20000 + 1000);
+    CHECK(intervals.mean >= 19950 && intervals.mean <= 20050);
+    CHECK(stats.missed_vsyncs == 0);
+}
+
+static void test_blits_start_at_te(void) {
+    te_set_enabled(true);
+    CHECK_OK(bsp_display_set_frame_interval(0));
+    intervals_t               intervals = present_frames(3000);
+    bsp_display_frame_stats_t stats     = report("every vsync", intervals);
+
+    for (size_t i = 0; i < blit_count; i++) {
+        CHECK(since_te_edge(blits[i]) == 0);
+    }
+    CHECK(intervals.min == TE_PERIOD_US && intervals.max == TE_PERIOD_US);
+    CHECK(stats.missed_vsyncs == 0);
+}
+
+static void test_interval_selects_every_other_te(void) {
+    te_set_enabled(true);
+    CHECK_OK(bsp_display_set_frame_interval(2 * TE_PERIOD_US));
+    intervals_t               intervals = present_frames(3000);
+    bsp_display_frame_stats_t stats     = report("30 fps on a 60 Hz panel", intervals);
+
+    for (size_t i = 0; i < blit_count; i++) {
+        CHECK(since_te_edge(blits[i]) == 0);
+    }
+    CHECK(intervals.min == 2 * TE_PERIOD_US && intervals.max == 2 * TE_PERIOD_US);
+    CHECK(stats.missed_vsyncs == 0);
+}
+
+static void test_slow_frames_count_missed_vsyncs(void) {
+    te_set_enabled(true);
+    CHECK_OK(bsp_display_set_frame_interval(0));
+    // Rendering takes longer than a panel refresh, every frame waits for the vsync after the one it was due at
+    intervals_t               intervals = present_frames(TE_PERIOD_US + 3000);
+    bsp_display_frame_stats_t stats     = report("slow frames", intervals);
+
+    CHECK(intervals.min == 2 * TE_PERIOD_US && intervals.max == 2 * TE_PERIOD_US);
+    CHECK(stats.missed_vsyncs == FRAMES);
+}
+
+static void test_recent_te_is_used_as_is(void) {
+    te_set_enabled(true);
+    CHECK_OK(bsp_display_set_frame_interval(0));
+    CHECK_OK(bsp_display_present(0, 0, 1, 1, NULL));
+
+    // A frame that becomes ready within a millisecond of a vsync is presented right away
+    host_clock_advance(TE_PERIOD_US + 500);
+    blit_count = 0;
+    CHECK_OK(bsp_display_present(0, 0, 1, 1, NULL));
+    CHECK(blit_count == 1 && since_te_edge(blits[0]) == 500);
+
+    // Later than that it waits for the next one
+    host_clock_advance(TE_PERIOD_US - 500 + 2000);
+    CHECK_OK(bsp_display_present(0, 0, 1, 1, NULL));
+    CHECK(blit_count == 2 && since_te_edge(blits[1]) == 0 && blits[1] - blits[0] == 2 * TE_PERIOD_US - 500);
+}
+
+static void test_stopped_te_does_not_block(void) {
+    te_set_enabled(true);
+    CHECK_OK(bsp_display_set_frame_interval(0));
+    CHECK_OK(bsp_display_present(0, 0, 1, 1, NULL));
+
+    te_set_enabled(false);
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < 10; i++) {
+        CHECK_OK(bsp_display_present(0, 0, 1, 1, NULL));
+    }
+    CHECK(esp_timer_get_time() == start);
+}
+
+int main(void) {
+    host_clock_set_simulated(1000000);
+    esp_timer_create_args_t timer_args = {
+        .callback        = te_callback,
+        .dispatch_method = ESP_TIMER_ISR,
+        .name            = "TE",
+    };
+    CHECK_OK(esp_timer_create(&timer_args, &te_timer));
+
+    RUN_TEST(test_paced_by_interval_without_te);
+    RUN_TEST(test_blits_start_at_te);
+    RUN_TEST(test_interval_selects_every_other_te);
+    RUN_TEST(test_slow_frames_count_missed_vsyncs);
+    RUN_TEST(test_recent_te_is_used_as_is);
+    RUN_TEST(test_stopped_te_does_not_block);
+    return 0;
+}
@@ -0,0 +1,274 @@
+// Host tests: software rotation fallback of bsp_display_blit_rotated against a reference rotation, with a benchmark
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "bsp/display.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "mock_panel.h"
+#include "test_support.h"
+
+// The mock panel is a 320x240 RGB565 panel, the resolution of mch2022 and hackaday2025
+#define H_RES        320
+#define V_RES        240
+#define PIXELS       (H_RES * V_RES)
+#define BENCH_ROUNDS 50
+#define TASK_ROUNDS  20
+
+// Memory the software rotation needs instead of a rotated framebuffer: two staging buffers of eight rows
+#define STAGING_BYTES (2 * H_RES * 8 * 2)
+
+static uint8_t source[PIXELS * 4];
+static uint8_t converted[PIXELS * 2];
+static uint8_t framebuffer[PIXELS * 2];
+
+static char const* const rotation_names[] = {"0", "90", "180", "270"};
+
+static void fill_random(uint8_t* buffer, size_t length, uint32_t seed) {
+    for (size_t i = 0; i < length; i++) {
+        seed      = seed * 1664525 + 1013904223;
+        buffer[i] = (uint8_t)(seed >> 24);
+    }
+}
+
+// ============================================
+// Reference rotation, one pixel at a time
+// ============================================
+
+// Panel coordinates of pixel (x, y) of the display rotated clockwise by the rotation
+static void reference_map(bsp_display_rotation_t rotation, size_t x, size_t y, size_t* out_x, size_t* out_y) {
+    switch (rotation) {
+        case BSP_DISPLAY_ROTATION_90:
+            *out_x = H_RES - 1 - y;
+            *out_y = x;
+            break;
+        case BSP_DISPLAY_ROTATION_180:
+            *out_x = H_RES - 1 - x;
+            *out_y = V_RES - 1 - y;
+            break;
+        case BSP_DISPLAY_ROTATION_270:
+            *out_x = y;
+            *out_y = V_RES - 1 - x;
+            break;
+        default:
+            *out_x = x;
+            *out_y = y;
+            break;
+    }
+}
+
+// Rotate a region of RGB565 pixels into a full panel framebuffer the way applications do it today
+__attribute__((noinline)) static void reference_rotate(uint8_t* dst, uint8_t const* src, size_t x_start,
+                                                       size_t y_start, size_t x_end, size_t y_end,
+                                                       bsp_display_rotation_t rotation) {
+    size_t width = x_end - x_start;
+    for (size_t y = y_start; y < y_end; y++) {
+        for (size_t x = x_start; x < x_end; x++) {
+            size_t panel_x, panel_y;
+            reference_map(rotation, x, y, &panel_x, &panel_y);
+            memcpy(&dst[(panel_y * H_RES + panel_x) * 2], &src[((y - y_start) * width + (x - x_start)) * 2], 2);
+        }
+    }
+}
+
+// ============================================
+// Tests
+// ============================================
+
+// Rotate a region and compare every pixel of the panel with the reference, pixels outside the region stay cleared
+static void check_rotation(size_t x_start, size_t y_start, size_t x_end, size_t y_end,
+                           bsp_display_color_format_t src_fmt, bsp_display_rotation_t rotation) {
+    size_t pixels = (x_end - x_start) * (y_end - y_start);
+    fill_random(source, pixels * 4, (uint32_t)(x_start * 7 + y_end * 13 + rotation));
+    uint8_t const* pixels_565 = source;
+    if (src_fmt != BSP_DISPLAY_COLOR_FORMAT_16_565RGB) {
+        CHECK_OK(bsp_display_convert(converted, BSP_DISPLAY_COLOR_FORMAT_16_565RGB, BSP_DISPLAY_ENDIAN_LITTLE, source,
+                                     src_fmt, pixels));
+        pixels_565 = converted;
+    }
+    memset(framebuffer, 0, sizeof(framebuffer));
+    reference_rotate(framebuffer, pixels_565, x_start, y_start, x_end, y_end, rotation);
+
+    mock_panel_reset();
+    CHECK_OK(bsp_display_blit_rotated(x_start, y_start, x_end, y_end, source, src_fmt, rotation));
+    CHECK_OK(bsp_display_blit_wait_idle(pdMS_TO_TICKS(1000)));
+    if (memcmp(mock_panel_memory(), framebuffer, sizeof(framebuffer)) != 0) {
+        fprintf(stderr, "  rotation %s of region %zu,%zu..%zu,%zu differs from the reference\n",
+                rotation_names[rotation], x_start, y_start, x_end, y_end);
+        CHECK(false);
+    }
+}
+
+static void test_full_screen(void) {
+    for (bsp_display_rotation_t rotation = BSP_DISPLAY_ROTATION_0; rotation <= BSP_DISPLAY_ROTATION_270; rotation++) {
+        bool   portrait = rotation == BSP_DISPLAY_ROTATION_90 || rotation == BSP_DISPLAY_ROTATION_270;
+        size_t width    = portrait ? V_RES : H_RES;
+        size_t height   = portrait ? H_RES : V_RES;
+        check_rotation(0, 0, width, height, BSP_DISPLAY_COLOR_FORMAT_16_565RGB, rotation);
+    }
+}
+
+static void test_partial_regions(void) {
+    // Regions smaller than a tile, not a multiple of the tile size, touching every edge and a single pixel
+    static size_t const regions[][4] = {
+        {0, 0, 1, 1}, {5, 3, 17, 9}, {31, 2, 97, 45}, {100, 50, 240, 200}, {0, 100, 33, 240}, {200, 0, 240, 1},
+    };
+    for (bsp_display_rotation_t rotation = BSP_DISPLAY_ROTATION_0; rotation <= BSP_DISPLAY_ROTATION_270; rotation++) {
+        for (size_t i = 0; i < sizeof(regions) / sizeof(regions[0]); i++) {
+            check_rotation(regions[i][0], regions[i][1], regions[i][2], regions[i][3],
+                           BSP_DISPLAY_COLOR_FORMAT_16_565RGB, rotation);
+        }
+    }
+}
+
+static void test_rotate_and_convert(void) {
+    for (bsp_display_rotation_t rotation = BSP_DISPLAY_ROTATION_0; rotation <= BSP_DISPLAY_ROTATION_270; rotation++) {
+        check_rotation(10, 20, 130, 140, BSP_DISPLAY_COLOR_FORMAT_24_888RGB, rotation);
+        check_rotation(0, 0, 240, 240, BSP_DISPLAY_COLOR_FORMAT_24_888RGB, rotation);
+    }
+}
+
+// A task rotating one half of the display while another task rotates the other half
+typedef struct {
+    size_t                     y_start;
+    size_t                     y_end;
+    bsp_display_color_format_t src_fmt;
+    uint8_t const*             src;
+    SemaphoreHandle_t          done;
+    esp_err_t                  res;
+    int                        mismatches;  // Rounds after which the half of the panel differed from the reference
+} rotate_task_t;
+
+// Rotated by 90 degrees, the rows of the half are columns of the panel
+static bool rotate_task_matches(rotate_task_t const* task) {
+    size_t x_start = H_RES - task->y_end;
+    size_t length  = (task->y_end - task->y_start) * 2;
+    for (size_t y = 0; y < V_RES; y++) {
+        size_t offset = (y * H_RES + x_start) * 2;
+        if (memcmp(&mock_panel_memory()[offset], &framebuffer[offset], length) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void rotate_task(void* arg) {
+    rotate_task_t* task = arg;
+    task->res           = ESP_OK;
+    for (int round = 0; round < TASK_ROUNDS && task->res == ESP_OK; round++) {
+        task->res = bsp_display_blit_rotated(0, task->y_start, V_RES, task->y_end, task->src, task->src_fmt,
+                                             BSP_DISPLAY_ROTATION_90);
+        if (task->res == ESP_OK) {
+            task->res = bsp_display_blit_wait_idle(pdMS_TO_TICKS(1000));
+        }
+        task->mismatches += !rotate_task_matches(task);
+    }
+    xSemaphoreGive(task->done);
+    vTaskDelete(NULL);
+}
+
+// Tasks converting pixels while they rotate do not share the buffer the pixels are rotated into
+static void test_concurrent_tasks(void) {
+    size_t        half     = H_RES / 2 * V_RES;
+    rotate_task_t tasks[2] = {
+        {.y_start = 0, .y_end = H_RES / 2, .src_fmt = BSP_DISPLAY_COLOR_FORMAT_24_888RGB, .src = source},
+        {.y_start = H_RES / 2, .y_end = H_RES, .src_fmt = BSP_DISPLAY_COLOR_FORMAT_24_888RGB, .src = &source[half * 3]},
+    };
+    fill_random(source, sizeof(source), 7);
+    memset(framebuffer, 0, sizeof(framebuffer));
+    for (size_t i = 0; i < 2; i++) {
+        CHECK_OK(bsp_display_convert(&converted[i * half * 2], BSP_DISPLAY_COLOR_FORMAT_16_565RGB,
+                                     BSP_DISPLAY_ENDIAN_LITTLE, tasks[i].src, tasks[i].src_fmt, half));
+        reference_rotate(framebuffer, &converted[i * half * 2], 0, tasks[i].y_start, V_RES, tasks[i].y_end,
+                         BSP_DISPLAY_ROTATION_90);
+    }
+
+    mock_panel_reset();
+    for (size_t i = 0; i < 2; i++) {
+        tasks[i].done = xSemaphoreCreateBinary();
+        CHECK(tasks[i].done != NULL);
+        CHECK(xTaskCreate(rotate_task, "rotate", 4096, &tasks[i], 5, NULL) == pdPASS);
+    }
+    for (size_t i = 0; i < 2; i++) {
+        CHECK(xSemaphoreTake(tasks[i].done, pdMS_TO_TICKS(10000)) == pdTRUE);
+        vSemaphoreDelete(tasks[i].done);
+        CHECK_OK(tasks[i].res);
+        CHECK(tasks[i].mismatches == 0);
+    }
+}
+
+static void test_invalid_arguments(void) {
+    CHECK_ESP(ESP_ERR_INVALID_ARG, bsp_display_blit_rotated(0, 0, 10, 10, NULL, BSP_DISPLAY_COLOR_FORMAT_16_565RGB,
+                                                            BSP_DISPLAY_ROTATION_90));
+    CHECK_ESP(ESP_ERR_INVALID_ARG, bsp_display_blit_rotated(10, 0, 10, 10, source, BSP_DISPLAY_COLOR_FORMAT_16_565RGB,
+                                                            BSP_DISPLAY_ROTATION_0));
+    // A landscape region does not fit the display rotated to portrait
+    CHECK_ESP(ESP_ERR_INVALID_ARG, bsp_display_blit_rotated(0, 0, H_RES, V_RES, source,
+                                                            BSP_DISPLAY_COLOR_FORMAT_16_565RGB,
+                                                            BSP_DISPLAY_ROTATION_90));
+    CHECK_ESP(ESP_ERR_NOT_SUPPORTED, bsp_display_blit_rotated(0, 0, 8, 8, source, BSP_DISPLAY_COLOR_FORMAT_1_GREY,
+                                                              BSP_DISPLAY_ROTATION_0));
+}
+
+// ============================================
+// Benchmark
+// ============================================
+
+// Microseconds of CPU time to rotate and send a full screen frame, the panel transfers instantly
+static double microseconds_per_frame(bsp_display_rotation_t rotation, bool reference) {
+    bool   portrait = rotation == BSP_DISPLAY_ROTATION_90 || rotation == BSP_DISPLAY_ROTATION_270;
+    size_t width    = portrait ? V_RES : H_RES;
+    size_t height   = portrait ? H_RES : V_RES;
+
+    int64_t start = 0;
+    for (int i = -1; i < BENCH_ROUNDS; i++) {
+        if (i == 0) {
+            start = test_wall_time_us();  // The first round warms up the caches
+        }
+        if (reference) {
+            reference_rotate(framebuffer, source, 0, 0, width, height, rotation);
+            CHECK_OK(bsp_display_blit(0, 0, H_RES, V_RES, framebuffer));
+        } else {
+            CHECK_OK(bsp_display_blit_rotated(0, 0, width, height, source, BSP_DISPLAY_COLOR_FORMAT_16_565RGB,
+                                              rotation));
+        }
+    }
+    CHECK_OK(bsp_display_blit_wait_idle(pdMS_TO_TICKS(1000)));
+    int64_t elapsed = test_wall_time_us() - start;
+    return (double)elapsed / BENCH_ROUNDS;
+}
+
+static void test_benchmark(void) {
+    fill_random(source, PIXELS * 2, 1);
+    printf("  %dx%d RGB565, us per frame rotating into a %d byte framebuffer vs rotating into %d bytes of strips\n",
+           H_RES, V_RES, PIXELS * 2, STAGING_BYTES);
+    for (bsp_display_rotation_t rotation = BSP_DISPLAY_ROTATION_0; rotation <= BSP_DISPLAY_ROTATION_270; rotation++) {
+        double reference = microseconds_per_frame(rotation, true);
+        double strips    = microseconds_per_frame(rotation, false);
+        printf("    %3s degrees: %6.1f vs %6.1f us\n", rotation_names[rotation], reference, strips);
+    }
+}
+
+int main(void) {
+    mock_panel_config_t config = {
+        .h_res               = H_RES,
+        .v_res               = V_RES,
+        .color_fmt           = BSP_DISPLAY_COLOR_FORMAT_16_565RGB,
+        .data_endian         = BSP_DISPLAY_ENDIAN_LITTLE,
+        .max_blits_in_flight = 2,
+    };
+    CHECK_OK(mock_panel_initialize(&config));
+
+    RUN_TEST(test_full_screen);
+    RUN_TEST(test_partial_regions);
+    RUN_TEST(test_rotate_and_convert);
+    RUN_TEST(test_concurrent_tasks);
+    RUN_TEST(test_invalid_arguments);
+    RUN_TEST(test_benchmark);
+    return 0;
+}
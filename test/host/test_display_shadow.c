@@ -0,0 +1,115 @@
+// Host tests: shadow framebuffer of e-paper panels
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "badge_bsp_display_shadow.h"
+#include "test_support.h"
+
+// The 2-bit panel of kami and hackerhotel-2024
+#define H_RES  296
+#define V_RES  128
+#define BPP    2
+#define STRIDE (H_RES * BPP / 8)
+
+static uint8_t frame[STRIDE * V_RES];
+
+static void test_first_frame_is_full(void) {
+    size_t                      changed = 0;
+    bsp_display_shadow_window_t window;
+    memset(frame, 0, sizeof(frame));
+    CHECK_OK(bsp_display_shadow_update(0, 0, H_RES, V_RES, frame, &changed));
+    CHECK(changed == sizeof(frame));
+    CHECK(bsp_display_shadow_get_dirty(&window));
+    CHECK(window.x_start == 0 && window.x_end == H_RES && window.y_start == 0 && window.y_end == V_RES);
+    CHECK(bsp_display_shadow_wants_full_refresh(changed));
+    bsp_display_shadow_mark_presented(true, changed);
+
+    CHECK_OK(bsp_display_shadow_update(0, 0, H_RES, V_RES, frame, &changed));
+    CHECK(changed == 0);
+}
+
+static void test_failed_write_is_retried(void) {
+    size_t  changed   = 0;
+    uint8_t region[2] = {0xFF, 0xFF};  // 8 pixels
+    CHECK_OK(bsp_display_shadow_update(8, 10, 16, 11, region, &changed));
+    CHECK(changed == 2);
+
+    // The panel write failed and the caller retries the same blit, the change is still pending
+    CHECK_OK(bsp_display_shadow_update(8, 10, 16, 11, region, &changed));
+    CHECK(changed == 2);
+
+    bsp_display_shadow_mark_presented(false, changed);
+    CHECK_OK(bsp_display_shadow_update(8, 10, 16, 11, region, &changed));
+    CHECK(changed == 0);
+    CHECK(bsp_display_shadow_get_buffer()[10 * STRIDE + 2] == 0xFF);
+}
+
+static void test_unaligned_pixels(void) {
+    size_t  changed = 0;
+    uint8_t pixel   = 0x40;  // A single pixel of value 1, packed at the most significant bits
+    CHECK_OK(bsp_display_shadow_update(1, 0, 2, 1, &pixel, &changed));
+    CHECK(changed == 1);
+    CHECK(bsp_display_shadow_get_buffer()[0] == 0x10);
+    bsp_display_shadow_mark_presented(false, changed);
+}
+
+// Packed pixels are counted by the bytes holding them, like whole bytes
+static void test_changes_counted_in_bytes(void) {
+    size_t  changed   = 0;
+    uint8_t region[2] = {0xAA, 0xAA};  // 8 pixels of value 2, spanning 3 bytes from pixel 2
+    CHECK_OK(bsp_display_shadow_update(2, 20, 10, 21, region, &changed));
+    CHECK(changed == 3);
+    bsp_display_shadow_mark_presented(false, changed);
+
+    CHECK_OK(bsp_display_shadow_update(0, 20, 8, 21, region, &changed));
+    CHECK(changed == 1);
+    bsp_display_shadow_mark_presented(false, changed);
+}
+
+// The dirty region holds every byte changed since the last write to the panel
+static void test_dirty_region(void) {
+    bsp_display_shadow_window_t window;
+    CHECK(!bsp_display_shadow_get_dirty(&window));
+
+    size_t  changed = 0;
+    uint8_t pixel   = 0x40;
+    CHECK_OK(bsp_display_shadow_update(9, 30, 10, 31, &pixel, &changed));
+    CHECK_OK(bsp_display_shadow_update(21, 40, 22, 41, &pixel, &changed));
+    CHECK(bsp_display_shadow_get_dirty(&window));
+    CHECK(window.x_start == 8 && window.x_end == 24 && window.y_start == 30 && window.y_end == 41);
+
+    bsp_display_shadow_mark_presented(false, changed);
+    CHECK(!bsp_display_shadow_get_dirty(&window));
+}
+
+static void test_ghosting_forces_full_refresh(void) {
+    size_t  changed = 0;
+    uint8_t region  = 0;
+    size_t  fast    = 0;
+    for (int i = 0; i < 64; i++) {
+        region = (uint8_t)(i + 1);
+        CHECK_OK(bsp_display_shadow_update(0, 100, 4, 101, &region, &changed));
+        bool full = bsp_display_shadow_wants_full_refresh(changed);
+        bsp_display_shadow_mark_presented(full, changed);
+        if (full) {
+            break;
+        }
+        fast++;
+    }
+    CHECK(fast > 0 && fast < 64);
+}
+
+int main(void) {
+    CHECK_OK(bsp_display_shadow_initialize(H_RES, V_RES, BPP));
+
+    RUN_TEST(test_first_frame_is_full);
+    RUN_TEST(test_failed_write_is_retried);
+    RUN_TEST(test_unaligned_pixels);
+    RUN_TEST(test_changes_counted_in_bytes);
+    RUN_TEST(test_dirty_region);
+    RUN_TEST(test_ghosting_forces_full_refresh);
+    return 0;
+}
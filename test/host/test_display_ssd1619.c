@@ -0,0 +1,180 @@
+// Host tests: partial RAM writes of the kami and hackerhotel-2024 e-paper panels, on a model of the SSD1619 RAM
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "badge_bsp_display_shadow.h"
+#include "badge_bsp_display_ssd1619.h"
+#include "driver/gpio.h"
+#include "ssd1619.h"
+#include "test_support.h"
+
+#define H_RES      128
+#define V_RES      296
+#define STRIDE     (H_RES / 4)
+#define RAM_STRIDE (H_RES / 8)
+
+// Model of the controller: the RAM window, the address counters and both RAM planes
+static uint8_t ram_black[V_RES][RAM_STRIDE];
+static uint8_t ram_red[V_RES][RAM_STRIDE];
+static uint8_t command;
+static uint8_t params[4];
+static size_t  num_params;
+static size_t  window_x_start, window_x_end, window_y_start, window_y_end;
+static size_t  counter_x, counter_y;
+static size_t  ram_bytes_sent;
+static int     refreshes;
+
+esp_err_t ssd1619_send_command(ssd1619_t* device, uint8_t value) {
+    command    = value;
+    num_params = 0;
+    if (command == 0x20) {
+        refreshes++;
+    }
+    return ESP_OK;
+}
+
+static void ram_write(uint8_t value) {
+    CHECK(counter_y < V_RES && counter_x < RAM_STRIDE);
+    if (command == 0x24) {
+        ram_black[counter_y][counter_x] = value;
+    } else {
+        ram_red[counter_y][counter_x] = value;
+    }
+    ram_bytes_sent++;
+    // Data entry mode 3: X increments first, then Y, within the window
+    if (++counter_x > window_x_end) {
+        counter_x = window_x_start;
+        counter_y = counter_y < window_y_end ? counter_y + 1 : window_y_start;
+    }
+}
+
+esp_err_t ssd1619_send_data(ssd1619_t* device, const uint8_t* data, uint16_t length) {
+    for (uint16_t i = 0; i < length; i++) {
+        if (command == 0x24 || command == 0x26) {
+            ram_write(data[i]);
+            continue;
+        }
+        CHECK(num_params < sizeof(params));
+        params[num_params++] = data[i];
+        if (command == 0x11 && num_params == 1) {
+            CHECK(params[0] == 0x03);
+        } else if (command == 0x44 && num_params == 2) {
+            window_x_start = params[0];
+            window_x_end   = params[1];
+        } else if (command == 0x45 && num_params == 4) {
+            window_y_start = params[0] | (params[1] << 8);
+            window_y_end   = params[2] | (params[3] << 8);
+        } else if (command == 0x4E && num_params == 1) {
+            counter_x = params[0];
+        } else if (command == 0x4F && num_params == 2) {
+            counter_y = params[0] | (params[1] << 8);
+        }
+    }
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio_num) {
+    return 0;
+}
+
+static ssd1619_t epaper = {.screen_width = H_RES, .screen_height = V_RES};
+static uint8_t   frame[STRIDE * V_RES];
+
+static void set_pixel(size_t x, size_t y, uint8_t value) {
+    uint8_t* byte  = &frame[y * STRIDE + x / 4];
+    size_t   shift = 6 - 2 * (x % 4);
+    *byte          = (*byte & ~(0x3 << shift)) | (value << shift);
+}
+
+// Give a pixel the next of the three colors
+static void change_pixel(size_t x, size_t y) {
+    uint8_t value = (frame[y * STRIDE + x / 4] >> (6 - 2 * (x % 4))) & 0x3;
+    set_pixel(x, y, (value + 1) % 3);
+}
+
+// The RAM planes hold every pixel of the frame
+static bool ram_matches_frame(void) {
+    for (size_t y = 0; y < V_RES; y++) {
+        for (size_t x = 0; x < H_RES; x++) {
+            uint8_t value = (frame[y * STRIDE + x / 4] >> (6 - 2 * (x % 4))) & 0x3;
+            bool    black = (ram_black[y][x / 8] >> (7 - x % 8)) & 1;
+            bool    red   = (ram_red[y][x / 8] >> (7 - x % 8)) & 1;
+            if (black != (value != BSP_DISPLAY_SSD1619_BLACK) || red != (value == BSP_DISPLAY_SSD1619_RED)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Write what changed in the shadow framebuffer to the panel, like the blit of the targets
+static size_t present(void) {
+    size_t changed = 0;
+    CHECK_OK(bsp_display_shadow_update(0, 0, H_RES, V_RES, frame, &changed));
+    bsp_display_shadow_window_t window;
+    if (!bsp_display_shadow_get_dirty(&window)) {
+        return 0;
+    }
+    ram_bytes_sent = 0;
+    CHECK_OK(bsp_display_ssd1619_write_window(&epaper, bsp_display_shadow_get_buffer(), H_RES, &window));
+    bsp_display_shadow_mark_presented(false, changed);
+    return ram_bytes_sent;
+}
+
+// ============================================
+// Tests
+// ============================================
+
+// The first frame is sent whole
+static void test_first_frame(void) {
+    srand(1);
+    for (size_t y = 0; y < V_RES; y++) {
+        for (size_t x = 0; x < H_RES; x++) {
+            set_pixel(x, y, rand() % 3);
+        }
+    }
+    CHECK(present() == 2 * RAM_STRIDE * V_RES);
+    CHECK(refreshes == 1);
+    CHECK(ram_matches_frame());
+}
+
+// Only the RAM bytes holding the changed pixels are sent, the rest of the RAM keeps the frame
+static void test_changed_window(void) {
+    change_pixel(13, 200);
+    change_pixel(20, 203);
+    change_pixel(19, 201);
+    // Pixels 13 up to 20 are in RAM bytes 1 and 2, rows 200 up to 203
+    CHECK(present() == 2 * 2 * 4);
+    CHECK(window_x_start == 1 && window_x_end == 2 && window_y_start == 200 && window_y_end == 203);
+    CHECK(ram_matches_frame());
+
+    // The last pixel of the panel
+    change_pixel(H_RES - 1, V_RES - 1);
+    CHECK(present() == 2);
+    CHECK(ram_matches_frame());
+
+    // Nothing changed, nothing is sent
+    int before = refreshes;
+    CHECK(present() == 0);
+    CHECK(refreshes == before);
+}
+
+static void test_invalid_window(void) {
+    bsp_display_shadow_window_t window = {.x_start = 0, .y_start = 0, .x_end = H_RES + 8, .y_end = 1};
+    CHECK_ESP(ESP_ERR_INVALID_ARG, bsp_display_ssd1619_write_window(&epaper, frame, H_RES, &window));
+    window.x_end = 0;
+    CHECK_ESP(ESP_ERR_INVALID_ARG, bsp_display_ssd1619_write_window(&epaper, frame, H_RES, &window));
+}
+
+int main(void) {
+    CHECK_OK(bsp_display_shadow_initialize(H_RES, V_RES, 2));
+
+    RUN_TEST(test_first_frame);
+    RUN_TEST(test_changed_window);
+    RUN_TEST(test_invalid_window);
+    return 0;
+}
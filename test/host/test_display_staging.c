@@ -0,0 +1,164 @@
+// Host tests: shared staging buffers used by concurrent tasks
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "badge_bsp_display_staging.h"
+#include "bsp/display.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "mock_panel.h"
+#include "test_support.h"
+
+// The mock panel is the 320x240 RGB565 panel of mch2022, which stages buffers in strips of 16 rows
+#define H_RES       320
+#define V_RES       240
+#define STRIP_ROWS  16
+#define WRITERS     2
+#define WRITER_ROWS (V_RES / WRITERS)
+#define ROUNDS      20
+
+typedef struct {
+    size_t            y_start;
+    uint16_t          color;
+    esp_err_t         res;
+    SemaphoreHandle_t done;
+} writer_t;
+
+// Each writer repeatedly stages its own half of the screen in its own color
+static void writer_task(void* arg) {
+    writer_t* writer = arg;
+    writer->res      = ESP_OK;
+    for (int round = 0; round < ROUNDS && writer->res == ESP_OK; round++) {
+        for (size_t y = writer->y_start; y < writer->y_start + WRITER_ROWS && writer->res == ESP_OK;) {
+            uint8_t* staging      = NULL;
+            size_t   staging_size = 0;
+            writer->res           = bsp_display_staging_get(&staging, &staging_size);
+            if (writer->res != ESP_OK) {
+                break;
+            }
+            size_t rows = staging_size / (H_RES * 2);
+            if (rows > writer->y_start + WRITER_ROWS - y) {
+                rows = writer->y_start + WRITER_ROWS - y;
+            }
+            uint16_t* pixels = (uint16_t*)staging;
+            for (size_t i = 0; i < rows * H_RES; i++) {
+                pixels[i] = writer->color;
+            }
+            // Let the other writer fill its buffer in between, like a preempted task would
+            vTaskDelay(0);
+            writer->res  = bsp_display_staging_blit(staging, 0, y, H_RES, y + rows);
+            y           += rows;
+        }
+    }
+    xSemaphoreGive(writer->done);
+    vTaskDelete(NULL);
+}
+
+// ============================================
+// Tests
+// ============================================
+
+// The target sizes the staging buffers before their first use, later requests are refused
+static void test_rows(void) {
+    CHECK_ESP(ESP_ERR_INVALID_ARG, bsp_display_staging_set_rows(0));
+    CHECK_OK(bsp_display_staging_set_rows(STRIP_ROWS));
+
+    uint8_t* staging      = NULL;
+    size_t   staging_size = 0;
+    CHECK_OK(bsp_display_staging_get(&staging, &staging_size));
+    CHECK(staging_size == H_RES * STRIP_ROWS * 2);
+    bsp_display_staging_release(staging);
+
+    CHECK_ESP(ESP_ERR_INVALID_STATE, bsp_display_staging_set_rows(32));
+}
+
+// Only buffers handed out by bsp_display_staging_get are accepted
+static void test_foreign_buffer(void) {
+    static uint8_t buffer[H_RES * 2];
+    CHECK_ESP(ESP_ERR_INVALID_ARG, bsp_display_staging_blit(buffer, 0, 0, H_RES, 1));
+    bsp_display_staging_release(buffer);
+}
+
+static TaskHandle_t callback_task  = NULL;
+static int          callback_calls = 0;
+static bool         callback_drawn = false;
+
+static bool strips_done(void* user_ctx) {
+    callback_task  = xTaskGetCurrentTaskHandle();
+    callback_drawn = ((const uint16_t*)mock_panel_memory())[(V_RES - 1) * H_RES] == *(uint16_t*)user_ctx;
+    callback_calls++;
+    return false;
+}
+
+// The callback of a blit sent in strips fires from the transfer done interrupt of the last strip, like the callback of
+// a blit sent in one transfer
+static void test_callback_after_last_strip(void) {
+    uint16_t color = 0x001F;
+    mock_panel_reset();
+    for (size_t y = 0; y < V_RES; y += STRIP_ROWS) {
+        uint8_t* staging      = NULL;
+        size_t   staging_size = 0;
+        CHECK_OK(bsp_display_staging_get(&staging, &staging_size));
+        for (size_t i = 0; i < STRIP_ROWS * H_RES; i++) {
+            ((uint16_t*)staging)[i] = color;
+        }
+        bool last = y + STRIP_ROWS == V_RES;
+        CHECK_OK(bsp_display_staging_blit_with_callback(staging, 0, y, H_RES, y + STRIP_ROWS,
+                                                        last ? strips_done : NULL, &color));
+    }
+    CHECK_OK(bsp_display_blit_wait_idle(pdMS_TO_TICKS(1000)));
+    CHECK(callback_calls == 1 && callback_drawn);
+    CHECK(callback_task != NULL && callback_task != xTaskGetCurrentTaskHandle());
+}
+
+// Two tasks staging at the same time each send their own buffer: every strip ends up in the color of its writer
+static void test_concurrent_writers(void) {
+    static const uint16_t colors[WRITERS] = {0xF800, 0x07E0};
+    writer_t              writers[WRITERS];
+    mock_panel_reset();
+    for (size_t i = 0; i < WRITERS; i++) {
+        writers[i] = (writer_t){.y_start = i * WRITER_ROWS, .color = colors[i], .done = xSemaphoreCreateBinary()};
+        CHECK(writers[i].done != NULL);
+        CHECK(xTaskCreate(writer_task, "writer", 4096, &writers[i], 5, NULL) == pdPASS);
+    }
+    for (size_t i = 0; i < WRITERS; i++) {
+        CHECK(xSemaphoreTake(writers[i].done, pdMS_TO_TICKS(10000)) == pdTRUE);
+        CHECK_OK(writers[i].res);
+        vSemaphoreDelete(writers[i].done);
+    }
+    CHECK_OK(bsp_display_blit_wait_idle(pdMS_TO_TICKS(1000)));
+
+    const uint16_t* memory = (const uint16_t*)mock_panel_memory();
+    for (size_t y = 0; y < V_RES; y++) {
+        for (size_t x = 0; x < H_RES; x++) {
+            CHECK(memory[y * H_RES + x] == colors[y / WRITER_ROWS]);
+        }
+    }
+
+    mock_panel_transfer_t const* transfers = NULL;
+    size_t                       count     = mock_panel_get_transfers(&transfers);
+    CHECK(count == WRITERS * ROUNDS * (WRITER_ROWS / STRIP_ROWS + (WRITER_ROWS % STRIP_ROWS ? 1 : 0)));
+}
+
+int main(void) {
+    mock_panel_config_t config = {
+        .h_res               = H_RES,
+        .v_res               = V_RES,
+        .color_fmt           = BSP_DISPLAY_COLOR_FORMAT_16_565RGB,
+        .data_endian         = BSP_DISPLAY_ENDIAN_LITTLE,
+        .max_blits_in_flight = 2,
+        .bytes_per_ms        = 20000,
+    };
+    CHECK_OK(mock_panel_initialize(&config));
+
+    RUN_TEST(test_rows);
+    RUN_TEST(test_foreign_buffer);
+    RUN_TEST(test_callback_after_last_strip);
+    RUN_TEST(test_concurrent_writers);
+    return 0;
+}
@@ -0,0 +1,138 @@
+// Host tests: display pipeline statistics, built with and without CONFIG_BSP_DISPLAY_STATS
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "badge_bsp_display_flush.h"
+#include "badge_bsp_display_stats.h"
+#include "bsp/display.h"
+#include "esp_timer.h"
+#include "host_idf.h"
+#include "mock_panel.h"
+#include "sdkconfig.h"
+#include "test_support.h"
+
+#define H_RES          64
+#define V_RES          48
+#define OVERHEAD_CALLS 1000000
+
+static uint8_t pixels[H_RES * V_RES * 2];
+
+// Time per recording of a blit, the way a display driver records every blit it hands to the panel
+static double nanoseconds_per_record(void) {
+    int64_t start = test_wall_time_us();
+    for (size_t i = 0; i < OVERHEAD_CALLS; i++) {
+        int64_t record_start = bsp_display_stats_now();
+        bsp_display_stats_record_blit(0, 0, 1, 1, record_start);
+    }
+    return (test_wall_time_us() - start) * 1000.0 / OVERHEAD_CALLS;
+}
+
+#if CONFIG_BSP_DISPLAY_STATS
+
+static void test_blits_are_counted(void) {
+    bsp_display_reset_stats();
+
+    // 16x16 RGB565 regions take half a millisecond each on the mock bus, every blit waits for the one before
+    for (int i = 0; i < 10; i++) {
+        CHECK_OK(bsp_display_blit(i, 0, i + 16, 16, pixels));
+    }
+    CHECK_OK(bsp_display_blit_wait_idle(pdMS_TO_TICKS(1000)));
+
+    bsp_display_stats_t stats;
+    CHECK_OK(bsp_display_get_stats(&stats));
+    printf("  %llu blits, %llu pixels, %llu bytes, waited %llu us, at most %lu us for one blit\n",
+           (unsigned long long)stats.blits, (unsigned long long)stats.pixels, (unsigned long long)stats.bytes,
+           (unsigned long long)stats.wait_time_us, (unsigned long)stats.wait.max_us);
+    CHECK(stats.blits == 10);
+    CHECK(stats.pixels == 10 * 16 * 16);
+    CHECK(stats.bytes == 10 * 16 * 16 * 2);
+    CHECK(stats.flush_timeouts == 0);
+    CHECK(stats.wait_time_us >= 9 * 300);  // Nine blits found the previous transfer still running
+    CHECK(stats.wait.max_us >= 300 && stats.wait.min_us <= stats.wait.avg_us && stats.wait.avg_us <= stats.wait.max_us);
+    CHECK(stats.submit.max_us < 100000);
+}
+
+static void test_timeouts_are_counted(void) {
+    bsp_display_reset_stats();
+
+    // A full screen transfer takes 6 ms, claiming another slot without waiting times out
+    CHECK_OK(bsp_display_blit(0, 0, H_RES, V_RES, pixels));
+    CHECK_ESP(ESP_ERR_TIMEOUT, bsp_display_flush_begin(NULL, NULL, 0));
+    CHECK_OK(bsp_display_blit_wait_idle(pdMS_TO_TICKS(1000)));
+
+    bsp_display_stats_t stats;
+    CHECK_OK(bsp_display_get_stats(&stats));
+    CHECK(stats.blits == 1);
+    CHECK(stats.flush_timeouts == 1);
+}
+
+static void test_timing_summary(void) {
+    host_clock_set_simulated(1000000);
+    bsp_display_reset_stats();
+
+    // Waits of 1 up to 100 microseconds, the percentiles cover the most recent 64 of them: 37 up to 100
+    for (int64_t duration = 1; duration <= 100; duration++) {
+        bsp_display_stats_record_wait(esp_timer_get_time() - duration, false);
+    }
+
+    bsp_display_stats_t stats;
+    CHECK_OK(bsp_display_get_stats(&stats));
+    CHECK(stats.wait_time_us == 5050);
+    CHECK(stats.wait.min_us == 1 && stats.wait.max_us == 100 && stats.wait.avg_us == 50);
+    CHECK(stats.wait.p50_us == 68 && stats.wait.p90_us == 93 && stats.wait.p99_us == 99);
+    CHECK(stats.blits == 0 && stats.submit.max_us == 0);
+
+    bsp_display_reset_stats();
+    CHECK_OK(bsp_display_get_stats(&stats));
+    CHECK(stats.wait_time_us == 0 && stats.wait.max_us == 0 && stats.wait.p99_us == 0);
+    CHECK_ESP(ESP_ERR_INVALID_ARG, bsp_display_get_stats(NULL));
+}
+
+static void test_overhead(void) {
+    printf("  %.1f ns per recorded blit\n", nanoseconds_per_record());
+}
+
+#else
+
+static void test_disabled(void) {
+    bsp_display_stats_t stats;
+    CHECK_ESP(ESP_ERR_NOT_SUPPORTED, bsp_display_get_stats(&stats));
+    bsp_display_reset_stats();
+
+    // The display keeps working without statistics
+    CHECK_OK(bsp_display_blit(0, 0, H_RES, V_RES, pixels));
+    CHECK_OK(bsp_display_blit_wait_idle(pdMS_TO_TICKS(1000)));
+}
+
+static void test_overhead(void) {
+    // The recording functions are empty inline functions, the loop compiles to nothing
+    double overhead = nanoseconds_per_record();
+    printf("  %.3f ns per recorded blit with statistics compiled out\n", overhead);
+    CHECK(overhead < 0.5);
+}
+
+#endif
+
+int main(void) {
+    mock_panel_config_t config = {
+        .h_res        = H_RES,
+        .v_res        = V_RES,
+        .color_fmt    = BSP_DISPLAY_COLOR_FORMAT_16_565RGB,
+        .bytes_per_ms = 1000,
+    };
+    CHECK_OK(mock_panel_initialize(&config));
+
+#if CONFIG_BSP_DISPLAY_STATS
+    RUN_TEST(test_blits_are_counted);
+    RUN_TEST(test_timeouts_are_counted);
+    RUN_TEST(test_overhead);
+    RUN_TEST(test_timing_summary);
+#else
+    RUN_TEST(test_disabled);
+    RUN_TEST(test_overhead);
+#endif
+    return 0;
+}
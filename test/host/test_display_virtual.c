@@ -0,0 +1,133 @@
+// Host tests: the virtual display target on Linux, with a simulated 40 MHz SPI bus and frame dumps
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "bsp/display.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "test_support.h"
+
+#define H_RES             CONFIG_BSP_VIRTUAL_DISPLAY_H_RES
+#define V_RES             CONFIG_BSP_VIRTUAL_DISPLAY_V_RES
+#define FRAME_BYTES       (H_RES * V_RES * 2)
+#define FRAME_TRANSFER_US ((int64_t)FRAME_BYTES * 8 * 1000000 / CONFIG_BSP_VIRTUAL_DISPLAY_SPI_CLOCK_HZ)
+#define MAX_COMPLETIONS   16
+
+// Called by the device initialization, not part of the public API
+esp_err_t bsp_display_initialize(bsp_display_configuration_t const* configuration);
+
+static uint8_t frame[FRAME_BYTES];
+
+// ============================================
+// Completion recording
+// ============================================
+
+static int     completions[MAX_COMPLETIONS];
+static int64_t completion_times[MAX_COMPLETIONS];
+static size_t  completion_count;
+
+static bool record_completion(void* user_ctx) {
+    if (completion_count < MAX_COMPLETIONS) {
+        completions[completion_count]        = (int)(intptr_t)user_ctx;
+        completion_times[completion_count++] = esp_timer_get_time();
+    }
+    return false;
+}
+
+// ============================================
+// Tests
+// ============================================
+
+static void test_tiny_blits_complete_in_order(void) {
+    completion_count = 0;
+
+    // A single pixel takes less than a microsecond on the bus, it must still complete after the frame queued before it
+    int64_t start = esp_timer_get_time();
+    CHECK_OK(bsp_display_blit_async(0, 0, H_RES, V_RES, frame, record_completion, (void*)1));
+    CHECK_OK(bsp_display_blit_async(3, 4, 4, 5, frame, record_completion, (void*)2));
+    CHECK_OK(bsp_display_blit_async(5, 6, 6, 7, frame, record_completion, (void*)3));
+    CHECK_OK(bsp_display_blit_wait_idle(pdMS_TO_TICKS(1000)));
+
+    printf("  frame completed after %lld us, the pixels %lld and %lld us later, the bus needs %lld us for the frame\n",
+           (long long)(completion_times[0] - start), (long long)(completion_times[1] - completion_times[0]),
+           (long long)(completion_times[2] - completion_times[0]), (long long)FRAME_TRANSFER_US);
+    CHECK(completion_count == 3);
+    CHECK(completions[0] == 1 && completions[1] == 2 && completions[2] == 3);
+    CHECK(completion_times[0] - start >= FRAME_TRANSFER_US);
+    CHECK(completion_times[1] >= completion_times[0] && completion_times[2] >= completion_times[1]);
+}
+
+static void test_blits_take_the_bus_time(void) {
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < 4; i++) {
+        CHECK_OK(bsp_display_blit(0, 0, H_RES, V_RES, frame));
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+    printf("  4 frames in %lld us, the bus needs %lld us\n", (long long)elapsed, (long long)(4 * FRAME_TRANSFER_US));
+    CHECK(elapsed >= 4 * FRAME_TRANSFER_US);
+}
+
+static void test_frame_dump(void) {
+    // A horizontal red to blue gradient over a green ramp, big endian RGB565 like the ILI9341
+    for (size_t y = 0; y < V_RES; y++) {
+        for (size_t x = 0; x < H_RES; x++) {
+            uint16_t value = (uint16_t)((x * 31 / (H_RES - 1)) << 11 | (y * 63 / (V_RES - 1)) << 5 |
+                                        (31 - x * 31 / (H_RES - 1)));
+            frame[(y * H_RES + x) * 2]     = value >> 8;
+            frame[(y * H_RES + x) * 2 + 1] = value & 0xFF;
+        }
+    }
+    char path[256];
+    snprintf(path, sizeof(path), CONFIG_BSP_VIRTUAL_DISPLAY_DUMP_PATH, 1u);
+    remove(path);
+
+    // The very first blit dumped the black frame the display starts with, the blits after it did not change the
+    // framebuffer. This is the second dump.
+    CHECK_OK(bsp_display_blit(0, 0, H_RES, V_RES, frame));
+    FILE* file = fopen(path, "rb");
+    CHECK(file != NULL);
+    unsigned int width, height, max;
+    CHECK(fscanf(file, "P6 %u %u %u", &width, &height, &max) == 3 && fgetc(file) == '\n');
+    CHECK(width == H_RES && height == V_RES && max == 255);
+    for (size_t y = 0; y < V_RES; y++) {
+        for (size_t x = 0; x < H_RES; x++) {
+            uint8_t rgb[3];
+            CHECK(fread(rgb, 1, 3, file) == 3);
+            uint16_t value = frame[(y * H_RES + x) * 2] << 8 | frame[(y * H_RES + x) * 2 + 1];
+            CHECK(rgb[0] >> 3 == value >> 11 && rgb[1] >> 2 == ((value >> 5) & 0x3F) && rgb[2] >> 3 == (value & 0x1F));
+        }
+    }
+    CHECK(fgetc(file) == EOF);
+    fclose(file);
+}
+
+static void test_invalid_regions(void) {
+    CHECK_ESP(ESP_ERR_INVALID_ARG, bsp_display_blit_async(0, 0, H_RES + 1, V_RES, frame, NULL, NULL));
+    CHECK_ESP(ESP_ERR_INVALID_ARG, bsp_display_blit_async(4, 0, 4, V_RES, frame, NULL, NULL));
+    CHECK_ESP(ESP_ERR_INVALID_ARG, bsp_display_blit_async(0, 0, 1, 1, NULL, NULL, NULL));
+    CHECK_OK(bsp_display_blit_wait_idle(0));
+}
+
+int main(void) {
+    bsp_display_configuration_t configuration = {
+        .max_blits_in_flight = 4,
+    };
+    CHECK_OK(bsp_display_initialize(&configuration));
+
+    size_t                     h_res, v_res;
+    bsp_display_color_format_t color_fmt;
+    bsp_display_endianness_t   data_endian;
+    CHECK_OK(bsp_display_get_parameters(&h_res, &v_res, &color_fmt, &data_endian));
+    CHECK(h_res == H_RES && v_res == V_RES && color_fmt == BSP_DISPLAY_COLOR_FORMAT_16_565RGB &&
+          data_endian == BSP_DISPLAY_ENDIAN_BIG);
+
+    RUN_TEST(test_tiny_blits_complete_in_order);
+    RUN_TEST(test_blits_take_the_bus_time);
+    RUN_TEST(test_frame_dump);
+    RUN_TEST(test_invalid_regions);
+    return 0;
+}
@@ -0,0 +1,143 @@
+// Host tests: event coalescing of bsp_input_get_events per calling task, and a benchmark of receiving events one by
+// one from the FreeRTOS queue against receiving them in batches
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "badge_bsp_input_queue.h"
+#include "bsp/input.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "test_support.h"
+
+#define COALESCE_MS  100
+#define BENCH_BURSTS 300
+#define BENCH_BURST  8
+
+static void send_event(uint32_t scancode) {
+    bsp_input_event_t event = {.type = INPUT_EVENT_TYPE_SCANCODE, .args_scancode.scancode = scancode};
+    CHECK(bsp_input_queue_send(&event));
+}
+
+static SemaphoreHandle_t other_done = NULL;
+
+// Another task receiving an event, which starts its own coalescing interval
+static void other_task(void* arg) {
+    bsp_input_event_t event;
+    CHECK(bsp_input_get_events(&event, 1, pdMS_TO_TICKS(1000)) == 1);
+    xSemaphoreGive(other_done);
+    vTaskDelete(NULL);
+}
+
+// ============================================
+// Tests
+// ============================================
+
+// Events another task received do not hold back the calling task, events the calling task received do
+static void test_per_caller(void) {
+    bsp_input_event_t events[4];
+    CHECK_OK(bsp_input_set_event_coalescing(COALESCE_MS));
+
+    other_done = xSemaphoreCreateBinary();
+    CHECK(other_done != NULL);
+    send_event(BSP_INPUT_SCANCODE_A);
+    CHECK(xTaskCreate(other_task, "other", 4096, NULL, 5, NULL) == pdPASS);
+    CHECK(xSemaphoreTake(other_done, pdMS_TO_TICKS(1000)) == pdTRUE);
+    vSemaphoreDelete(other_done);
+
+    send_event(BSP_INPUT_SCANCODE_B);
+    int64_t start = test_wall_time_us();
+    CHECK(bsp_input_get_events(events, 4, pdMS_TO_TICKS(1000)) == 1);
+    int64_t first = test_wall_time_us() - start;
+    CHECK(first < COALESCE_MS * 1000 / 2);
+
+    send_event(BSP_INPUT_SCANCODE_C);
+    send_event(BSP_INPUT_SCANCODE_D);
+    start = test_wall_time_us();
+    CHECK(bsp_input_get_events(events, 4, pdMS_TO_TICKS(1000)) == 2);
+    int64_t second = test_wall_time_us() - start;
+    CHECK(second >= (COALESCE_MS - 10) * 1000);
+    printf("  first call %.1f ms, second call %.1f ms\n", first / 1000.0, second / 1000.0);
+
+    // The wait is cut short by the timeout
+    send_event(BSP_INPUT_SCANCODE_E);
+    CHECK(bsp_input_get_events(events, 4, 0) == 1);
+    CHECK_OK(bsp_input_set_event_coalescing(0));
+}
+
+// ============================================
+// Benchmark
+// ============================================
+
+static atomic_bool producer_running = false;
+
+// Key bursts like a fast typist or a report of several changed keys, a few milliseconds apart
+static void producer_task(void* arg) {
+    for (int burst = 0; burst < BENCH_BURSTS; burst++) {
+        for (int i = 0; i < BENCH_BURST; i++) {
+            bsp_input_event_t event = {.type = INPUT_EVENT_TYPE_SCANCODE, .args_scancode.scancode = i};
+            bsp_input_queue_send(&event);
+        }
+        vTaskDelay(pdMS_TO_TICKS(2));
+    }
+    atomic_store(&producer_running, false);
+    vTaskDelete(NULL);
+}
+
+// Receives until the producer is done and the queue is drained, and counts the calls that returned events
+static void receive(char const* name, QueueHandle_t queue, uint32_t coalesce_ms) {
+    bsp_input_event_t       events[64];
+    bsp_input_queue_stats_t stats;
+    size_t                  received = 0;
+    size_t                  wakeups  = 0;
+
+    CHECK_OK(bsp_input_set_event_coalescing(coalesce_ms));
+    bsp_input_reset_queue_stats();
+    atomic_store(&producer_running, true);
+    int64_t start = test_wall_time_us();
+    CHECK(xTaskCreate(producer_task, "producer", 4096, NULL, 5, NULL) == pdPASS);
+    while (true) {
+        bool   running = atomic_load(&producer_running);
+        size_t count;
+        if (queue != NULL) {
+            count = xQueueReceive(queue, &events[0], pdMS_TO_TICKS(20)) == pdTRUE ? 1 : 0;
+        } else {
+            count = bsp_input_get_events(events, 64, pdMS_TO_TICKS(20));
+        }
+        if (count == 0 && !running) {
+            break;
+        }
+        received += count;
+        wakeups  += count > 0;
+    }
+    int64_t elapsed = test_wall_time_us() - start;
+
+    CHECK_OK(bsp_input_get_queue_stats(&stats));
+    CHECK(received == stats.queued);
+    printf("  %-22s %5zu events in %5zu wakeups, %5.2f events per wakeup, dropped %u, %.0f ms\n", name, received,
+           wakeups, (double)received / wakeups, stats.dropped_newest, elapsed / 1000.0);
+    CHECK_OK(bsp_input_set_event_coalescing(0));
+}
+
+static void test_benchmark(void) {
+    printf("  %d bursts of %d events, 2 ms apart\n", BENCH_BURSTS, BENCH_BURST);
+    receive("batched", NULL, 0);
+    receive("batched, coalesce 5 ms", NULL, 5);
+    // Last, the adapter can not be removed again
+    QueueHandle_t queue = NULL;
+    CHECK_OK(bsp_input_queue_get_handle(&queue));
+    receive("per event", queue, 0);
+}
+
+int main(void) {
+    CHECK_OK(bsp_input_queue_initialize());
+
+    RUN_TEST(test_per_caller);
+    RUN_TEST(test_benchmark);
+    return 0;
+}
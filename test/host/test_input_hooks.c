@@ -0,0 +1,319 @@
+// Host tests: input hook dispatch order and unregistering hooks while events are being dispatched
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "badge_bsp_input_hooks.h"
+#include "bsp/input.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "test_support.h"
+
+#define STRESS_ROUNDS 2000
+#define BENCH_EVENTS  1000000
+#define BLOCKED_TASKS 5
+
+void bsp_input_hooks_initialize(void);
+
+static bsp_input_event_t make_event(bsp_input_navigation_key_t key) {
+    bsp_input_event_t event = {
+        .type                  = INPUT_EVENT_TYPE_NAVIGATION,
+        .args_navigation.key   = key,
+        .args_navigation.state = true,
+    };
+    return event;
+}
+
+// User data of a hook, a hook called after its unregister returned sees it freed
+typedef struct {
+    atomic_bool freed;
+    atomic_uint calls;
+    atomic_uint calls_after_free;
+    bool        consume;
+} hook_data_t;
+
+static bool counting_hook(bsp_input_event_t* event, void* user_data) {
+    hook_data_t* data = user_data;
+    if (atomic_load(&data->freed)) {
+        atomic_fetch_add(&data->calls_after_free, 1);
+    }
+    atomic_fetch_add(&data->calls, 1);
+    return data->consume;
+}
+
+// ============================================
+// Tests
+// ============================================
+
+static char   order[8];
+static size_t order_length = 0;
+
+static bool order_hook(bsp_input_event_t* event, void* user_data) {
+    order[order_length++] = *(char const*)user_data;
+    return false;
+}
+
+// Hooks are called by priority and then by registration order, and only for the events they selected
+static void test_order(void) {
+    static char const names[] = "abcd";
+    bsp_input_hook_config_t configs[] = {
+        {.callback = order_hook, .user_data = (void*)&names[0], .priority = 0},
+        {.callback = order_hook, .user_data = (void*)&names[1], .priority = 10},
+        {.callback = order_hook, .user_data = (void*)&names[2], .priority = 0},
+        {.callback        = order_hook,
+         .user_data       = (void*)&names[3],
+         .priority        = 20,
+         .navigation_keys = BSP_INPUT_HOOK_NAVIGATION_KEY(BSP_INPUT_NAVIGATION_KEY_UP)},
+    };
+    int ids[4];
+    for (size_t i = 0; i < 4; i++) {
+        ids[i] = bsp_input_hook_register_with_config(&configs[i]);
+        CHECK(ids[i] >= 0);
+    }
+
+    bsp_input_event_t event = make_event(BSP_INPUT_NAVIGATION_KEY_UP);
+    order_length            = 0;
+    CHECK(!bsp_input_hooks_process(&event));
+    CHECK(order_length == 4 && order[0] == 'd' && order[1] == 'b' && order[2] == 'a' && order[3] == 'c');
+
+    event        = make_event(BSP_INPUT_NAVIGATION_KEY_DOWN);
+    order_length = 0;
+    CHECK(!bsp_input_hooks_process(&event));
+    CHECK(order_length == 3 && order[0] == 'b' && order[1] == 'a' && order[2] == 'c');
+
+    for (size_t i = 0; i < 4; i++) {
+        bsp_input_hook_unregister(ids[i]);
+    }
+    order_length = 0;
+    CHECK(!bsp_input_hooks_process(&event));
+    CHECK(order_length == 0);
+}
+
+static atomic_bool       slow_hook_entered  = false;
+static atomic_bool       slow_hook_release  = false;
+static atomic_bool       unregister_done    = false;
+static SemaphoreHandle_t dispatch_done      = NULL;
+static SemaphoreHandle_t unregister_stopped = NULL;
+
+static bool slow_hook(bsp_input_event_t* event, void* user_data) {
+    atomic_store(&slow_hook_entered, true);
+    while (!atomic_load(&slow_hook_release)) {
+        vTaskDelay(1);
+    }
+    return counting_hook(event, user_data);
+}
+
+static void dispatch_task(void* arg) {
+    bsp_input_event_t event = make_event(BSP_INPUT_NAVIGATION_KEY_UP);
+    bsp_input_hooks_process(&event);
+    xSemaphoreGive(dispatch_done);
+    vTaskDelete(NULL);
+}
+
+static void unregister_task(void* arg) {
+    bsp_input_hook_unregister(*(int*)arg);
+    atomic_store(&unregister_done, true);
+    xSemaphoreGive(unregister_stopped);
+    vTaskDelete(NULL);
+}
+
+// Unregistering a hook that is being called returns only after the call, and the hook is not called again
+static void test_unregister_waits(void) {
+    hook_data_t data = {0};
+    int         id   = bsp_input_hook_register(slow_hook, &data);
+    CHECK(id >= 0);
+    dispatch_done      = xSemaphoreCreateBinary();
+    unregister_stopped = xSemaphoreCreateBinary();
+    CHECK(dispatch_done != NULL && unregister_stopped != NULL);
+
+    CHECK(xTaskCreate(dispatch_task, "dispatch", 4096, NULL, 5, NULL) == pdPASS);
+    while (!atomic_load(&slow_hook_entered)) {
+        vTaskDelay(1);
+    }
+    CHECK(xTaskCreate(unregister_task, "unregister", 4096, &id, 5, NULL) == pdPASS);
+    vTaskDelay(pdMS_TO_TICKS(50));
+    CHECK(!atomic_load(&unregister_done));
+
+    atomic_store(&slow_hook_release, true);
+    CHECK(xSemaphoreTake(unregister_stopped, pdMS_TO_TICKS(1000)) == pdTRUE);
+    CHECK(xSemaphoreTake(dispatch_done, pdMS_TO_TICKS(1000)) == pdTRUE);
+    atomic_store(&data.freed, true);
+    CHECK(atomic_load(&data.calls) == 1);
+
+    bsp_input_event_t event = make_event(BSP_INPUT_NAVIGATION_KEY_UP);
+    CHECK(!bsp_input_hooks_process(&event));
+    CHECK(atomic_load(&data.calls) == 1 && atomic_load(&data.calls_after_free) == 0);
+    vSemaphoreDelete(dispatch_done);
+    vSemaphoreDelete(unregister_stopped);
+}
+
+static int         self_ids[2];
+static hook_data_t other_data;
+
+static bool unregistering_hook(bsp_input_event_t* event, void* user_data) {
+    bsp_input_hook_unregister(self_ids[0]);
+    bsp_input_hook_unregister(self_ids[1]);
+    atomic_store(&other_data.freed, true);
+    return counting_hook(event, user_data);
+}
+
+// A hook can unregister itself and a hook after it without waiting for its own dispatch, the other hook is skipped
+static void test_unregister_from_hook(void) {
+    hook_data_t             data   = {0};
+    bsp_input_hook_config_t first  = {.callback = unregistering_hook, .user_data = &data, .priority = 1};
+    bsp_input_hook_config_t second = {.callback = counting_hook, .user_data = &other_data};
+    self_ids[0]                    = bsp_input_hook_register_with_config(&first);
+    self_ids[1]                    = bsp_input_hook_register_with_config(&second);
+    CHECK(self_ids[0] >= 0 && self_ids[1] >= 0);
+
+    bsp_input_event_t event = make_event(BSP_INPUT_NAVIGATION_KEY_UP);
+    CHECK(!bsp_input_hooks_process(&event));
+    CHECK(!bsp_input_hooks_process(&event));
+    CHECK(atomic_load(&data.calls) == 1);
+    CHECK(atomic_load(&other_data.calls) == 0);
+}
+
+static int               blocking_ids[2];
+static atomic_uint       blocked_dispatches = 0;
+static atomic_bool       blocked_release    = false;
+static SemaphoreHandle_t blocking_done      = NULL;
+
+// Dispatches of the up key wait in the hook until released, the down key releases them and unregisters the other hook
+static bool blocking_hook(bsp_input_event_t* event, void* user_data) {
+    if (event->args_navigation.key == BSP_INPUT_NAVIGATION_KEY_DOWN) {
+        atomic_store(&blocked_release, true);
+        bsp_input_hook_unregister(blocking_ids[1]);
+        return false;
+    }
+    atomic_fetch_add(&blocked_dispatches, 1);
+    while (!atomic_load(&blocked_release)) {
+        vTaskDelay(1);
+    }
+    return false;
+}
+
+static void blocking_dispatch_task(void* arg) {
+    bsp_input_event_t event = make_event((bsp_input_navigation_key_t)(intptr_t)arg);
+    bsp_input_hooks_process(&event);
+    xSemaphoreGive(blocking_done);
+    vTaskDelete(NULL);
+}
+
+// A hook can unregister a hook while many other tasks are dispatching events at the same time
+static void test_unregister_from_hook_with_many_dispatchers(void) {
+    hook_data_t             data   = {0};
+    bsp_input_hook_config_t first  = {.callback = blocking_hook, .priority = 1};
+    bsp_input_hook_config_t second = {.callback = counting_hook, .user_data = &data};
+    blocking_ids[0]                = bsp_input_hook_register_with_config(&first);
+    blocking_ids[1]                = bsp_input_hook_register_with_config(&second);
+    blocking_done                  = xSemaphoreCreateCounting(BLOCKED_TASKS + 1, 0);
+    CHECK(blocking_ids[0] >= 0 && blocking_ids[1] >= 0 && blocking_done != NULL);
+
+    for (int i = 0; i < BLOCKED_TASKS; i++) {
+        CHECK(xTaskCreate(blocking_dispatch_task, "dispatch", 4096, (void*)(intptr_t)BSP_INPUT_NAVIGATION_KEY_UP, 5,
+                          NULL) == pdPASS);
+    }
+    for (int waited = 0; atomic_load(&blocked_dispatches) < BLOCKED_TASKS; waited++) {
+        CHECK(waited < 1000);
+        vTaskDelay(1);
+    }
+    CHECK(xTaskCreate(blocking_dispatch_task, "dispatch", 4096, (void*)(intptr_t)BSP_INPUT_NAVIGATION_KEY_DOWN, 5,
+                      NULL) == pdPASS);
+    for (int i = 0; i < BLOCKED_TASKS + 1; i++) {
+        CHECK(xSemaphoreTake(blocking_done, pdMS_TO_TICKS(2000)) == pdTRUE);
+    }
+    vSemaphoreDelete(blocking_done);
+
+    atomic_store(&data.freed, true);
+    bsp_input_event_t event = make_event(BSP_INPUT_NAVIGATION_KEY_LEFT);
+    CHECK(!bsp_input_hooks_process(&event));
+    CHECK(atomic_load(&data.calls_after_free) == 0);
+    bsp_input_hook_unregister(blocking_ids[0]);
+}
+
+static atomic_bool       stress_running = false;
+static SemaphoreHandle_t stress_done    = NULL;
+static atomic_uint       stress_events  = 0;
+
+static void stress_dispatch_task(void* arg) {
+    bsp_input_event_t event = make_event(BSP_INPUT_NAVIGATION_KEY_UP);
+    while (atomic_load(&stress_running)) {
+        bsp_input_hooks_process(&event);
+        atomic_fetch_add(&stress_events, 1);
+    }
+    xSemaphoreGive(stress_done);
+    vTaskDelete(NULL);
+}
+
+// Hooks registered and unregistered while two tasks dispatch events are never called once unregister returned
+static void test_unregister_stress(void) {
+    static hook_data_t data[STRESS_ROUNDS];
+    stress_done = xSemaphoreCreateCounting(2, 0);
+    CHECK(stress_done != NULL);
+    atomic_store(&stress_running, true);
+    for (int i = 0; i < 2; i++) {
+        CHECK(xTaskCreate(stress_dispatch_task, "dispatch", 4096, NULL, 5, NULL) == pdPASS);
+    }
+
+    uint32_t calls = 0;
+    for (int round = 0; round < STRESS_ROUNDS; round++) {
+        int id = bsp_input_hook_register(counting_hook, &data[round]);
+        CHECK(id >= 0);
+        vTaskDelay(0);
+        bsp_input_hook_unregister(id);
+        atomic_store(&data[round].freed, true);
+        calls += atomic_load(&data[round].calls);
+    }
+    atomic_store(&stress_running, false);
+    for (int i = 0; i < 2; i++) {
+        CHECK(xSemaphoreTake(stress_done, pdMS_TO_TICKS(10000)) == pdTRUE);
+    }
+    vSemaphoreDelete(stress_done);
+
+    uint32_t calls_after_free = 0;
+    for (int round = 0; round < STRESS_ROUNDS; round++) {
+        calls_after_free += atomic_load(&data[round].calls_after_free);
+    }
+    printf("  %d hooks, %u events dispatched, %u hook calls, %u after unregister\n", STRESS_ROUNDS,
+           atomic_load(&stress_events), calls, calls_after_free);
+    CHECK(calls_after_free == 0);
+}
+
+// ============================================
+// Benchmark
+// ============================================
+
+static void test_benchmark(void) {
+    hook_data_t data[2] = {0};
+    int         ids[2];
+    for (int i = 0; i < 2; i++) {
+        ids[i] = bsp_input_hook_register(counting_hook, &data[i]);
+        CHECK(ids[i] >= 0);
+    }
+    bsp_input_event_t event = make_event(BSP_INPUT_NAVIGATION_KEY_UP);
+    int64_t           start = test_wall_time_us();
+    for (int i = 0; i < BENCH_EVENTS; i++) {
+        bsp_input_hooks_process(&event);
+    }
+    int64_t elapsed = test_wall_time_us() - start;
+    printf("  %.1f ns per event dispatched to 2 hooks\n", 1000.0 * elapsed / BENCH_EVENTS);
+    for (int i = 0; i < 2; i++) {
+        bsp_input_hook_unregister(ids[i]);
+    }
+}
+
+int main(void) {
+    bsp_input_hooks_initialize();
+
+    RUN_TEST(test_order);
+    RUN_TEST(test_unregister_waits);
+    RUN_TEST(test_unregister_from_hook);
+    RUN_TEST(test_unregister_from_hook_with_many_dispatchers);
+    RUN_TEST(test_unregister_stress);
+    RUN_TEST(test_benchmark);
+    return 0;
+}
@@ -0,0 +1,170 @@
+// Host tests: input event timestamps and latency histograms on a simulated clock, built with and without
+// CONFIG_BSP_INPUT_LATENCY_STATS
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "badge_bsp_input_queue.h"
+#include "bsp/input.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "host_idf.h"
+#include "sdkconfig.h"
+#include "test_support.h"
+
+#define CLOCK_START_US 1000000
+
+// Generates a scancode event now, like the interrupt handler of a target does
+static bsp_input_event_t generate_event(void) {
+    bsp_input_event_t event = {
+        .type                   = INPUT_EVENT_TYPE_SCANCODE,
+        .args_scancode.scancode = BSP_INPUT_SCANCODE_A,
+        .timestamp              = esp_timer_get_time(),
+    };
+    return event;
+}
+
+#if CONFIG_BSP_INPUT_LATENCY_STATS
+
+// Bucket of a latency in the histogram: below 2 us in bucket 0, from 2^n us up to 2^(n+1) us in bucket n, longer
+// latencies in the last bucket
+static size_t bucket_of(uint32_t latency_us) {
+    size_t bucket = latency_us < 2 ? 0 : 31 - __builtin_clz(latency_us);
+    return bucket < BSP_INPUT_LATENCY_HISTOGRAM_BUCKETS ? bucket : BSP_INPUT_LATENCY_HISTOGRAM_BUCKETS - 1;
+}
+
+#endif
+
+// ============================================
+// Tests
+// ============================================
+
+// An event carries the time it was generated and the time it was queued, the application receives both
+static void test_timestamps(void) {
+    bsp_input_event_t event     = generate_event();
+    int64_t           generated = esp_timer_get_time();
+    host_clock_advance(300);
+    CHECK(bsp_input_queue_send(&event));
+    host_clock_advance(5000);
+
+    bsp_input_event_t received;
+    CHECK(bsp_input_get_events(&received, 1, 0) == 1);
+    CHECK(received.timestamp == generated);
+    CHECK(received.queued_timestamp == generated + 300);
+
+    // An event generated without a timestamp is stamped when it is queued
+    event = (bsp_input_event_t){.type = INPUT_EVENT_TYPE_SCANCODE, .args_scancode.scancode = BSP_INPUT_SCANCODE_B};
+    CHECK(bsp_input_queue_send(&event));
+    CHECK(bsp_input_get_events(&received, 1, 0) == 1);
+    CHECK(received.timestamp == esp_timer_get_time());
+    CHECK(received.queued_timestamp == received.timestamp);
+}
+
+#if CONFIG_BSP_INPUT_LATENCY_STATS
+
+// Both stages are measured on the events that pass through bsp_input_get_events and land in the right buckets
+static void test_histograms(void) {
+    static const struct {
+        uint32_t source_to_enqueue_us;
+        uint32_t enqueue_to_dequeue_us;
+    } samples[] = {
+        {0, 1}, {3, 40}, {300, 5000}, {1000, 20000}, {150, 70000},
+    };
+    size_t num_samples = sizeof(samples) / sizeof(samples[0]);
+
+    bsp_input_reset_latency_stats();
+    bsp_input_latency_stats_t expected = {0};
+    for (size_t i = 0; i < num_samples; i++) {
+        bsp_input_event_t event = generate_event();
+        host_clock_advance(samples[i].source_to_enqueue_us);
+        CHECK(bsp_input_queue_send(&event));
+        host_clock_advance(samples[i].enqueue_to_dequeue_us);
+        bsp_input_event_t received;
+        CHECK(bsp_input_get_events(&received, 1, 0) == 1);
+
+        expected.source_to_enqueue.histogram[bucket_of(samples[i].source_to_enqueue_us)]++;
+        expected.source_to_enqueue.total_us += samples[i].source_to_enqueue_us;
+        if (samples[i].source_to_enqueue_us > expected.source_to_enqueue.max_us) {
+            expected.source_to_enqueue.max_us = samples[i].source_to_enqueue_us;
+        }
+        expected.enqueue_to_dequeue.histogram[bucket_of(samples[i].enqueue_to_dequeue_us)]++;
+        expected.enqueue_to_dequeue.total_us += samples[i].enqueue_to_dequeue_us;
+        if (samples[i].enqueue_to_dequeue_us > expected.enqueue_to_dequeue.max_us) {
+            expected.enqueue_to_dequeue.max_us = samples[i].enqueue_to_dequeue_us;
+        }
+    }
+    expected.source_to_enqueue.count  = num_samples;
+    expected.enqueue_to_dequeue.count = num_samples;
+
+    bsp_input_latency_stats_t stats;
+    CHECK_ESP(ESP_ERR_INVALID_ARG, bsp_input_get_latency_stats(NULL));
+    CHECK_OK(bsp_input_get_latency_stats(&stats));
+    CHECK(memcmp(&stats, &expected, sizeof(stats)) == 0);
+
+    // Latencies past the last bucket are counted in it
+    bsp_input_reset_latency_stats();
+    bsp_input_event_t event = generate_event();
+    host_clock_advance(10000000);
+    CHECK(bsp_input_queue_send(&event));
+    bsp_input_event_t received;
+    CHECK(bsp_input_get_events(&received, 1, 0) == 1);
+    CHECK_OK(bsp_input_get_latency_stats(&stats));
+    CHECK(stats.source_to_enqueue.histogram[BSP_INPUT_LATENCY_HISTOGRAM_BUCKETS - 1] == 1);
+    CHECK(stats.source_to_enqueue.max_us == 10000000);
+    CHECK(stats.enqueue_to_dequeue.histogram[0] == 1);
+
+    bsp_input_reset_latency_stats();
+    CHECK_OK(bsp_input_get_latency_stats(&stats));
+    CHECK(stats.source_to_enqueue.count == 0 && stats.enqueue_to_dequeue.count == 0);
+}
+
+// Applications reading the FreeRTOS queue record the dequeue themselves
+static void test_queue_handle(void) {
+    QueueHandle_t queue = NULL;
+    CHECK_OK(bsp_input_queue_get_handle(&queue));
+    bsp_input_reset_latency_stats();
+
+    bsp_input_event_t event = generate_event();
+    CHECK(bsp_input_queue_send(&event));
+    host_clock_advance(2500);
+    bsp_input_event_t received;
+    CHECK(xQueueReceive(queue, &received, pdMS_TO_TICKS(1000)) == pdTRUE);
+    int64_t waited = esp_timer_get_time() - received.queued_timestamp;
+    bsp_input_record_dequeue(&received);
+
+    bsp_input_latency_stats_t stats;
+    CHECK_OK(bsp_input_get_latency_stats(&stats));
+    CHECK(stats.source_to_enqueue.count == 1 && stats.source_to_enqueue.max_us == 0);
+    CHECK(stats.enqueue_to_dequeue.count == 1 && stats.enqueue_to_dequeue.max_us == waited);
+    CHECK(waited >= 2500);
+}
+
+#else
+
+// Without the statistics events are still stamped, only the histograms are left out
+static void test_disabled(void) {
+    bsp_input_latency_stats_t stats;
+    CHECK_ESP(ESP_ERR_NOT_SUPPORTED, bsp_input_get_latency_stats(&stats));
+    bsp_input_reset_latency_stats();
+    bsp_input_record_dequeue(NULL);
+}
+
+#endif
+
+int main(void) {
+    host_clock_set_simulated(CLOCK_START_US);
+    CHECK_OK(bsp_input_queue_initialize());
+
+    RUN_TEST(test_timestamps);
+#if CONFIG_BSP_INPUT_LATENCY_STATS
+    RUN_TEST(test_histograms);
+    RUN_TEST(test_queue_handle);
+#else
+    RUN_TEST(test_disabled);
+#endif
+    return 0;
+}
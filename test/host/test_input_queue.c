@@ -0,0 +1,211 @@
+// Host tests: input event queue overflow policies, with and without the FreeRTOS queue adapter, and a stress
+// benchmark with several producer tasks
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "badge_bsp_input_queue.h"
+#include "bsp/input.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+#include "test_support.h"
+
+#define DEPTH         CONFIG_BSP_INPUT_QUEUE_DEPTH
+#define MAX_PRODUCERS 4
+#define BENCH_EVENTS  50000
+
+// Events carry their producer in the scancode and their sequence number in the generation timestamp
+static bsp_input_event_t make_event(uint32_t producer, int64_t sequence) {
+    bsp_input_event_t event = {
+        .type                   = INPUT_EVENT_TYPE_SCANCODE,
+        .args_scancode.scancode = producer,
+        .timestamp              = sequence,
+    };
+    return event;
+}
+
+static void reset(bsp_input_overflow_policy_t policy) {
+    bsp_input_event_t events[DEPTH];
+    while (bsp_input_queue_receive(events, DEPTH) > 0) {
+    }
+    CHECK_OK(bsp_input_set_overflow_policy(policy));
+    bsp_input_reset_queue_stats();
+}
+
+// Sends count events numbered from 1 and waits for the adapter to move each of them, so the ring never fills
+static void send_paced(size_t count) {
+    for (size_t i = 1; i <= count; i++) {
+        bsp_input_event_t event = make_event(0, i);
+        bsp_input_queue_send(&event);
+        int64_t                 deadline = test_wall_time_us() + 1000000;
+        bsp_input_queue_stats_t stats;
+        do {
+            CHECK(test_wall_time_us() < deadline);
+            vTaskDelay(0);
+            CHECK_OK(bsp_input_get_queue_stats(&stats));
+        } while (stats.pending > DEPTH);
+    }
+}
+
+// Receives the events still pending in the adapter queue and checks they are the events numbered first to last
+static void expect_queue(QueueHandle_t queue, int64_t first, int64_t last) {
+    bsp_input_event_t event;
+    for (int64_t sequence = first; sequence <= last; sequence++) {
+        CHECK(xQueueReceive(queue, &event, pdMS_TO_TICKS(1000)) == pdTRUE);
+        CHECK(event.timestamp == sequence);
+    }
+    CHECK(xQueueReceive(queue, &event, pdMS_TO_TICKS(20)) != pdTRUE);
+}
+
+// ============================================
+// Tests
+// ============================================
+
+// A full ring drops the new event or the oldest pending event, depending on the policy
+static void test_ring_policies(void) {
+    bsp_input_event_t       events[DEPTH];
+    bsp_input_queue_stats_t stats;
+
+    reset(BSP_INPUT_OVERFLOW_DROP_NEWEST);
+    for (int64_t i = 1; i <= 3 * DEPTH; i++) {
+        bsp_input_event_t event = make_event(0, i);
+        CHECK(bsp_input_queue_send(&event) == (i <= DEPTH));
+    }
+    CHECK_OK(bsp_input_get_queue_stats(&stats));
+    CHECK(stats.pending == DEPTH && stats.queued == DEPTH && stats.dropped_newest == 2 * DEPTH);
+    CHECK(stats.high_water == DEPTH);
+    CHECK(bsp_input_queue_receive(events, DEPTH) == DEPTH);
+    for (size_t i = 0; i < DEPTH; i++) {
+        CHECK(events[i].timestamp == (int64_t)i + 1);
+    }
+
+    reset(BSP_INPUT_OVERFLOW_DROP_OLDEST);
+    for (int64_t i = 1; i <= 3 * DEPTH; i++) {
+        bsp_input_event_t event = make_event(0, i);
+        CHECK(bsp_input_queue_send(&event));
+    }
+    CHECK_OK(bsp_input_get_queue_stats(&stats));
+    CHECK(stats.pending == DEPTH && stats.queued == 3 * DEPTH && stats.dropped_oldest == 2 * DEPTH);
+    CHECK(bsp_input_queue_receive(events, DEPTH) == DEPTH);
+    for (size_t i = 0; i < DEPTH; i++) {
+        CHECK(events[i].timestamp == 2 * DEPTH + (int64_t)i + 1);
+    }
+}
+
+// Once the adapter queue exists it holds the pending events: the policies keep at most the depth of the queue pending
+// and drop oldest drops the oldest event of all
+static void test_adapter_policies(void) {
+    QueueHandle_t           queue = NULL;
+    bsp_input_queue_stats_t stats;
+    CHECK_OK(bsp_input_queue_get_handle(&queue));
+
+    reset(BSP_INPUT_OVERFLOW_DROP_OLDEST);
+    send_paced(3 * DEPTH);
+    expect_queue(queue, 2 * DEPTH + 1, 3 * DEPTH);
+    CHECK_OK(bsp_input_get_queue_stats(&stats));
+    CHECK(stats.queued == 3 * DEPTH && stats.dropped_oldest == 2 * DEPTH && stats.dropped_newest == 0);
+    CHECK(stats.high_water == DEPTH);
+
+    reset(BSP_INPUT_OVERFLOW_DROP_NEWEST);
+    send_paced(3 * DEPTH);
+    expect_queue(queue, 1, DEPTH);
+    CHECK_OK(bsp_input_get_queue_stats(&stats));
+    CHECK(stats.queued == DEPTH && stats.dropped_newest == 2 * DEPTH && stats.dropped_oldest == 0);
+}
+
+// ============================================
+// Benchmark
+// ============================================
+
+typedef struct {
+    uint32_t          id;
+    SemaphoreHandle_t done;
+} producer_t;
+
+static atomic_bool producers_go = false;
+
+static void producer_task(void* arg) {
+    producer_t* producer = arg;
+    while (!atomic_load(&producers_go)) {
+        vTaskDelay(0);
+    }
+    for (int64_t i = 1; i <= BENCH_EVENTS; i++) {
+        bsp_input_event_t event = make_event(producer->id, i);
+        bsp_input_queue_send(&event);
+    }
+    xSemaphoreGive(producer->done);
+    vTaskDelete(NULL);
+}
+
+// Producers flood the ring while the main task receives: every producer's events arrive in order and every queued
+// event is either received or dropped to make room
+static void stress(bsp_input_overflow_policy_t policy, size_t num_producers) {
+    static char const* const policy_names[] = {"drop newest", "drop oldest", "block"};
+    producer_t               producers[MAX_PRODUCERS];
+    int64_t                  last[MAX_PRODUCERS] = {0};
+    size_t                   total               = num_producers * BENCH_EVENTS;
+
+    reset(policy);
+    atomic_store(&producers_go, false);
+    for (size_t i = 0; i < num_producers; i++) {
+        producers[i] = (producer_t){.id = i, .done = xSemaphoreCreateBinary()};
+        CHECK(producers[i].done != NULL);
+        CHECK(xTaskCreate(producer_task, "producer", 4096, &producers[i], 5, NULL) == pdPASS);
+    }
+
+    size_t                  received = 0;
+    bsp_input_event_t       events[DEPTH];
+    bsp_input_queue_stats_t stats;
+    int64_t                 start = test_wall_time_us();
+    atomic_store(&producers_go, true);
+    // Every producer counts an event after queueing it, once all events are counted the rest is drained
+    size_t count;
+    do {
+        CHECK_OK(bsp_input_get_queue_stats(&stats));
+        while ((count = bsp_input_queue_receive(events, DEPTH)) > 0) {
+            for (size_t i = 0; i < count; i++) {
+                uint32_t id = events[i].args_scancode.scancode;
+                CHECK(id < num_producers && events[i].timestamp > last[id]);
+                last[id] = events[i].timestamp;
+            }
+            received += count;
+        }
+    } while (stats.queued + stats.dropped_newest < total);
+    int64_t elapsed = test_wall_time_us() - start;
+
+    for (size_t i = 0; i < num_producers; i++) {
+        CHECK(xSemaphoreTake(producers[i].done, pdMS_TO_TICKS(10000)) == pdTRUE);
+        vSemaphoreDelete(producers[i].done);
+    }
+    CHECK_OK(bsp_input_get_queue_stats(&stats));
+    CHECK(received == stats.queued - stats.dropped_oldest);
+    printf("    %-11s %zu producers %6.2f Mevents/s, dropped newest %6u oldest %6u, blocked %6u, high water %2u\n",
+           policy_names[policy], num_producers, (double)total / elapsed, stats.dropped_newest, stats.dropped_oldest,
+           stats.blocked, stats.high_water);
+}
+
+static void test_benchmark(void) {
+    printf("  %d events per producer\n", BENCH_EVENTS);
+    for (bsp_input_overflow_policy_t policy = BSP_INPUT_OVERFLOW_DROP_NEWEST; policy <= BSP_INPUT_OVERFLOW_BLOCK;
+         policy++) {
+        for (size_t num_producers = 1; num_producers <= MAX_PRODUCERS; num_producers *= 2) {
+            stress(policy, num_producers);
+        }
+    }
+}
+
+int main(void) {
+    CHECK_OK(bsp_input_queue_initialize());
+
+    RUN_TEST(test_ring_policies);
+    RUN_TEST(test_benchmark);
+    // Last, the adapter can not be removed again
+    RUN_TEST(test_adapter_policies);
+    return 0;
+}
@@ -0,0 +1,160 @@
+// Host tests: key repeat timing, stale repeats and repeats on a full queue, on a simulated clock
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "badge_bsp_input_hooks.h"
+#include "badge_bsp_input_queue.h"
+#include "badge_bsp_input_repeat.h"
+#include "bsp/input.h"
+#include "esp_timer.h"
+#include "host_idf.h"
+#include "sdkconfig.h"
+#include "test_support.h"
+
+#define CLOCK_START_US 1000000
+#define DEPTH          CONFIG_BSP_INPUT_QUEUE_DEPTH
+#define KEY            7
+#define REPEATS        16
+
+void bsp_input_hooks_initialize(void);
+
+static bsp_input_event_t navigation_event(void) {
+    bsp_input_event_t event = {
+        .type                  = INPUT_EVENT_TYPE_NAVIGATION,
+        .args_navigation.key   = BSP_INPUT_NAVIGATION_KEY_UP,
+        .args_navigation.state = true,
+    };
+    return event;
+}
+
+static bsp_input_event_t keyboard_event(void) {
+    bsp_input_event_t event = {
+        .type                = INPUT_EVENT_TYPE_KEYBOARD,
+        .args_keyboard.ascii = 'a',
+        .args_keyboard.utf8  = "a",
+    };
+    return event;
+}
+
+static void drain(void) {
+    bsp_input_event_t events[DEPTH];
+    while (bsp_input_queue_receive(events, DEPTH) > 0) {
+    }
+}
+
+// ============================================
+// Tests
+// ============================================
+
+// Repeats start after the delay and speed up by the acceleration until the minimum interval, a release stops them
+static void test_timing(void) {
+    bsp_input_repeat_config_t config;
+    CHECK_OK(bsp_input_get_repeat_config(&config));
+    bsp_input_event_t event = navigation_event();
+    int64_t           start = esp_timer_get_time();
+    bsp_input_repeat_press(KEY, &event);
+
+    bsp_input_event_t received;
+    host_clock_advance((int64_t)config.delay_ms * 1000 - 1);
+    CHECK(bsp_input_queue_receive(&received, 1) == 0);
+
+    int64_t  expected = start + (int64_t)config.delay_ms * 1000;
+    uint32_t interval = config.interval_ms;
+    host_clock_advance(1);
+    for (int repeat = 0; repeat < REPEATS; repeat++) {
+        CHECK(bsp_input_queue_receive(&received, 1) == 1);
+        CHECK(received.type == INPUT_EVENT_TYPE_NAVIGATION);
+        CHECK(received.args_navigation.key == event.args_navigation.key);
+        CHECK(received.timestamp == expected);
+        CHECK(bsp_input_queue_receive(&received, 1) == 0);
+        host_clock_advance((int64_t)interval * 1000);
+        expected += (int64_t)interval * 1000;
+        uint32_t next = interval - interval * config.acceleration / 100;
+        interval      = next > config.min_interval_ms ? next : config.min_interval_ms;
+    }
+    CHECK(interval == config.min_interval_ms);
+
+    bsp_input_repeat_release(KEY);
+    drain();
+    host_clock_advance(1000000);
+    CHECK(bsp_input_queue_receive(&received, 1) == 0);
+}
+
+static bool releasing_hook_armed = false;
+
+static bool releasing_hook(bsp_input_event_t* event, void* user_data) {
+    if (releasing_hook_armed) {
+        releasing_hook_armed = false;
+        bsp_input_repeat_release(KEY);
+    }
+    return false;
+}
+
+// A release while the timer callback sends a repeat drops the rest of that repeat, even from a hook offered the repeat
+static void test_stale_dropped(void) {
+    int id = bsp_input_hook_register(releasing_hook, NULL);
+    CHECK(id >= 0);
+    bsp_input_event_t navigation = navigation_event();
+    bsp_input_event_t keyboard   = keyboard_event();
+    bsp_input_repeat_press(KEY, &navigation);
+    bsp_input_repeat_press(KEY, &keyboard);
+
+    bsp_input_repeat_config_t config;
+    CHECK_OK(bsp_input_get_repeat_config(&config));
+    host_clock_advance((int64_t)config.delay_ms * 1000);
+    bsp_input_event_t events[4];
+    CHECK(bsp_input_queue_receive(events, 4) == 2);
+    CHECK(events[0].type == INPUT_EVENT_TYPE_NAVIGATION && events[1].type == INPUT_EVENT_TYPE_KEYBOARD);
+
+    releasing_hook_armed = true;
+    host_clock_advance((int64_t)config.interval_ms * 1000);
+    CHECK(!releasing_hook_armed);
+    CHECK(bsp_input_queue_receive(events, 4) == 1);
+    CHECK(events[0].type == INPUT_EVENT_TYPE_NAVIGATION);
+
+    host_clock_advance(1000000);
+    CHECK(bsp_input_queue_receive(events, 4) == 0);
+    bsp_input_hook_unregister(id);
+}
+
+// With the block policy a full queue drops repeats instead of holding up the timer task
+static void test_full_queue(void) {
+    CHECK_OK(bsp_input_set_overflow_policy(BSP_INPUT_OVERFLOW_BLOCK));
+    for (int i = 0; i < DEPTH; i++) {
+        bsp_input_event_t event = keyboard_event();
+        CHECK(bsp_input_queue_send(&event));
+    }
+    bsp_input_reset_queue_stats();
+
+    bsp_input_event_t navigation = navigation_event();
+    bsp_input_event_t keyboard   = keyboard_event();
+    bsp_input_repeat_press(KEY, &navigation);
+    bsp_input_repeat_press(KEY, &keyboard);
+    bsp_input_repeat_config_t config;
+    CHECK_OK(bsp_input_get_repeat_config(&config));
+    int64_t start = esp_timer_get_time();
+    host_clock_advance((int64_t)config.delay_ms * 1000);
+    CHECK(esp_timer_get_time() == start + (int64_t)config.delay_ms * 1000);
+
+    bsp_input_queue_stats_t stats;
+    CHECK_OK(bsp_input_get_queue_stats(&stats));
+    CHECK(stats.blocked == 0 && stats.dropped_newest == 2);
+    bsp_input_repeat_release(KEY);
+    drain();
+    CHECK_OK(bsp_input_set_overflow_policy(BSP_INPUT_OVERFLOW_DROP_NEWEST));
+}
+
+int main(void) {
+    host_clock_set_simulated(CLOCK_START_US);
+    CHECK_OK(bsp_input_queue_initialize());
+    bsp_input_hooks_initialize();
+    CHECK_OK(bsp_input_repeat_initialize());
+
+    RUN_TEST(test_timing);
+    RUN_TEST(test_stale_dropped);
+    RUN_TEST(test_full_queue);
+    return 0;
+}
@@ -0,0 +1,161 @@
+// Host tests: input state snapshot kept up to date from the event path and read without locking
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "badge_bsp_input_state.h"
+#include "bsp/input.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "test_support.h"
+
+#define WRITER_ROUNDS 200000
+#define BENCH_ROUNDS  1000000
+
+// Two keys whose bits live in words far apart in the snapshot, a torn copy can see both pressed
+#define KEY_FIRST  BSP_INPUT_SCANCODE_ESC
+#define KEY_SECOND BSP_INPUT_SCANCODE_ESCAPED_GREY_DOWN
+
+static void send_scancode(uint32_t scancode, bool state) {
+    bsp_input_event_t event = {
+        .type                   = INPUT_EVENT_TYPE_SCANCODE,
+        .args_scancode.scancode = scancode | (state ? 0 : BSP_INPUT_SCANCODE_RELEASE_MODIFIER),
+    };
+    bsp_input_state_update(&event);
+}
+
+static void send_navigation(bsp_input_navigation_key_t key, bool state) {
+    bsp_input_event_t event = {
+        .type                  = INPUT_EVENT_TYPE_NAVIGATION,
+        .args_navigation.key   = key,
+        .args_navigation.state = state,
+    };
+    bsp_input_state_update(&event);
+}
+
+static void send_action(bsp_input_action_type_t action, bool state) {
+    bsp_input_event_t event = {
+        .type              = INPUT_EVENT_TYPE_ACTION,
+        .args_action.type  = action,
+        .args_action.state = state,
+    };
+    bsp_input_state_update(&event);
+}
+
+static atomic_bool       writer_running = false;
+static SemaphoreHandle_t writer_done    = NULL;
+
+// Moves a single pressed key back and forth between the two keys, never holding both
+static void writer_task(void* arg) {
+    for (int round = 0; round < WRITER_ROUNDS; round++) {
+        send_scancode(KEY_FIRST, true);
+        send_scancode(KEY_FIRST, false);
+        send_scancode(KEY_SECOND, true);
+        send_scancode(KEY_SECOND, false);
+        bsp_input_state_set_modifiers(round & 1 ? BSP_INPUT_MODIFIER_SHIFT_L : 0);
+    }
+    atomic_store(&writer_running, false);
+    xSemaphoreGive(writer_done);
+    vTaskDelete(NULL);
+}
+
+// ============================================
+// Tests
+// ============================================
+
+// Navigation, scancode and action events and the modifiers end up in the snapshot, releases clear them again
+static void test_updates(void) {
+    bsp_input_state_t state;
+    CHECK_ESP(ESP_ERR_INVALID_ARG, bsp_input_get_state_snapshot(NULL));
+
+    send_navigation(BSP_INPUT_NAVIGATION_KEY_UP, true);
+    send_scancode(BSP_INPUT_SCANCODE_A, true);
+    send_scancode(BSP_INPUT_SCANCODE_ESCAPED_GREY_UP, true);
+    send_action(BSP_INPUT_ACTION_TYPE_SD_CARD, true);
+    bsp_input_state_set_modifiers(BSP_INPUT_MODIFIER_CTRL_L);
+    CHECK_OK(bsp_input_get_state_snapshot(&state));
+    CHECK(bsp_input_state_get_navigation_key(&state, BSP_INPUT_NAVIGATION_KEY_UP));
+    CHECK(!bsp_input_state_get_navigation_key(&state, BSP_INPUT_NAVIGATION_KEY_DOWN));
+    CHECK(bsp_input_state_get_scancode(&state, BSP_INPUT_SCANCODE_A));
+    CHECK(!bsp_input_state_get_scancode(&state, BSP_INPUT_SCANCODE_B));
+    CHECK(bsp_input_state_get_scancode(&state, BSP_INPUT_SCANCODE_ESCAPED_GREY_UP));
+    CHECK(!bsp_input_state_get_scancode(&state, BSP_INPUT_SCANCODE_ESCAPED_GREY_DOWN));
+    CHECK(bsp_input_state_get_action(&state, BSP_INPUT_ACTION_TYPE_SD_CARD));
+    CHECK(state.modifiers == BSP_INPUT_MODIFIER_CTRL_L);
+
+    send_navigation(BSP_INPUT_NAVIGATION_KEY_UP, false);
+    send_scancode(BSP_INPUT_SCANCODE_A, false);
+    send_scancode(BSP_INPUT_SCANCODE_ESCAPED_GREY_UP, false);
+    send_action(BSP_INPUT_ACTION_TYPE_SD_CARD, false);
+    bsp_input_state_set_modifiers(0);
+    CHECK_OK(bsp_input_get_state_snapshot(&state));
+    bsp_input_state_t empty = {0};
+    CHECK(memcmp(&state, &empty, sizeof(state)) == 0);
+}
+
+// Keys that can not be tracked leave the snapshot alone
+static void test_untracked(void) {
+    bsp_input_state_t state;
+    send_navigation(64, true);
+    send_action(32, true);
+    send_scancode(0xE1, true);
+    CHECK_OK(bsp_input_get_state_snapshot(&state));
+    bsp_input_state_t empty = {0};
+    CHECK(memcmp(&state, &empty, sizeof(state)) == 0);
+    CHECK(!bsp_input_state_get_navigation_key(&state, 64));
+    CHECK(!bsp_input_state_get_action(&state, 32));
+    CHECK(bsp_input_state_scancode_index(0xE1) == -1);
+}
+
+// A snapshot taken while another task updates the state is a state that existed: the two keys are never seen
+// pressed together, even though their bits are copied far apart
+static void test_consistent_while_writing(void) {
+    writer_done = xSemaphoreCreateBinary();
+    CHECK(writer_done != NULL);
+    atomic_store(&writer_running, true);
+    CHECK(xTaskCreate(writer_task, "writer", 4096, NULL, 5, NULL) == pdPASS);
+
+    size_t snapshots = 0;
+    size_t torn      = 0;
+    while (atomic_load(&writer_running)) {
+        bsp_input_state_t state;
+        CHECK_OK(bsp_input_get_state_snapshot(&state));
+        if (bsp_input_state_get_scancode(&state, KEY_FIRST) && bsp_input_state_get_scancode(&state, KEY_SECOND)) {
+            torn++;
+        }
+        snapshots++;
+    }
+    CHECK(xSemaphoreTake(writer_done, pdMS_TO_TICKS(10000)) == pdTRUE);
+    vSemaphoreDelete(writer_done);
+    printf("  %zu snapshots during the writes, %zu torn\n", snapshots, torn);
+    CHECK(torn == 0);
+}
+
+// ============================================
+// Benchmark
+// ============================================
+
+static void test_benchmark(void) {
+    bsp_input_state_t state;
+    size_t            pressed = 0;
+    int64_t           start   = test_wall_time_us();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        CHECK_OK(bsp_input_get_state_snapshot(&state));
+        pressed += bsp_input_state_get_scancode(&state, BSP_INPUT_SCANCODE_A);
+    }
+    int64_t elapsed = test_wall_time_us() - start;
+    printf("  %.1f ns per snapshot (%zu pressed)\n", 1000.0 * elapsed / BENCH_ROUNDS, pressed);
+}
+
+int main(void) {
+    RUN_TEST(test_updates);
+    RUN_TEST(test_untracked);
+    RUN_TEST(test_consistent_while_writing);
+    RUN_TEST(test_benchmark);
+    return 0;
+}
@@ -0,0 +1,157 @@
+// Host tests: tanmatsu keyboard decoder replaying recorded coprocessor key reports
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "bsp/input.h"
+#include "bsp/tanmatsu.h"
+#include "driver/gpio.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/timers.h"
+#include "tanmatsu_coprocessor.h"
+#include "test_support.h"
+
+#define MAX_EVENTS_PER_REPORT 32
+
+esp_err_t bsp_input_initialize(void);
+
+// Replaces the coprocessor and GPIO drivers, the keyboard callback is driven by the test directly
+esp_err_t bsp_tanmatsu_coprocessor_get_handle(tanmatsu_coprocessor_handle_t* handle) {
+    *handle = NULL;
+    return ESP_OK;
+}
+
+esp_err_t tanmatsu_coprocessor_get_keyboard_keys(tanmatsu_coprocessor_handle_t handle,
+                                                 tanmatsu_coprocessor_keys_t*  out_keys) {
+    memset(out_keys, 0, sizeof(*out_keys));
+    return ESP_OK;
+}
+
+esp_err_t tanmatsu_coprocessor_get_keyboard_backlight(tanmatsu_coprocessor_handle_t handle, uint8_t* out_brightness) {
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t tanmatsu_coprocessor_set_keyboard_backlight(tanmatsu_coprocessor_handle_t handle, uint8_t brightness) {
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t tanmatsu_coprocessor_get_inputs(tanmatsu_coprocessor_handle_t  handle,
+                                          tanmatsu_coprocessor_inputs_t* out_inputs) {
+    memset(out_inputs, 0, sizeof(*out_inputs));
+    return ESP_OK;
+}
+
+esp_err_t gpio_config(gpio_config_t const* config) {
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio_num) {
+    return 1;
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio_num, void (*isr_handler)(void* arg), void* args) {
+    return ESP_OK;
+}
+
+BaseType_t xTimerPendFunctionCallFromISR(PendedFunction_t function, void* parameter1, uint32_t parameter2,
+                                         BaseType_t* higher_priority_task_woken) {
+    function(parameter1, parameter2);
+    return pdPASS;
+}
+
+// Formats an event the way the recording lists it
+static void format_event(bsp_input_event_t const* event, char* line, size_t size) {
+    switch (event->type) {
+        case INPUT_EVENT_TYPE_NAVIGATION:
+            snprintf(line, size, "N %u %u %08x", (unsigned)event->args_navigation.key,
+                     (unsigned)event->args_navigation.state, (unsigned)event->args_navigation.modifiers);
+            break;
+        case INPUT_EVENT_TYPE_SCANCODE:
+            snprintf(line, size, "S %03x", (unsigned)event->args_scancode.scancode);
+            break;
+        case INPUT_EVENT_TYPE_KEYBOARD: {
+            size_t length = snprintf(line, size, "K %02x ", (unsigned char)event->args_keyboard.ascii);
+            for (char const* c = event->args_keyboard.utf8; *c != '\0' && length < size; c++) {
+                length += snprintf(line + length, size - length, "%02x", (unsigned char)*c);
+            }
+            snprintf(line + length, size - length, " %08x", (unsigned)event->args_keyboard.modifiers);
+            break;
+        }
+        default:
+            snprintf(line, size, "? %d", (int)event->type);
+            break;
+    }
+}
+
+// ============================================
+// Tests
+// ============================================
+
+// Every recorded report produces exactly the recorded events in the recorded order, including reports in which
+// several keys change at once
+static void test_replay(void) {
+    FILE* file = fopen(TEST_DATA_DIR "/tanmatsu_keys.txt", "r");
+    CHECK(file != NULL);
+
+    tanmatsu_coprocessor_keys_t prev_keys = {0};
+    tanmatsu_coprocessor_keys_t keys      = {0};
+    bsp_input_event_t           events[MAX_EVENTS_PER_REPORT];
+    size_t                      num_events = 0;
+    size_t                      next_event = 0;
+    size_t                      report     = 0;
+    char                        line[128];
+    char                        actual[64];
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '#' || line[0] == '\0') {
+            continue;
+        }
+        if (line[0] == 'R') {
+            if (next_event != num_events) {
+                format_event(&events[next_event], actual, sizeof(actual));
+                fprintf(stderr, "report %zu: unexpected event %s\n", report, actual);
+                CHECK(next_event == num_events);
+            }
+            char const* cursor = line + 1;
+            for (size_t reg = 0; reg < TANMATSU_COPROCESSOR_KEYBOARD_NUM_REGS; reg++) {
+                unsigned value;
+                int      consumed;
+                CHECK(sscanf(cursor, " %2x%n", &value, &consumed) == 1);
+                keys.raw[reg]  = value;
+                cursor        += consumed;
+            }
+            report++;
+            bsp_internal_coprocessor_keyboard_callback(NULL, &prev_keys, &keys);
+            prev_keys  = keys;
+            num_events = bsp_input_get_events(events, MAX_EVENTS_PER_REPORT, 0);
+            next_event = 0;
+            continue;
+        }
+        if (next_event == num_events) {
+            fprintf(stderr, "report %zu: missing event %s\n", report, line);
+            CHECK(next_event < num_events);
+        }
+        format_event(&events[next_event++], actual, sizeof(actual));
+        if (strcmp(actual, line) != 0) {
+            fprintf(stderr, "report %zu: expected %s, got %s\n", report, line, actual);
+            CHECK(strcmp(actual, line) == 0);
+        }
+    }
+    CHECK(next_event == num_events);
+    CHECK(report > 0);
+    fclose(file);
+}
+
+int main(void) {
+    // The recording holds the events of the key reports only, without repeats
+    bsp_input_repeat_config_t repeat = {0};
+    CHECK_OK(bsp_input_set_repeat_config(&repeat));
+    CHECK_OK(bsp_input_initialize());
+
+    RUN_TEST(test_replay);
+    return 0;
+}
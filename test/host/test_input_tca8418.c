@@ -0,0 +1,195 @@
+// Host tests: TCA8418 keyboard decoders of hackaday2025 and why2025 replaying recorded key event FIFO contents
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "bsp/i2c.h"
+#include "bsp/input.h"
+#include "driver/gpio.h"
+#include "tca8418.h"
+#include "test_support.h"
+
+#define MAX_FIFO_EVENTS       10
+#define MAX_EVENTS_PER_REPORT 32
+
+esp_err_t bsp_input_initialize(void);
+
+// Replaces the I2C bus, GPIO and TCA8418 drivers, the key callback is driven by the test directly
+static tca8418_callback_t key_callback = NULL;
+static uint8_t            fifo_codes[MAX_FIFO_EVENTS];
+static bool               fifo_pressed[MAX_FIFO_EVENTS];
+static size_t             fifo_length   = 0;
+static size_t             fifo_position = 0;
+
+esp_err_t bsp_i2c_primary_bus_get_handle(i2c_master_bus_handle_t* handle) {
+    *handle = NULL;
+    return ESP_OK;
+}
+
+esp_err_t gpio_config(gpio_config_t const* config) {
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio_num) {
+    return 1;
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio_num, void (*isr_handler)(void* arg), void* args) {
+    return ESP_OK;
+}
+
+esp_err_t tca8418_initialize(tca8418_handle_t* handle, i2c_master_bus_handle_t i2c_bus, int reset_pin,
+                             int interrupt_pin) {
+    return ESP_OK;
+}
+
+esp_err_t tca8418_set_kp_gpio1(tca8418_handle_t* handle, bool row0, bool row1, bool row2, bool row3, bool row4,
+                               bool row5, bool row6, bool row7) {
+    return ESP_OK;
+}
+
+esp_err_t tca8418_set_kp_gpio2(tca8418_handle_t* handle, bool col0, bool col1, bool col2, bool col3, bool col4,
+                               bool col5, bool col6, bool col7) {
+    return ESP_OK;
+}
+
+esp_err_t tca8418_set_kp_gpio3(tca8418_handle_t* handle, bool col8, bool col9) {
+    return ESP_OK;
+}
+
+esp_err_t tca8418_set_cfg(tca8418_handle_t* handle, bool ai, bool gpi_e_cfg, bool overflow_mode, bool int_cfg,
+                          bool overflow_ien, bool k_lck_ien, bool gpi_ien, bool ke_ien) {
+    return ESP_OK;
+}
+
+esp_err_t tca8418_set_cad_callback(tca8418_handle_t* handle, tca8418_callback_t callback) {
+    return ESP_OK;
+}
+
+esp_err_t tca8418_set_lock_callback(tca8418_handle_t* handle, tca8418_callback_t callback) {
+    return ESP_OK;
+}
+
+esp_err_t tca8418_set_gpi_callback(tca8418_handle_t* handle, tca8418_callback_t callback) {
+    return ESP_OK;
+}
+
+esp_err_t tca8418_set_overflow_callback(tca8418_handle_t* handle, tca8418_callback_t callback) {
+    return ESP_OK;
+}
+
+esp_err_t tca8418_set_key_callback(tca8418_handle_t* handle, tca8418_callback_t callback) {
+    key_callback = callback;
+    return ESP_OK;
+}
+
+// Pops the next recorded FIFO entry, an empty FIFO reads as key code 0
+esp_err_t tca8418_get_key_event_a(tca8418_handle_t* handle, bool* out_pressed, uint8_t* out_code) {
+    if (fifo_position == fifo_length) {
+        *out_pressed = false;
+        *out_code    = 0;
+        return ESP_OK;
+    }
+    *out_pressed = fifo_pressed[fifo_position];
+    *out_code    = fifo_codes[fifo_position];
+    fifo_position++;
+    return ESP_OK;
+}
+
+// Formats an event the way the recording lists it
+static void format_event(bsp_input_event_t const* event, char* line, size_t size) {
+    switch (event->type) {
+        case INPUT_EVENT_TYPE_NAVIGATION:
+            snprintf(line, size, "N %u %u %08x", (unsigned)event->args_navigation.key,
+                     (unsigned)event->args_navigation.state, (unsigned)event->args_navigation.modifiers);
+            break;
+        case INPUT_EVENT_TYPE_SCANCODE:
+            snprintf(line, size, "S %03x", (unsigned)event->args_scancode.scancode);
+            break;
+        case INPUT_EVENT_TYPE_KEYBOARD: {
+            size_t length = snprintf(line, size, "K %02x ", (unsigned char)event->args_keyboard.ascii);
+            for (char const* c = event->args_keyboard.utf8; *c != '\0' && length < size; c++) {
+                length += snprintf(line + length, size - length, "%02x", (unsigned char)*c);
+            }
+            snprintf(line + length, size - length, " %08x", (unsigned)event->args_keyboard.modifiers);
+            break;
+        }
+        default:
+            snprintf(line, size, "? %d", (int)event->type);
+            break;
+    }
+}
+
+// ============================================
+// Tests
+// ============================================
+
+// Every recorded batch of FIFO entries produces exactly the recorded events in the recorded order, modifiers included
+static void test_replay(void) {
+    FILE* file = fopen(TEST_KEYS_FILE, "r");
+    CHECK(file != NULL);
+    CHECK(key_callback != NULL);
+
+    bsp_input_event_t events[MAX_EVENTS_PER_REPORT];
+    size_t            num_events = 0;
+    size_t            next_event = 0;
+    size_t            report     = 0;
+    char              line[128];
+    char              actual[64];
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '#' || line[0] == '\0') {
+            continue;
+        }
+        if (line[0] == 'R') {
+            if (next_event != num_events) {
+                format_event(&events[next_event], actual, sizeof(actual));
+                fprintf(stderr, "report %zu: unexpected event %s\n", report, actual);
+                CHECK(next_event == num_events);
+            }
+            char const* cursor = line + 1;
+            char        direction;
+            unsigned    code;
+            int         consumed;
+            fifo_length        = 0;
+            fifo_position      = 0;
+            while (sscanf(cursor, " %c%2x%n", &direction, &code, &consumed) == 2) {
+                CHECK(fifo_length < MAX_FIFO_EVENTS);
+                fifo_pressed[fifo_length] = direction == '+';
+                fifo_codes[fifo_length]   = code;
+                fifo_length++;
+                cursor += consumed;
+            }
+            CHECK(fifo_length > 0);
+            report++;
+            key_callback(NULL);
+            CHECK(fifo_position == fifo_length);
+            num_events = bsp_input_get_events(events, MAX_EVENTS_PER_REPORT, 0);
+            next_event = 0;
+            continue;
+        }
+        if (next_event == num_events) {
+            fprintf(stderr, "report %zu: missing event %s\n", report, line);
+            CHECK(next_event < num_events);
+        }
+        format_event(&events[next_event++], actual, sizeof(actual));
+        if (strcmp(actual, line) != 0) {
+            fprintf(stderr, "report %zu: expected %s, got %s\n", report, line, actual);
+            CHECK(strcmp(actual, line) == 0);
+        }
+    }
+    CHECK(next_event == num_events);
+    CHECK(report > 0);
+    fclose(file);
+}
+
+int main(void) {
+    CHECK_OK(bsp_input_initialize());
+
+    RUN_TEST(test_replay);
+    return 0;
+}
@@ -0,0 +1,218 @@
+// Host tests: panel initialization tables, sent to a recording SPI device
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "badge_bsp_lcd_init.h"
+#include "driver/spi_master.h"
+#include "esp_timer.h"
+#include "host_idf.h"
+#include "targets/why2025/why2025_lcd_init_cmds.h"
+#include "test_support.h"
+
+#define MAX_RECORDS 256
+#define QUEUE_SIZE  8
+
+// ============================================
+// Recording SPI device
+// ============================================
+
+typedef struct {
+    int     dc;
+    size_t  length;
+    uint8_t data[64];
+    bool    inline_data;  // Sent from tx_data instead of tx_buffer
+    bool    bus_held;
+    size_t  outstanding;  // Transactions queued but not yet collected when this one was queued
+    int64_t time;
+} spi_record_t;
+
+static spi_record_t       records[MAX_RECORDS];
+static size_t             num_records;
+static spi_transaction_t* pending[QUEUE_SIZE];
+static size_t             pending_head;
+static size_t             pending_count;
+static size_t             max_pending;
+static bool               bus_held;
+static int                bus_acquisitions;
+static size_t             fail_at = SIZE_MAX;  // Record index at which queueing fails
+
+esp_err_t spi_device_acquire_bus(spi_device_handle_t device, TickType_t wait) {
+    (void)device;
+    (void)wait;
+    CHECK(!bus_held);
+    bus_held = true;
+    bus_acquisitions++;
+    return ESP_OK;
+}
+
+void spi_device_release_bus(spi_device_handle_t device) {
+    (void)device;
+    CHECK(bus_held);
+    CHECK(pending_count == 0);  // Every transaction was collected before the bus is released
+    bus_held = false;
+}
+
+esp_err_t spi_device_queue_trans(spi_device_handle_t device, spi_transaction_t* transaction, TickType_t timeout) {
+    (void)device;
+    (void)timeout;
+    if (num_records == fail_at) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    CHECK(num_records < MAX_RECORDS);
+    CHECK(pending_count < QUEUE_SIZE);
+
+    spi_record_t* record = &records[num_records++];
+    record->dc           = (int)(intptr_t)transaction->user;
+    record->length       = transaction->length / 8;
+    record->inline_data  = (transaction->flags & SPI_TRANS_USE_TXDATA) != 0;
+    record->bus_held     = bus_held;
+    record->outstanding  = pending_count;
+    record->time         = esp_timer_get_time();
+    CHECK(record->length <= sizeof(record->data));
+    memcpy(record->data, record->inline_data ? transaction->tx_data : transaction->tx_buffer, record->length);
+
+    pending[(pending_head + pending_count) % QUEUE_SIZE] = transaction;
+    pending_count++;
+    if (pending_count > max_pending) {
+        max_pending = pending_count;
+    }
+    return ESP_OK;
+}
+
+esp_err_t spi_device_get_trans_result(spi_device_handle_t device, spi_transaction_t** out_transaction,
+                                      TickType_t timeout) {
+    (void)device;
+    (void)timeout;
+    CHECK(pending_count > 0);
+    *out_transaction = pending[pending_head];
+    pending_head     = (pending_head + 1) % QUEUE_SIZE;
+    pending_count--;
+    return ESP_OK;
+}
+
+static void recorder_reset(void) {
+    num_records      = 0;
+    pending_head     = 0;
+    pending_count    = 0;
+    max_pending      = 0;
+    bus_acquisitions = 0;
+    fail_at          = SIZE_MAX;
+}
+
+// ============================================
+// Tests
+// ============================================
+
+// Command 0x00 (NOP) next to delays and at the end, the old encoding used 0x00 to start delay and end records
+static const uint8_t nop_table[] = {
+    BSP_LCD_INIT_CMD0(0x00),
+    BSP_LCD_INIT_DELAY(5),
+    BSP_LCD_INIT_CMD(0x00, 0x81, 0xFF),
+    BSP_LCD_INIT_CMD(0x3A, 0x55),
+    BSP_LCD_INIT_DELAY(10),
+    BSP_LCD_INIT_DELAY(20),
+    BSP_LCD_INIT_CMD(0x2A, 0x00, 0x00, 0x01, 0x3F, 0x00),
+    BSP_LCD_INIT_CMD0(0x00),
+    BSP_LCD_INIT_END(),
+};
+
+static void test_parse_commands_with_value_zero(void) {
+    const uint8_t*     cursor = nop_table;
+    bsp_lcd_init_cmd_t cmd;
+
+    CHECK(bsp_lcd_init_next(&cursor, &cmd));
+    CHECK(cmd.command == 0x00 && cmd.num_params == 0 && cmd.delay_ms == 5);
+    CHECK(bsp_lcd_init_next(&cursor, &cmd));
+    CHECK(cmd.command == 0x00 && cmd.num_params == 2 && cmd.params[0] == 0x81 && cmd.params[1] == 0xFF);
+    CHECK(cmd.delay_ms == 0);
+    CHECK(bsp_lcd_init_next(&cursor, &cmd));
+    CHECK(cmd.command == 0x3A && cmd.num_params == 1 && cmd.delay_ms == 30);
+    CHECK(bsp_lcd_init_next(&cursor, &cmd));
+    CHECK(cmd.command == 0x2A && cmd.num_params == 5 && cmd.delay_ms == 0);
+    CHECK(bsp_lcd_init_next(&cursor, &cmd));
+    CHECK(cmd.command == 0x00 && cmd.num_params == 0);
+    CHECK(!bsp_lcd_init_next(&cursor, &cmd));
+    CHECK(!bsp_lcd_init_next(&cursor, &cmd));  // Stays at the end
+
+    CHECK(bsp_lcd_init_count(nop_table) == 5);
+}
+
+static void test_parse_why2025_table(void) {
+    // Every command of the table, counted from its source
+    CHECK(bsp_lcd_init_count(why2025_lcd_init_table) == 24);
+
+    const uint8_t*     cursor = why2025_lcd_init_table;
+    bsp_lcd_init_cmd_t cmd;
+    uint32_t           total_delay = 0;
+    while (bsp_lcd_init_next(&cursor, &cmd)) {
+        CHECK(cmd.command != 0x00);
+        total_delay += cmd.delay_ms;
+    }
+    CHECK(total_delay == 300);
+    CHECK(cursor == &why2025_lcd_init_table[sizeof(why2025_lcd_init_table) - 2]);
+}
+
+static void test_run_spi_sends_table(void) {
+    recorder_reset();
+    host_clock_set_simulated(1000000);
+    CHECK_OK(bsp_lcd_init_run_spi(NULL, nop_table));
+    CHECK(bus_acquisitions == 1 && !bus_held);
+
+    // Commands go out with DC low, parameters with DC high
+    static const struct {
+        int     dc;
+        size_t  length;
+        uint8_t data[5];
+        int64_t delay_before;  // Simulated time that must have passed since the previous transaction
+    } expected[] = {
+        {0, 1, {0x00}, 0},
+        {0, 1, {0x00}, 5000},
+        {1, 2, {0x81, 0xFF}, 0},
+        {0, 1, {0x3A}, 0},
+        {1, 1, {0x55}, 0},
+        {0, 1, {0x2A}, 30000},
+        {1, 5, {0x00, 0x00, 0x01, 0x3F, 0x00}, 0},
+        {0, 1, {0x00}, 0},
+    };
+    CHECK(num_records == sizeof(expected) / sizeof(expected[0]));
+    for (size_t i = 0; i < num_records; i++) {
+        CHECK(records[i].bus_held);
+        CHECK(records[i].dc == expected[i].dc);
+        CHECK(records[i].length == expected[i].length);
+        CHECK(memcmp(records[i].data, expected[i].data, expected[i].length) == 0);
+        CHECK(records[i].inline_data == (records[i].length <= 4));
+        if (i > 0) {
+            CHECK(records[i].time - records[i - 1].time == expected[i].delay_before);
+        }
+        if (expected[i].delay_before > 0) {
+            CHECK(records[i].outstanding == 0);  // The delay started after the previous command was sent
+        }
+    }
+}
+
+static void test_run_spi_queues_back_to_back(void) {
+    recorder_reset();
+    CHECK_OK(bsp_lcd_init_run_spi(NULL, why2025_lcd_init_table));
+    CHECK(max_pending == QUEUE_SIZE);
+    CHECK(num_records == 24 + 22);  // 24 commands, 22 of them with parameters
+}
+
+static void test_run_spi_reports_errors(void) {
+    recorder_reset();
+    fail_at = 3;
+    CHECK_ESP(ESP_ERR_INVALID_STATE, bsp_lcd_init_run_spi(NULL, nop_table));
+    CHECK(num_records == 3 && !bus_held);
+}
+
+int main(void) {
+    RUN_TEST(test_parse_commands_with_value_zero);
+    RUN_TEST(test_parse_why2025_table);
+    RUN_TEST(test_run_spi_sends_table);
+    RUN_TEST(test_run_spi_queues_back_to_back);
+    RUN_TEST(test_run_spi_reports_errors);
+    return 0;
+}
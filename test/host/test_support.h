@@ -0,0 +1,53 @@
+// Host tests: assertions and helpers shared by the test programs
+// SPDX-FileCopyrightText: 2026 Nicolai Electronics
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "esp_err.h"
+
+// Abort the test program with the location of the failing check
+#define CHECK(condition)                                                                 \
+    do {                                                                                 \
+        if (!(condition)) {                                                              \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            exit(1);                                                                     \
+        }                                                                                \
+    } while (0)
+
+#define CHECK_ESP(expected, expression)                                                              \
+    do {                                                                                             \
+        esp_err_t check_res = (expression);                                                          \
+        if (check_res != (expected)) {                                                               \
+            fprintf(stderr, "%s:%d: %s returned %s, expected %s\n", __FILE__, __LINE__, #expression, \
+                    esp_err_to_name(check_res), esp_err_to_name(expected));                          \
+            exit(1);                                                                                 \
+        }                                                                                            \
+    } while (0)
+
+#define CHECK_OK(expression) CHECK_ESP(ESP_OK, expression)
+
+// Run a test function and report it
+#define RUN_TEST(function)                  \
+    do {                                    \
+        printf("%s\n", #function);          \
+        fflush(stdout);                     \
+        function();                         \
+    } while (0)
+
+// Wall clock time in microseconds, independent of the simulated esp_timer clock
+static inline int64_t test_wall_time_us(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+// Keep the calling thread busy for the given time, stands in for rendering work
+static inline void test_busy_wait_us(int64_t duration) {
+    int64_t end = test_wall_time_us() + duration;
+    while (test_wall_time_us() < end) {
+    }
+}